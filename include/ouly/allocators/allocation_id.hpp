@@ -39,4 +39,19 @@ struct arena_id
 
 using allocation_size_type = std::conditional_t<cfg::coalescing_allocator_large_size, uint64_t, uint32_t>;
 
+/**
+ * @brief How long an allocation is expected to live, a placement hint for arena allocators.
+ *
+ * Keeping short-lived blocks away from long-lived ones means freeing them leaves one large hole
+ * instead of many small ones between blocks that stay.
+ */
+enum class allocation_lifetime : uint8_t
+{
+  persistent, ///< Lives for a level or longer
+  frame,      ///< Freed within a few frames
+  transient   ///< Freed soon after it is used, such as upload staging
+};
+
+constexpr uint32_t allocation_lifetime_count = 3;
+
 } // namespace ouly
\ No newline at end of file
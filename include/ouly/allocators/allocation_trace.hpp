@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/alignment.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file allocation_trace.hpp
+ * @brief Binary allocation traces: record the calls an application makes, replay them against any allocator
+ *
+ * A trace is a fixed header followed by fixed-size events. Allocations are identified by a dense
+ * handle chosen at record time, so a replayer can keep its own handles (pointers, allocation_ids,
+ * block ids) in a plain vector indexed by the trace handle. Handles are recycled after
+ * deallocation, which bounds the replay table by the peak number of live allocations.
+ *
+ * The layout is the host's native (little-endian on every supported target) byte order, and it
+ * is meant to be mapped straight from disk:
+ * @code
+ * std::ofstream out("frame.trace", std::ios::binary);
+ * ouly::allocation_recorder recorder(out);
+ * ouly::default_allocator<> backing;
+ * ouly::recording_allocator<ouly::default_allocator<>> heap(backing, recorder);
+ * // ... run the workload through `heap` ...
+ *
+ * auto file = ouly::make_mmap_source("frame.trace");
+ * ouly::allocation_trace_view trace(file.data(), file.size());
+ * for (auto event : trace) { ... }
+ * @endcode
+ */
+
+namespace ouly
+{
+
+/** @brief Kind of a recorded call */
+enum class trace_op : uint8_t
+{
+  allocate,
+  deallocate,
+  defragment,
+};
+
+/**
+ * @brief One recorded call; 16 bytes on disk
+ *
+ * For `allocate`, `size_` and `alignment_log2_` describe the request and `handle_` names the new
+ * allocation. For `deallocate`, `handle_` names the allocation released and `size_` repeats its
+ * requested size. `defragment` carries no payload.
+ */
+struct trace_event
+{
+  uint64_t size_           = 0;
+  uint32_t handle_         = 0;
+  trace_op op_             = trace_op::allocate;
+  uint8_t  alignment_log2_ = 0;
+  uint16_t reserved_       = 0;
+
+  [[nodiscard]] auto alignment() const noexcept -> std::size_t
+  {
+    return std::size_t{1} << alignment_log2_;
+  }
+};
+
+static_assert(sizeof(trace_event) == 16);
+
+/**
+ * @brief File header
+ *
+ * Later versions may only append fields to trace_event. Readers accept any version whose `event_size_` covers
+ * the fields they know, read those, and step over the rest by `event_size_`.
+ */
+struct trace_header
+{
+  static constexpr uint32_t magic_v   = 0x43525455; // "UTRC"
+  static constexpr uint32_t version_v = 1;
+
+  uint32_t magic_      = magic_v;
+  uint32_t version_    = version_v;
+  uint32_t event_size_ = sizeof(trace_event);
+  uint32_t reserved_   = 0;
+};
+
+static_assert(sizeof(trace_header) == 16);
+
+/**
+ * @brief Streams trace events to a binary std::ostream
+ *
+ * The header is written on construction. The stream should be opened with std::ios::binary.
+ */
+class allocation_trace_writer
+{
+public:
+  explicit allocation_trace_writer(std::ostream& out) : out_(&out)
+  {
+    trace_header header;
+    write_bytes(&header, sizeof(header));
+  }
+
+  void write(trace_event const& event)
+  {
+    write_bytes(&event, sizeof(event));
+    ++events_written_;
+  }
+
+  [[nodiscard]] auto events_written() const noexcept -> uint64_t
+  {
+    return events_written_;
+  }
+
+private:
+  void write_bytes(void const* data, std::size_t size)
+  {
+    out_->write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+  }
+
+  std::ostream* out_            = nullptr;
+  uint64_t      events_written_ = 0;
+};
+
+/**
+ * @brief Read-only view over a trace held in memory, typically an mmap_source
+ *
+ * Events are decoded on access, so the buffer need not be aligned. The view does not own the bytes.
+ */
+class allocation_trace_view
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = trace_event;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = trace_event;
+
+    iterator() noexcept = default;
+    iterator(allocation_trace_view const* view, std::size_t index) noexcept : view_(view), index_(index) {}
+
+    auto operator*() const noexcept -> trace_event
+    {
+      return (*view_)[index_];
+    }
+
+    auto operator++() noexcept -> iterator&
+    {
+      ++index_;
+      return *this;
+    }
+
+    auto operator++(int) noexcept -> iterator
+    {
+      auto copy = *this;
+      ++index_;
+      return copy;
+    }
+
+    auto operator-(iterator const& other) const noexcept -> difference_type
+    {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    auto operator==(iterator const& other) const noexcept -> bool
+    {
+      return index_ == other.index_;
+    }
+
+  private:
+    allocation_trace_view const* view_  = nullptr;
+    std::size_t                  index_ = 0;
+  };
+
+  allocation_trace_view() noexcept = default;
+
+  /**
+   * @brief Wrap `size` bytes of trace data, including traces written by later versions
+   * @throws std::system_error (invalid_argument) if the header is missing, has the wrong magic, or declares
+   * events smaller than trace_event
+   */
+  template <typename Byte>
+    requires(sizeof(Byte) == 1)
+  allocation_trace_view(Byte const* data, std::size_t size) : data_(reinterpret_cast<std::byte const*>(data)) // NOLINT
+  {
+    trace_header header;
+    if (size < sizeof(header))
+    {
+      throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+    }
+    std::memcpy(&header, data_, sizeof(header));
+    if (header.magic_ != trace_header::magic_v || header.event_size_ < sizeof(trace_event))
+    {
+      throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+    }
+    stride_ = header.event_size_;
+    count_  = (size - sizeof(header)) / stride_;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return count_;
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return count_ == 0;
+  }
+
+  [[nodiscard]] auto operator[](std::size_t index) const noexcept -> trace_event
+  {
+    trace_event event;
+    std::memcpy(&event, data_ + sizeof(trace_header) + (index * stride_), sizeof(event));
+    return event;
+  }
+
+  [[nodiscard]] auto begin() const noexcept -> iterator
+  {
+    return {this, 0};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> iterator
+  {
+    return {this, count_};
+  }
+
+  /** @brief Largest handle + 1, the size of a table indexed by handle */
+  [[nodiscard]] auto handle_count() const noexcept -> uint32_t
+  {
+    uint32_t count = 0;
+    for (auto event : *this)
+    {
+      if (event.op_ == trace_op::allocate)
+      {
+        count = std::max(count, event.handle_ + 1);
+      }
+    }
+    return count;
+  }
+
+private:
+  std::byte const* data_   = nullptr;
+  std::size_t      stride_ = sizeof(trace_event);
+  std::size_t      count_  = 0;
+};
+
+/**
+ * @brief Assigns trace handles to allocations and writes their events
+ *
+ * Allocators identify allocations differently (pointers, allocation_ids, block ids), so calls are
+ * keyed by any 64-bit value unique among live allocations: the address for pointer allocators,
+ * the id for the offset allocators. Wrap pointer allocators with recording_allocator; record
+ * offset allocators next to their allocate/deallocate/defragment calls.
+ */
+class allocation_recorder
+{
+public:
+  explicit allocation_recorder(std::ostream& out) : writer_(out) {}
+
+  /** @return The trace handle assigned to `key` */
+  auto record_allocate(uint64_t key, uint64_t size, std::size_t alignment = 1) -> uint32_t
+  {
+    uint32_t handle = 0;
+    if (!free_handles_.empty())
+    {
+      handle = free_handles_.back();
+      free_handles_.pop_back();
+    }
+    else
+    {
+      handle = next_handle_++;
+    }
+    live_[key] = {.size_ = size, .handle_ = handle};
+    writer_.write({.size_           = size,
+                   .handle_         = handle,
+                   .op_             = trace_op::allocate,
+                   .alignment_log2_ = static_cast<uint8_t>(std::countr_zero(std::max<std::size_t>(alignment, 1)))});
+    return handle;
+  }
+
+  /** @brief Record the release of the allocation recorded under `key`; unknown keys are ignored */
+  void record_deallocate(uint64_t key)
+  {
+    auto it = live_.find(key);
+    if (it == live_.end())
+    {
+      return;
+    }
+    writer_.write({.size_ = it->second.size_, .handle_ = it->second.handle_, .op_ = trace_op::deallocate});
+    free_handles_.push_back(it->second.handle_);
+    live_.erase(it);
+  }
+
+  void record_defragment()
+  {
+    writer_.write({.op_ = trace_op::defragment});
+  }
+
+  /** @brief Re-key a live allocation, e.g. after defragmentation moved it */
+  void rekey(uint64_t old_key, uint64_t new_key)
+  {
+    auto it = live_.find(old_key);
+    if (it != live_.end())
+    {
+      auto value = it->second;
+      live_.erase(it);
+      live_[new_key] = value;
+    }
+  }
+
+  [[nodiscard]] auto events_written() const noexcept -> uint64_t
+  {
+    return writer_.events_written();
+  }
+
+  [[nodiscard]] auto live_allocations() const noexcept -> std::size_t
+  {
+    return live_.size();
+  }
+
+private:
+  struct live_entry
+  {
+    uint64_t size_   = 0;
+    uint32_t handle_ = 0;
+  };
+
+  allocation_trace_writer                  writer_;
+  std::unordered_map<uint64_t, live_entry> live_;
+  std::vector<uint32_t>                    free_handles_;
+  uint32_t                                 next_handle_ = 0;
+};
+
+/**
+ * @brief Forwards to a pointer allocator and records every call
+ *
+ * Works with any allocator exposing `size_type`, `address`, `allocate(size, alignment)`,
+ * `deallocate(ptr, size, alignment)` and optionally `zero_allocate`, like default_allocator,
+ * linear_arena_allocator or pool_allocator.
+ */
+template <typename Allocator>
+class recording_allocator
+{
+public:
+  using allocator_type = Allocator;
+  using size_type      = typename allocator_type::size_type;
+  using address        = typename allocator_type::address;
+
+  recording_allocator(allocator_type& allocator, allocation_recorder& recorder) noexcept
+      : allocator_(&allocator), recorder_(&recorder)
+  {}
+
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto allocate(size_type size, Alignment align = {}) -> address
+  {
+    auto ptr = allocator_->allocate(size, align);
+    recorder_->record_allocate(key(ptr), size, static_cast<std::size_t>(align));
+    return ptr;
+  }
+
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto zero_allocate(size_type size, Alignment align = {}) -> address
+  {
+    auto ptr = allocator_->zero_allocate(size, align);
+    recorder_->record_allocate(key(ptr), size, static_cast<std::size_t>(align));
+    return ptr;
+  }
+
+  template <typename Alignment = alignment<>>
+  void deallocate(address ptr, size_type size, Alignment align = {})
+  {
+    recorder_->record_deallocate(key(ptr));
+    allocator_->deallocate(ptr, size, align);
+  }
+
+  [[nodiscard]] auto get() const noexcept -> allocator_type*
+  {
+    return allocator_;
+  }
+
+private:
+  static auto key(address ptr) noexcept -> uint64_t
+  {
+    return static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(ptr)); // NOLINT
+  }
+
+  allocator_type*      allocator_ = nullptr;
+  allocation_recorder* recorder_  = nullptr;
+};
+
+} // namespace ouly
@@ -23,7 +23,8 @@ namespace ouly
  *
  * `defragment` compacts allocations towards the front of earlier arenas, drops emptied arenas and
  * reports moves and relocations through the manager. Allocation ids remain stable across
- * defragmentation, only their arena/offset change.
+ * defragmentation, only their arena/offset change. A byte/move budget splits the work into
+ * resumable steps, so each frame can spend a fixed slice compacting.
  *
  * @note Always allocate through this class (not through a base class reference) so that
  * per-allocation alignment is recorded for defragmentation.
@@ -55,12 +56,26 @@ public:
    * underlying block is over-allocated by `alignment - 1` bytes to guarantee the fit.
    */
   template <CoalescingMemoryManager M, typename Alignment = ouly::alignment<>, typename Dedicated = std::false_type>
-  auto allocate(size_type size, M& manager, Alignment alignment = {}, Dedicated dedicated = {}) -> ca_allocation
+  auto allocate(size_type size, M& manager, Alignment alignment = {}, Dedicated /*unused*/ = {}) -> ca_allocation
   {
-    auto const align_value = static_cast<size_type>(alignment);
-    auto const mask        = align_value > 1 ? align_value - 1 : size_type{0};
+    return allocate(size, manager,
+                    ca_allocation_options{.alignment_ = static_cast<size_type>(alignment),
+                                          .dedicated_ = static_cast<bool>(Dedicated::value)});
+  }
+
+  /**
+   * @brief `coalescing_arena_allocator::allocate` with runtime options, recording the alignment for
+   * defragmentation. The lifetime picks the side of the free block the same way; `defragment` repacks
+   * bottom-up and does not preserve that placement.
+   */
+  template <CoalescingMemoryManager M>
+  auto allocate(size_type size, M& manager, ca_allocation_options options) -> ca_allocation
+  {
+    auto const mask = options.alignment_ > 1 ? options.alignment_ - 1 : size_type{0};
 
-    auto al = coalescing_arena_allocator::allocate(size + mask, manager, ouly::alignment<>{}, dedicated);
+    auto raw_options       = options;
+    raw_options.alignment_ = 1;
+    auto al                = coalescing_arena_allocator::allocate(size + mask, manager, raw_options);
     if (al.get_allocation_id() == allocation_id())
     {
       return al;
@@ -71,12 +86,25 @@ public:
       alignments_.resize(static_cast<size_t>(id) + 1, 0);
     }
     // dedicated allocations are pinned: defragment never relocates them out of their arena
-    bool const is_dedicated = Dedicated::value || size + mask >= get_arena_size();
+    bool const is_dedicated = options.dedicated_ || size + mask >= get_arena_size();
     alignments_[id]         = static_cast<uint8_t>(std::popcount(mask) | (is_dedicated ? dedicated_bit : 0));
     al.offset_              = (al.offset_ + mask) & ~mask;
     return al;
   }
 
+  /** @brief `coalescing_arena_allocator::allocate_batch`, recording the alignment of every block */
+  template <CoalescingMemoryManager M, typename Alignment = ouly::alignment<>>
+  auto allocate_batch(std::span<size_type const> sizes, M& manager, Alignment alignment = {})
+   -> std::vector<ca_allocation>
+  {
+    std::vector<ca_allocation> result(sizes.size());
+    for (auto index : batch_order(sizes))
+    {
+      ouly::detail::vector_access(result, index) = allocate(sizes[index], manager, alignment);
+    }
+    return result;
+  }
+
   /**
    * @brief Compact allocations towards the front of earlier arenas and drop emptied arenas.
    *
@@ -87,12 +115,28 @@ public:
    * about relocations through `rebind_alloc` with the new aligned offset.
    *
    * @param max_bytes_to_move Optional budget; once moving another allocation would exceed it, all
-   * remaining allocations stay in place and `completed_` is false in the result.
+   * remaining allocations stay in place and `completed_` is false in the result. The next call
+   * resumes the sweep at the allocation that did not fit.
    */
   template <typename M>
     requires(CoalescingDefragMemoryManager<M, best_fit_defrag_allocator>)
   auto defragment(M& manager, size_type max_bytes_to_move = std::numeric_limits<size_type>::max())
    -> coalescing_defrag_result
+  {
+    return defragment(manager, coalescing_defrag_budget{.max_bytes_to_move_ = max_bytes_to_move});
+  }
+
+  /**
+   * @brief Run one budgeted step of an incremental defragmentation sweep.
+   *
+   * Blocks the sweep already went past (those before the point where the previous call ran out of
+   * budget) are left in place; the step continues from there until either budget limit is hit or
+   * the sweep reaches the end, which `completed_` reports. If the arena the sweep stopped in has
+   * been released since, the sweep starts over.
+   */
+  template <typename M>
+    requires(CoalescingDefragMemoryManager<M, best_fit_defrag_allocator>)
+  auto defragment(M& manager, coalescing_defrag_budget budget) -> coalescing_defrag_result
   {
     manager.begin_defragment(*this);
     coalescing_defrag_result result;
@@ -112,6 +156,13 @@ public:
     std::vector<size_type>   cursor(arena_entries().entries_.size(), 0);
     bool                     budget_left = true;
 
+    auto resume_pos = static_cast<uint32_t>(std::ranges::find(order, resume_arena_) - order.begin());
+    if (resume_arena_ == 0 || resume_pos == order.size())
+    {
+      resume_pos     = 0;
+      resume_offset_ = 0;
+    }
+
     for (uint32_t pos = 0; pos < static_cast<uint32_t>(order.size()); ++pos)
     {
       auto const arena_idx = order[pos];
@@ -125,15 +176,19 @@ public:
         }
         auto const raw_size = ouly::detail::vector_access(block_entries().sizes_, block);
         auto const from_raw = ouly::detail::vector_access(block_entries().offsets_, block);
-        bool const movable  = budget_left && !is_dedicated(block);
+        bool const settled  = pos < resume_pos || (pos == resume_pos && from_raw < resume_offset_);
+        bool const movable  = budget_left && !settled && !is_dedicated(block);
         auto [dst, to] = movable ? find_placement(order, pos, cursor, raw_size) : std::make_pair(arena_idx, from_raw);
         bool const relocates = dst != arena_idx || to != from_raw;
         auto const mask      = mask_of(block);
 
-        if (relocates && result.bytes_moved_ + (raw_size - mask) > max_bytes_to_move)
+        if (relocates && (result.bytes_moved_ + (raw_size - mask) > budget.max_bytes_to_move_ ||
+                          result.allocations_moved_ >= budget.max_allocations_moved_))
         {
           result.completed_ = false;
           budget_left       = false;
+          resume_arena_     = arena_idx;
+          resume_offset_    = from_raw;
           dst               = arena_idx;
           to                = from_raw;
         }
@@ -155,6 +210,11 @@ public:
       }
     }
     result.moves_ = static_cast<uint32_t>(moves.size());
+    if (result.completed_)
+    {
+      resume_arena_  = 0;
+      resume_offset_ = 0;
+    }
 
     // Recycle the old free block entries; gap and tail blocks below will reuse the slots
     for (auto block : old_free_blocks)
@@ -183,9 +243,16 @@ public:
     }
 
     manager.end_defragment(*this);
+    defrag_stats_.record(result);
     return result;
   }
 
+  /** @brief Totals accumulated over every `defragment` call. */
+  [[nodiscard]] auto defrag_statistics() const noexcept -> coalescing_defrag_statistics const&
+  {
+    return defrag_stats_;
+  }
+
 private:
   struct placement
   {
@@ -226,6 +293,12 @@ private:
 
   // log2(alignment) per allocated block id (high bit: pinned); free-list split blocks are never read
   std::vector<uint8_t> alignments_;
+
+  // where the last budget-limited defragment stopped; arena 0 means the next sweep starts over
+  uint16_t  resume_arena_  = 0;
+  size_type resume_offset_ = 0;
+
+  coalescing_defrag_statistics defrag_stats_;
 };
 
 } // namespace ouly
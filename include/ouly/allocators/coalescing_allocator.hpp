@@ -3,8 +3,11 @@
 #pragma once
 
 #include "ouly/allocators/config.hpp"
+#include "ouly/allocators/detail/tlsf.hpp"
 #include "ouly/utility/common.hpp"
+#include <cstdint>
 #include <limits>
+#include <unordered_map>
 #include <vector>
 
 namespace ouly
@@ -12,6 +15,22 @@ namespace ouly
 
 using coalescing_allocator_size_type = std::conditional_t<cfg::coalescing_allocator_large_size, uint64_t, uint32_t>;
 
+/**
+ * @brief How coalescing_allocator and compacting_allocator search their free blocks
+ */
+enum class fit_strategy : uint8_t
+{
+  /** @brief Scan free blocks in offset order; O(free blocks) allocation, O(log n) deallocation */
+  first_fit,
+  /**
+   * @brief Two-level segregated fit; O(1) allocation and deallocation
+   *
+   * Allocation may pick a block larger than the best fit, since a bin is only searched when all its
+   * blocks are large enough. Blocks stay coalesced, so fragmentation remains comparable to first fit.
+   */
+  tlsf
+};
+
 /**
  * @brief This allocator grows the buffer size, and merges free sizes.
  */
@@ -31,19 +50,33 @@ using coalescing_allocator_size_type = std::conditional_t<cfg::coalescing_alloca
  * - Suitable for scenarios requiring defragmented memory allocation
  *
  * @note The allocator starts with one maximum-sized free block
+ * @note With fit_strategy::tlsf, deallocate() must be passed a block exactly as returned by allocate()
  */
 class coalescing_allocator
 {
 public:
   using size_type = coalescing_allocator_size_type;
 
+  coalescing_allocator() noexcept = default;
+  OULY_API explicit coalescing_allocator(fit_strategy strategy);
+
   OULY_API auto allocate(size_type size) -> size_type;
   OULY_API void deallocate(size_type offset, size_type size);
 
+  [[nodiscard]] auto get_fit_strategy() const noexcept -> fit_strategy
+  {
+    return strategy_;
+  }
+
 private:
   // Free blocks
   std::vector<size_type> offsets_ = {0};
   std::vector<size_type> sizes_   = {std::numeric_limits<size_type>::max()};
+
+  // fit_strategy::tlsf: block index and live offset -> block node
+  ouly::detail::tlsf_index<size_type>     index_;
+  std::unordered_map<size_type, uint32_t> live_;
+  fit_strategy                            strategy_ = fit_strategy::first_fit;
 };
 
 } // namespace ouly
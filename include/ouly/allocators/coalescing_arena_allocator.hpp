@@ -6,9 +6,12 @@
 #include "ouly/allocators/allocator.hpp"
 #include "ouly/allocators/detail/ca_structs.hpp"
 #include "ouly/allocators/detail/memory_stats.hpp"
+#include "ouly/allocators/heap_snapshot.hpp"
 #include "ouly/containers/detail/vlist.hpp"
 #include "ouly/utility/config.hpp"
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <vector>
 
@@ -58,6 +61,71 @@ struct coalescing_defrag_result
   bool completed_ = true;
 };
 
+/**
+ * @brief Work one `defragment` call may do, the CPU-side counterpart of `gpu_defrag_budget`.
+ *
+ * A call that runs out of budget remembers where it stopped and the next call resumes the sweep
+ * from there, so a fixed budget per frame walks the whole heap over several frames.
+ */
+struct coalescing_defrag_budget
+{
+  /** Bytes copied by `move_memory` calls */
+  allocation_size_type max_bytes_to_move_ = std::numeric_limits<allocation_size_type>::max();
+  /** Allocations relocated; adjacent ones may share a single `move_memory` call */
+  uint32_t max_allocations_moved_ = std::numeric_limits<uint32_t>::max();
+};
+
+/** @brief Lifetime totals reported by `defrag_statistics()` of the defragmenting allocators. */
+struct coalescing_defrag_statistics
+{
+  uint64_t             calls_              = 0;
+  uint64_t             sweeps_completed_   = 0;
+  uint64_t             bytes_moved_        = 0;
+  uint64_t             allocations_moved_  = 0;
+  uint64_t             arenas_removed_     = 0;
+  allocation_size_type max_bytes_per_call_ = 0;
+
+  void record(coalescing_defrag_result const& result) noexcept
+  {
+    ++calls_;
+    sweeps_completed_ += result.completed_ ? 1 : 0;
+    bytes_moved_ += result.bytes_moved_;
+    allocations_moved_ += result.allocations_moved_;
+    arenas_removed_ += result.arenas_removed_;
+    max_bytes_per_call_ = std::max(max_bytes_per_call_, result.bytes_moved_);
+  }
+};
+
+/** @brief Runtime placement options for `coalescing_arena_allocator::allocate`. */
+struct ca_allocation_options
+{
+  allocation_size_type alignment_ = 1;
+  /** Persistent blocks are carved bottom-up, frame and transient ones top-down */
+  allocation_lifetime lifetime_  = allocation_lifetime::persistent;
+  bool                dedicated_ = false;
+};
+
+/**
+ * @brief Where the live blocks of one `allocation_lifetime` sit, as reported by
+ * `coalescing_arena_allocator::lifetime_usage`.
+ *
+ * A run is a stretch of adjacent blocks of the lifetime. Freeing them all leaves one hole per run,
+ * so the fewer and longer the runs, the less the lifetime fragments the arenas it shares.
+ */
+struct ca_lifetime_usage
+{
+  allocation_size_type bytes_            = 0;
+  allocation_size_type largest_run_      = 0;
+  uint32_t             allocation_count_ = 0;
+  uint32_t             runs_             = 0;
+
+  /** @brief Share of the bytes outside the largest run: 0 when the blocks are contiguous */
+  [[nodiscard]] auto fragmentation() const noexcept -> double
+  {
+    return bytes_ == 0 ? 0.0 : 1.0 - (static_cast<double>(largest_run_) / static_cast<double>(bytes_));
+  }
+};
+
 struct ca_allocation
 {
   allocation_size_type offset_ = 0;
@@ -166,33 +234,69 @@ public:
    * returned offset is rounded up to the alignment; `get_offset`/`get_size` report the raw block. */
   template <CoalescingMemoryManager M, typename Alignment = ouly::alignment<>, typename Dedicated = std::false_type>
   auto allocate(size_type size, M& manager, Alignment alignment = {}, Dedicated /*unused*/ = {}) -> ca_allocation
+  {
+    return allocate(size, manager,
+                    ca_allocation_options{.alignment_ = static_cast<size_type>(alignment),
+                                          .dedicated_ = static_cast<bool>(Dedicated::value)});
+  }
+
+  /**
+   * @brief Allocate with runtime options.
+   *
+   * Frame and transient blocks are carved from the top of the free block they are placed in, and
+   * persistent ones from the bottom, so within an arena the two lifetimes grow towards each other
+   * from opposite ends and short-lived blocks do not end up wedged between long-lived ones.
+   */
+  template <CoalescingMemoryManager M>
+  auto allocate(size_type size, M& manager, ca_allocation_options options) -> ca_allocation
   {
     [[maybe_unused]] auto measure = statistics::report_allocate(size);
 
-    auto const align_value  = static_cast<size_type>(alignment);
-    auto const mask         = align_value > 1 ? align_value - 1 : size_type{0};
+    auto const mask         = options.alignment_ > 1 ? options.alignment_ - 1 : size_type{0};
     auto const vsize        = size + mask;
-    bool const is_dedicated = Dedicated::value || vsize >= arena_size_;
+    bool const is_dedicated = options.dedicated_ || vsize >= arena_size_;
 
     if (is_dedicated)
     {
       // a dedicated allocation starts at offset 0, which is aligned for any power of two
       auto [arena, block] = add_arena_filled(size, manager);
+      set_lifetime(block.get(), options.lifetime_);
       return ca_allocation{.offset_ = 0, .id_ = block, .arena_ = arena};
     }
 
-    ca_allocation al = try_allocate(vsize);
+    bool const    top_down = options.lifetime_ != allocation_lifetime::persistent;
+    ca_allocation al       = try_allocate(vsize, top_down);
 
     if (al.get_allocation_id() == allocation_id())
     {
       add_arena(vsize, manager);
-      al = try_allocate(vsize);
+      al = try_allocate(vsize, top_down);
     }
 
+    set_lifetime(al.get_allocation_id().get(), options.lifetime_);
     al.offset_ = (al.offset_ + mask) & ~mask;
     return al;
   }
 
+  /**
+   * @brief Allocate a block for every entry of `sizes`, all with the same alignment.
+   *
+   * Requests are placed largest first, so the small ones fill the tails the large ones leave
+   * instead of splitting the holes a large request needs later.
+   * @return One allocation per size, in the order of `sizes`
+   */
+  template <CoalescingMemoryManager M, typename Alignment = ouly::alignment<>>
+  auto allocate_batch(std::span<size_type const> sizes, M& manager, Alignment alignment = {})
+   -> std::vector<ca_allocation>
+  {
+    std::vector<ca_allocation> result(sizes.size());
+    for (auto index : batch_order(sizes))
+    {
+      ouly::detail::vector_access(result, index) = allocate(sizes[index], manager, alignment);
+    }
+    return result;
+  }
+
   /** @brief Dellocate an allocation. The manager must be provided for removal of arenas_. */
   template <CoalescingMemoryManager M>
   void deallocate(allocation_id id, M& manager)
@@ -204,6 +308,40 @@ public:
     }
   }
 
+  /**
+   * @brief Deallocate many allocations at once.
+   *
+   * Blocks are released first and every touched arena is then coalesced in a single walk of its
+   * block list, with one merge into the free size list, instead of a neighbour merge and a free
+   * list update per block. Arenas left empty are removed through the manager.
+   */
+  template <CoalescingMemoryManager M>
+  void deallocate_batch(std::span<allocation_id const> ids, M& manager)
+  {
+    for (auto arena : deallocate_batch(ids))
+    {
+      manager.remove(arena);
+    }
+  }
+
+  /** @brief The lifetime an allocation was made with */
+  [[nodiscard]] auto get_lifetime(allocation_id id) const noexcept -> allocation_lifetime
+  {
+    return id.get() < lifetimes_.size() ? static_cast<allocation_lifetime>(lifetimes_[id.get()])
+                                        : allocation_lifetime::persistent;
+  }
+
+  /** @brief Walk every arena and measure how the live blocks of `lifetime` are laid out */
+  [[nodiscard]] OULY_API auto lifetime_usage(allocation_lifetime lifetime) const -> ca_lifetime_usage;
+
+  /**
+   * @brief Copy out the block map of every arena, walking each block list once.
+   *
+   * Blocks record the lifetime they were allocated with. The allocator pins nothing, so every used
+   * block is reported movable.
+   */
+  [[nodiscard]] OULY_API auto snapshot() const -> heap_snapshot;
+
   void validate_integrity() const;
 
   [[nodiscard]] auto get_offsets() const noexcept -> std::span<allocation_size_type const>
@@ -252,6 +390,10 @@ protected:
   OULY_API void add_free(uint32_t node);
   OULY_API void erase(uint32_t node);
   OULY_API auto deallocate(allocation_id id) -> arena_id;
+  /** @return Arenas dropped because they became empty */
+  OULY_API auto deallocate_batch(std::span<allocation_id const> ids) -> std::vector<arena_id>;
+  /** @return Indices into `sizes`, largest size first */
+  OULY_API static auto batch_order(std::span<size_type const> sizes) -> std::vector<uint32_t>;
 
   static auto mini2(size_type const* it, size_t size, size_type key) noexcept
   {
@@ -304,14 +446,23 @@ protected:
     return sz;
   }
 
-  auto try_allocate(size_type size) -> ca_allocation
+  void set_lifetime(uint32_t block, allocation_lifetime lifetime)
+  {
+    if (lifetimes_.size() <= block)
+    {
+      lifetimes_.resize(static_cast<size_t>(block) + 1, 0);
+    }
+    lifetimes_[block] = static_cast<uint8_t>(lifetime);
+  }
+
+  auto try_allocate(size_type size, bool top_down = false) -> ca_allocation
   {
     if (sizes_.empty() || sizes_.back() < size)
     {
       return {};
     }
     const auto* it = find_free(size);
-    auto        id = commit(size, it);
+    auto        id = commit(size, it, top_down);
     return ca_allocation{.offset_ = ouly::detail::vector_access(block_entries_.offsets_, id),
                          .id_     = {.id_ = id},
                          .arena_  = {.id_ = ouly::detail::vector_access(block_entries_.arenas_, id)}};
@@ -319,7 +470,8 @@ protected:
 
   OULY_API void reinsert_left(size_t of, size_type size, std::uint32_t node);
   OULY_API void reinsert_right(size_t of, size_type size, std::uint32_t node);
-  OULY_API auto commit(size_type size, size_type const* found) -> uint32_t;
+  /** @param top_down Carve the block from the end of the free block instead of its start */
+  OULY_API auto commit(size_type size, size_type const* found, bool top_down = false) -> uint32_t;
 
   // Accessors for derived allocators (e.g. defragmentation support)
   [[nodiscard]] auto arena_entries() noexcept -> ouly::detail::ca_arena_entries&
@@ -382,6 +534,8 @@ private:
 
   std::vector<size_type> sizes_;
   std::vector<uint32_t>  free_ordering_;
+  // allocation_lifetime of each block, indexed by block id
+  std::vector<uint8_t> lifetimes_;
 
   size_type arena_size_ = 0;
 };
@@ -26,6 +26,9 @@ namespace ouly
  * of an allocation is queried with `get_offset`. This is what allows `compact` to slide live
  * allocations towards offset zero: ids remain stable across compaction, only offsets change.
  *
+ * Constructed with `fit_strategy::tlsf`, free blocks are kept in a two-level segregated fit index
+ * instead, making allocation and deallocation O(1) regardless of how fragmented the space is.
+ *
  * @note This class is meant for virtual allocations, for example GPU memory management. No actual
  * memory is touched by the allocator; `compact` reports the ranges to move through a callback.
  */
@@ -34,6 +37,9 @@ class compacting_allocator
 public:
   using size_type = coalescing_allocator_size_type;
 
+  compacting_allocator() noexcept = default;
+  OULY_API explicit compacting_allocator(fit_strategy strategy);
+
   struct compact_result
   {
     size_type bytes_moved_       = 0;
@@ -102,8 +108,7 @@ public:
     size_type         cursor      = 0;
     bool              budget_left = true;
 
-    free_offsets_.clear();
-    free_sizes_.clear();
+    begin_rebuild();
 
     for (auto const& it : items)
     {
@@ -134,15 +139,14 @@ public:
       // rebuild the free list from the gap left before this allocation's final position
       if (to > cursor)
       {
-        free_offsets_.push_back(cursor);
-        free_sizes_.push_back(to - cursor);
+        rebuild_free(cursor, to - cursor);
       }
+      rebuild_live(it.id_, to, size);
       cursor = to + size;
     }
     if (cursor != std::numeric_limits<size_type>::max())
     {
-      free_offsets_.push_back(cursor);
-      free_sizes_.push_back(std::numeric_limits<size_type>::max() - cursor);
+      rebuild_free(cursor, std::numeric_limits<size_type>::max() - cursor);
     }
     result.moves_ = static_cast<uint32_t>(moves.size());
 
@@ -155,7 +159,46 @@ public:
 
   OULY_API void validate_integrity() const;
 
+  [[nodiscard]] auto get_fit_strategy() const noexcept -> fit_strategy
+  {
+    return strategy_;
+  }
+
 private:
+  void begin_rebuild()
+  {
+    if (strategy_ == fit_strategy::tlsf)
+    {
+      index_.clear();
+    }
+    else
+    {
+      free_offsets_.clear();
+      free_sizes_.clear();
+    }
+  }
+
+  void rebuild_free(size_type offset, size_type size)
+  {
+    if (strategy_ == fit_strategy::tlsf)
+    {
+      index_.append(offset, size, true);
+    }
+    else
+    {
+      free_offsets_.push_back(offset);
+      free_sizes_.push_back(size);
+    }
+  }
+
+  void rebuild_live(uint32_t id, size_type offset, size_type size)
+  {
+    if (strategy_ == fit_strategy::tlsf)
+    {
+      ouly::detail::vector_access(entry_nodes_, id) = index_.append(offset, size, false);
+    }
+  }
+
   OULY_API auto push_entry(size_type offset, size_type size) -> uint32_t;
 
   OULY_API void free_entry(uint32_t id);
@@ -169,6 +212,11 @@ private:
   std::vector<size_type> entry_sizes_   = {0};
   std::vector<bool>      entry_live_    = {false};
   uint32_t               free_entry_    = 0;
+
+  // fit_strategy::tlsf: block index, and the index node backing each allocation
+  ouly::detail::tlsf_index<size_type> index_;
+  std::vector<uint32_t>               entry_nodes_ = {0};
+  fit_strategy                        strategy_    = fit_strategy::first_fit;
 };
 
 } // namespace ouly
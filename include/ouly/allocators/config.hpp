@@ -14,6 +14,8 @@ inline static constexpr bool prefetch_next_allocation        = false; // TODO ma
 inline static constexpr uint32_t default_gpu_block_to_scan = 64;
 /** @brief Page size of the scratch allocator gpu defragmentation falls back to */
 inline static constexpr uint32_t default_gpu_scratch_size = 16 * 1024;
+/** @brief Evacuation candidates gpu defragmentation simulates at once when planning is dispatched to workers */
+inline static constexpr uint32_t default_gpu_planning_batch = 16;
 
 struct track_memory
 {
@@ -123,7 +125,8 @@ enum class advice : std::uint8_t
   random,     // Random access pattern
   sequential, // Sequential access pattern
   will_need,  // Will need this memory soon
-  dont_need   // Don't need this memory soon
+  dont_need,  // Don't need this memory soon
+  huge_page   // Back with transparent huge pages where supported
 };
 
 enum class protection : std::uint8_t
@@ -138,6 +141,28 @@ enum class protection : std::uint8_t
   // read_write_execute = read | write | execute
 };
 
+/**
+ * @brief Page size backing a virtual memory mapping
+ *
+ * Large, randomly accessed regions (ECS tables, arenas) miss the TLB far less often when backed by
+ * huge pages. Both huge modes fall back to normal pages when the system cannot provide them.
+ */
+enum class page_backing : std::uint8_t
+{
+  normal,           // System page size
+  transparent_huge, // Huge-page aligned mapping advised with MADV_HUGEPAGE; the kernel promotes it lazily
+  huge              // Pre-reserved huge pages (MAP_HUGETLB, MEM_LARGE_PAGES), then transparent_huge
+};
+
+/**
+ * @brief Select the page_backing of allocators that map memory directly
+ */
+template <page_backing B>
+struct backing_pages
+{
+  static constexpr page_backing page_backing_v = B;
+};
+
 enum class memory_stat_type : uint8_t
 {
   e_none,
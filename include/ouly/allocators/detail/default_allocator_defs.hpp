@@ -43,6 +43,11 @@ concept HasUnderlyingAllocator = requires { typename T::underlying_allocator_t;
 template <typename T>
 concept HasProtection = requires { typename T::protection_t; };
 
+template <typename T>
+concept HasPageBacking = requires {
+  { T::page_backing_v } -> std::convertible_to<ouly::cfg::page_backing>;
+};
+
 template <typename T>
 struct debug_tracer
 {
@@ -108,4 +113,19 @@ using protection_t = protection<T>::type;
 template <typename T>
 constexpr auto protection_v = protection<T>::value;
 
+template <typename T>
+struct page_backing
+{
+  static constexpr auto value = ouly::cfg::page_backing::normal;
+};
+
+template <HasPageBacking T>
+struct page_backing<T>
+{
+  static constexpr auto value = T::page_backing_v;
+};
+
+template <typename T>
+constexpr auto page_backing_v = page_backing<T>::value;
+
 } // namespace ouly::detail
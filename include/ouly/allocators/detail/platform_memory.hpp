@@ -24,6 +24,7 @@ struct memory_info
 {
   std::size_t page_size_              = 0;
   std::size_t allocation_granularity_ = 0;
+  std::size_t huge_page_size_         = 0; // Default huge page size; 0 when the system has none
 };
 
 struct mapped_file_info
@@ -48,10 +49,13 @@ OULY_API auto get_memory_info() noexcept -> memory_info;
  * @param size Size in bytes to allocate
  * @param prot Memory cfg::protection flags
  * @param preferred_address Preferred address (may be ignored)
+ * @param backing Requested page size; huge pages fall back to normal pages when unavailable
  * @return Pointer to allocated memory or nullptr on failure
+ * @note Free with virtual_free() and the same size, whatever backing was obtained
  */
 OULY_API auto virtual_alloc(std::size_t size, cfg::protection prot = cfg::protection::read_write,
-                            void* preferred_address = nullptr) noexcept -> void*;
+                            void* preferred_address = nullptr,
+                            cfg::page_backing backing = cfg::page_backing::normal) noexcept -> void*;
 
 /**
  * @brief Deallocate virtual memory
@@ -61,6 +65,36 @@ OULY_API auto virtual_alloc(std::size_t size, cfg::protection prot = cfg::protec
  */
 OULY_API auto virtual_free(void* ptr, std::size_t size) noexcept -> bool;
 
+/**
+ * @brief Reserve address space without committing memory
+ * @param size Size in bytes to reserve, a multiple of the allocation granularity
+ * @return Start of the reserved range or nullptr on failure
+ * @note Accessing the range faults until it is committed; release it with virtual_free()
+ */
+OULY_API auto virtual_reserve(std::size_t size) noexcept -> void*;
+
+/**
+ * @brief Commit pages inside a reserved range
+ * @param ptr Page-aligned start of the pages to commit
+ * @param size Size of the region, a multiple of the page size
+ * @param prot Protection of the committed pages
+ * @return true on success, false when the system is out of memory
+ * @note The pages must not be committed already; on POSIX they are replaced with fresh zero pages
+ * @note On Linux the commit charge is taken here, but only a strict overcommit policy
+ * (vm.overcommit_memory=2) refuses it; under the default heuristic an out-of-memory condition surfaces
+ * when the pages are first touched
+ */
+OULY_API auto virtual_commit(void* ptr, std::size_t size, cfg::protection prot = cfg::protection::read_write) noexcept
+ -> bool;
+
+/**
+ * @brief Return committed pages to the system while keeping their address range reserved
+ * @param ptr Page-aligned start of the pages to decommit
+ * @param size Size of the region, a multiple of the page size
+ * @return true on success, false on failure
+ */
+OULY_API auto virtual_decommit(void* ptr, std::size_t size) noexcept -> bool;
+
 /**
  * @brief Change memory cfg::protection on a region
  * @param ptr Pointer to memory region
@@ -88,10 +122,12 @@ OULY_API auto map_file(std::filesystem::path const& filename, std::size_t size,
  * @param size Size to map
  * @param prot Protection flags
  * @param preferred_address Preferred address (may be ignored)
+ * @param backing Requested page size; huge pages fall back to normal pages when unavailable
  * @return Pointer to mapped memory or nullptr on failure
  */
 OULY_API auto map_anonymous(std::size_t size, cfg::protection prot = cfg::protection::read_write,
-                            void* preferred_address = nullptr) noexcept -> void*;
+                            void* preferred_address = nullptr,
+                            cfg::page_backing backing = cfg::page_backing::normal) noexcept -> void*;
 
 /**
  * @brief Unmap memory-mapped region
@@ -112,6 +148,18 @@ OULY_API auto sync(void* ptr, std::size_t size, bool async = false) noexcept ->
 
 OULY_API auto advise(void* ptr, std::size_t size, cfg::advice advice_type) noexcept -> bool;
 
+/**
+ * @brief Round `size` up to whole pages; huge pages when the backing asks for them and `size` spans one
+ */
+constexpr auto round_up_to_pages(std::size_t size, cfg::page_backing backing, std::size_t page_size,
+                                 std::size_t huge_page_size) noexcept -> std::size_t
+{
+  std::size_t const granule =
+   (backing != cfg::page_backing::normal && huge_page_size != 0 && size >= huge_page_size) ? huge_page_size
+                                                                                            : page_size;
+  return ((size + granule - 1) / granule) * granule;
+}
+
 constexpr auto operator|(cfg::protection lhs, cfg::protection rhs) noexcept -> cfg::protection
 {
   return static_cast<cfg::protection>(static_cast<std::underlying_type_t<cfg::protection>>(lhs) |
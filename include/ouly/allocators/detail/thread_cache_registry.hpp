@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ouly::detail
+{
+
+/**
+ * @brief Ids of live allocators that keep per-thread caches.
+ *
+ * A thread that exits takes the lock and abandons its caches only in allocators that are still alive; a
+ * destructor unregisters under the same lock first.
+ */
+class thread_cache_registry
+{
+public:
+  static auto get() -> thread_cache_registry&
+  {
+    // Leaked on purpose: threads may exit after static destruction has begun
+    static auto* instance = new thread_cache_registry();
+    return *instance;
+  }
+
+  /**
+   * @brief Process-unique id for a new allocator; ids are never reused
+   */
+  auto add() -> uint64_t
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    live_.push_back(next_id_);
+    return next_id_++;
+  }
+
+  void remove(uint64_t id)
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    std::erase(live_, id);
+  }
+
+private:
+  template <typename Allocator, typename Cache>
+  friend class thread_cache_list;
+
+  [[nodiscard]] auto is_live(uint64_t id) const noexcept -> bool
+  {
+    return std::ranges::find(live_, id) != live_.end();
+  }
+
+  std::mutex            mutex_;
+  std::vector<uint64_t> live_;
+  uint64_t              next_id_ = 1;
+};
+
+/**
+ * @brief The caches one thread holds in allocators of one type, keyed by allocator id.
+ *
+ * Meant to be a thread_local. When the thread exits, every cache whose allocator is still alive is
+ * handed back through `Allocator::abandon(Cache*)`.
+ */
+template <typename Allocator, typename Cache>
+class thread_cache_list
+{
+public:
+  thread_cache_list() noexcept = default;
+  ~thread_cache_list() noexcept
+  {
+    if (entries_.empty())
+    {
+      return;
+    }
+    auto&                       reg = thread_cache_registry::get();
+    std::lock_guard<std::mutex> lock{reg.mutex_};
+    for (auto const& cached : entries_)
+    {
+      if (reg.is_live(cached.id_))
+      {
+        cached.allocator_->abandon(cached.cache_);
+      }
+    }
+  }
+
+  thread_cache_list(thread_cache_list const&)                    = delete;
+  thread_cache_list(thread_cache_list&&)                         = delete;
+  auto operator=(thread_cache_list const&) -> thread_cache_list& = delete;
+  auto operator=(thread_cache_list&&) -> thread_cache_list&      = delete;
+
+  [[nodiscard]] auto find(uint64_t id) noexcept -> Cache*
+  {
+    if (last_id_ == id)
+    {
+      return last_cache_;
+    }
+    for (auto const& cached : entries_)
+    {
+      if (cached.id_ == id)
+      {
+        last_id_    = id;
+        last_cache_ = cached.cache_;
+        return cached.cache_;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Add the cache of allocator `id`, first forgetting allocators destroyed since this thread last
+   * used them.
+   */
+  void insert(uint64_t id, Allocator* allocator, Cache* cache)
+  {
+    if (!entries_.empty())
+    {
+      auto&                       reg = thread_cache_registry::get();
+      std::lock_guard<std::mutex> lock{reg.mutex_};
+      std::erase_if(entries_,
+                    [&reg](entry const& cached) -> bool
+                    {
+                      return !reg.is_live(cached.id_);
+                    });
+    }
+    entries_.push_back({.id_ = id, .allocator_ = allocator, .cache_ = cache});
+    last_id_    = id;
+    last_cache_ = cache;
+  }
+
+private:
+  struct entry
+  {
+    uint64_t   id_        = 0;
+    Allocator* allocator_ = nullptr;
+    Cache*     cache_     = nullptr;
+  };
+
+  uint64_t           last_id_    = 0;
+  Cache*             last_cache_ = nullptr;
+  std::vector<entry> entries_;
+};
+
+} // namespace ouly::detail
@@ -0,0 +1,451 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/containers/detail/vlist.hpp"
+#include "ouly/utility/common.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace ouly::detail
+{
+
+/**
+ * @brief Two-level segregated fit (TLSF) bins over intrusive free lists
+ *
+ * Free blocks are binned by size: the first level is the power of two below the size, the second
+ * level splits each power of two into `sl_count` linear ranges. Sizes below `sl_count` get one exact
+ * bin each. A bitmap per level records the non-empty bins, so finding a bin holding a block of at
+ * least the requested size is two count-trailing-zeros operations, whatever the number of free
+ * blocks.
+ *
+ * The bins only hold list heads. Nodes are identified by non-zero uint32_t ids, and their
+ * `list_node` links are reached through a caller-provided accessor, so the same bins serve the
+ * arena_allocator block bank and tlsf_index.
+ */
+template <typename SizeType>
+class tlsf_bins
+{
+  static_assert(std::is_unsigned_v<SizeType>);
+
+public:
+  using size_type = SizeType;
+
+  static constexpr uint32_t sl_log2  = 4;
+  static constexpr uint32_t sl_count = 1U << sl_log2;
+  static constexpr uint32_t fl_count = std::numeric_limits<size_type>::digits - sl_log2 + 1;
+  static_assert(fl_count <= 64, "first level bitmap is 64 bits wide");
+
+  struct bin
+  {
+    uint32_t fl_ = 0;
+    uint32_t sl_ = 0;
+  };
+
+  /** @brief Bin a free block of `size` bytes belongs to */
+  static constexpr auto bin_of(size_type size) noexcept -> bin
+  {
+    if (size < sl_count)
+    {
+      return {.fl_ = 0, .sl_ = static_cast<uint32_t>(size)};
+    }
+    auto const top = static_cast<uint32_t>(std::bit_width(size)) - 1;
+    return {.fl_ = top - sl_log2 + 1, .sl_ = static_cast<uint32_t>(size >> (top - sl_log2)) - sl_count};
+  }
+
+  /**
+   * @brief First bin whose blocks are all at least `size` bytes
+   * @return A bin with fl_ == fl_count when no bin can guarantee the size
+   */
+  static constexpr auto bin_for_request(size_type size) noexcept -> bin
+  {
+    if (size < sl_count)
+    {
+      return bin_of(size);
+    }
+    auto const top   = static_cast<uint32_t>(std::bit_width(size)) - 1;
+    auto const round = static_cast<size_type>((size_type{1} << (top - sl_log2)) - 1);
+    if (size > std::numeric_limits<size_type>::max() - round)
+    {
+      return {.fl_ = fl_count, .sl_ = 0};
+    }
+    return bin_of(static_cast<size_type>(size + round));
+  }
+
+  /** @brief Empty every bin */
+  void reset() noexcept
+  {
+    heads_.fill(0);
+    sl_map_.fill(0);
+    fl_map_ = 0;
+  }
+
+  /**
+   * @brief Find a free node of at least `size` bytes, 0 if there is none
+   *
+   * The bitmaps give the first bin whose blocks all fit. Only when no such bin exists is the bin
+   * `size` itself falls in walked, so a request that exactly matches a free block never fails.
+   */
+  template <typename Links, typename SizeOf>
+  [[nodiscard]] auto find(Links&& links, SizeOf&& size_of, size_type size) const noexcept -> uint32_t
+  {
+    if (auto id = find(bin_for_request(size)); id != 0)
+    {
+      return id;
+    }
+    auto const b = bin_of(size);
+    for (auto id = heads_[index(b.fl_, b.sl_)]; id != 0; id = links(id).next_)
+    {
+      if (size_of(id) >= size)
+      {
+        return id;
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Head of the first non-empty bin at or above `from`, 0 if there is none
+   */
+  [[nodiscard]] auto find(bin from) const noexcept -> uint32_t
+  {
+    if (from.fl_ >= fl_count)
+    {
+      return 0;
+    }
+    auto fl     = from.fl_;
+    auto sl_map = sl_map_[fl] & (~0U << from.sl_);
+    if (sl_map == 0)
+    {
+      auto const fl_map = (fl + 1 < 64) ? fl_map_ & (~uint64_t{0} << (fl + 1)) : uint64_t{0};
+      if (fl_map == 0)
+      {
+        return 0;
+      }
+      fl     = static_cast<uint32_t>(std::countr_zero(fl_map));
+      sl_map = sl_map_[fl];
+    }
+    return heads_[index(fl, static_cast<uint32_t>(std::countr_zero(sl_map)))];
+  }
+
+  /** @brief Push node `id` holding a free block of `size` bytes */
+  template <typename Links>
+  void insert(Links&& links, uint32_t id, size_type size) noexcept
+  {
+    auto const b    = bin_of(size);
+    auto&      head = heads_[index(b.fl_, b.sl_)];
+    auto&      node = links(id);
+    node.prev_      = 0;
+    node.next_      = head;
+    if (head != 0)
+    {
+      links(head).prev_ = id;
+    }
+    head = id;
+    sl_map_[b.fl_] |= 1U << b.sl_;
+    fl_map_ |= uint64_t{1} << b.fl_;
+  }
+
+  /** @brief Unlink node `id`, which was inserted with `size` */
+  template <typename Links>
+  void remove(Links&& links, uint32_t id, size_type size) noexcept
+  {
+    auto& node = links(id);
+    if (node.next_ != 0)
+    {
+      links(node.next_).prev_ = node.prev_;
+    }
+    if (node.prev_ != 0)
+    {
+      links(node.prev_).next_ = node.next_;
+    }
+    else
+    {
+      auto const b    = bin_of(size);
+      auto&      head = heads_[index(b.fl_, b.sl_)];
+      OULY_ASSERT(head == id);
+      head = node.next_;
+      if (head == 0)
+      {
+        sl_map_[b.fl_] &= ~(1U << b.sl_);
+        if (sl_map_[b.fl_] == 0)
+        {
+          fl_map_ &= ~(uint64_t{1} << b.fl_);
+        }
+      }
+    }
+    node = {};
+  }
+
+  /** @brief Visit every node in every bin */
+  template <typename Links, typename Fn>
+  void for_each(Links&& links, Fn&& fn) const
+  {
+    for (auto head : heads_)
+    {
+      for (auto id = head; id != 0; id = links(id).next_)
+      {
+        fn(id);
+      }
+    }
+  }
+
+private:
+  static constexpr auto index(uint32_t fl, uint32_t sl) noexcept -> std::size_t
+  {
+    return (static_cast<std::size_t>(fl) * sl_count) + sl;
+  }
+
+  std::array<uint32_t, std::size_t{fl_count} * sl_count> heads_  = {};
+  std::array<uint32_t, fl_count>                          sl_map_ = {};
+  uint64_t                                                fl_map_ = 0;
+};
+
+/**
+ * @brief O(1) free-block index over a single offset range, built on tlsf_bins
+ *
+ * Every block, free or allocated, is a node chained to its physical neighbours, so releasing a
+ * block coalesces with free neighbours without any search. Allocation takes the head of the first
+ * bin that guarantees the size and splits off the tail. Node ids are stable while the block lives;
+ * ids of blocks merged away are recycled.
+ */
+template <typename SizeType>
+class tlsf_index
+{
+public:
+  using size_type = SizeType;
+  using bins_type = tlsf_bins<size_type>;
+
+  struct node
+  {
+    size_type offset_    = 0;
+    size_type size_      = 0;
+    list_node free_      = {};
+    uint32_t  prev_phys_ = 0;
+    uint32_t  next_phys_ = 0;
+    bool      is_free_   = false;
+  };
+
+  /** @brief Drop every block and start over with one free block covering [offset, offset + size) */
+  void reset(size_type offset, size_type size)
+  {
+    clear();
+    append(offset, size, true);
+  }
+
+  /** @brief Drop every block; rebuild the layout with append() */
+  void clear()
+  {
+    nodes_.assign(1, node{});
+    recycled_ = 0;
+    first_    = 0;
+    last_     = 0;
+    bins_.reset();
+  }
+
+  /** @brief Add a block after the current last one, used to rebuild a known layout in offset order */
+  auto append(size_type offset, size_type size, bool is_free) -> uint32_t
+  {
+    auto  id     = new_node();
+    auto& n      = nodes_[id];
+    n.offset_    = offset;
+    n.size_      = size;
+    n.prev_phys_ = last_;
+    n.is_free_   = is_free;
+    if (last_ != 0)
+    {
+      nodes_[last_].next_phys_ = id;
+    }
+    else
+    {
+      first_ = id;
+    }
+    last_ = id;
+    if (is_free)
+    {
+      bins_.insert(links(), id, size);
+    }
+    return id;
+  }
+
+  /**
+   * @brief Carve `size` bytes from a free block
+   * @return Node id of the allocated block, 0 when no free block guarantees the size
+   */
+  auto allocate(size_type size) -> uint32_t
+  {
+    auto const found = bins_.find(links(),
+                                  [this](uint32_t id) -> size_type
+                                  {
+                                    return nodes_[id].size_;
+                                  },
+                                  size);
+    if (found == 0)
+    {
+      return 0;
+    }
+    bins_.remove(links(), found, nodes_[found].size_);
+    nodes_[found].is_free_ = false;
+
+    auto const remaining = nodes_[found].size_ - size;
+    if (remaining != 0)
+    {
+      nodes_[found].size_ = size;
+      auto  tail          = new_node();
+      auto& f             = nodes_[found];
+      auto& t             = nodes_[tail];
+      t.offset_           = f.offset_ + size;
+      t.size_             = remaining;
+      t.is_free_          = true;
+      t.prev_phys_        = found;
+      t.next_phys_        = f.next_phys_;
+      if (f.next_phys_ != 0)
+      {
+        nodes_[f.next_phys_].prev_phys_ = tail;
+      }
+      else
+      {
+        last_ = tail;
+      }
+      f.next_phys_ = tail;
+      bins_.insert(links(), tail, remaining);
+    }
+    return found;
+  }
+
+  /** @brief Free an allocated block, merging it with free physical neighbours */
+  void release(uint32_t id)
+  {
+    OULY_ASSERT(id != 0 && !nodes_[id].is_free_);
+    auto const prev = nodes_[id].prev_phys_;
+    auto const next = nodes_[id].next_phys_;
+    if (next != 0 && nodes_[next].is_free_)
+    {
+      bins_.remove(links(), next, nodes_[next].size_);
+      nodes_[id].size_ += nodes_[next].size_;
+      unlink(next);
+    }
+    if (prev != 0 && nodes_[prev].is_free_)
+    {
+      bins_.remove(links(), prev, nodes_[prev].size_);
+      nodes_[prev].size_ += nodes_[id].size_;
+      unlink(id);
+      id = prev;
+    }
+    nodes_[id].is_free_ = true;
+    bins_.insert(links(), id, nodes_[id].size_);
+  }
+
+  [[nodiscard]] auto offset(uint32_t id) const noexcept -> size_type
+  {
+    return nodes_[id].offset_;
+  }
+
+  [[nodiscard]] auto size(uint32_t id) const noexcept -> size_type
+  {
+    return nodes_[id].size_;
+  }
+
+  /** @brief Visit every block in offset order as fn(offset, size, is_free) */
+  template <typename Fn>
+  void for_each_block(Fn&& fn) const
+  {
+    for (auto id = first_; id != 0; id = nodes_[id].next_phys_)
+    {
+      fn(nodes_[id].offset_, nodes_[id].size_, nodes_[id].is_free_);
+    }
+  }
+
+  /** @brief Check the physical chain tiles its range, free blocks are coalesced and binned */
+  void validate_integrity() const
+  {
+    [[maybe_unused]] uint32_t free_blocks = 0;
+    for (auto id = first_; id != 0; id = nodes_[id].next_phys_)
+    {
+      [[maybe_unused]] auto const& n = nodes_[id];
+      OULY_ASSERT(n.size_ > 0);
+      if (n.next_phys_ != 0)
+      {
+        OULY_ASSERT(nodes_[n.next_phys_].prev_phys_ == id);
+        OULY_ASSERT(n.offset_ + n.size_ == nodes_[n.next_phys_].offset_);
+        OULY_ASSERT(!(n.is_free_ && nodes_[n.next_phys_].is_free_));
+      }
+      free_blocks += n.is_free_ ? 1 : 0;
+    }
+    [[maybe_unused]] uint32_t binned = 0;
+    bins_.for_each(links(),
+                   [&]([[maybe_unused]] uint32_t id)
+                   {
+                     OULY_ASSERT(nodes_[id].is_free_);
+                     ++binned;
+                   });
+    OULY_ASSERT(binned == free_blocks);
+  }
+
+private:
+  auto links() noexcept
+  {
+    return [this](uint32_t id) -> list_node&
+    {
+      return nodes_[id].free_;
+    };
+  }
+
+  auto links() const noexcept
+  {
+    return [this](uint32_t id) -> list_node const&
+    {
+      return nodes_[id].free_;
+    };
+  }
+
+  auto new_node() -> uint32_t
+  {
+    if (recycled_ != 0)
+    {
+      auto id    = recycled_;
+      recycled_  = nodes_[id].next_phys_;
+      nodes_[id] = node{};
+      return id;
+    }
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+  }
+
+  // Remove `id` from the physical chain and recycle it
+  void unlink(uint32_t id)
+  {
+    auto const prev = nodes_[id].prev_phys_;
+    auto const next = nodes_[id].next_phys_;
+    if (prev != 0)
+    {
+      nodes_[prev].next_phys_ = next;
+    }
+    else
+    {
+      first_ = next;
+    }
+    if (next != 0)
+    {
+      nodes_[next].prev_phys_ = prev;
+    }
+    else
+    {
+      last_ = prev;
+    }
+    nodes_[id].next_phys_ = recycled_;
+    recycled_             = id;
+  }
+
+  // slot 0 is the null node
+  std::vector<node> nodes_ = {node{}};
+  bins_type         bins_;
+  uint32_t          recycled_ = 0;
+  uint32_t          first_    = 0;
+  uint32_t          last_     = 0;
+};
+
+} // namespace ouly::detail
@@ -41,8 +41,8 @@ namespace ouly
  * - Arenas that become empty are returned to the manager.
  * - `defragment` compacts allocations towards the front of earlier arenas, drops emptied arenas and
  *   reports moves/rebinds through the manager. Allocation ids remain stable across defragmentation.
- * - An optional byte budget makes defragmentation incremental, which is useful to bound copy
- *   bandwidth per frame.
+ * - An optional byte/move budget makes defragmentation incremental, which is useful to bound copy
+ *   bandwidth per frame. A pass cut short by its budget resumes where it stopped on the next call.
  */
 class first_fit_defrag_allocator
 {
@@ -147,7 +147,8 @@ public:
    * told about relocations through `rebind_alloc`.
    *
    * @param max_bytes_to_move Optional budget; once moving another allocation would exceed it, all
-   * remaining allocations stay in place and `completed_` is false in the result.
+   * remaining allocations stay in place and `completed_` is false in the result. The next call
+   * resumes the sweep at the allocation that did not fit.
    *
    * @note Planning needs temporary storage proportional to the number of live allocations. It is
    * taken from a call-local `defrag_scratch`; use the overload taking a `ScratchAllocator` to draw it
@@ -157,9 +158,24 @@ public:
     requires(CoalescingDefragMemoryManager<M, first_fit_defrag_allocator>)
   auto defragment(M& manager, size_type max_bytes_to_move = std::numeric_limits<size_type>::max())
    -> coalescing_defrag_result
+  {
+    return defragment(manager, coalescing_defrag_budget{.max_bytes_to_move_ = max_bytes_to_move});
+  }
+
+  /**
+   * @brief Run one budgeted step of an incremental defragmentation sweep.
+   *
+   * Allocations the sweep already went past (those before the point where the previous call ran out
+   * of budget) are left in place; the step continues from there until either budget limit is hit
+   * or the sweep reaches the end, which `completed_` reports. Spending a fixed budget every frame
+   * therefore walks the whole heap instead of repeatedly re-packing its front.
+   */
+  template <typename M>
+    requires(CoalescingDefragMemoryManager<M, first_fit_defrag_allocator>)
+  auto defragment(M& manager, coalescing_defrag_budget budget) -> coalescing_defrag_result
   {
     defrag_scratch scratch{ouly::cfg::default_gpu_scratch_size};
-    return defragment(manager, max_bytes_to_move, scratch);
+    return defragment(manager, budget, scratch);
   }
 
   /**
@@ -172,6 +188,14 @@ public:
   template <typename M, ScratchAllocator S>
     requires(CoalescingDefragMemoryManager<M, first_fit_defrag_allocator>)
   auto defragment(M& manager, size_type max_bytes_to_move, S& scratch) -> coalescing_defrag_result
+  {
+    return defragment(manager, coalescing_defrag_budget{.max_bytes_to_move_ = max_bytes_to_move}, scratch);
+  }
+
+  /** @brief Budgeted, resumable `defragment` drawing its temporary buffers from `scratch`. */
+  template <typename M, ScratchAllocator S>
+    requires(CoalescingDefragMemoryManager<M, first_fit_defrag_allocator>)
+  auto defragment(M& manager, coalescing_defrag_budget budget, S& scratch) -> coalescing_defrag_result
   {
     scratch_allocator_ref source{scratch};
 
@@ -188,7 +212,8 @@ public:
     {
       cursor.push_back(0);
     }
-    bool budget_left = true;
+    bool       budget_left = true;
+    auto const resume_pos  = find_resume_position();
 
     for (auto const& it : items)
     {
@@ -196,14 +221,18 @@ public:
       auto const src       = ouly::detail::vector_access(entry_arenas_, id);
       auto const size      = ouly::detail::vector_access(entry_sizes_, id);
       auto const offset    = ouly::detail::vector_access(entry_offsets_, id);
-      bool const movable   = budget_left && !ouly::detail::vector_access(entry_dedicated_, id);
+      bool const settled   = it.pos_ < resume_pos || (it.pos_ == resume_pos && offset < resume_offset_);
+      bool const movable   = budget_left && !settled && !ouly::detail::vector_access(entry_dedicated_, id);
       auto [dst, to]       = movable ? find_placement(it, cursor) : std::make_pair(src, offset);
       bool const relocates = dst != src || to != offset;
 
-      if (relocates && result.bytes_moved_ + size > max_bytes_to_move)
+      if (relocates && (result.bytes_moved_ + size > budget.max_bytes_to_move_ ||
+                        result.allocations_moved_ >= budget.max_allocations_moved_))
       {
         result.completed_ = false;
         budget_left       = false;
+        resume_arena_     = src;
+        resume_offset_    = offset;
         dst               = src;
         to                = offset;
       }
@@ -220,6 +249,11 @@ public:
       plan.push_back({.to_ = to, .size_ = size, .dst_ = dst});
     }
     result.moves_ = static_cast<uint32_t>(moves.size());
+    if (result.completed_)
+    {
+      resume_arena_  = 0;
+      resume_offset_ = 0;
+    }
 
     apply_plan(plan);
     auto removed           = drop_empty_arenas(source);
@@ -240,9 +274,16 @@ public:
     }
 
     manager.end_defragment(*this);
+    defrag_stats_.record(result);
     return result;
   }
 
+  /** @brief Totals accumulated over every `defragment` call. */
+  [[nodiscard]] auto defrag_statistics() const noexcept -> coalescing_defrag_statistics const&
+  {
+    return defrag_stats_;
+  }
+
   OULY_API void validate_integrity() const;
 
 private:
@@ -283,6 +324,9 @@ private:
   [[nodiscard]] OULY_API auto snapshot_allocations(scratch_allocator_ref scratch) const
    -> ouly::scratch_vector<defrag_item>;
 
+  /** Position in `arena_order_` of the arena an interrupted sweep resumes in; 0 to start over. */
+  [[nodiscard]] OULY_API auto find_resume_position() const noexcept -> uint32_t;
+
   /** Earliest arena (up to and including the source) where the allocation fits at the pack cursor. */
   [[nodiscard]] OULY_API auto find_placement(defrag_item const&                     it,
                                              ouly::scratch_vector<size_type> const& cursor) const
@@ -350,6 +394,12 @@ private:
   std::vector<uint16_t>    arena_order_;
   std::vector<uint16_t>    free_arenas_;
 
+  // where the last budget-limited defragment stopped; arena 0 means the next sweep starts over
+  uint16_t  resume_arena_  = 0;
+  size_type resume_offset_ = 0;
+
+  coalescing_defrag_statistics defrag_stats_;
+
   size_type arena_size_ = 0;
 };
 
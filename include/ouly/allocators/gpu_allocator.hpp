@@ -4,6 +4,7 @@
 
 #include "ouly/allocators/alignment.hpp"
 #include "ouly/allocators/allocation_id.hpp"
+#include "ouly/allocators/heap_snapshot.hpp"
 #include "ouly/allocators/linear_stack_allocator.hpp"
 #include "ouly/allocators/scratch_allocator.hpp"
 #include "ouly/utility/user_config.hpp"
@@ -14,6 +15,7 @@
 #include <cstdint>
 #include <limits>
 #include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -48,6 +50,15 @@ struct gpu_allocation_options
   uint32_t             resource_class_ = 0;
   bool                 movable_        = true;
   bool                 dedicated_      = false;
+  /** Allocations of different lifetimes never share an arena */
+  allocation_lifetime lifetime_ = allocation_lifetime::persistent;
+};
+
+/** @brief One buffer of a `gpu_allocator::allocate_batch` call. */
+struct gpu_allocation_request
+{
+  allocation_size_type   size_ = 0;
+  gpu_allocation_options options_;
 };
 
 /** @brief Result returned by `gpu_allocator::allocate`. */
@@ -111,6 +122,25 @@ struct gpu_defrag_result
   bool                 completed_         = true;
 };
 
+/**
+ * @brief Space held by the arenas of one `allocation_lifetime`, as reported by
+ * `gpu_allocator::lifetime_usage`.
+ */
+struct gpu_lifetime_usage
+{
+  uint64_t             bytes_reserved_     = 0;
+  uint64_t             bytes_free_         = 0;
+  uint32_t             arena_count_        = 0;
+  uint32_t             allocation_count_   = 0;
+  allocation_size_type largest_free_block_ = 0;
+
+  /** @brief Share of the free bytes outside the largest free block: 0 is one contiguous hole */
+  [[nodiscard]] auto fragmentation() const noexcept -> double
+  {
+    return bytes_free_ == 0 ? 0.0 : 1.0 - (static_cast<double>(largest_free_block_) / static_cast<double>(bytes_free_));
+  }
+};
+
 /** @brief Lifetime totals reported by `gpu_allocator::statistics`. */
 struct gpu_defrag_statistics
 {
@@ -124,6 +154,29 @@ struct gpu_defrag_statistics
   uint32_t active_evacuation_targets_ = 0;
 };
 
+/**
+ * @brief Space accounting of one memory class, kept up to date by `gpu_allocator` as it works.
+ *
+ * Bytes in arenas (`bytes_reserved_`) are either used by live allocations, free, or held by an
+ * in-flight relocation (a reserved destination or a source awaiting retirement).
+ */
+struct gpu_memory_class_budget
+{
+  uint64_t             bytes_reserved_     = 0;
+  uint64_t             bytes_used_         = 0;
+  uint64_t             bytes_free_         = 0;
+  uint64_t             soft_limit_         = std::numeric_limits<uint64_t>::max();
+  uint32_t             arena_count_        = 0;
+  uint32_t             allocation_count_   = 0;
+  allocation_size_type largest_free_block_ = 0;
+
+  /** @brief Share of the free bytes outside the largest free block: 0 is one contiguous hole */
+  [[nodiscard]] auto fragmentation() const noexcept -> double
+  {
+    return bytes_free_ == 0 ? 0.0 : 1.0 - (static_cast<double>(largest_free_block_) / static_cast<double>(bytes_free_));
+  }
+};
+
 template <typename T>
 concept GpuMemoryManagerWithClass = requires(T manager) {
   { manager.add(arena_id(), allocation_size_type(), uint32_t()) } -> std::same_as<void>;
@@ -134,11 +187,21 @@ concept GpuMemoryManagerWithoutClass = requires(T manager) {
   { manager.add(arena_id(), allocation_size_type()) } -> std::same_as<void>;
 };
 
+/**
+ * @brief Optional `GpuMemoryManager` hook, called when adding an arena leaves its memory class above
+ * the soft limit set with `gpu_allocator::set_soft_limit`. A streaming system evicts from here.
+ */
+template <typename T>
+concept GpuMemoryManagerWithBudget = requires(T manager, gpu_memory_class_budget const& budget) {
+  manager.on_budget_exceeded(uint32_t(), budget);
+};
+
 /**
  * @brief Backing-memory owner used by `gpu_allocator`.
  *
  * `add` creates an API heap/buffer for an arena. Managers that distinguish memory classes accept
  * the three-argument form; simple managers may use the two-argument form. `remove` destroys it.
+ * A manager may also model `GpuMemoryManagerWithBudget`.
  */
 template <typename T>
 concept GpuMemoryManager = (GpuMemoryManagerWithClass<T> || GpuMemoryManagerWithoutClass<T>) && requires(T manager) {
@@ -159,6 +222,18 @@ concept GpuRelocationExecutor = requires(T executor, gpu_relocation const& reloc
   { executor.is_complete(value) } -> std::convertible_to<bool>;
 };
 
+/**
+ * @brief Runs independent evacuation-planning work on worker threads.
+ *
+ * `dispatch(count, work)` must call `work(begin, end)` for disjoint ranges that together cover
+ * `[0, count)`, on any threads and in any order, and return only once every call has finished. A
+ * scheduler workgroup adapts to it with `parallel_for` over `ouly::subrange<uint32_t>{0, count}`.
+ */
+template <typename T>
+concept GpuPlanningDispatcher = requires(T dispatch, uint32_t count, void (&work)(uint32_t, uint32_t)) {
+  dispatch(count, work);
+};
+
 /**
  * @brief Scratch allocator `gpu_allocator::defragment` falls back to when the caller supplies none.
  *
@@ -185,6 +260,10 @@ using gpu_defrag_scratch = ouly::linear_stack_allocator<>;
  * evacuation source. The public `allocation_id` remains stable while its arena and offset change only
  * after `switch_references` succeeds.
  *
+ * Arenas are segregated by `allocation_lifetime` as well as memory class: transient and frame
+ * allocations never share an arena with persistent ones, and evacuation keeps them apart, so freeing
+ * a frame's worth of buffers releases whole arenas instead of punching holes between long-lived ones.
+ *
  * @note The class is not internally synchronized. Allocation, completion processing, and
  * defragmentation must be externally serialized.
  */
@@ -207,6 +286,7 @@ public:
   [[nodiscard]] OULY_API auto get_resource_class(allocation_id id) const noexcept -> uint32_t;
   [[nodiscard]] OULY_API auto is_movable(allocation_id id) const noexcept -> bool;
   [[nodiscard]] OULY_API auto is_relocating(allocation_id id) const noexcept -> bool;
+  [[nodiscard]] OULY_API auto get_lifetime(allocation_id id) const noexcept -> allocation_lifetime;
 
   OULY_API void set_movable(allocation_id id, bool movable);
 
@@ -228,8 +308,16 @@ public:
 
     auto const capacity = dedicated ? size : arena_size_;
     OULY_ASSERT(capacity != 0);
-    auto const arena = create_arena(capacity, options.memory_class_, dedicated);
+    auto const arena = create_arena(capacity, options, dedicated);
     notify_add(manager, arena, capacity, options.memory_class_);
+    if constexpr (GpuMemoryManagerWithBudget<M>)
+    {
+      auto const budget = memory_class_budget(options.memory_class_);
+      if (budget.bytes_reserved_ > budget.soft_limit_)
+      {
+        manager.on_budget_exceeded(options.memory_class_, budget);
+      }
+    }
 
     options.dedicated_ = dedicated;
     options.movable_   = options.movable_ && !dedicated;
@@ -250,6 +338,26 @@ public:
                                            .dedicated_ = static_cast<bool>(Dedicated::value)});
   }
 
+  /**
+   * @brief Allocate many buffers at once, such as the resources of a level being loaded.
+   *
+   * Within each memory class requests are placed strictest alignment and largest size first, so
+   * small buffers fill the gaps large ones leave rather than splitting the ranges they need.
+   * Arenas whose largest free range cannot hold a request are skipped without being searched.
+   * @return One allocation per request, in request order
+   */
+  template <GpuMemoryManager M>
+  auto allocate_batch(std::span<gpu_allocation_request const> requests, M& manager) -> std::vector<gpu_allocation>
+  {
+    std::vector<gpu_allocation> result(requests.size());
+    for (auto index : batch_order(requests))
+    {
+      auto const& request                        = requests[index];
+      ouly::detail::vector_access(result, index) = allocate(request.size_, manager, request.options_);
+    }
+    return result;
+  }
+
   /**
    * @brief Release an allocation.
    *
@@ -277,6 +385,22 @@ public:
     OULY_ASSERT(released && "cannot deallocate while a GPU relocation copy is pending");
   }
 
+  /**
+   * @brief Release many allocations; the freed ranges of each arena are coalesced in one sweep.
+   *
+   * Every allocation must be releasable, as with `deallocate`. Arenas left empty are removed once
+   * the whole batch has been released.
+   */
+  template <GpuMemoryManager M>
+  void deallocate_batch(std::span<allocation_id const> ids, M& manager)
+  {
+    for (auto arena : release_allocations(ids))
+    {
+      try_release_arena(manager, arena);
+    }
+    finish_target_if_possible(manager);
+  }
+
   /**
    * @brief Process completed copies/retirements and schedule more evacuation work under `budget`.
    *
@@ -301,52 +425,22 @@ public:
   template <GpuMemoryManager M, GpuRelocationExecutor E, ScratchAllocator S>
   auto defragment(M& manager, E& executor, gpu_defrag_budget budget, S& scratch) -> gpu_defrag_result
   {
-    auto result = process_completions(manager, executor);
-
-    if (!target_ && budget.max_copy_bytes_ != 0 && budget.max_move_count_ != 0)
-    {
-      begin_evacuation(budget.max_blocks_scanned_, scratch_allocator_ref{scratch});
-    }
-
-    auto remaining_bytes = budget.max_copy_bytes_;
-    auto remaining_moves = budget.max_move_count_;
-
-    while (target_ && remaining_bytes != 0 && remaining_moves != 0)
-    {
-      auto* move = find_schedulable_move(remaining_bytes);
-      if (move == nullptr)
-      {
-        break;
-      }
-
-      auto const command  = make_relocation(*move);
-      auto const timeline = executor.schedule_copy(command);
-      if (!timeline)
-      {
-        cancel_move(*move);
-        abort_evacuation();
-        break;
-      }
-
-      move->copy_completion_ = *timeline;
-      move->state_           = move_state::copy_scheduled;
-      remaining_bytes -= move->size_;
-      --remaining_moves;
-
-      result.bytes_scheduled_ += move->size_;
-      ++result.moves_scheduled_;
-      statistics_.bytes_scheduled_ += move->size_;
-      ++statistics_.moves_scheduled_;
-    }
+    serial_planning dispatch;
+    return run_defragment(manager, executor, budget, scratch, dispatch, 1);
+  }
 
-    if (target_ && has_reserved_moves())
-    {
-      result.budget_exhausted_ =
-       remaining_bytes == 0 || remaining_moves == 0 || find_schedulable_move(remaining_bytes) == nullptr;
-    }
-    finish_target_if_possible(manager, &result);
-    set_result_state(result);
-    return result;
+  /**
+   * @brief `defragment` with evacuation planning spread over worker threads.
+   *
+   * Up to `cfg::default_gpu_planning_batch` candidate arenas are simulated at once through
+   * `dispatch`, each worker drawing from its own scratch allocator. The simulations only read the
+   * allocator; the first plan in candidate order that can be reserved wins, so the evacuation
+   * chosen and every relocation reported are the same as with serial planning.
+   */
+  template <GpuMemoryManager M, GpuRelocationExecutor E, ScratchAllocator S, GpuPlanningDispatcher D>
+  auto defragment(M& manager, E& executor, gpu_defrag_budget budget, S& scratch, D&& dispatch) -> gpu_defrag_result
+  {
+    return run_defragment(manager, executor, budget, scratch, dispatch, ouly::cfg::default_gpu_planning_batch);
   }
 
   /** @brief Advance copies and source retirement without scheduling new work. */
@@ -396,9 +490,88 @@ public:
 
   [[nodiscard]] OULY_API auto statistics() const noexcept -> gpu_defrag_statistics;
 
+  /** @brief Current accounting of `memory_class`, in O(1); all zeros for a class never used */
+  [[nodiscard]] OULY_API auto memory_class_budget(uint32_t memory_class) const noexcept -> gpu_memory_class_budget;
+
+  /** @brief Reserved bytes above which adding an arena to `memory_class` notifies the manager */
+  OULY_API void set_soft_limit(uint32_t memory_class, uint64_t bytes);
+
+  /** @brief Accounting of the arenas holding `lifetime` allocations, across memory classes */
+  [[nodiscard]] OULY_API auto lifetime_usage(allocation_lifetime lifetime) const noexcept -> gpu_lifetime_usage;
+
+  /**
+   * @brief Copy out the block map of every arena; O(allocations + free ranges).
+   *
+   * Blocks carry the resource class, lifetime and movability of their allocation. Ranges held by a
+   * relocation in progress are reported as `heap_block_state::in_flight`.
+   */
+  [[nodiscard]] OULY_API auto snapshot() const -> heap_snapshot;
+
   OULY_API void validate_integrity() const;
 
 private:
+  /** @brief Runs planning work inline on the calling thread */
+  struct serial_planning
+  {
+    template <typename Work>
+    void operator()(uint32_t count, Work& work) const
+    {
+      work(0, count);
+    }
+  };
+
+  template <GpuMemoryManager M, GpuRelocationExecutor E, ScratchAllocator S, typename D>
+  auto run_defragment(M& manager, E& executor, gpu_defrag_budget budget, S& scratch, D& dispatch, uint32_t batch)
+   -> gpu_defrag_result
+  {
+    auto result = process_completions(manager, executor);
+
+    if (!target_ && budget.max_copy_bytes_ != 0 && budget.max_move_count_ != 0)
+    {
+      begin_evacuation(budget.max_blocks_scanned_, scratch_allocator_ref{scratch}, dispatch, batch);
+    }
+
+    auto remaining_bytes = budget.max_copy_bytes_;
+    auto remaining_moves = budget.max_move_count_;
+
+    while (target_ && remaining_bytes != 0 && remaining_moves != 0)
+    {
+      auto* move = find_schedulable_move(remaining_bytes);
+      if (move == nullptr)
+      {
+        break;
+      }
+
+      auto const command  = make_relocation(*move);
+      auto const timeline = executor.schedule_copy(command);
+      if (!timeline)
+      {
+        cancel_move(*move);
+        abort_evacuation();
+        break;
+      }
+
+      move->copy_completion_ = *timeline;
+      move->state_           = move_state::copy_scheduled;
+      remaining_bytes -= move->size_;
+      --remaining_moves;
+
+      result.bytes_scheduled_ += move->size_;
+      ++result.moves_scheduled_;
+      statistics_.bytes_scheduled_ += move->size_;
+      ++statistics_.moves_scheduled_;
+    }
+
+    if (target_ && has_reserved_moves())
+    {
+      result.budget_exhausted_ =
+       remaining_bytes == 0 || remaining_moves == 0 || find_schedulable_move(remaining_bytes) == nullptr;
+    }
+    finish_target_if_possible(manager, &result);
+    set_result_state(result);
+    return result;
+  }
+
   enum class arena_role : uint8_t
   {
     normal,
@@ -425,10 +598,12 @@ private:
     std::vector<free_range> free_ranges_;
     size_type               capacity_     = 0;
     size_type               free_         = 0;
+    size_type               largest_free_ = 0;
     uint32_t                allocations_  = 0;
     uint32_t                reservations_ = 0;
     uint32_t                retiring_     = 0;
     uint32_t                memory_class_ = 0;
+    allocation_lifetime     lifetime_     = allocation_lifetime::persistent;
     arena_role              role_         = arena_role::normal;
     bool                    active_       = false;
     bool                    dedicated_    = false;
@@ -472,6 +647,13 @@ private:
     uint32_t  count_    = 0;
   };
 
+  /** @brief Ids of the live allocations of every arena, in id order, built once per planning pass */
+  struct arena_index
+  {
+    ouly::scratch_vector<uint32_t> first_; ///< Start of each arena's ids in `ids_`, plus an end marker
+    ouly::scratch_vector<uint32_t> ids_;
+  };
+
   /** @brief A destination arena as the planner sees it while it places moves one by one */
   struct simulated_arena
   {
@@ -501,6 +683,61 @@ private:
     }
   }
 
+  /**
+   * @brief Pick the arena to evacuate and reserve every destination of its plan.
+   *
+   * Candidates are simulated `batch` at a time through `dispatch`; a simulation only reads the
+   * allocator, so they run concurrently. The results are then tried in candidate order, which makes
+   * the outcome independent of `batch` and of how `dispatch` spreads the work.
+   */
+  template <typename D>
+  void begin_evacuation(uint32_t max_blocks_scanned, scratch_allocator_ref scratch, D& dispatch, uint32_t batch)
+  {
+    auto const index      = index_allocations(scratch);
+    auto const candidates = rank_candidates(index, scratch);
+    auto const scan       = std::min<size_t>(candidates.size(), max_blocks_scanned);
+
+    std::vector<std::optional<evacuation_target>> plans;
+    for (size_t first = 0; first < scan; first += batch)
+    {
+      auto const count = static_cast<uint32_t>(std::min<size_t>(batch, scan - first));
+      plans.clear();
+      plans.resize(count);
+
+      auto work = [&](uint32_t begin, uint32_t end)
+      {
+        // A single simulation runs alone and may share the caller's scratch; concurrent ones may not
+        auto simulate = [&](scratch_allocator_ref local)
+        {
+          for (auto i = begin; i < end; ++i)
+          {
+            plans[i] = simulate_evacuation(candidates[first + i].arena_, index, local);
+          }
+        };
+        if (count == 1)
+        {
+          simulate(scratch);
+        }
+        else
+        {
+          gpu_defrag_scratch local{ouly::cfg::default_gpu_scratch_size};
+          simulate(local);
+        }
+      };
+      dispatch(count, work);
+
+      for (auto& plan : plans)
+      {
+        if (plan && reserve_plan(*plan))
+        {
+          ouly::detail::vector_access(arena_pool_, plan->source_arena_).role_ = arena_role::evacuation_source;
+          target_                                                            = std::move(*plan);
+          return;
+        }
+      }
+    }
+  }
+
   template <GpuMemoryManager M>
   void try_release_arena(M& manager, uint16_t arena)
   {
@@ -540,19 +777,30 @@ private:
   OULY_API auto try_allocate(size_type size, gpu_allocation_options const& options) -> gpu_allocation;
   OULY_API auto try_allocate_in_arena(uint16_t arena, size_type size, gpu_allocation_options const& options)
    -> gpu_allocation;
-  OULY_API auto create_arena(size_type capacity, uint32_t memory_class, bool dedicated) -> arena_id;
+  OULY_API auto create_arena(size_type capacity, gpu_allocation_options const& options, bool dedicated) -> arena_id;
+  OULY_API auto class_budget(uint32_t memory_class) -> gpu_memory_class_budget&;
+  OULY_API void update_largest_free(uint16_t arena, size_type previous);
+  OULY_API void refresh_largest_free(uint32_t memory_class);
   OULY_API auto push_allocation(uint16_t arena, size_type offset, size_type size, gpu_allocation_options const& options)
    -> allocation_id;
   OULY_API auto release_allocation(allocation_id id) -> uint16_t;
+  OULY_API void release_entry(allocation_id id);
+  /** @return Arenas that lost allocations, each once */
+  OULY_API auto release_allocations(std::span<allocation_id const> ids) -> std::vector<uint16_t>;
+  [[nodiscard]] OULY_API static auto batch_order(std::span<gpu_allocation_request const> requests)
+   -> std::vector<uint32_t>;
   OULY_API auto prepare_deallocate(allocation_id id) -> bool;
 
-  [[nodiscard]] OULY_API auto        measure_arena(uint16_t arena) const -> arena_usage;
+  [[nodiscard]] OULY_API auto index_allocations(scratch_allocator_ref scratch) const -> arena_index;
+  [[nodiscard]] OULY_API auto rank_candidates(arena_index const& index, scratch_allocator_ref scratch) const
+   -> ouly::scratch_vector<evacuation_candidate>;
+  [[nodiscard]] OULY_API auto        measure_arena(uint16_t arena, arena_index const& index) const -> arena_usage;
   [[nodiscard]] OULY_API auto        can_evacuate(uint16_t arena) const -> bool;
   [[nodiscard]] OULY_API static auto recovers_more(evacuation_candidate const& lhs, evacuation_candidate const& rhs)
    -> bool;
   OULY_API auto               reserve_plan(evacuation_target& plan) -> bool;
-  OULY_API void               begin_evacuation(uint32_t max_blocks_scanned, scratch_allocator_ref scratch);
-  [[nodiscard]] OULY_API auto simulate_evacuation(uint16_t source, scratch_allocator_ref scratch) const
+  [[nodiscard]] OULY_API auto simulate_evacuation(uint16_t source, arena_index const& index,
+                                                  scratch_allocator_ref scratch) const
    -> std::optional<evacuation_target>;
   [[nodiscard]] OULY_API auto collect_destinations(uint16_t source, size_t move_count,
                                                    scratch_allocator_ref scratch) const
@@ -591,6 +839,9 @@ private:
   std::vector<bool>      entry_movable_          = {false};
   uint32_t               free_entry_             = 0;
 
+  // indexed by memory class
+  std::vector<gpu_memory_class_budget> budgets_;
+
   std::optional<evacuation_target> target_;
   gpu_defrag_statistics            statistics_;
   size_type                        arena_size_   = 0;
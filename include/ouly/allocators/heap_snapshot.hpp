@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/allocation_id.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file heap_snapshot.hpp
+ * @brief Point-in-time block maps of the arena allocators, for offline fragmentation analysis
+ *
+ * `gpu_allocator::snapshot()` and `coalescing_arena_allocator::snapshot()` copy out every arena as
+ * a list of blocks that tile it. The snapshot types are plain aggregates, so the reflection-based
+ * serializers write and read them without further glue:
+ * @code
+ * ouly::binary_output_stream out;
+ * ouly::write(out, allocator.snapshot());
+ * // save out.get_string(), later:
+ * ouly::heap_snapshot snapshot;
+ * ouly::binary_input_stream in(bytes);
+ * ouly::read(in, snapshot);
+ * @endcode
+ * The heap_snapshot_view tool renders a saved snapshot as an ASCII or HTML occupancy map.
+ */
+
+namespace ouly
+{
+
+/** @brief Bumped whenever the snapshot layout changes */
+constexpr uint32_t heap_snapshot_version = 1;
+
+enum class heap_block_state : uint8_t
+{
+  free,
+  used,
+  /** Neither free nor owned by a live allocation: a relocation destination or a source awaiting retirement */
+  in_flight
+};
+
+struct heap_snapshot_block
+{
+  allocation_size_type offset_         = 0;
+  allocation_size_type size_           = 0;
+  uint32_t             resource_class_ = 0;
+  heap_block_state     state_          = heap_block_state::free;
+  allocation_lifetime  lifetime_       = allocation_lifetime::persistent;
+  bool                 movable_        = false;
+};
+
+struct heap_snapshot_arena
+{
+  allocation_size_type             capacity_     = 0;
+  uint32_t                         memory_class_ = 0;
+  uint16_t                         arena_        = 0;
+  bool                             dedicated_    = false;
+  std::vector<heap_snapshot_block> blocks_; ///< Sorted by offset, tiling [0, capacity_)
+};
+
+struct heap_snapshot
+{
+  uint32_t                         version_ = heap_snapshot_version;
+  std::vector<heap_snapshot_arena> arenas_;
+};
+
+/** @brief Totals of one arena of a snapshot */
+struct heap_arena_summary
+{
+  allocation_size_type capacity_           = 0;
+  allocation_size_type bytes_used_         = 0;
+  allocation_size_type bytes_free_         = 0;
+  allocation_size_type bytes_in_flight_    = 0;
+  allocation_size_type largest_free_block_ = 0;
+  uint32_t             used_blocks_        = 0;
+  uint32_t             free_blocks_        = 0;
+
+  /** @brief Share of the free bytes outside the largest free block: 0 is one contiguous hole */
+  [[nodiscard]] auto fragmentation() const noexcept -> double
+  {
+    return bytes_free_ == 0 ? 0.0 : 1.0 - (static_cast<double>(largest_free_block_) / static_cast<double>(bytes_free_));
+  }
+
+  /** @brief Fold another arena in; the largest free block is the largest of either */
+  OULY_API void merge(heap_arena_summary const& other) noexcept;
+};
+
+[[nodiscard]] OULY_API auto summarize(heap_snapshot_arena const& arena) noexcept -> heap_arena_summary;
+
+/** @brief Totals over every arena of the snapshot */
+[[nodiscard]] OULY_API auto summarize(heap_snapshot const& snapshot) noexcept -> heap_arena_summary;
+
+} // namespace ouly
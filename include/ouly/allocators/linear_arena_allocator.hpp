@@ -2,9 +2,19 @@
 #pragma once
 
 #include "ouly/allocators/linear_allocator.hpp"
+#include "ouly/allocators/virtual_allocator.hpp"
+#include <type_traits>
 
 namespace ouly
 {
+namespace detail
+{
+/** @brief Arenas come from page_allocator when only a page backing is configured */
+template <typename Config>
+using arena_underlying_allocator_t =
+ std::conditional_t<HasPageBacking<Config> && !HasUnderlyingAllocator<Config>, page_allocator<Config>,
+                    underlying_allocator_t<Config>>;
+} // namespace detail
 
 /**
  * @brief A linear arena allocator that manages memory in contiguous blocks (arenas)
@@ -23,6 +33,8 @@ namespace ouly
  * - Ability to rewind memory state
  * - Optional statistics tracking
  * - Configurable arena size (default 4MB)
+ * - Arenas on huge pages via cfg::backing_pages, which selects page_allocator as the underlying
+ *   allocator unless one is given explicitly
  * - Move constructible but not copy constructible
  *
  * Memory management:
@@ -46,7 +58,7 @@ public:
 
   using tag                  = linear_arena_allocator_tag;
   using statistics           = ouly::detail::statistics<linear_arena_allocator_tag, Config>;
-  using underlying_allocator = ouly::detail::underlying_allocator_t<Config>;
+  using underlying_allocator = ouly::detail::arena_underlying_allocator_t<Config>;
   using size_type            = underlying_allocator::size_type;
   using address              = underlying_allocator::address;
 
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/config.hpp"
+#include "ouly/allocators/detail/arena.hpp"
+#include "ouly/allocators/detail/tlsf.hpp"
+#include "ouly/utility/optional_val.hpp"
+
+namespace ouly::strat
+{
+
+/**
+ * @brief Strategy class for arena_allocator using two-level segregated fit (TLSF)
+ *
+ * Free blocks are binned by size class and linked through the block's own list node, so no side
+ * storage is needed. Finding a fitting block is a pair of bitmap lookups, and returning a block is a
+ * list push, making allocation and deallocation O(1) however many free blocks the arenas hold. The
+ * block picked is the first in the smallest bin guaranteed to fit, which is close to, but not always,
+ * the best fit.
+ */
+template <typename Config = ouly::config<>>
+class tlsf
+{
+  static constexpr uint32_t k_null_0 = 0;
+  using optional_addr                = ouly::optional_val<k_null_0>;
+
+public:
+  using extension       = uint64_t;
+  using size_type       = ouly::detail::choose_size_t<uint32_t, Config>;
+  using arena_bank      = ouly::detail::arena_bank<size_type, extension>;
+  using block_bank      = ouly::detail::block_bank<size_type, extension>;
+  using block           = ouly::detail::block<size_type, extension>;
+  using bank_data       = ouly::detail::bank_data<size_type, extension>;
+  using block_link      = typename block_bank::link;
+  using allocate_result = optional_addr;
+  using bins_type       = ouly::detail::tlsf_bins<size_type>;
+
+  static constexpr size_type min_granularity = 4;
+
+  tlsf() noexcept       = default;
+  tlsf(tlsf const&)     = default;
+  tlsf(tlsf&&) noexcept = default;
+  ~tlsf() noexcept      = default;
+
+  auto operator=(tlsf const&) -> tlsf&     = default;
+  auto operator=(tlsf&&) noexcept -> tlsf& = default;
+
+  [[nodiscard]] auto try_allocate(bank_data& bank, size_type size) -> optional_addr
+  {
+    auto found = bins_.find(links(bank.blocks_),
+                            [&bank](uint32_t id) -> size_type
+                            {
+                              return bank.blocks_[block_link(id)].size_;
+                            },
+                            size);
+    if (found == 0)
+    {
+      return {};
+    }
+    return {found};
+  }
+
+  auto commit(bank_data& bank, size_type size, optional_addr found) -> std::uint32_t
+  {
+    erase(bank.blocks_, found.value_);
+
+    auto& blk = bank.blocks_[block_link(found.value_)];
+    // Marker
+    blk.is_free_ = false;
+
+    auto remaining = blk.size_ - size;
+    blk.size_      = size;
+    if (remaining > 0)
+    {
+      auto& list  = bank.arenas_[blk.arena_].block_order();
+      auto  arena = blk.arena_;
+
+      auto newblk = bank.blocks_.emplace(blk.offset_ + size, remaining, arena, ouly::detail::list_node{}, true);
+      list.insert_after(bank.blocks_, found.value_, (uint32_t)newblk);
+      add_free(bank.blocks_, (uint32_t)newblk);
+    }
+    return found.value_;
+  }
+
+  void add_free_arena(block_bank& blocks, std::uint32_t block)
+  {
+    add_free(blocks, block);
+  }
+
+  void add_free(block_bank& blocks, std::uint32_t block)
+  {
+    bins_.insert(links(blocks), block, blocks[block_link(block)].size_);
+  }
+
+  void grow_free_node(block_bank& blocks, std::uint32_t block, size_type newsize)
+  {
+    erase(blocks, block);
+    blocks[block_link(block)].size_ = newsize;
+    add_free(blocks, block);
+  }
+
+  void replace_and_grow(block_bank& blocks, std::uint32_t block, std::uint32_t new_block, size_type new_size)
+  {
+    erase(blocks, block);
+    blocks[block_link(new_block)].size_ = new_size;
+    add_free(blocks, new_block);
+  }
+
+  void erase(block_bank& blocks, std::uint32_t node)
+  {
+    bins_.remove(links(blocks), node, blocks[block_link(node)].size_);
+  }
+
+  auto total_free_nodes(block_bank const& blocks) const -> std::uint32_t
+  {
+    uint32_t count = 0;
+    bins_.for_each(links(blocks),
+                   [&](uint32_t)
+                   {
+                     count++;
+                   });
+    return count;
+  }
+
+  auto total_free_size(block_bank const& blocks) const -> size_type
+  {
+    size_type sz = 0;
+    bins_.for_each(links(blocks),
+                   [&](uint32_t id)
+                   {
+                     sz += blocks[block_link(id)].size_;
+                   });
+    return sz;
+  }
+
+  void validate_integrity(block_bank const& blocks) const
+  {
+    bins_.for_each(links(blocks),
+                   [&]([[maybe_unused]] uint32_t id)
+                   {
+                     [[maybe_unused]] auto const& blk = blocks[block_link(id)];
+                     OULY_ASSERT(blk.is_free_);
+                     OULY_ASSERT(blk.size_ > 0);
+                     OULY_ASSERT(blk.list_.next_ == 0 || blocks[block_link(blk.list_.next_)].list_.prev_ == id);
+                   });
+  }
+
+  template <typename Owner>
+  void init([[maybe_unused]] Owner const& owner)
+  {
+    bins_.reset();
+  }
+
+private:
+  static auto links(block_bank& blocks) noexcept
+  {
+    return [&blocks](uint32_t id) -> ouly::detail::list_node&
+    {
+      return blocks[block_link(id)].list_;
+    };
+  }
+
+  static auto links(block_bank const& blocks) noexcept
+  {
+    return [&blocks](uint32_t id) -> ouly::detail::list_node const&
+    {
+      return blocks[block_link(id)].list_;
+    };
+  }
+
+  bins_type bins_;
+};
+
+} // namespace ouly::strat
@@ -22,4 +22,7 @@ struct mmap_allocator_tag
 
 struct virtual_memory_allocator_tag
 {};
+
+struct virtual_arena_allocator_tag
+{};
 } // namespace ouly
\ No newline at end of file
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/ts_pool_allocator.hpp"
+
+namespace ouly
+{
+
+/**
+ * @brief Thread-safe counterpart of object_pool
+ *
+ * Hands out uninitialized storage for one T at a time from a ts_pool_allocator, so objects may be
+ * allocated and freed from any thread, and freed on a thread other than the one that allocated
+ * them. As with object_pool, construction and destruction are up to the caller.
+ */
+template <typename T>
+class ts_object_pool
+{
+public:
+  explicit ts_object_pool(uint32_t magazine_size = ts_pool_allocator::default_magazine_size)
+      : pool_(sizeof(T), alignof(T), magazine_size)
+  {}
+
+  /// Allocate storage for a single object
+  [[nodiscard]] auto allocate() -> T*
+  {
+    return static_cast<T*>(pool_.allocate());
+  }
+
+  /// Return storage for a single object, from any thread
+  void deallocate(T* ptr)
+  {
+    pool_.deallocate(ptr);
+  }
+
+  /// Number of pages allocated from the system
+  [[nodiscard]] auto get_page_count() const noexcept -> std::size_t
+  {
+    return pool_.get_page_count();
+  }
+
+private:
+  ts_pool_allocator pool_;
+};
+
+} // namespace ouly
@@ -0,0 +1,141 @@
+/**
+ * @file ts_pool_allocator.hpp
+ * @brief Thread-safe fixed-size slot pool with per-thread magazines
+ */
+#pragma once
+
+#include "ouly/allocators/detail/thread_cache_registry.hpp"
+#include "ouly/utility/common.hpp"
+#include "ouly/utility/tagged_ptr.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ouly
+{
+/**
+ * @class ts_pool_allocator
+ * @brief A pool of equal-sized slots shared by many threads
+ *
+ * pool_allocator and object_pool are single-threaded. This variant serves one slot size to any
+ * number of threads without a lock on the common path, for node pools that every scheduler worker
+ * allocates from and frees into.
+ *
+ * Design:
+ * - Free slots move in magazines: fixed-capacity arrays of slot pointers.
+ * - Each thread keeps a loaded and a previous magazine per pool. allocate() pops from the loaded
+ *   magazine and deallocate() pushes onto it; when it runs empty or full the two are swapped, so a
+ *   thread alternating around a boundary does not touch shared state.
+ * - Only when both magazines are exhausted (or both full) does the thread exchange a whole
+ *   magazine with the depot: two lock-free stacks of full and empty magazines. Their heads are
+ *   tagged_ptr values whose tag changes on every push and pop, which protects the CAS from ABA.
+ *   Magazines are never freed before the pool, so a stale head can always be read safely.
+ * - When the depot has no full magazine, slots are carved from the current page under a mutex,
+ *   a magazine at a time.
+ * - A thread that exits hands its magazines back to the depot.
+ *
+ * Thread Safety:
+ * - allocate() and deallocate() may be called from any thread, and a slot may be freed on a thread
+ *   other than the one that allocated it
+ * - Destruction must not overlap any other call; every slot becomes invalid
+ */
+class ts_pool_allocator
+{
+public:
+  /** @brief Default number of slots a magazine holds */
+  static constexpr uint32_t default_magazine_size = 64;
+
+  /** @brief Pages are carved into this many magazines worth of slots */
+  static constexpr uint32_t magazines_per_page = 16;
+
+  /**
+   * @param slot_size Size of every slot; raised to hold at least a pointer
+   * @param slot_alignment Alignment of every slot, a power of two
+   * @param magazine_size Slots moved between a thread and the depot at a time
+   */
+  OULY_API explicit ts_pool_allocator(std::size_t slot_size, std::size_t slot_alignment = alignof(std::max_align_t),
+                                      uint32_t magazine_size = default_magazine_size);
+
+  ts_pool_allocator(ts_pool_allocator const&)                    = delete;
+  ts_pool_allocator(ts_pool_allocator&&)                         = delete;
+  auto operator=(ts_pool_allocator const&) -> ts_pool_allocator& = delete;
+  auto operator=(ts_pool_allocator&&) -> ts_pool_allocator&      = delete;
+
+  /**
+   * @brief Releases every page; all outstanding slots become invalid
+   */
+  OULY_API ~ts_pool_allocator() noexcept;
+
+  /**
+   * @brief Take one slot
+   * @throws std::bad_alloc when the system is out of memory
+   */
+  OULY_API auto allocate() -> void*;
+
+  /**
+   * @brief Return a slot from any thread
+   * @param ptr Slot returned by allocate(); nullptr is ignored
+   */
+  OULY_API void deallocate(void* ptr);
+
+  /** @brief Size of one slot, after rounding to the alignment */
+  [[nodiscard]] auto get_slot_size() const noexcept -> std::size_t
+  {
+    return stride_;
+  }
+
+  /** @brief Number of pages allocated from the system */
+  [[nodiscard]] auto get_page_count() const noexcept -> std::size_t
+  {
+    return page_count_.load(std::memory_order_relaxed);
+  }
+
+  struct magazine;
+  struct thread_cache;
+
+private:
+  friend class detail::thread_cache_list<ts_pool_allocator, thread_cache>;
+
+  using magazine_stack = std::atomic<ouly::tagged_ptr<magazine>>;
+
+  auto        local_cache() -> thread_cache*;
+  auto        create_cache() -> thread_cache*;
+  auto        refill(thread_cache& cache) -> void*;
+  void        spill(thread_cache& cache, void* ptr);
+  auto        carve() -> magazine*;
+  auto        new_magazine() -> magazine*;
+  void        abandon(thread_cache* cache) noexcept;
+  static void push(magazine_stack& stack, magazine* mag) noexcept;
+  static auto pop(magazine_stack& stack) noexcept -> magazine*;
+  static auto lookup_cache(uint64_t id) noexcept -> thread_cache*;
+
+  /** @brief Process-unique id; thread-local cache entries are keyed by it, never by address */
+  uint64_t id_ = 0;
+
+  std::size_t stride_         = 0;
+  std::size_t alignment_      = 0;
+  uint32_t    magazine_size_  = default_magazine_size;
+  std::size_t slots_per_page_ = 0;
+
+  /** @brief Depot: magazines holding at least one slot, and empty ones */
+  magazine_stack full_{};
+  magazine_stack empty_{};
+
+  /** @brief Pages allocated from the system */
+  std::atomic<std::size_t> page_count_{0};
+
+  /** @brief Guards carving, the page and magazine lists and the cache list */
+  std::mutex mutex_;
+
+  std::byte* cursor_ = nullptr;
+  std::byte* end_    = nullptr;
+
+  std::vector<void*>         pages_;
+  std::vector<magazine*>     magazines_;
+  std::vector<thread_cache*> caches_;
+  std::vector<thread_cache*> idle_caches_;
+};
+
+} // namespace ouly
@@ -0,0 +1,201 @@
+/**
+ * @file ts_size_class_allocator.hpp
+ * @brief Thread-safe general-purpose allocator with per-thread size-class caches
+ */
+#pragma once
+
+#include "ouly/allocators/detail/thread_cache_registry.hpp"
+#include "ouly/utility/common.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ouly
+{
+/**
+ * @class ts_size_class_allocator
+ * @brief A thread-safe allocator for mixed-size allocations that may be freed on any thread
+ *
+ * Requests up to max_small_size are rounded up to one of num_size_classes size classes. Each
+ * thread allocates from its own slabs without synchronization, and larger requests go to the
+ * global operator new. Unlike ts_thread_local_allocator, memory is reused block by block, so
+ * this allocator can replace malloc for long-lived, cross-thread workloads such as
+ * producer/consumer pipelines.
+ *
+ * Design:
+ * - A slab is a slab_size-aligned block of slab_size bytes. A header is followed by equal blocks
+ *   of one size class, so deallocate() finds a block's slab by masking the pointer.
+ * - Each thread gets a cache per allocator instance, created on the thread's first allocation.
+ *   It keeps the slabs it owns per size class. A free from the owning thread pushes the block on
+ *   the slab's local free list.
+ * - A free from any other thread pushes the block onto the slab's lock-free remote list. The
+ *   owner drains that list when its own free list runs dry, so cross-thread frees never take a
+ *   lock and never touch the owner's local state.
+ * - When a slab becomes empty, its owner keeps at most cached_empty_slabs of them for reuse
+ *   and hands the rest to a global pool that every thread refills from. The pool holds at most
+ *   the configured number of retained slabs, and anything beyond that goes back to the system.
+ * - When a thread exits, its empty slabs go to the pool. Slabs still in use are orphaned, and the
+ *   next thread that runs short on that size class adopts them together with their pending
+ *   remote frees.
+ *
+ * Thread Safety:
+ * - allocate() and deallocate() may be called from any thread, and a block may be freed on a
+ *   thread other than the one that allocated it
+ * - trim() may be called from any thread
+ * - Destruction must not overlap any other call; all blocks become invalid
+ *
+ * All allocations are aligned to alignof(std::max_align_t).
+ */
+class ts_size_class_allocator
+{
+public:
+  /** @brief Size of one slab, also its alignment (64 KiB) */
+  static constexpr std::size_t slab_size = 64 * 1024;
+
+  /** @brief Largest request served from slabs; larger ones use operator new */
+  static constexpr std::size_t max_small_size = 8 * 1024;
+
+  /** @brief Number of size classes: 16-byte steps up to 128, then four classes per doubling */
+  static constexpr uint32_t num_size_classes = 32;
+
+  /** @brief All allocations are aligned to this boundary */
+  static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+  /** @brief Empty slabs a thread keeps before returning them to the global pool */
+  static constexpr uint32_t cached_empty_slabs = 1;
+
+  /** @brief Default number of empty slabs the global pool keeps before freeing them */
+  static constexpr uint32_t default_retained_slabs = 64;
+
+  OULY_API ts_size_class_allocator();
+
+  /**
+   * @param retained_slabs Empty slabs the global pool keeps for reuse; further ones are freed
+   */
+  OULY_API explicit ts_size_class_allocator(uint32_t retained_slabs);
+
+  ts_size_class_allocator(ts_size_class_allocator const&)                    = delete;
+  ts_size_class_allocator(ts_size_class_allocator&&)                         = delete;
+  auto operator=(ts_size_class_allocator const&) -> ts_size_class_allocator& = delete;
+  auto operator=(ts_size_class_allocator&&) -> ts_size_class_allocator&      = delete;
+
+  /**
+   * @brief Releases every slab; all outstanding blocks become invalid
+   */
+  OULY_API ~ts_size_class_allocator() noexcept;
+
+  /**
+   * @brief Allocate `size` bytes
+   * @return Pointer aligned to alignof(std::max_align_t); a zero size returns a valid minimum block
+   * @throws std::bad_alloc when the system is out of memory
+   */
+  OULY_API auto allocate(std::size_t size) -> void*;
+
+  /**
+   * @brief Free a block from any thread
+   * @param ptr Block returned by allocate(); nullptr is ignored
+   * @param size The size passed to allocate()
+   */
+  OULY_API void deallocate(void* ptr, std::size_t size) noexcept;
+
+  /**
+   * @brief Return every slab held by the global pool to the system
+   * @return Number of slabs freed
+   */
+  OULY_API auto trim() noexcept -> std::size_t;
+
+  /**
+   * @brief Number of slabs currently allocated from the system
+   */
+  [[nodiscard]] auto get_slab_count() const noexcept -> std::size_t
+  {
+    return slab_count_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Size class serving a request of `size` bytes; num_size_classes for large requests
+   */
+  [[nodiscard]] static constexpr auto size_class_of(std::size_t size) noexcept -> uint32_t
+  {
+    if (size <= small_step_limit)
+    {
+      return size == 0 ? 0 : static_cast<uint32_t>((size - 1) / small_step);
+    }
+    if (size > max_small_size)
+    {
+      return num_size_classes;
+    }
+    auto const last  = size - 1;
+    auto const log2  = static_cast<uint32_t>(std::bit_width(last) - 1);
+    auto const group = log2 - small_step_limit_log2;
+    auto const index = static_cast<uint32_t>((last - (std::size_t{1} << log2)) >> (log2 - 2));
+    return small_step_classes + (group * classes_per_doubling) + index;
+  }
+
+  /**
+   * @brief Block size of size class `size_class`
+   */
+  [[nodiscard]] static constexpr auto size_of_class(uint32_t size_class) noexcept -> std::size_t
+  {
+    if (size_class < small_step_classes)
+    {
+      return (size_class + 1) * small_step;
+    }
+    auto const group = (size_class - small_step_classes) / classes_per_doubling;
+    auto const index = (size_class - small_step_classes) % classes_per_doubling;
+    auto const base  = small_step_limit << group;
+    return base + ((index + 1) * (base / classes_per_doubling));
+  }
+
+  struct slab_t;
+  struct thread_cache;
+
+private:
+  friend class detail::thread_cache_list<ts_size_class_allocator, thread_cache>;
+
+  static constexpr std::size_t small_step            = 16;
+  static constexpr std::size_t small_step_limit      = 128;
+  static constexpr uint32_t    small_step_limit_log2 = 7;
+  static constexpr uint32_t    small_step_classes    = 8;
+  static constexpr uint32_t    classes_per_doubling  = 4;
+
+  auto local_cache() -> thread_cache*;
+  auto create_cache() -> thread_cache*;
+  auto refill(thread_cache& cache, uint32_t size_class) -> void*;
+  auto acquire_slab(thread_cache& cache, uint32_t size_class) -> slab_t*;
+  void release_empty(thread_cache& cache, slab_t* slab) noexcept;
+  void collect(thread_cache& cache) noexcept;
+  void pool_slab(slab_t* slab) noexcept;
+  void free_slab(slab_t* slab) noexcept;
+  void abandon(thread_cache* cache) noexcept;
+  static auto lookup_cache(uint64_t id) noexcept -> thread_cache*;
+
+  /** @brief Process-unique id; thread-local cache entries are keyed by it, never by address */
+  uint64_t id_ = 0;
+
+  /** @brief Empty slabs kept by the global pool before freeing to the system */
+  uint32_t retained_slabs_ = default_retained_slabs;
+
+  /** @brief Slabs allocated from the system and not yet freed */
+  std::atomic<std::size_t> slab_count_{0};
+
+  /** @brief Guards the pool, orphan lists and cache list */
+  std::mutex mutex_;
+
+  /** @brief Global pool of empty slabs */
+  slab_t*     empty_slabs_ = nullptr;
+  std::size_t empty_count_ = 0;
+
+  /** @brief Slabs in use whose owning thread has exited, per size class */
+  std::array<slab_t*, num_size_classes> orphans_ = {};
+
+  /** @brief Every cache created by this allocator; caches of exited threads are reused */
+  std::vector<thread_cache*> caches_;
+  std::vector<thread_cache*> idle_caches_;
+};
+
+} // namespace ouly
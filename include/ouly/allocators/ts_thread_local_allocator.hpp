@@ -4,11 +4,15 @@
  */
 #pragma once
 
+#include "ouly/allocators/config.hpp"
 #include "ouly/utility/common.hpp"
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <shared_mutex>
 #include <utility>
+#include <vector>
 
 namespace ouly
 {
@@ -25,16 +29,26 @@ namespace ouly
  * - Per-thread arenas eliminate contention
  * - Generation-based invalidation for safe reset
  * - Optional stack-style deallocation for the most recent allocation
+ * - Blocks freed by another thread are queued back to the owning thread and reused before reset()
  * - All allocations are aligned to alignof(std::max_align_t)
  *
  * Thread Safety:
  * - allocate() and deallocate() are thread-safe
+ * - A block may be deallocated from any thread; only its owner reuses it
  * - reset() must be called from a single thread with no concurrent allocations
  * - release() must be called from a single thread with no concurrent allocations
  *
  * Memory Layout:
  * Each arena consists of a header (arena_t) followed by aligned data storage.
- * All memory is allocated with std::max_align_t alignment.
+ * All memory is allocated with std::max_align_t alignment. Arenas come from operator new, or are
+ * mapped directly with huge page backing when a cfg::page_backing other than normal is requested.
+ *
+ * Remote Frees:
+ * The first arena a thread installs in a generation is its home arena. Every arena the thread uses
+ * afterwards is tagged with that home, and the home carries a lock-free inbox. A block deallocated on
+ * another thread is pushed onto the owner's inbox; the owner drains the whole inbox in one exchange
+ * when its current arena runs out and serves allocations from the drained blocks before taking a new
+ * arena. The bump-pointer fast path is unchanged and never touches the inbox.
  *
  * @warning reset() must be called when no worker threads are calling allocate()
  * @warning All allocated memory becomes invalid after reset() or release()
@@ -61,16 +75,27 @@ public:
    */
   explicit ts_thread_local_allocator(std::size_t page_size) noexcept : default_page_size_{page_size} {}
 
+  /**
+   * @brief Constructor with custom page size and page backing
+   * @param page_size Size in bytes for new arenas (must be > 0); use a multiple of the huge page size
+   * @param backing Arenas are mapped with this backing; huge pages fall back to normal pages
+   * @note Mapped arenas are rounded up to whole (huge) pages and the slack becomes usable payload
+   */
+  ts_thread_local_allocator(std::size_t page_size, cfg::page_backing backing) noexcept
+      : default_page_size_{page_size}, backing_{backing}
+  {}
+
   /**
    * @brief Move constructor
    * @param other Source allocator (will be reset)
    */
   ts_thread_local_allocator(ts_thread_local_allocator&& other) noexcept
       : default_page_size_{std::exchange(other.default_page_size_, default_page_size)},
+        backing_{std::exchange(other.backing_, cfg::page_backing::normal)},
         page_list_head_{std::exchange(other.page_list_head_, nullptr)},
         page_list_tail_{std::exchange(other.page_list_tail_, nullptr)},
         available_pages_(std::exchange(other.available_pages_, nullptr)),
-        pages_to_free_{std::exchange(other.pages_to_free_, nullptr)}
+        pages_to_free_{std::exchange(other.pages_to_free_, nullptr)}, arenas_{std::exchange(other.arenas_, {})}
   {}
 
   /**
@@ -86,10 +111,12 @@ public:
     }
     reset(); // free any existing arenas
     default_page_size_ = std::exchange(other.default_page_size_, default_page_size);
+    backing_           = std::exchange(other.backing_, cfg::page_backing::normal);
     page_list_head_    = std::exchange(other.page_list_head_, nullptr);
     page_list_tail_    = std::exchange(other.page_list_tail_, nullptr);
     pages_to_free_     = std::exchange(other.pages_to_free_, nullptr);
     available_pages_   = std::exchange(other.available_pages_, nullptr);
+    arenas_            = std::exchange(other.arenas_, {});
     return *this;
   }
 
@@ -118,12 +145,13 @@ public:
   OULY_API auto allocate(std::size_t size) -> void*;
 
   /**
-   * @brief Optional stack-style deallocation for the most recent allocation
+   * @brief Stack-style deallocation on the owning thread, queued reuse from any other thread
    * @param ptr Pointer to memory to deallocate
    * @param size Size of the allocation in bytes
-   * @return true if deallocation succeeded, false otherwise
-   * @note Only works if ptr was the most recent allocation on this thread's arena
-   * @note Safe even with concurrent access from other threads
+   * @return true if the block was released or queued back to its owner, false otherwise
+   * @note On the owning thread, only the most recent allocation on its current arena is released
+   * @note From any other thread, the block is pushed onto the owner's inbox without locking the
+   *       owner; it becomes reusable once the owner's current arena is exhausted
    * @note Thread-safe - each thread owns its arena
    */
   OULY_API auto deallocate(void* ptr, std::size_t size) const -> bool;
@@ -160,6 +188,20 @@ public:
   struct tls_t;
 
 private:
+  struct arena_t;
+
+  /** @brief A released block, linked through its own storage */
+  struct free_block
+  {
+    free_block* next_ = nullptr;
+    std::size_t size_ = 0;
+  };
+
+  static_assert(sizeof(free_block) <= alignment, "every allocation must be able to hold a free_block");
+
+  /** @brief Number of power-of-two size classes the owner sorts drained blocks into */
+  static constexpr std::size_t reuse_bins = 20;
+
   /**
    * @brief Internal arena structure for memory management
    *
@@ -168,19 +210,29 @@ private:
    */
   struct arena_t
   {
-    std::size_t used_ = 0;       ///< Current bump offset (owned by one thread)
-    std::size_t size_ = 0;       ///< Total bytes available in data_[]
-    arena_t*    next_ = nullptr; ///< Intrusive list pointer (for free list)
+    std::size_t used_        = 0;       ///< Current bump offset (owned by one thread)
+    std::size_t size_        = 0;       ///< Total bytes available in data_[]
+    arena_t*    next_        = nullptr; ///< Intrusive list pointer (for free list)
+    std::size_t mapped_size_ = 0;       ///< Mapping length for page-backed arenas, 0 for operator new
+    arena_t*    home_        = nullptr; ///< Home arena of the owning thread, nullptr if unowned
+
+    std::atomic<free_block*>            remote_free_ = nullptr; ///< Inbox of remote frees (home arenas)
+    std::array<free_block*, reuse_bins> reuse_       = {};      ///< Drained blocks by size class (home arenas)
 
     alignas(std::max_align_t) std::byte data_[1] = {}; ///< Flexible array member for allocations
   };
 
   /**
    * @brief Create a new arena with specified payload size
-   * @param payload_size Size of the data portion in bytes
+   * @param payload_size Minimum size of the data portion in bytes
    * @return Pointer to newly created arena
    */
-  static auto create_page(std::size_t payload_size) -> arena_t*;
+  auto create_page(std::size_t payload_size) const -> arena_t*;
+
+  /**
+   * @brief Return an arena to operator delete or unmap it, as it was created
+   */
+  static void free_page(arena_t* page) noexcept;
 
   /**
    * @brief Try to reuse an arena from the free list
@@ -196,6 +248,24 @@ private:
    */
   auto allocate_slow_path(std::size_t size) -> void*;
 
+  /**
+   * @brief Find the arena holding @p ptr in arenas_
+   * @note Caller holds page_mutex_
+   */
+  [[nodiscard]] auto find_arena(void const* ptr) const noexcept -> arena_t*;
+
+  /** @brief Record a new arena in arenas_; caller holds page_mutex_ exclusively */
+  void register_arena(arena_t* arena);
+
+  /** @brief Move the home arena's inbox into its size classes; owner thread only */
+  static void drain_remote_frees(arena_t* home) noexcept;
+
+  /** @brief Take a drained block of at least @p size bytes, splitting off the tail; owner thread only */
+  static auto take_reused(arena_t* home, std::size_t size) noexcept -> void*;
+
+  /** @brief File a block under its size class; owner thread only */
+  static void add_reused(arena_t* home, void* ptr, std::size_t size) noexcept;
+
   /**
    * @brief Thread-safe removal of TLS slot during thread destruction
    * @param slot TLS slot to remove
@@ -208,8 +278,11 @@ private:
   /** @brief Default size for new arenas */
   std::size_t default_page_size_ = default_page_size;
 
-  /** @brief Mutex protecting shared data structures */
-  std::shared_mutex page_mutex_;
+  /** @brief Page size backing new arenas */
+  cfg::page_backing backing_ = cfg::page_backing::normal;
+
+  /** @brief Mutex protecting shared data structures; shared by remote frees looking up arenas */
+  mutable std::shared_mutex page_mutex_;
 
   /** @brief Head of the arena list (LIFO) */
   arena_t* page_list_head_ = nullptr;
@@ -223,6 +296,9 @@ private:
   /** @brief Arenas scheduled for deletion by reset() */
   arena_t* pages_to_free_ = nullptr;
 
+  /** @brief Every live arena sorted by address, to find the owner of a remotely freed block */
+  std::vector<arena_t*> arenas_;
+
   /** @brief Monotonically-increasing frame ID for generation tracking */
   uintptr_t generation_ = {generate_random_id(this)};
 };
@@ -8,6 +8,7 @@
 #include "ouly/allocators/detail/platform_memory.hpp"
 #include "ouly/allocators/tags.hpp"
 #include <cstddef>
+#include <new>
 
 namespace ouly
 {
@@ -29,6 +30,7 @@ namespace ouly
  * - Page-aligned allocations (automatically rounds up to page boundaries)
  * - Zero-initialized memory by default
  * - Cross-platform (Windows and POSIX systems)
+ * - Optional huge page backing through cfg::backing_pages, with fallback to normal pages
  * - Move constructible/assignable but not copy constructible/assignable
  *
  * @tparam Config Configuration template for the allocator
@@ -45,11 +47,16 @@ namespace ouly
  * virtual_allocator<ExecConfig> exec_alloc;
  * void* code_ptr = exec_alloc.allocate(4096);
  *
+ * // Back large tables with huge pages to cut TLB misses
+ * using HugeConfig = ouly::config<ouly::cfg::backing_pages<ouly::cfg::page_backing::huge>>;
+ * virtual_allocator<HugeConfig> table_alloc;
+ *
  * alloc.deallocate(ptr, 1024 * 1024);
  * exec_alloc.deallocate(code_ptr, 4096);
  * @endcode
  *
- * @note All allocations are rounded up to the system page size
+ * @note All allocations are rounded up to the system page size, and with huge page backing, requests of
+ *       at least one huge page are rounded up to the huge page size
  * @note Memory is automatically zeroed on allocation
  * @warning Deallocating with wrong size or pointer may cause undefined behavior
  */
@@ -64,6 +71,7 @@ public:
 
   static constexpr auto align              = ouly::detail::min_alignment_v<Config>;
   static constexpr auto default_protection = cfg::protection::read_write;
+  static constexpr auto backing            = ouly::detail::page_backing_v<Config>;
 
   static constexpr auto null() -> address
   {
@@ -80,6 +88,7 @@ public:
     auto info               = detail::get_memory_info();
     page_size_              = info.page_size_;
     allocation_granularity_ = info.allocation_granularity_;
+    huge_page_size_         = info.huge_page_size_;
   }
 
   /**
@@ -92,7 +101,7 @@ public:
    */
   virtual_allocator(virtual_allocator&& other) noexcept
       : statistics(std::move(other)), page_size_(other.page_size_),
-        allocation_granularity_(other.allocation_granularity_)
+        allocation_granularity_(other.allocation_granularity_), huge_page_size_(other.huge_page_size_)
   {}
 
   /**
@@ -110,6 +119,7 @@ public:
       statistics::operator=(std::move(other));
       page_size_              = other.page_size_;
       allocation_granularity_ = other.allocation_granularity_;
+      huge_page_size_         = other.huge_page_size_;
     }
     return *this;
   }
@@ -140,7 +150,7 @@ public:
     // Get protection from config or use default
     auto protection = get_protection_from_config();
 
-    void* ptr = detail::virtual_alloc(aligned_size, protection);
+    void* ptr = detail::virtual_alloc(aligned_size, protection, nullptr, backing);
 
     if (ptr != nullptr)
     {
@@ -243,13 +253,22 @@ public:
     return allocation_granularity_;
   }
 
+  /**
+   * @brief Get the system's default huge page size, 0 when huge pages are not supported
+   */
+  [[nodiscard]] auto huge_page_size() const noexcept -> size_type
+  {
+    return huge_page_size_;
+  }
+
 private:
   size_type page_size_{0};
   size_type allocation_granularity_{0};
+  size_type huge_page_size_{0};
 
   [[nodiscard]] auto round_up_to_page_size(size_type size) const noexcept -> size_type
   {
-    return ((size + page_size_ - 1) / page_size_) * page_size_;
+    return detail::round_up_to_pages(size, backing, page_size_, huge_page_size_);
   }
 
   [[nodiscard]] auto get_protection_from_config() const noexcept -> cfg::protection
@@ -266,4 +285,64 @@ private:
   }
 };
 
+/**
+ * @brief Stateless allocator that maps whole pages with the page backing selected by Config
+ *
+ * Serves as the underlying allocator of arena-based allocators, so their arenas can live on huge
+ * pages. linear_arena_allocator picks it automatically when its config has cfg::backing_pages:
+ * @code
+ * using huge_arenas = ouly::config<ouly::cfg::backing_pages<ouly::cfg::page_backing::transparent_huge>>;
+ * ouly::linear_arena_allocator<huge_arenas> arenas(4 * 1024 * 1024);
+ * @endcode
+ *
+ * Sizes are rounded like virtual_allocator rounds them. Allocation failure throws std::bad_alloc,
+ * matching default_allocator.
+ */
+template <typename Config = ouly::config<>>
+struct page_allocator
+{
+  using tag       = virtual_memory_allocator_tag;
+  using address   = void*;
+  using size_type = std::size_t;
+
+  static constexpr auto align   = ouly::detail::min_alignment_v<Config>;
+  static constexpr auto backing = ouly::detail::page_backing_v<Config>;
+
+  template <typename Alignment = alignment<align>>
+  [[nodiscard]] static auto allocate(size_type size, Alignment /* alignment_hint */ = {}) -> address
+  {
+    void* ptr = detail::virtual_alloc(round_up(size), cfg::protection::read_write, nullptr, backing);
+    if (ptr == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  template <typename Alignment = alignment<align>>
+  [[nodiscard]] static auto zero_allocate(size_type size, Alignment /* alignment_hint */ = {}) -> address
+  {
+    // Fresh mappings are zero-filled by the OS
+    return allocate(size);
+  }
+
+  template <typename Alignment = alignment<align>>
+  static void deallocate(address ptr, size_type size, Alignment /* alignment_hint */ = {}) noexcept
+  {
+    detail::virtual_free(ptr, round_up(size));
+  }
+
+  static constexpr auto null() -> address
+  {
+    return nullptr;
+  }
+
+private:
+  static auto round_up(size_type size) noexcept -> size_type
+  {
+    static detail::memory_info const info = detail::get_memory_info();
+    return detail::round_up_to_pages(size, backing, info.page_size_, info.huge_page_size_);
+  }
+};
+
 } // namespace ouly
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/alignment.hpp"
+#include "ouly/allocators/config.hpp"
+#include "ouly/allocators/detail/default_allocator_defs.hpp"
+#include "ouly/allocators/detail/memory_stats.hpp"
+#include "ouly/allocators/detail/platform_memory.hpp"
+#include "ouly/allocators/tags.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace ouly
+{
+
+/**
+ * @brief A linear allocator over one reserved address range that commits pages on demand
+ *
+ * The constructor reserves `reserve_size` bytes of address space but commits none of it. Allocation
+ * bumps a head offset and commits pages in `commit_granularity` steps as the head crosses the
+ * committed boundary. Every block therefore stays at the same address for the life of the allocator,
+ * and all blocks are contiguous. A buffer allocated last can grow through realloc() up to the whole
+ * reservation without copying.
+ *
+ * Compared to the other linear allocators:
+ * - linear_allocator commits its whole buffer up front
+ * - linear_arena_allocator chains separate arenas, so consecutive blocks are not contiguous
+ * - virtual_arena_allocator pays only for the pages touched, and rewind() can hand them back
+ *
+ * @tparam Config Configuration for the allocator (statistics tracking)
+ *
+ * Example usage:
+ * @code
+ * ouly::virtual_arena_allocator<> scratch(std::size_t{1} << 32); // 4 GiB of address space, nothing committed
+ * auto* verts = static_cast<vertex*>(scratch.allocate(n * sizeof(vertex), ouly::alignarg<vertex>));
+ * verts = static_cast<vertex*>(scratch.realloc(verts, n * sizeof(vertex), 2 * n * sizeof(vertex)));
+ * scratch.rewind(1024 * 1024); // end of frame: keep 1 MiB committed, decommit the rest
+ * @endcode
+ *
+ * @note Alignments up to the page size are honored
+ * @note Allocation throws std::bad_alloc when the reservation is exhausted or pages cannot be committed. On
+ * Linux a commit is refused only under strict overcommit (vm.overcommit_memory=2); otherwise running out of
+ * memory is not detected at commit time and surfaces when the pages are first touched.
+ * @warning Not thread-safe
+ */
+template <typename Config = ouly::config<>>
+class virtual_arena_allocator : ouly::detail::statistics<virtual_arena_allocator_tag, Config>
+{
+public:
+  using tag        = virtual_arena_allocator_tag;
+  using statistics = ouly::detail::statistics<virtual_arena_allocator_tag, Config>;
+  using size_type  = std::size_t;
+  using address    = void*;
+
+  /** @brief Pages are committed in steps of this many bytes by default (64 KiB) */
+  static constexpr size_type default_commit_granularity = 64 * 1024;
+
+  static constexpr auto null() -> address
+  {
+    return nullptr;
+  }
+
+  /**
+   * @brief Reserve the address range
+   * @param reserve_size Upper bound on the bytes this allocator can hand out
+   * @param commit_granularity Bytes committed per step, rounded up to the page size
+   * @throws std::bad_alloc when the address space cannot be reserved
+   */
+  explicit virtual_arena_allocator(size_type reserve_size, size_type commit_granularity = default_commit_granularity)
+  {
+    auto const info = detail::get_memory_info();
+    granularity_    = round_up(std::max(commit_granularity, info.page_size_), info.page_size_);
+    reserved_       = round_up(std::max(reserve_size, granularity_), info.allocation_granularity_);
+    base_           = static_cast<std::byte*>(detail::virtual_reserve(reserved_));
+    if (base_ == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+    statistics::report_new_arena();
+  }
+
+  virtual_arena_allocator(virtual_arena_allocator const&)                    = delete;
+  auto operator=(virtual_arena_allocator const&) -> virtual_arena_allocator& = delete;
+
+  virtual_arena_allocator(virtual_arena_allocator&& other) noexcept
+      : statistics(std::move(other)), base_(std::exchange(other.base_, nullptr)),
+        reserved_(std::exchange(other.reserved_, 0)), committed_(std::exchange(other.committed_, 0)),
+        used_(std::exchange(other.used_, 0)), granularity_(other.granularity_)
+  {}
+
+  auto operator=(virtual_arena_allocator&& other) noexcept -> virtual_arena_allocator&
+  {
+    if (this != &other)
+    {
+      release();
+      statistics::operator=(std::move(other));
+      base_        = std::exchange(other.base_, nullptr);
+      reserved_    = std::exchange(other.reserved_, 0);
+      committed_   = std::exchange(other.committed_, 0);
+      used_        = std::exchange(other.used_, 0);
+      granularity_ = other.granularity_;
+    }
+    return *this;
+  }
+
+  ~virtual_arena_allocator() noexcept
+  {
+    release();
+  }
+
+  /**
+   * @brief Bump-allocate `size` bytes, committing pages as needed
+   * @throws std::bad_alloc when the reservation is exhausted or pages cannot be committed
+   */
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto allocate(size_type size, Alignment alignment = {}) -> address
+  {
+    [[maybe_unused]] auto measure = statistics::report_allocate(size);
+
+    size_type offset = used_;
+    if (alignment)
+    {
+      // The base is page aligned, so aligning the offset aligns the pointer
+      auto const fixup = static_cast<size_type>(alignment) - 1;
+      offset           = (offset + fixup) & ~fixup;
+    }
+    if (offset > reserved_ || size > reserved_ - offset)
+    {
+      throw std::bad_alloc();
+    }
+    ensure_committed(offset + size);
+    used_ = offset + size;
+    return base_ + offset;
+  }
+
+  /**
+   * @brief Allocate and zero `size` bytes
+   */
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto zero_allocate(size_type size, Alignment alignment = {}) -> address
+  {
+    // Pages reused after rewind() may still hold old contents, so clearing cannot be skipped
+    auto* ptr = allocate(size, alignment);
+    std::memset(ptr, 0, size);
+    return ptr;
+  }
+
+  /**
+   * @brief Resize a block, in place when it is the most recent allocation
+   *
+   * The last block grows in place up to the end of the reservation, which makes this allocator a
+   * pointer-stable backing store for growable arrays. Any other block is copied to a new one.
+   *
+   * @return Address of the resized block, which may differ from `data`
+   */
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto realloc(address data, size_type old_size, size_type new_size, Alignment alignment = {})
+   -> address
+  {
+    if (data == nullptr || old_size == 0)
+    {
+      return allocate(new_size, alignment);
+    }
+
+    auto const offset = static_cast<size_type>(static_cast<std::byte*>(data) - base_);
+    if (offset + old_size == used_)
+    {
+      if (new_size > reserved_ - offset)
+      {
+        throw std::bad_alloc();
+      }
+      if (new_size > old_size)
+      {
+        [[maybe_unused]] auto measure = statistics::report_allocate(new_size - old_size);
+        ensure_committed(offset + new_size);
+      }
+      else
+      {
+        [[maybe_unused]] auto measure = statistics::report_deallocate(old_size - new_size);
+      }
+      used_ = offset + new_size;
+      return data;
+    }
+
+    auto* moved = allocate(new_size, alignment);
+    std::memcpy(moved, data, std::min(old_size, new_size));
+    return moved;
+  }
+
+  /**
+   * @brief Reclaim `data` if it is the most recent allocation; otherwise a no-op until rewind()
+   */
+  template <typename Alignment = alignment<>>
+  void deallocate(address data, size_type size, Alignment /* alignment */ = {}) noexcept
+  {
+    [[maybe_unused]] auto measure = statistics::report_deallocate(size);
+    if (static_cast<std::byte*>(data) + size == base_ + used_)
+    {
+      used_ -= size;
+    }
+  }
+
+  /**
+   * @brief Current head offset, to be passed to rewind_to()
+   */
+  [[nodiscard]] auto get_marker() const noexcept -> size_type
+  {
+    return used_;
+  }
+
+  /**
+   * @brief Free every block allocated after `marker` was taken; pages stay committed
+   */
+  void rewind_to(size_type marker) noexcept
+  {
+    OULY_ASSERT(marker <= used_);
+    used_ = marker;
+  }
+
+  /**
+   * @brief Free every block and decommit pages beyond the first `keep_committed` bytes
+   *
+   * Decommitted pages go back to the system (MADV_DONTNEED on POSIX, MEM_DECOMMIT on Windows) and
+   * read as zero once committed again. Keeping a frame's typical footprint committed avoids page
+   * faults in the next frame.
+   */
+  void rewind(size_type keep_committed = 0) noexcept
+  {
+    used_           = 0;
+    auto const keep = std::min(round_up(keep_committed, granularity_), committed_);
+    if (keep < committed_ && detail::virtual_decommit(base_ + keep, committed_ - keep))
+    {
+      committed_ = keep;
+    }
+  }
+
+  /** @brief Bytes handed out, including alignment padding */
+  [[nodiscard]] auto get_used_size() const noexcept -> size_type
+  {
+    return used_;
+  }
+
+  /** @brief Bytes currently committed */
+  [[nodiscard]] auto get_committed_size() const noexcept -> size_type
+  {
+    return committed_;
+  }
+
+  /** @brief Bytes of reserved address space */
+  [[nodiscard]] auto get_reserved_size() const noexcept -> size_type
+  {
+    return reserved_;
+  }
+
+  /** @brief Start of the reservation; every block lies in [data(), data() + get_used_size()) */
+  [[nodiscard]] auto data() const noexcept -> address
+  {
+    return base_;
+  }
+
+private:
+  static constexpr auto round_up(size_type size, size_type granule) noexcept -> size_type
+  {
+    return ((size + granule - 1) / granule) * granule;
+  }
+
+  void ensure_committed(size_type end)
+  {
+    if (end <= committed_) [[likely]]
+    {
+      return;
+    }
+    auto const target = std::min(round_up(end, granularity_), reserved_);
+    if (!detail::virtual_commit(base_ + committed_, target - committed_))
+    {
+      throw std::bad_alloc();
+    }
+    committed_ = target;
+  }
+
+  void release() noexcept
+  {
+    if (base_ != nullptr)
+    {
+      detail::virtual_free(base_, reserved_);
+      base_      = nullptr;
+      committed_ = 0;
+      used_      = 0;
+    }
+  }
+
+  std::byte* base_        = nullptr;
+  size_type  reserved_    = 0;
+  size_type  committed_   = 0;
+  size_type  used_        = 0;
+  size_type  granularity_ = default_commit_granularity;
+};
+
+} // namespace ouly
@@ -42,4 +42,8 @@ struct name_map
 struct single_threaded_consumer_for_each
 {};
 
+/** Enables the blocking push_wait/pop_wait of spsc_ring; each publication then also checks for a parked peer */
+struct blocking_wait
+{};
+
 } // namespace ouly::cfg
@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/containers/config.hpp"
+#include "ouly/utility/config.hpp"
+#include "ouly/utility/user_config.hpp"
+#include "ouly/utility/utils.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly
+{
+
+/**
+ * @brief Wait-free bounded FIFO for exactly one producer thread and one consumer thread
+ *
+ * @tparam T Element type
+ * @tparam Capacity Number of slots, a power of two
+ * @tparam Config Pass ouly::config<ouly::cfg::blocking_wait> to enable push_wait() and pop_wait()
+ *
+ * Intended for pinned pipeline stages (audio mixer feeding an output thread, network receiver
+ * feeding a decoder) where mpmc_ring or concurrent_queue would pay for contention that cannot occur.
+ *
+ * Design:
+ * - The write index belongs to the producer and the read index to the consumer. Each sits on its own
+ *   cache line, next to a private copy of the other side's index. A side reloads the shared index
+ *   only when its copy says the ring is full (producer) or empty (consumer). A steady stream
+ *   therefore touches the other side's cache line once per lap of the ring, not once per element.
+ * - Elements are constructed before the write index is published (release) and moved out before the
+ *   read index is published, so neither side ever sees a slot mid-construction.
+ * - try_push_n() and try_pop_n() move a whole batch with a single index publication.
+ * - Blocking is opt-in. A waiting side parks in std::atomic::wait on the other side's index and
+ *   raises a flag. The other side checks the flag after each publication, behind a seq_cst fence,
+ *   and notifies only when the flag is set. The default configuration publishes with a plain
+ *   release store.
+ *
+ * Calling producer functions from more than one thread, or consumer functions from more than one
+ * thread, is undefined behaviour. Remaining elements are destroyed with the ring.
+ *
+ * Usage:
+ * ```cpp
+ * ouly::spsc_ring<sample_block, 64> ring;
+ * // producer
+ * while (!ring.try_push(block)) { }
+ * // consumer
+ * sample_block block;
+ * if (ring.try_pop(block)) { mix(block); }
+ * ```
+ */
+template <typename T, std::size_t Capacity, typename Config = ouly::default_config<T>>
+class spsc_ring
+{
+  static_assert((Capacity > 0) && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power-of-two > 0");
+  static_assert(std::is_nothrow_destructible_v<T>, "T must be nothrow destructible");
+
+  static constexpr std::size_t mask       = Capacity - 1;
+  static constexpr bool        blocking   = requires { typename Config::blocking_wait; };
+  static constexpr std::size_t cache_line = ouly_cache_line_size;
+  using storage_t                         = ouly::detail::aligned_storage<sizeof(T), alignof(T)>;
+
+public:
+  using value_type = T;
+
+  spsc_ring() noexcept = default;
+
+  ~spsc_ring() noexcept
+  {
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+      auto read  = read_.load(std::memory_order_relaxed);
+      auto write = write_.load(std::memory_order_relaxed);
+      for (; read != write; ++read)
+      {
+        std::destroy_at(slot(read));
+      }
+    }
+  }
+
+  spsc_ring(spsc_ring const&)                    = delete;
+  auto operator=(spsc_ring const&) -> spsc_ring& = delete;
+  spsc_ring(spsc_ring&&)                         = delete;
+  auto operator=(spsc_ring&&) -> spsc_ring&      = delete;
+
+  /*===============================  PRODUCER  ===============================*/
+
+  /** @brief Construct an element in place; false if the ring is full */
+  template <typename... Args>
+  auto try_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> bool
+  {
+    auto write = write_.load(std::memory_order_relaxed);
+    if (free_slots(write) == 0)
+    {
+      return false;
+    }
+    std::construct_at(slot(write), std::forward<Args>(args)...);
+    publish_write(write + 1);
+    return true;
+  }
+
+  auto try_push(T const& value) noexcept(std::is_nothrow_copy_constructible_v<T>) -> bool
+  {
+    return try_emplace(value);
+  }
+
+  auto try_push(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) -> bool
+  {
+    return try_emplace(std::move(value));
+  }
+
+  /**
+   * @brief Copy as many leading `values` as fit and publish them together
+   * @return Number of elements pushed
+   */
+  auto try_push_n(std::span<T const> values) noexcept(std::is_nothrow_copy_constructible_v<T>) -> std::size_t
+  {
+    auto write = write_.load(std::memory_order_relaxed);
+    auto count = std::min(values.size(), free_slots(write, values.size()));
+    if (count == 0)
+    {
+      return 0;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      if constexpr (std::is_nothrow_copy_constructible_v<T>)
+      {
+        std::construct_at(slot(write + i), values[i]);
+      }
+      else
+      {
+        try
+        {
+          std::construct_at(slot(write + i), values[i]);
+        }
+        catch (...)
+        {
+          // Nothing was published yet: undo the partial batch and leave the ring unchanged
+          for (std::size_t j = 0; j < i; ++j)
+          {
+            std::destroy_at(slot(write + j));
+          }
+          throw;
+        }
+      }
+    }
+    publish_write(write + count);
+    return count;
+  }
+
+  /**
+   * @brief Push, waiting for a free slot when the ring is full
+   */
+  template <typename... Args>
+    requires(blocking)
+  void push_wait(Args&&... args)
+  {
+    auto write = write_.load(std::memory_order_relaxed);
+    while (free_slots(write) == 0)
+    {
+      // The ring is full: sleep until the consumer moves the read index away from write - Capacity
+      auto full_read = write - Capacity;
+      producer_waiting_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      read_.wait(full_read, std::memory_order_acquire);
+      producer_waiting_.store(false, std::memory_order_relaxed);
+    }
+    std::construct_at(slot(write), std::forward<Args>(args)...);
+    publish_write(write + 1);
+  }
+
+  /*===============================  CONSUMER  ===============================*/
+
+  /** @brief Move the oldest element into `out`; false if the ring is empty */
+  auto try_pop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) -> bool
+  {
+    auto read = read_.load(std::memory_order_relaxed);
+    if (ready_slots(read) == 0)
+    {
+      return false;
+    }
+    out = std::move(*slot(read));
+    std::destroy_at(slot(read));
+    publish_read(read + 1);
+    return true;
+  }
+
+  /**
+   * @brief Move up to `out.size()` of the oldest elements into `out` and release their slots together
+   * @return Number of elements popped
+   */
+  auto try_pop_n(std::span<T> out) noexcept(std::is_nothrow_move_assignable_v<T>) -> std::size_t
+  {
+    auto read  = read_.load(std::memory_order_relaxed);
+    auto count = std::min(out.size(), ready_slots(read, out.size()));
+    if (count == 0)
+    {
+      return 0;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      out[i] = std::move(*slot(read + i));
+      std::destroy_at(slot(read + i));
+    }
+    publish_read(read + count);
+    return count;
+  }
+
+  /**
+   * @brief Pop, waiting for an element when the ring is empty
+   */
+  void pop_wait(T& out)
+    requires(blocking)
+  {
+    auto read = read_.load(std::memory_order_relaxed);
+    while (ready_slots(read) == 0)
+    {
+      consumer_waiting_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      write_.wait(read, std::memory_order_acquire);
+      consumer_waiting_.store(false, std::memory_order_relaxed);
+    }
+    out = std::move(*slot(read));
+    std::destroy_at(slot(read));
+    publish_read(read + 1);
+  }
+
+  /*=================================  ANY  ==================================*/
+
+  /** @brief Element count; only a snapshot when called while the other side is active */
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    auto read = read_.load(std::memory_order_acquire);
+    return write_.load(std::memory_order_acquire) - read;
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return size() == 0;
+  }
+
+  [[nodiscard]] static constexpr auto capacity() noexcept -> std::size_t
+  {
+    return Capacity;
+  }
+
+private:
+  auto slot(std::size_t index) noexcept -> T*
+  {
+    return ouly::detail::vector_access(slots_, index & mask).template as<T>();
+  }
+
+  // Producer side: refresh the cached read index only when it shows fewer than `wanted` free slots
+  auto free_slots(std::size_t write, std::size_t wanted = 1) noexcept -> std::size_t
+  {
+    auto free = Capacity - (write - read_cache_);
+    if (free < wanted)
+    {
+      read_cache_ = read_.load(std::memory_order_acquire);
+      free        = Capacity - (write - read_cache_);
+    }
+    return free;
+  }
+
+  // Consumer side: refresh the cached write index only when it shows fewer than `wanted` elements
+  auto ready_slots(std::size_t read, std::size_t wanted = 1) noexcept -> std::size_t
+  {
+    auto ready = write_cache_ - read;
+    if (ready < wanted)
+    {
+      write_cache_ = write_.load(std::memory_order_acquire);
+      ready        = write_cache_ - read;
+    }
+    return ready;
+  }
+
+  void publish_write(std::size_t write) noexcept
+  {
+    write_.store(write, std::memory_order_release);
+    if constexpr (blocking)
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (consumer_waiting_.load(std::memory_order_relaxed))
+      {
+        write_.notify_one();
+      }
+    }
+  }
+
+  void publish_read(std::size_t read) noexcept
+  {
+    read_.store(read, std::memory_order_release);
+    if constexpr (blocking)
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (producer_waiting_.load(std::memory_order_relaxed))
+      {
+        read_.notify_one();
+      }
+    }
+  }
+
+  struct empty_flag
+  {};
+  using wait_flag = std::conditional_t<blocking, std::atomic<bool>, empty_flag>;
+
+  // Producer line: published write index, the producer's copy of the read index, and the consumer's
+  // wait flag, which only the producer polls
+  alignas(cache_line) std::atomic<std::size_t> write_{0};
+  std::size_t                                  read_cache_ = 0;
+  [[no_unique_address]] wait_flag              consumer_waiting_{};
+
+  // Consumer line, mirrored
+  alignas(cache_line) std::atomic<std::size_t> read_{0};
+  std::size_t                                  write_cache_ = 0;
+  [[no_unique_address]] wait_flag              producer_waiting_{};
+
+  alignas(cache_line) std::array<storage_t, Capacity> slots_;
+};
+
+} // namespace ouly
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,643 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/awaiters.hpp"
+#include "ouly/scheduler/scheduler.hpp"
+#include "ouly/scheduler/spin_lock.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace ouly
+{
+
+namespace detail
+{
+
+/**
+ * @brief Intrusive list entry for a coroutine suspended on one of the async primitives.
+ *
+ * The entry lives in the awaiter, i.e. in the suspended coroutine frame. It records the workgroup the
+ * coroutine was running on so that whoever releases it resubmits the coroutine there instead of running
+ * it on the releasing thread. A coroutine suspended outside a scheduler worker is resumed inline.
+ */
+template <TaskContext WC>
+class async_waiter
+{
+public:
+  /**
+   * @brief Record how to resume `coroutine`. Must be called before the entry is published to a list.
+   */
+  template <typename Promise>
+    requires(std::derived_from<Promise, coro_state> && std::same_as<typename Promise::context_type, WC>)
+  void prepare(std::coroutine_handle<Promise> coroutine) noexcept
+  {
+    coroutine_ = coroutine;
+    resume_    = &resume_as<Promise>;
+    if (auto const* ctx = coroutine_context_slot<WC>::current_)
+    {
+      origin_     = *ctx;
+      group_      = ctx->get_workgroup();
+      has_origin_ = true;
+    }
+  }
+
+  /**
+   * @brief Hand the coroutine back to the scheduler. The entry may be destroyed before this returns.
+   */
+  void resume() noexcept
+  {
+    resume_(*this);
+  }
+
+  async_waiter* next_ = nullptr;
+
+private:
+  template <typename Promise>
+  static void resume_as(async_waiter& self) noexcept
+  {
+    auto coroutine = std::coroutine_handle<Promise>::from_address(self.coroutine_.address());
+    if (!self.has_origin_)
+    {
+      coroutine.resume();
+      return;
+    }
+    auto origin = self.origin_;
+    auto group  = self.group_;
+    submit_coroutine(origin, group, coroutine);
+  }
+
+  void                    (*resume_)(async_waiter&) noexcept = nullptr;
+  std::coroutine_handle<> coroutine_;
+  WC                      origin_;
+  workgroup_id            group_;
+  bool                    has_origin_ = false;
+};
+
+/**
+ * @brief FIFO of waiters; not synchronized.
+ */
+template <TaskContext WC>
+class async_waiter_queue
+{
+public:
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return head_ == nullptr;
+  }
+
+  void push_back(async_waiter<WC>* waiter) noexcept
+  {
+    waiter->next_ = nullptr;
+    if (tail_ != nullptr)
+    {
+      tail_->next_ = waiter;
+    }
+    else
+    {
+      head_ = waiter;
+    }
+    tail_ = waiter;
+  }
+
+  auto pop_front() noexcept -> async_waiter<WC>*
+  {
+    auto* waiter = head_;
+    if (waiter != nullptr)
+    {
+      head_ = waiter->next_;
+      if (head_ == nullptr)
+      {
+        tail_ = nullptr;
+      }
+    }
+    return waiter;
+  }
+
+private:
+  async_waiter<WC>* head_ = nullptr;
+  async_waiter<WC>* tail_ = nullptr;
+};
+
+/**
+ * @brief Resume every waiter of a singly linked LIFO chain in arrival order.
+ */
+template <TaskContext WC>
+void resume_waiter_stack(async_waiter<WC>* waiters) noexcept
+{
+  async_waiter<WC>* ordered = nullptr;
+  while (waiters != nullptr)
+  {
+    auto* next     = waiters->next_;
+    waiters->next_ = ordered;
+    ordered        = waiters;
+    waiters        = next;
+  }
+  while (ordered != nullptr)
+  {
+    auto* next = ordered->next_;
+    ordered->resume();
+    ordered = next;
+  }
+}
+
+} // namespace detail
+
+template <TaskContext WC>
+class basic_async_mutex;
+
+/**
+ * @brief Ownership of a locked basic_async_mutex, released on destruction.
+ */
+template <TaskContext WC>
+class basic_async_mutex_lock
+{
+public:
+  basic_async_mutex_lock() noexcept = default;
+  explicit basic_async_mutex_lock(basic_async_mutex<WC>& mutex, std::adopt_lock_t /*unused*/) noexcept
+      : mutex_(&mutex)
+  {}
+
+  basic_async_mutex_lock(basic_async_mutex_lock&& other) noexcept : mutex_(std::exchange(other.mutex_, nullptr)) {}
+  basic_async_mutex_lock(basic_async_mutex_lock const&) = delete;
+
+  auto operator=(basic_async_mutex_lock&& other) noexcept -> basic_async_mutex_lock&
+  {
+    if (this != &other)
+    {
+      unlock();
+      mutex_ = std::exchange(other.mutex_, nullptr);
+    }
+    return *this;
+  }
+  auto operator=(basic_async_mutex_lock const&) -> basic_async_mutex_lock& = delete;
+
+  ~basic_async_mutex_lock() noexcept
+  {
+    unlock();
+  }
+
+  void unlock() noexcept
+  {
+    if (auto* mutex = std::exchange(mutex_, nullptr))
+    {
+      mutex->unlock();
+    }
+  }
+
+  [[nodiscard]] auto owns_lock() const noexcept -> bool
+  {
+    return mutex_ != nullptr;
+  }
+
+private:
+  basic_async_mutex<WC>* mutex_ = nullptr;
+};
+
+/**
+ * @brief Mutex for co_task. A contended `co_await mutex.lock()` suspends the coroutine instead of blocking
+ * the worker; unlock() hands ownership directly to the oldest waiter and resubmits it to its workgroup.
+ *
+ * The lock word is either "unlocked", "locked without waiters" or the head of a lock-free stack of newly
+ * arrived waiters. The owner moves that stack into its private FIFO on unlock, so waiters are served in
+ * arrival order and the uncontended path is a single compare-exchange.
+ */
+template <TaskContext WC>
+class basic_async_mutex
+{
+  using waiter = detail::async_waiter<WC>;
+
+  static constexpr std::uintptr_t locked_no_waiters = 0;
+  static constexpr std::uintptr_t not_locked        = 1;
+
+public:
+  class lock_awaiter : waiter
+  {
+  public:
+    explicit lock_awaiter(basic_async_mutex& mutex) noexcept : mutex_(mutex) {}
+
+    [[nodiscard]] auto await_ready() noexcept -> bool
+    {
+      // A caller that is already cancelled does not queue; await_resume() throws without the lock
+      skipped_ = ouly::detail::cancellation_slot::current_.is_cancellation_requested();
+      return skipped_ || mutex_.try_lock();
+    }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> awaiting_coro) noexcept -> bool
+    {
+      this->prepare(awaiting_coro);
+      return mutex_.enqueue(this);
+    }
+
+    void await_resume() const
+    {
+      if (skipped_)
+      {
+        throw operation_cancelled();
+      }
+      if (ouly::detail::cancellation_slot::current_.is_cancellation_requested())
+      {
+        // Cancelled while queued: pass the lock on to the next waiter
+        mutex_.unlock();
+        throw operation_cancelled();
+      }
+    }
+
+  protected:
+    basic_async_mutex& mutex_; // NOLINT
+
+  private:
+    bool skipped_ = false;
+  };
+
+  class scoped_lock_awaiter : public lock_awaiter
+  {
+  public:
+    using lock_awaiter::lock_awaiter;
+
+    [[nodiscard]] auto await_resume() const -> basic_async_mutex_lock<WC>
+    {
+      lock_awaiter::await_resume();
+      return basic_async_mutex_lock<WC>(this->mutex_, std::adopt_lock);
+    }
+  };
+
+  basic_async_mutex() noexcept                                   = default;
+  basic_async_mutex(basic_async_mutex const&)                    = delete;
+  basic_async_mutex(basic_async_mutex&&)                         = delete;
+  auto operator=(basic_async_mutex const&) -> basic_async_mutex& = delete;
+  auto operator=(basic_async_mutex&&) -> basic_async_mutex&      = delete;
+
+  ~basic_async_mutex() noexcept
+  {
+    OULY_ASSERT(state_.load(std::memory_order_relaxed) == not_locked && waiters_ == nullptr);
+  }
+
+  [[nodiscard]] auto try_lock() noexcept -> bool
+  {
+    auto expected = not_locked;
+    return state_.compare_exchange_strong(expected, locked_no_waiters, std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief `co_await mutex.lock();` acquires the mutex; pair with unlock().
+   *
+   * Cancellation does not wake a queued waiter: the ambient token is checked before queuing and again once
+   * the lock is handed over, in which case the lock is released before throwing.
+   * @throws operation_cancelled if the ambient cancellation token fired by then
+   */
+  [[nodiscard]] auto lock() noexcept -> lock_awaiter
+  {
+    return lock_awaiter(*this);
+  }
+
+  /**
+   * @brief `auto guard = co_await mutex.scoped_lock();` acquires the mutex and releases it with the guard.
+   * @throws operation_cancelled under the same conditions as lock()
+   */
+  [[nodiscard]] auto scoped_lock() noexcept -> scoped_lock_awaiter
+  {
+    return scoped_lock_awaiter(*this);
+  }
+
+  void unlock() noexcept
+  {
+    OULY_ASSERT(state_.load(std::memory_order_relaxed) != not_locked);
+    auto* head = waiters_;
+    if (head == nullptr)
+    {
+      auto expected = locked_no_waiters;
+      if (state_.compare_exchange_strong(expected, not_locked, std::memory_order_release,
+                                         std::memory_order_relaxed))
+      {
+        return;
+      }
+
+      // Reverse the stack of new arrivals into the owner's FIFO
+      auto* arrivals = reinterpret_cast<waiter*>(state_.exchange(locked_no_waiters, std::memory_order_acquire));
+      while (arrivals != nullptr)
+      {
+        auto* next      = arrivals->next_;
+        arrivals->next_ = head;
+        head            = arrivals;
+        arrivals        = next;
+      }
+    }
+
+    // Ownership passes to the oldest waiter; the lock word stays locked
+    waiters_ = head->next_;
+    head->resume();
+  }
+
+private:
+  // Returns false when the lock was acquired instead of queuing
+  auto enqueue(waiter* entry) noexcept -> bool
+  {
+    auto state = state_.load(std::memory_order_acquire);
+    while (true)
+    {
+      if (state == not_locked)
+      {
+        if (state_.compare_exchange_weak(state, locked_no_waiters, std::memory_order_acquire,
+                                         std::memory_order_acquire))
+        {
+          return false;
+        }
+        continue;
+      }
+      entry->next_ = state == locked_no_waiters ? nullptr : reinterpret_cast<waiter*>(state);
+      if (state_.compare_exchange_weak(state, reinterpret_cast<std::uintptr_t>(entry), std::memory_order_release,
+                                       std::memory_order_acquire))
+      {
+        return true;
+      }
+    }
+  }
+
+  std::atomic<std::uintptr_t> state_{not_locked};
+  // Waiters in arrival order, only touched by the current owner
+  waiter* waiters_ = nullptr;
+};
+
+/**
+ * @brief Counting semaphore for co_task. `co_await semaphore.acquire()` suspends while no permits are
+ * available; release() hands permits to waiters in arrival order and resubmits them to their workgroups.
+ */
+template <TaskContext WC>
+class basic_async_semaphore
+{
+  using waiter = detail::async_waiter<WC>;
+
+public:
+  class acquire_awaiter : waiter
+  {
+  public:
+    explicit acquire_awaiter(basic_async_semaphore& semaphore) noexcept : semaphore_(semaphore) {}
+
+    [[nodiscard]] auto await_ready() noexcept -> bool
+    {
+      // A caller that is already cancelled does not queue; await_resume() throws without a permit
+      skipped_ = ouly::detail::cancellation_slot::current_.is_cancellation_requested();
+      return skipped_ || semaphore_.try_acquire();
+    }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> awaiting_coro) noexcept -> bool
+    {
+      this->prepare(awaiting_coro);
+      std::scoped_lock lock(semaphore_.lock_);
+      if (semaphore_.count_ > 0)
+      {
+        --semaphore_.count_;
+        return false;
+      }
+      semaphore_.waiters_.push_back(this);
+      return true;
+    }
+
+    void await_resume() const
+    {
+      if (skipped_)
+      {
+        throw operation_cancelled();
+      }
+      if (ouly::detail::cancellation_slot::current_.is_cancellation_requested())
+      {
+        // Cancelled while queued: the permit goes back to the next waiter
+        semaphore_.release();
+        throw operation_cancelled();
+      }
+    }
+
+  private:
+    basic_async_semaphore& semaphore_; // NOLINT
+    bool                   skipped_ = false;
+  };
+
+  explicit basic_async_semaphore(std::size_t initial_count = 0) noexcept : count_(initial_count) {}
+  basic_async_semaphore(basic_async_semaphore const&)                    = delete;
+  basic_async_semaphore(basic_async_semaphore&&)                         = delete;
+  auto operator=(basic_async_semaphore const&) -> basic_async_semaphore& = delete;
+  auto operator=(basic_async_semaphore&&) -> basic_async_semaphore&      = delete;
+
+  ~basic_async_semaphore() noexcept
+  {
+    OULY_ASSERT(waiters_.empty());
+  }
+
+  [[nodiscard]] auto try_acquire() noexcept -> bool
+  {
+    std::scoped_lock lock(lock_);
+    if (count_ == 0)
+    {
+      return false;
+    }
+    --count_;
+    return true;
+  }
+
+  /**
+   * @brief `co_await semaphore.acquire();` takes one permit.
+   *
+   * Cancellation does not wake a queued waiter: the ambient token is checked before queuing and again once
+   * a permit is handed over, in which case the permit is returned before throwing.
+   * @throws operation_cancelled if the ambient cancellation token fired by then
+   */
+  [[nodiscard]] auto acquire() noexcept -> acquire_awaiter
+  {
+    return acquire_awaiter(*this);
+  }
+
+  /**
+   * @brief Return `count` permits. Waiters receive them first, the rest are kept.
+   */
+  void release(std::size_t count = 1) noexcept
+  {
+    detail::async_waiter_queue<WC> ready;
+    {
+      std::scoped_lock lock(lock_);
+      while (count > 0 && !waiters_.empty())
+      {
+        ready.push_back(waiters_.pop_front());
+        --count;
+      }
+      count_ += count;
+    }
+    while (auto* entry = ready.pop_front())
+    {
+      entry->resume();
+    }
+  }
+
+  [[nodiscard]] auto available() const noexcept -> std::size_t
+  {
+    std::scoped_lock lock(lock_);
+    return count_;
+  }
+
+private:
+  mutable spin_lock              lock_;
+  std::size_t                    count_ = 0;
+  detail::async_waiter_queue<WC> waiters_;
+};
+
+/**
+ * @brief Event for co_task that stays signalled until reset(). `co_await event.wait()` suspends until set()
+ * is called; set() resubmits every waiter to its workgroup.
+ *
+ * The state word is either "set", "not set" (null) or the head of a lock-free stack of waiters.
+ */
+template <TaskContext WC>
+class basic_async_manual_reset_event
+{
+  using waiter = detail::async_waiter<WC>;
+
+public:
+  class wait_awaiter : waiter
+  {
+  public:
+    explicit wait_awaiter(basic_async_manual_reset_event const& event) noexcept : event_(event) {}
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool
+    {
+      return event_.is_set();
+    }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> awaiting_coro) noexcept -> bool
+    {
+      this->prepare(awaiting_coro);
+      auto const* set_state = event_.set_state();
+      auto*       state     = event_.state_.load(std::memory_order_acquire);
+      do
+      {
+        if (state == set_state)
+        {
+          return false;
+        }
+        this->next_ = static_cast<waiter*>(state);
+      }
+      while (!event_.state_.compare_exchange_weak(state, static_cast<waiter*>(this), std::memory_order_release,
+                                                  std::memory_order_acquire));
+      return true;
+    }
+
+    static void await_resume()
+    {
+      ouly::detail::throw_if_cancelled();
+    }
+
+  private:
+    basic_async_manual_reset_event const& event_; // NOLINT
+  };
+
+  explicit basic_async_manual_reset_event(bool initially_set = false) noexcept
+      : state_(initially_set ? set_state() : nullptr)
+  {}
+  basic_async_manual_reset_event(basic_async_manual_reset_event const&)                    = delete;
+  basic_async_manual_reset_event(basic_async_manual_reset_event&&)                         = delete;
+  auto operator=(basic_async_manual_reset_event const&) -> basic_async_manual_reset_event& = delete;
+  auto operator=(basic_async_manual_reset_event&&) -> basic_async_manual_reset_event&      = delete;
+  ~basic_async_manual_reset_event() noexcept                                               = default;
+
+  [[nodiscard]] auto is_set() const noexcept -> bool
+  {
+    return state_.load(std::memory_order_acquire) == set_state();
+  }
+
+  /**
+   * @brief Signal the event and resume all waiters. Has no effect if already set.
+   */
+  void set() noexcept
+  {
+    auto* state = state_.exchange(set_state(), std::memory_order_acq_rel);
+    if (state != set_state())
+    {
+      detail::resume_waiter_stack(static_cast<waiter*>(state));
+    }
+  }
+
+  /**
+   * @brief Clear the event if it is set; waiters already queued are not affected.
+   */
+  void reset() noexcept
+  {
+    void* expected = set_state();
+    state_.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief `co_await event.wait();` returns once the event is set.
+   *
+   * Cancellation does not wake the waiter: the ambient token is only checked when the wait completes, so a
+   * cancelled waiter stays suspended until set() is called.
+   * @throws operation_cancelled if the ambient cancellation token fired by the time the wait completes
+   */
+  [[nodiscard]] auto wait() const noexcept -> wait_awaiter
+  {
+    return wait_awaiter(*this);
+  }
+
+private:
+  [[nodiscard]] auto set_state() const noexcept -> void*
+  {
+    return const_cast<basic_async_manual_reset_event*>(this);
+  }
+
+  mutable std::atomic<void*> state_;
+};
+
+/**
+ * @brief Single-use countdown latch for co_task. `co_await latch.wait()` suspends until count_down() has
+ * been called `count` times in total.
+ */
+template <TaskContext WC>
+class basic_async_latch
+{
+public:
+  explicit basic_async_latch(std::ptrdiff_t count) noexcept : count_(count), ready_(count <= 0) {}
+
+  void count_down(std::ptrdiff_t update = 1) noexcept
+  {
+    OULY_ASSERT(update >= 0);
+    auto const previous = count_.fetch_sub(update, std::memory_order_acq_rel);
+    OULY_ASSERT(previous >= update);
+    if (previous == update)
+    {
+      ready_.set();
+    }
+  }
+
+  [[nodiscard]] auto try_wait() const noexcept -> bool
+  {
+    return ready_.is_set();
+  }
+
+  /**
+   * @brief `co_await latch.wait();` returns once the count reached zero.
+   */
+  [[nodiscard]] auto wait() const noexcept -> typename basic_async_manual_reset_event<WC>::wait_awaiter
+  {
+    return ready_.wait();
+  }
+
+private:
+  std::atomic<std::ptrdiff_t>        count_;
+  basic_async_manual_reset_event<WC> ready_;
+};
+
+using async_mutex              = basic_async_mutex<task_context>;
+using async_mutex_lock         = basic_async_mutex_lock<task_context>;
+using async_semaphore          = basic_async_semaphore<task_context>;
+using async_manual_reset_event = basic_async_manual_reset_event<task_context>;
+using async_latch              = basic_async_latch<task_context>;
+
+} // namespace ouly
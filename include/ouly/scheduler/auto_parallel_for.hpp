@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
 #include "ouly/scheduler/detail/parallel_executer.hpp"
 #include "ouly/scheduler/task.hpp"
@@ -251,6 +252,8 @@ struct auto_range
     constexpr bool is_range_executor = ouly::detail::RangeExecutor<lambda_type, iterator, WC>;
     auto&          lambda            = state_->lambda_instance_.get();
 
+    // Chunk boundary: stop once the ambient token fires
+    ouly::detail::throw_if_cancelled();
     if constexpr (is_range_executor)
     {
       auto start = state_->first_ + start_;
@@ -381,6 +384,7 @@ void execute_sequential_auto(L& lambda, FwIt&& range, WC const& this_context)
   using iterator_t                 = decltype(std::begin(range));
   constexpr bool is_range_executor = ouly::detail::RangeExecutor<L, iterator_t, WC>;
 
+  ouly::detail::throw_if_cancelled();
   if constexpr (is_range_executor)
   {
     lambda(std::begin(std::forward<FwIt>(range)), std::end(std::forward<FwIt>(range)), this_context);
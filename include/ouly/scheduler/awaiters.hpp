@@ -4,7 +4,13 @@
 
 #include "ouly/scheduler/detail/coro_state.hpp"
 
+#include <algorithm>
+#include <concepts>
 #include <exception>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <tuple>
 
 namespace ouly
 {
@@ -18,11 +24,27 @@ void resume_coroutine(std::coroutine_handle<Promise> coroutine,
 {
   using context_type = typename Promise::context_type;
   coroutine_context_guard<context_type> guard(ctx);
+  cancellation_guard                    cancellation(coroutine.promise().cancellation_);
+  // The frame must not be touched once resume() returns: the coroutine may have re-enqueued itself
+  // and finished on another worker (detached frames are freed by final_awaiter, attached ones by
+  // their owner).
   coroutine.resume();
-  if (coroutine.done() && coroutine.promise().detached_)
-  {
-    coroutine.destroy();
-  }
+}
+
+/**
+ * @brief Enqueue a suspended coroutine on `group`. The handle is stored inline in the work item, no
+ * intermediate node is allocated.
+ */
+template <typename Promise>
+void submit_coroutine(typename Promise::context_type const& ctx, workgroup_id group,
+                      std::coroutine_handle<Promise> coroutine) noexcept
+{
+  using context_type = typename Promise::context_type;
+  ctx.get_scheduler().submit(ctx, group,
+                             [coroutine](context_type const& run_ctx) noexcept
+                             {
+                               resume_coroutine(coroutine, run_ctx);
+                             });
 }
 
 template <typename Promise>
@@ -41,25 +63,50 @@ auto dispatch_coroutine(std::coroutine_handle<> coroutine) noexcept -> std::coro
   {
     group = ctx->get_workgroup();
   }
-  ctx->get_scheduler().submit(*ctx, group,
-                              [typed](context_type const& run_ctx) noexcept
-                              {
-                                resume_coroutine(typed, run_ctx);
-                              });
+  submit_coroutine(*ctx, group, typed);
   return std::noop_coroutine();
 }
 
+/**
+ * @brief Continuation dispatch used by when_all: every child arrives on the parent's join counter and
+ * only the last arrival resumes the parent.
+ */
 template <typename Promise>
-auto start_coroutine(std::coroutine_handle<Promise> coroutine) noexcept -> std::coroutine_handle<>
+auto join_coroutine(std::coroutine_handle<> coroutine) noexcept -> std::coroutine_handle<>
 {
-  auto& state = coroutine.promise();
-  if (state.started_.exchange(true, std::memory_order_acq_rel))
+  auto typed = std::coroutine_handle<Promise>::from_address(coroutine.address());
+  if (typed.promise().join_count_.fetch_sub(1, std::memory_order_acq_rel) != 1)
   {
     return std::noop_coroutine();
   }
   return dispatch_coroutine<Promise>(coroutine);
 }
 
+/**
+ * @brief Hand over a coroutine whose caller won its started_ flag. Only that caller may set the resume
+ * group; a coroutine started elsewhere (spawn()) may already be running on another worker.
+ */
+template <typename Promise>
+auto launch_coroutine(std::coroutine_handle<Promise> coroutine) noexcept -> std::coroutine_handle<>
+{
+  using context_type = typename Promise::context_type;
+  if (auto* ctx = coroutine_context_slot<context_type>::current_)
+  {
+    coroutine.promise().resume_group_ = ctx->get_workgroup();
+  }
+  return dispatch_coroutine<Promise>(coroutine);
+}
+
+template <typename Promise>
+auto start_coroutine(std::coroutine_handle<Promise> coroutine) noexcept -> std::coroutine_handle<>
+{
+  if (coroutine.promise().started_.exchange(true, std::memory_order_acq_rel))
+  {
+    return std::noop_coroutine();
+  }
+  return launch_coroutine(coroutine);
+}
+
 } // namespace detail
 
 class final_awaiter
@@ -74,21 +121,32 @@ public:
   auto await_suspend(std::coroutine_handle<AwaiterPromise> awaiting_coro) noexcept -> std::coroutine_handle<>
   {
     ouly::detail::coro_state& state = awaiting_coro.promise();
+    // Read before publishing completion: once the continuation is dispatched it may run on another
+    // worker and destroy this frame.
+    bool const detached = state.detached_;
 
     std::coroutine_handle<> prev =
      state.continuation_.exchange(ouly::detail::completed_sentinel(), std::memory_order_acq_rel);
 
+    // No continuation yet: return noop; the runtime will “resume” it (no-op)
+    // and control will unwind to the resumer.
+    std::coroutine_handle<> next = ouly::detail::completed_sentinel();
+
     // Scheduler-bound continuations are enqueued as fresh work. A coroutine resumed manually
     // outside a scheduler falls back to symmetric transfer so it still makes progress.
     if (prev && prev != ouly::detail::completed_sentinel())
     {
       auto dispatch = state.continuation_dispatch_.load(std::memory_order_acquire);
-      return dispatch != nullptr ? dispatch(prev) : prev;
+      next          = dispatch != nullptr ? dispatch(prev) : prev;
     }
 
-    // No continuation yet: return noop; the runtime will “resume” it (no-op)
-    // and control will unwind to the resumer.
-    return ouly::detail::completed_sentinel();
+    // Nobody owns a detached frame, so it is released here at its final suspension point, the
+    // only place that knows the frame is no longer in use by any worker.
+    if (detached)
+    {
+      awaiting_coro.destroy();
+    }
+    return next;
   }
 
   void await_resume() noexcept {}
@@ -120,16 +178,16 @@ public:
     {
       state.continuation_dispatch_.store(nullptr, std::memory_order_release);
     }
-    // Try to install ourselves as the continuation.
+    // Claim the start before installing ourselves as the continuation: a task that spawn() already
+    // started may finish as soon as the continuation is installed, resume us on another worker and be
+    // destroyed, so its frame must not be touched after the exchange below.
+    bool const start = !state.started_.exchange(true, std::memory_order_acq_rel);
+
     std::coroutine_handle<> expected = nullptr;
     if (state.continuation_.compare_exchange_strong(expected, awaiting_coro, std::memory_order_acq_rel,
                                                     std::memory_order_acquire))
     {
-      if (auto* ctx = ouly::detail::coroutine_context_slot<typename PromiseArg::context_type>::current_)
-      {
-        coro_.promise().resume_group_ = ctx->get_workgroup();
-      }
-      return ouly::detail::start_coroutine(coro_);
+      return start ? ouly::detail::launch_coroutine(coro_) : std::noop_coroutine();
     }
 
     // Failed to install:
@@ -151,6 +209,7 @@ public:
       OULY_ASSERT(false && "Invalid state!");
       std::terminate();
     }
+    ouly::detail::throw_if_cancelled();
     return coro_.promise().result();
   }
 
@@ -158,4 +217,301 @@ private:
   std::coroutine_handle<PromiseArg> coro_;
 };
 
+/**
+ * @brief Awaitable that moves the awaiting coroutine onto a workgroup.
+ *
+ * `co_await schedule_on(group)` suspends the coroutine and enqueues its handle on `group`; it resumes
+ * on a worker of that group, and later continuations (awaited children, tasks) return to `group` as
+ * well. An invalid group re-enqueues on the group the coroutine currently runs in, which is what
+ * `co_await yield()` does: the worker returns to its scheduling loop and may pick up other work first.
+ *
+ * A coroutine that is not running on a scheduler worker continues inline.
+ */
+class schedule_awaiter
+{
+public:
+  explicit schedule_awaiter(workgroup_id group = {}) noexcept : group_(group) {}
+
+  [[nodiscard]] static auto await_ready() noexcept -> bool
+  {
+    return false;
+  }
+
+  template <typename Promise>
+    requires std::derived_from<Promise, ouly::detail::coro_state>
+  auto await_suspend(std::coroutine_handle<Promise> awaiting_coro) const noexcept -> bool
+  {
+    using context_type = typename Promise::context_type;
+    auto* ctx          = ouly::detail::coroutine_context_slot<context_type>::current_;
+    if (ctx == nullptr)
+    {
+      return false;
+    }
+
+    auto& promise = awaiting_coro.promise();
+    auto  group   = group_ ? group_ : ctx->get_workgroup();
+    if (group_)
+    {
+      promise.resume_group_ = group_;
+    }
+    ouly::detail::submit_coroutine(*ctx, group, awaiting_coro);
+    return true;
+  }
+
+  static void await_resume()
+  {
+    ouly::detail::throw_if_cancelled();
+  }
+
+private:
+  workgroup_id group_;
+};
+
+namespace detail
+{
+
+/**
+ * @brief Shared implementation of the co_task when_all awaiters.
+ *
+ * The parent's join counter is armed with one arrival per child plus one for the parent itself, so no
+ * child can resume the parent while children are still being attached. Every child gets the parent as
+ * continuation with join_coroutine as dispatcher; children are then started on the parent's workgroup
+ * and run concurrently. Whoever brings the counter to zero resumes the parent: the parent itself (no
+ * suspension) if all children were already done, otherwise the last child to finish.
+ */
+class when_all_join
+{
+protected:
+  template <typename Promise>
+  static void arm(std::coroutine_handle<Promise> parent, uint32_t count) noexcept
+  {
+    parent.promise().join_count_.store(count + 1, std::memory_order_relaxed);
+  }
+
+  template <typename Promise>
+  [[nodiscard]] static auto disarm(std::coroutine_handle<Promise> parent) noexcept -> bool
+  {
+    return parent.promise().join_count_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+
+  template <typename Task>
+  [[nodiscard]] static auto is_complete(Task const& task) noexcept -> bool
+  {
+    if (!task)
+    {
+      return true;
+    }
+    auto child = Task::handle::from_address(task.address());
+    return static_cast<coro_state&>(child.promise()).continuation_.load(std::memory_order_acquire) ==
+           completed_sentinel();
+  }
+
+  template <typename Promise, typename Task>
+  static void attach(std::coroutine_handle<Promise> parent, Task& task) noexcept
+  {
+    if (!task)
+    {
+      parent.promise().join_count_.fetch_sub(1, std::memory_order_relaxed);
+      return;
+    }
+
+    auto        child = Task::handle::from_address(task.address());
+    coro_state& state = child.promise();
+    state.continuation_dispatch_.store(&join_coroutine<Promise>, std::memory_order_release);
+
+    std::coroutine_handle<> expected = nullptr;
+    if (!state.continuation_.compare_exchange_strong(expected, parent, std::memory_order_acq_rel,
+                                                     std::memory_order_acquire))
+    {
+      if (expected != completed_sentinel())
+      {
+        OULY_ASSERT(false && "A coroutine task supports only one awaiter");
+        std::terminate();
+      }
+      // Already finished: arrive on its behalf. The parent's own arrival keeps this above zero.
+      parent.promise().join_count_.fetch_sub(1, std::memory_order_relaxed);
+      return;
+    }
+
+    // Off-scheduler start_coroutine hands the child back to be run inline.
+    auto next = start_coroutine(child);
+    if (next != std::noop_coroutine())
+    {
+      next.resume();
+    }
+  }
+
+  template <typename Task>
+  static void rethrow(Task& task)
+  {
+    if (task)
+    {
+      Task::handle::from_address(task.address()).promise().rethrow_if_exception();
+    }
+  }
+};
+
+/**
+ * @brief Awaiter returned by when_all(co_tasks...). Resumes with void; child results are read from the
+ * tasks afterwards. The first child exception (in argument order) is rethrown.
+ */
+template <typename... Tasks>
+class when_all_awaiter : when_all_join
+{
+public:
+  explicit when_all_awaiter(Tasks&... tasks) noexcept : tasks_(std::addressof(tasks)...) {}
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool
+  {
+    return std::apply(
+     [](auto const*... task) noexcept -> bool
+     {
+       return (is_complete(*task) && ...);
+     },
+     tasks_);
+  }
+
+  template <typename Promise>
+    requires std::derived_from<Promise, coro_state>
+  auto await_suspend(std::coroutine_handle<Promise> parent) noexcept -> bool
+  {
+    arm(parent, static_cast<uint32_t>(sizeof...(Tasks)));
+    std::apply(
+     [parent](auto*... task) noexcept
+     {
+       (attach(parent, *task), ...);
+     },
+     tasks_);
+    return disarm(parent);
+  }
+
+  void await_resume()
+  {
+    throw_if_cancelled();
+    std::apply(
+     [](auto*... task)
+     {
+       (rethrow(*task), ...);
+     },
+     tasks_);
+  }
+
+private:
+  std::tuple<Tasks*...> tasks_;
+};
+
+/**
+ * @brief Awaiter returned by when_all(range_of_co_tasks). Same semantics as the variadic form.
+ */
+template <typename Range>
+class when_all_range_awaiter : when_all_join
+{
+public:
+  explicit when_all_range_awaiter(Range& tasks) noexcept : tasks_(&tasks) {}
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool
+  {
+    return std::ranges::all_of(*tasks_,
+                               [](auto const& task) noexcept -> bool
+                               {
+                                 return is_complete(task);
+                               });
+  }
+
+  template <typename Promise>
+    requires std::derived_from<Promise, coro_state>
+  auto await_suspend(std::coroutine_handle<Promise> parent) noexcept -> bool
+  {
+    auto const size = std::ranges::size(*tasks_);
+    OULY_ASSERT(size < std::numeric_limits<uint32_t>::max());
+    arm(parent, static_cast<uint32_t>(size));
+    for (auto& task : *tasks_)
+    {
+      attach(parent, task);
+    }
+    return disarm(parent);
+  }
+
+  void await_resume()
+  {
+    throw_if_cancelled();
+    for (auto& task : *tasks_)
+    {
+      rethrow(task);
+    }
+  }
+
+private:
+  Range* tasks_ = nullptr;
+};
+
+/**
+ * @brief Awaiter returned by spawn(co_task): work-first fork.
+ *
+ * The awaiting coroutine's continuation is submitted to the scheduler, where idle workers can steal
+ * it, and the worker switches straight into the child by symmetric transfer. If nobody steals the
+ * parent, the same worker pops it again once the child finishes or suspends, so a recursive spawn
+ * keeps one queued continuation per level instead of every sibling that help-first submission
+ * would queue.
+ *
+ * Outside a scheduler worker the child runs inline until it finishes or suspends, then the parent
+ * continues.
+ */
+template <typename Task>
+class spawn_awaiter
+{
+public:
+  explicit spawn_awaiter(Task& task) noexcept : task_(&task) {}
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool
+  {
+    if (!*task_)
+    {
+      return true;
+    }
+    auto child = Task::handle::from_address(task_->address());
+    return static_cast<coro_state&>(child.promise()).started_.load(std::memory_order_acquire);
+  }
+
+  template <typename Promise>
+    requires std::derived_from<Promise, coro_state>
+  auto await_suspend(std::coroutine_handle<Promise> parent) noexcept -> std::coroutine_handle<>
+  {
+    using context_type = typename Promise::context_type;
+
+    auto        child = Task::handle::from_address(task_->address());
+    coro_state& state = child.promise();
+    if (state.started_.exchange(true, std::memory_order_acq_rel))
+    {
+      return parent;
+    }
+
+    auto* ctx = coroutine_context_slot<context_type>::current_;
+    if (ctx == nullptr)
+    {
+      child.resume();
+      return parent;
+    }
+
+    // Winning started_ makes this the only writer of the child's resume group, and it is written
+    // before the child is handed over: a later co_await of the child leaves it alone.
+    auto group          = parent.promise().resume_group_ ? parent.promise().resume_group_ : ctx->get_workgroup();
+    state.resume_group_ = ctx->get_workgroup();
+    // The parent may be stolen and resumed before the child starts, destroying this awaiter with
+    // it, so nothing may touch `this` after the submit.
+    submit_coroutine(*ctx, group, parent);
+    return child;
+  }
+
+  void await_resume() const
+  {
+    throw_if_cancelled();
+  }
+
+private:
+  Task* task_ = nullptr;
+};
+
+} // namespace detail
+
 } // namespace ouly
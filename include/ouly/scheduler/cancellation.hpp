@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <utility>
+
+namespace ouly
+{
+
+/**
+ * @brief Thrown by cancellable work (task scopes, parallel_for, co_task awaiters) once its cancellation token
+ * has been triggered.
+ */
+class operation_cancelled : public std::exception
+{
+public:
+  [[nodiscard]] auto what() const noexcept -> char const* override
+  {
+    return "operation cancelled";
+  }
+};
+
+/**
+ * @brief Read-only view of a cancellation_source. A default constructed token can never be cancelled.
+ * @note Tokens do not own the source; the source must outlive all work observing its tokens.
+ */
+class cancellation_token
+{
+public:
+  cancellation_token() noexcept = default;
+
+  [[nodiscard]] auto can_be_cancelled() const noexcept -> bool
+  {
+    return requested_ != nullptr;
+  }
+
+  [[nodiscard]] auto is_cancellation_requested() const noexcept -> bool
+  {
+    return requested_ != nullptr && requested_->load(std::memory_order_relaxed);
+  }
+
+  void throw_if_cancellation_requested() const
+  {
+    if (is_cancellation_requested())
+    {
+      throw operation_cancelled();
+    }
+  }
+
+  auto operator==(cancellation_token const&) const noexcept -> bool = default;
+
+private:
+  friend class cancellation_source;
+
+  explicit cancellation_token(std::atomic_bool const* requested) noexcept : requested_(requested) {}
+
+  std::atomic_bool const* requested_ = nullptr;
+};
+
+/**
+ * @brief Owner of a cancellation request. Hand out tokens with get_token() and call request_cancellation() to
+ * stop all work observing them at its next check point.
+ */
+class cancellation_source
+{
+public:
+  cancellation_source() noexcept                                     = default;
+  cancellation_source(cancellation_source const&)                    = delete;
+  cancellation_source(cancellation_source&&)                         = delete;
+  ~cancellation_source() noexcept                                    = default;
+  auto operator=(cancellation_source const&) -> cancellation_source& = delete;
+  auto operator=(cancellation_source&&) -> cancellation_source&      = delete;
+
+  [[nodiscard]] auto get_token() const noexcept -> cancellation_token
+  {
+    return cancellation_token(&requested_);
+  }
+
+  /**
+   * @brief Request cancellation; returns true for the call that made the request.
+   */
+  auto request_cancellation() noexcept -> bool
+  {
+    return !requested_.exchange(true, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto is_cancellation_requested() const noexcept -> bool
+  {
+    return requested_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Clear the request so the source can be reused; only valid once no work observes it.
+   */
+  void reset() noexcept
+  {
+    requested_.store(false, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic_bool requested_{false};
+};
+
+namespace detail
+{
+struct cancellation_slot
+{
+  inline static thread_local cancellation_token current_;
+};
+} // namespace detail
+
+/**
+ * @brief Make `token` the ambient cancellation token of the calling thread for the guard's lifetime.
+ *
+ * Work started while a token is ambient inherits it: task_scope children, parallel_for chunks, flow_graph
+ * tasks and co_task frames carry the token to whichever worker runs them and install it there, so nested
+ * work is cancelled as well. The ambient token is read with task_context::get_cancellation_token().
+ */
+class cancellation_guard
+{
+public:
+  explicit cancellation_guard(cancellation_token token) noexcept
+      : previous_(std::exchange(detail::cancellation_slot::current_, token))
+  {}
+
+  cancellation_guard(cancellation_guard const&)                    = delete;
+  cancellation_guard(cancellation_guard&&)                         = delete;
+  auto operator=(cancellation_guard const&) -> cancellation_guard& = delete;
+  auto operator=(cancellation_guard&&) -> cancellation_guard&      = delete;
+
+  ~cancellation_guard() noexcept
+  {
+    detail::cancellation_slot::current_ = previous_;
+  }
+
+private:
+  cancellation_token previous_;
+};
+
+namespace detail
+{
+/**
+ * @brief Check point used by scheduler primitives: throws operation_cancelled if the ambient token fired.
+ */
+inline void throw_if_cancelled()
+{
+  cancellation_slot::current_.throw_if_cancellation_requested();
+}
+} // namespace detail
+
+} // namespace ouly
@@ -3,6 +3,8 @@
 
 #include "ouly/scheduler/detail/co_task.hpp"
 #include <concepts>
+#include <ranges>
+#include <type_traits>
 
 namespace ouly
 {
@@ -65,4 +67,63 @@ struct co_sequence : public ouly::detail::co_task<R, ouly::detail::sequence_prom
   }
 };
 
+/**
+ * @brief Move the awaiting coroutine onto `group`: `co_await ouly::schedule_on(group);`
+ * @note The coroutine resumes on a worker of `group`, and its later continuations return there too.
+ */
+inline auto schedule_on(workgroup_id group) noexcept -> schedule_awaiter
+{
+  return schedule_awaiter(group);
+}
+
+/**
+ * @brief Re-enqueue the awaiting coroutine on its current workgroup: `co_await ouly::yield();`
+ */
+inline auto yield() noexcept -> schedule_awaiter
+{
+  return schedule_awaiter();
+}
+
+/**
+ * @brief Work-first fork: run `task` on this worker right away and make the awaiting coroutine's
+ * continuation stealable: `co_await ouly::spawn(child); ... co_await child;`
+ *
+ * Use this for recursive divide-and-conquer, where running the child immediately keeps its data hot
+ * in cache and the queues stay as deep as the recursion rather than as wide as its fan-out.
+ * when_all() is the help-first counterpart, which queues the children and parks the parent.
+ * @note The parent must join the task (co_await it or pass it to when_all) before the task goes out of
+ * scope. A task that was already started is not started again.
+ */
+template <typename Task>
+  requires CoroutineTask<Task>
+auto spawn(Task& task) noexcept -> detail::spawn_awaiter<Task>
+{
+  return detail::spawn_awaiter<Task>(task);
+}
+
+/**
+ * @brief Start all child coroutines concurrently and park the awaiting coroutine until every one of
+ * them has finished: `co_await ouly::when_all(load(a), load(b));`
+ *
+ * The parent does not occupy a worker while parked; the last child to finish resumes it. Results are
+ * read from the child tasks afterwards, and the first child exception is rethrown by the co_await.
+ * @note The awaiter references the tasks, so it must be awaited within the lifetime of its arguments.
+ */
+template <typename... Tasks>
+  requires(CoroutineTask<std::remove_cvref_t<Tasks>> && ...)
+auto when_all(Tasks&&... tasks) noexcept -> detail::when_all_awaiter<std::remove_reference_t<Tasks>...>
+{
+  return detail::when_all_awaiter<std::remove_reference_t<Tasks>...>(tasks...);
+}
+
+/**
+ * @brief Range form of when_all for a dynamic number of child coroutines.
+ */
+template <std::ranges::sized_range Range>
+  requires CoroutineTask<std::ranges::range_value_t<Range>>
+auto when_all(Range& tasks) noexcept -> detail::when_all_range_awaiter<Range>
+{
+  return detail::when_all_range_awaiter<Range>(tasks);
+}
+
 } // namespace ouly
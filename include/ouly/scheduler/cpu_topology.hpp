@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/utility/config.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace ouly
+{
+
+/**
+ * @brief Kind of core a workgroup's workers should run on.
+ */
+enum class core_kind : std::uint8_t
+{
+  /** @brief No placement; the OS picks */
+  any,
+  /** @brief Fastest cores only (P-cores, big cores) */
+  performance,
+  /** @brief Slower, power-efficient cores only (E-cores, LITTLE cores) */
+  efficiency
+};
+
+/**
+ * @brief One logical CPU as seen by the OS scheduler.
+ */
+struct logical_cpu
+{
+  uint32_t id_ = 0;
+  /** @brief Relative speed: cpu_capacity when reported, otherwise maximum frequency in kHz; 0 if unknown */
+  uint32_t  capacity_ = 0;
+  core_kind kind_     = core_kind::performance;
+};
+
+/**
+ * @brief Performance/efficiency classification of the machine's logical CPUs.
+ *
+ * On Linux the classification comes from sysfs, in order of reliability:
+ * - `/sys/devices/cpu_core/cpus` and `/sys/devices/cpu_atom/cpus`, listed by the kernel on Intel hybrid parts
+ * - `cpuN/cpu_capacity`, reported for asymmetric (big.LITTLE, some hybrid x86) systems
+ * - `cpuN/cpufreq/cpuinfo_max_freq`
+ * With capacities, CPUs clearly below the fastest one (under 85% of it) are efficiency cores, so small
+ * boost-frequency differences between performance cores do not split them. Offline CPUs are skipped.
+ *
+ * Elsewhere, or when nothing distinguishes the CPUs, every CPU is reported as a performance core and
+ * is_hybrid() is false.
+ */
+class cpu_topology
+{
+public:
+  cpu_topology() noexcept = default;
+
+  /**
+   * @brief Classify `cpus` by their capacity_; kind_ is overwritten.
+   */
+  OULY_API explicit cpu_topology(std::vector<logical_cpu> cpus);
+
+  /**
+   * @brief Read the topology from a sysfs cpu directory (normally /sys/devices/system/cpu).
+   */
+  [[nodiscard]] OULY_API static auto discover(std::filesystem::path const& sysfs_cpu_root) -> cpu_topology;
+
+  /**
+   * @brief Topology of the running machine. Discovered once from the system, so it does not depend on the
+   * affinity of the thread that asks first.
+   */
+  [[nodiscard]] OULY_API static auto get() -> cpu_topology const&;
+
+  [[nodiscard]] auto get_cpus() const noexcept -> std::span<logical_cpu const>
+  {
+    return cpus_;
+  }
+
+  /**
+   * @brief True when both performance and efficiency cores are present.
+   */
+  [[nodiscard]] auto is_hybrid() const noexcept -> bool
+  {
+    return hybrid_;
+  }
+
+  /**
+   * @brief Ids of the CPUs of `kind`; core_kind::any returns all CPUs.
+   */
+  [[nodiscard]] OULY_API auto get_cpu_ids(core_kind kind) const -> std::vector<uint32_t>;
+
+private:
+  void classify_by_capacity();
+
+  std::vector<logical_cpu> cpus_;
+  bool                     hybrid_ = false;
+};
+
+/**
+ * @brief Restrict the calling thread to the given logical CPUs.
+ * @return false if the set is empty or the platform does not support pinning
+ */
+OULY_API auto pin_current_thread(std::span<uint32_t const> cpu_ids) noexcept -> bool;
+
+/**
+ * @brief Logical CPUs the calling thread may currently run on.
+ * @return empty if the platform does not report thread affinity
+ */
+OULY_API auto current_thread_cpus() -> std::vector<uint32_t>;
+
+} // namespace ouly
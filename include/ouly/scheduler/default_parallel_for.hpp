@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/detail/parallel_executer.hpp"
 #include "ouly/scheduler/task.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
@@ -55,6 +56,8 @@ namespace ouly
  *
  * @note The parallel execution is only triggered if the task count exceeds
  *       parallel_execution_threshold and can be effectively parallelized
+ * @note The ambient cancellation token is checked once before every chunk, as auto_parallel_for does; once it
+ *       fires the remaining chunks are skipped and operation_cancelled is thrown.
  *
  * @see default_partitioner_traits For customizing execution behavior
  * @see task_context For execution context details
@@ -135,6 +138,7 @@ void execute_sequential(L& lambda, auto&& range, WC const& this_context)
   using iterator_t                 = decltype(std::begin(range));
   constexpr bool is_range_executor = ouly::detail::RangeExecutor<L, iterator_t, WC>;
 
+  ouly::detail::throw_if_cancelled();
   if constexpr (is_range_executor)
   {
     lambda(std::begin(range), std::end(range), this_context);
@@ -182,6 +186,7 @@ auto create_task_lambda(parallel_for_data<Iterator, L>& pfor_instance, uint32_t
   return [instance = &pfor_instance, start, end](WC const& wc)
   {
     using iterator_t = Iterator;
+    // The scope node has already checked the token before running this chunk
     if constexpr (ouly::detail::RangeExecutor<L, iterator_t, WC>)
     {
       instance->lambda_instance_(instance->first_ + start, instance->first_ + end, wc);
@@ -212,6 +217,7 @@ void execute_remaining_work(L& lambda, auto&& range, uint32_t current_pos, uint3
   const uint32_t remaining_work = count - current_pos;
   if (remaining_work > 0)
   {
+    ouly::detail::throw_if_cancelled();
     if constexpr (is_range_executor)
     {
       lambda(std::begin(range) + current_pos, std::begin(range) + count, this_context);
@@ -278,24 +284,7 @@ void default_parallel_for(L lambda, FwIt&& range, WC const& this_context, TaskTr
 
   if (count <= traits::parallel_execution_threshold || work_count <= 1)
   {
-    if constexpr (is_range_executor)
-    {
-      lambda(std::begin(range), std::end(range), this_context);
-    }
-    else
-    {
-      for (auto it = std::begin(range), end = std::end(range); it != end; ++it)
-      {
-        if constexpr (std::is_integral_v<std::decay_t<decltype(it)>>)
-        {
-          lambda(it, this_context);
-        }
-        else
-        {
-          lambda(*it, this_context);
-        }
-      }
-    }
+    execute_sequential(lambda, std::forward<FwIt>(range), this_context);
   }
   else
   {
@@ -160,10 +160,6 @@ struct co_lambda_executor
       else
       {
         coro_.resume();
-        if (coro_.done())
-        {
-          coro_.destroy();
-        }
       }
     }
   }
@@ -183,10 +179,10 @@ struct co_borrowed_executor
   template <typename TC>
   void operator()(TC const& ctx)
   {
-    auto& promise         = coro_.promise();
-    promise.resume_group_ = ctx.get_workgroup();
+    auto& promise = coro_.promise();
     if (!promise.started_.exchange(true, std::memory_order_acq_rel))
     {
+      promise.resume_group_ = ctx.get_workgroup();
       if constexpr (std::is_same_v<TC, typename C::promise_type::context_type>)
       {
         ouly::detail::resume_coroutine(coro_, ctx);
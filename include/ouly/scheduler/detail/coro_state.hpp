@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 
 #include <atomic>
@@ -22,8 +23,13 @@ struct coro_state
   std::atomic<std::coroutine_handle<>> continuation_{nullptr};
   std::atomic_bool                     started_{false};
   std::atomic<continuation_dispatch>   continuation_dispatch_{nullptr};
+  std::atomic<uint32_t>                join_count_{0};
+  // Plain field: written by the coroutine itself, or by whoever wins started_ before handing the frame
+  // to a worker. Awaiting an already started task never touches it.
   workgroup_id                        resume_group_;
-  bool                                detached_ = false;
+  // Ambient token when the frame was created; installed again whenever the frame is resumed.
+  cancellation_token                  cancellation_ = cancellation_slot::current_;
+  bool                                detached_     = false;
 };
 
 template <TaskContext WC>
@@ -3,8 +3,8 @@
 #include "ouly/scheduler/config.hpp"
 
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
-#include "ouly/scheduler/detail/mpmc_ring.hpp"
 #include "ouly/scheduler/detail/spmc_ring.hpp"
+#include "ouly/scheduler/detail/work_mailbox.hpp"
 #include "ouly/scheduler/v2/task_context.hpp"
 #include "ouly/utility/user_config.hpp"
 #include <atomic>
@@ -37,14 +37,14 @@ using work_item = task_delegate;
  *
  * Each workgroup contains:
  * - An array of Chase-Lev queues (one per worker in the group)
- * - A mailbox for receiving work from other workgroups
+ * - A mailbox for receiving work from other workgroups (bounded ring with an unbounded overflow list)
  * - Work availability notification mechanism
  * - Priority and configuration settings
  */
 class workgroup
 {
 public:
-  using mailbox = std::unique_ptr<ouly::detail::mpmc_ring<work_item, mpmc_capacity>>;
+  using mailbox = std::unique_ptr<ouly::detail::work_mailbox<work_item, mpmc_capacity>>;
 
   static constexpr int32_t  max_fast_context_switch = 64;
   static constexpr uint32_t word_size               = 64;
@@ -99,7 +99,7 @@ public:
 
     // Allocate Chase‑Lev queues for each worker
     work_queues_ = std::make_unique<queue_type[]>(thread_count);
-    mailbox_     = std::make_unique<ouly::detail::mpmc_ring<work_item, mpmc_capacity>>();
+    mailbox_     = std::make_unique<ouly::detail::work_mailbox<work_item, mpmc_capacity>>();
 
     // Bitmap initialisation
 
@@ -174,11 +174,12 @@ public:
   }
 
   /**
-   * @brief Submit work via mailbox (cross-workgroup submission)
+   * @brief Submit work via mailbox (cross-workgroup submission). Overflows past the ring instead of failing;
+   * returns false only if an overflow chunk cannot be allocated.
    */
   [[nodiscard]] auto submit_to_mailbox(work_item const& item) noexcept -> bool
   {
-    if (mailbox_->emplace(item))
+    if (mailbox_->push(item))
     {
       advertise_work_available();
       return true;
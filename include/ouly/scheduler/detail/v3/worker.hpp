@@ -4,6 +4,7 @@
 #include "ouly/scheduler/detail/v3/workgroup.hpp"
 #include "ouly/scheduler/v3/task_context.hpp"
 #include <array>
+#include <atomic>
 #include <cstdint>
 
 namespace ouly::detail::v3
@@ -36,6 +37,23 @@ private:
   // Indices of workgroups this worker belongs to, sorted by descending priority.
   std::array<uint8_t, max_workgroup> group_order_{};
   uint32_t                           group_count_ = 0;
+
+  // Placement resolved from the member groups' core_kind requests
+  core_kind cores_ = core_kind::any;
+
+  // Non-member workgroups this worker may be lent to while its own groups are empty, with
+  // their loan weights and the group offset reserved for this worker in each of them.
+  std::array<uint8_t, max_workgroup>  loan_order_{};
+  std::array<uint32_t, max_workgroup> loan_weight_{};
+  std::array<uint32_t, max_workgroup> loan_offset_{};
+  uint32_t                            loan_count_ = 0;
+
+  // Fair-share mode: deficit round robin over group_order_, indexed like it
+  std::array<uint32_t, max_workgroup> deficit_{};
+  uint32_t                            cursor_ = 0;
+
+  // Tasks this worker executed per workgroup index; only written by the owning worker
+  std::array<std::atomic<uint64_t>, max_workgroup> executed_{};
 };
 
 } // namespace ouly::detail::v3
@@ -1,11 +1,13 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "ouly/scheduler/cpu_topology.hpp"
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
-#include "ouly/scheduler/detail/mpmc_ring.hpp"
 #include "ouly/scheduler/detail/spmc_ring.hpp"
+#include "ouly/scheduler/detail/work_mailbox.hpp"
 #include "ouly/scheduler/v3/task_context.hpp"
 #include "ouly/utility/user_config.hpp"
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -18,7 +20,7 @@
 namespace ouly::detail::v3
 {
 static constexpr uint32_t max_workgroup    = 32;   // Maximum number of workgroups supported
-static constexpr uint32_t mailbox_capacity = 1024; // Capacity of the cross-thread mailbox
+static constexpr uint32_t mailbox_capacity = 1024; // Ring capacity of the cross-thread mailbox before overflow
 
 using work_item = ouly::v3::task_delegate;
 
@@ -30,6 +32,12 @@ struct workgroup_desc
   uint32_t start_        = 0;
   uint32_t thread_count_ = 0;
   uint32_t priority_     = 0;
+  // Fair-share quantum: tasks served per deficit round robin turn
+  uint32_t weight_ = 1;
+  // Cores the group's workers are pinned to
+  core_kind cores_ = core_kind::any;
+  // Weight with which idle members of this group may be lent to each other group (0 = never)
+  std::array<uint32_t, max_workgroup> loan_weights_{};
 };
 
 /**
@@ -44,7 +52,7 @@ class workgroup
 {
 public:
   using queue_type   = ouly::detail::spmc_ring<work_item>;
-  using mailbox_type = ouly::detail::mpmc_ring<work_item, mailbox_capacity>;
+  using mailbox_type = ouly::detail::work_mailbox<work_item, mailbox_capacity>;
 
   workgroup() noexcept  = default;
   ~workgroup() noexcept = default;
@@ -59,11 +67,21 @@ public:
     start_        = start;
     thread_count_ = thread_count;
     priority_     = priority;
+    borrowers_    = 0;
     queues_       = std::make_unique<queue_type[]>(thread_count);
     mailbox_      = std::make_unique<mailbox_type>();
     queued_.store(0, std::memory_order_relaxed);
   }
 
+  /**
+   * @brief Register one more non-member worker that may be lent to this group.
+   * @return The group offset reserved for that worker while it runs this group's tasks.
+   */
+  auto add_borrower() noexcept -> uint32_t
+  {
+    return thread_count_ + borrowers_++;
+  }
+
   void clear() noexcept
   {
     // Drop queued items; in-flight accounting is owned by the scheduler.
@@ -109,11 +127,12 @@ public:
   }
 
   /**
-   * @brief Push from any thread (cross-group or external submission).
+   * @brief Push from any thread (cross-group or external submission). Overflows past the ring instead of
+   * failing; returns false only if an overflow chunk cannot be allocated.
    */
   [[nodiscard]] auto push_mailbox(work_item const& item) noexcept -> bool
   {
-    if (mailbox_->emplace(item))
+    if (mailbox_->push(item))
     {
       queued_.fetch_add(1, std::memory_order_seq_cst);
       return true;
@@ -195,6 +214,14 @@ public:
     return priority_;
   }
 
+  /**
+   * @brief Number of non-member workers that may be lent to this group.
+   */
+  [[nodiscard]] auto get_borrower_count() const noexcept -> uint32_t
+  {
+    return borrowers_;
+  }
+
 private:
   void sink_one() noexcept
   {
@@ -209,6 +236,7 @@ private:
   uint32_t start_        = 0;
   uint32_t thread_count_ = 0;
   uint32_t priority_     = 0;
+  uint32_t borrowers_    = 0;
 };
 
 } // namespace ouly::detail::v3
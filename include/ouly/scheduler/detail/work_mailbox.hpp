@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/mpmc_ring.hpp"
+#include "ouly/scheduler/spin_lock.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ouly::detail
+{
+
+/**
+ * @brief Multi-producer workgroup mailbox: a bounded mpmc_ring backed by an unbounded overflow queue.
+ *
+ * Producers never wait for consumers. While the ring has room an item costs one ring slot; once it is full,
+ * items go to the overflow queue, a FIFO of fixed-size chunks guarded by a spin lock. A burst therefore
+ * allocates once per chunk rather than once per item, and the chunk a consumer empties is kept for the next
+ * burst. While overflow items are pending, new items keep going to the overflow so that they are not served
+ * before older ones.
+ */
+template <typename T, std::size_t Capacity>
+class work_mailbox
+{
+  static_assert(std::is_trivially_destructible_v<T>, "T must be trivially destructible");
+
+  static constexpr std::uint32_t chunk_capacity = 256;
+
+  struct overflow_chunk
+  {
+    overflow_chunk* next_ = nullptr;
+    std::uint32_t   head_ = 0; ///< Next item to pop
+    std::uint32_t   tail_ = 0; ///< Next free slot
+
+    alignas(T) std::byte storage_[chunk_capacity * sizeof(T)]; // NOLINT
+
+    auto slot(std::uint32_t index) noexcept -> T*
+    {
+      return std::launder(reinterpret_cast<T*>(storage_ + (static_cast<std::size_t>(index) * sizeof(T)))); // NOLINT
+    }
+  };
+
+public:
+  work_mailbox() noexcept = default;
+  ~work_mailbox() noexcept
+  {
+    release_overflow();
+  }
+
+  work_mailbox(work_mailbox const&)                    = delete;
+  auto operator=(work_mailbox const&) -> work_mailbox& = delete;
+  work_mailbox(work_mailbox&&)                         = delete;
+  auto operator=(work_mailbox&&) -> work_mailbox&      = delete;
+
+  /**
+   * @brief Enqueue an item. Only fails if the ring is full and an overflow chunk cannot be allocated.
+   */
+  [[nodiscard]] auto push(T const& item) noexcept -> bool
+  {
+    if (overflow_count_.load(std::memory_order_acquire) == 0 && ring_.emplace(item))
+    {
+      return true;
+    }
+
+    std::scoped_lock lock(overflow_lock_);
+    if (tail_ == nullptr || tail_->tail_ == chunk_capacity)
+    {
+      auto* chunk = spare_ != nullptr ? std::exchange(spare_, nullptr) : new (std::nothrow) overflow_chunk();
+      if (chunk == nullptr)
+      {
+        return ring_.emplace(item);
+      }
+      chunk->next_ = nullptr;
+      chunk->head_ = 0;
+      chunk->tail_ = 0;
+      (tail_ != nullptr ? tail_->next_ : head_) = chunk;
+      tail_                                     = chunk;
+    }
+    ::new (tail_->slot(tail_->tail_)) T(item);
+    ++tail_->tail_;
+    // Published only once the item is in place, so a consumer that sees the count finds the item
+    overflow_count_.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] auto pop(T& out) noexcept -> bool
+  {
+    if (ring_.pop(out))
+    {
+      return true;
+    }
+    return pop_overflow(out);
+  }
+
+  /**
+   * @brief Approximate number of queued items.
+   */
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return ring_.size() + overflow_count_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Drop all queued items. Not safe against concurrent producers or consumers.
+   */
+  void clear() noexcept
+  {
+    ring_.clear();
+    release_overflow();
+  }
+
+private:
+  auto pop_overflow(T& out) noexcept -> bool
+  {
+    if (overflow_count_.load(std::memory_order_acquire) == 0)
+    {
+      return false;
+    }
+
+    std::scoped_lock lock(overflow_lock_);
+    auto*            chunk = head_;
+    if (chunk == nullptr || chunk->head_ == chunk->tail_)
+    {
+      // Another consumer took the last item
+      return false;
+    }
+    out = *chunk->slot(chunk->head_);
+    ++chunk->head_;
+    if (chunk->head_ == chunk->tail_)
+    {
+      if (chunk->next_ == nullptr)
+      {
+        // The only chunk is empty: rewind it instead of giving it up
+        chunk->head_ = 0;
+        chunk->tail_ = 0;
+      }
+      else
+      {
+        head_ = chunk->next_;
+        delete std::exchange(spare_, chunk);
+      }
+    }
+    overflow_count_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void release_overflow() noexcept
+  {
+    while (head_ != nullptr)
+    {
+      delete std::exchange(head_, head_->next_);
+    }
+    delete std::exchange(spare_, nullptr);
+    tail_ = nullptr;
+    overflow_count_.store(0, std::memory_order_relaxed);
+  }
+
+  mpmc_ring<T, Capacity> ring_;
+
+  alignas(cache_line_size) std::atomic<std::size_t> overflow_count_{0};
+
+  // Overflow chunks in submission order, plus one emptied chunk kept for reuse; guarded by overflow_lock_
+  alignas(cache_line_size) spin_lock overflow_lock_;
+  overflow_chunk* head_  = nullptr;
+  overflow_chunk* tail_  = nullptr;
+  overflow_chunk* spare_ = nullptr;
+};
+
+} // namespace ouly::detail
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ouly/containers/small_vector.hpp"
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/flow_graph_config.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/config.hpp"
@@ -137,6 +138,8 @@ namespace ouly
  * - Tasks can be added dynamically up until `start()` is called
  * - The graph can be reused by calling `start()` multiple times
  * - Empty nodes (nodes without tasks) are supported and will trigger their successors
+ * - Once the cancellation token passed to `start()` fires, tasks that have not begun are skipped;
+ *   successors are still released so that `wait()` returns normally
  */
 
 template <typename SchedulerType, size_t AvgNodeCount = 4, size_t AvgDepCount = 4, typename Config = ouly::config<>>
@@ -288,16 +291,20 @@ public:
    * to the defined dependencies.
    *
    * @param ctx The scheduler context for task submission
+   * @param cancellation Token checked before each task runs; defaults to the caller's ambient token. Tasks
+   *                     observe it through context_type::get_cancellation_token().
    *
    * @note This method can be called multiple times to re-execute the graph
    * @note All tasks added to nodes up to this point will be executed
    * @note This method calculates total task count dynamically to handle late additions
    */
-  void start(context_type const& ctx)
+  void start(context_type const& ctx, cancellation_token cancellation = detail::cancellation_slot::current_)
   {
     OULY_ASSERT(!started_.load(std::memory_order_acquire));
     [[maybe_unused]] bool drain_acquire = done_.try_acquire();
 
+    cancellation_ = cancellation;
+
     // mark the thread that initiated start; inline nodes will run here
     main_worker_id_              = ctx.get_worker();
     total_inline_nodes_executed_ = 0;
@@ -564,16 +571,21 @@ private:
       return pending_dependencies_.load(std::memory_order_acquire) > 0;
     }
 
-    /// Execute a specific task by index and return completion status
-    auto execute_task(uint32_t node_index, uint32_t task_index, context_type const& ctx) noexcept -> bool
+    /// Execute a specific task by index, unless cancelled, and return completion status
+    auto execute_task(uint32_t node_index, uint32_t task_index, context_type const& ctx,
+                      cancellation_token cancellation) noexcept -> bool
     {
-      if constexpr (ouly::detail::flow_graph_node_id_v<config>)
-      {
-        tasks_[task_index](ctx, node_id{node_index});
-      }
-      else
+      if (!cancellation.is_cancellation_requested())
       {
-        tasks_[task_index](ctx);
+        cancellation_guard guard(cancellation);
+        if constexpr (ouly::detail::flow_graph_node_id_v<config>)
+        {
+          tasks_[task_index](ctx, node_id{node_index});
+        }
+        else
+        {
+          tasks_[task_index](ctx);
+        }
       }
       // Check if this is the last task in this node to complete
       auto completed_count = run_count_.fetch_add(1, std::memory_order_acq_rel) + 1;
@@ -614,6 +626,7 @@ private:
   std::atomic_bool      started_{false};                 ///< Whether graph execution has started
   std::binary_semaphore done_{0};                        ///< Signaled when all tasks complete
   worker_id             main_worker_id_;
+  cancellation_token    cancellation_; ///< Token of the current run
 
   /// Execute all tasks in a specific node
   void execute_node(uint32_t node_index, context_type const& ctx)
@@ -642,7 +655,8 @@ private:
                                  [graph_ptr, node_index, i](context_type const& task_ctx) mutable
                                  {
                                    // Execute the actual task
-                                   if (graph_ptr->nodes_[node_index].execute_task(node_index, i, task_ctx))
+                                   if (graph_ptr->nodes_[node_index].execute_task(node_index, i, task_ctx,
+                                                                                 graph_ptr->cancellation_))
                                    {
                                      // Last task in this node, notify successors
                                      graph_ptr->notify_successors(node_index, task_ctx);
@@ -679,7 +693,7 @@ private:
         continue;
       }
       // Execute sequentially
-      bool is_last = node.execute_task(node_index, i, ctx);
+      bool is_last = node.execute_task(node_index, i, ctx, cancellation_);
       if (remaining_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1)
       {
         signal_done();
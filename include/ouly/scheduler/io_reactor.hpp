@@ -0,0 +1,333 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/mmap_file.hpp"
+#include "ouly/scheduler/awaiters.hpp"
+#include "ouly/scheduler/scheduler.hpp"
+#include "ouly/utility/common.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace ouly
+{
+
+#ifdef _WIN32
+using native_file_handle = void*;
+#else
+using native_file_handle = int;
+#endif
+
+/**
+ * @brief Backend used by an io_reactor to complete file requests.
+ */
+enum class io_backend : std::uint8_t
+{
+  /** @brief io_uring where the kernel supports it, thread_pool otherwise */
+  automatic,
+  /** @brief Linux io_uring submission/completion rings */
+  io_uring,
+  /** @brief Blocking positional reads/writes on a small pool of dedicated threads */
+  thread_pool
+};
+
+enum class io_operation : std::uint8_t
+{
+  read,
+  write
+};
+
+/**
+ * @brief File handle opened for positional asynchronous I/O through an io_reactor.
+ *
+ * The handle carries no file position; every request names its own offset, so the same file can be read
+ * and written concurrently from many coroutines.
+ */
+class async_file
+{
+public:
+  async_file() noexcept = default;
+
+  /**
+   * @brief Open `path`. access_mode::write opens for reading and writing and creates the file if missing.
+   * @throws std::system_error when the file cannot be opened
+   */
+  OULY_API explicit async_file(std::filesystem::path const& path, access_mode mode = access_mode::read);
+
+  async_file(async_file&& other) noexcept : handle_(std::exchange(other.handle_, invalid_handle())) {}
+  async_file(async_file const&) = delete;
+  OULY_API ~async_file() noexcept;
+
+  auto operator=(async_file&& other) noexcept -> async_file&
+  {
+    if (this != &other)
+    {
+      close();
+      handle_ = std::exchange(other.handle_, invalid_handle());
+    }
+    return *this;
+  }
+  auto operator=(async_file const&) -> async_file& = delete;
+
+  /**
+   * @brief Open `path`, closing any file currently held. Errors are reported through `error`.
+   */
+  OULY_API void open(std::filesystem::path const& path, access_mode mode, std::error_code& error) noexcept;
+
+  OULY_API void close() noexcept;
+
+  /**
+   * @brief Current size of the file in bytes
+   * @throws std::system_error when the size cannot be queried
+   */
+  [[nodiscard]] OULY_API auto size() const -> std::uint64_t;
+
+  [[nodiscard]] auto is_open() const noexcept -> bool
+  {
+    return handle_ != invalid_handle();
+  }
+
+  [[nodiscard]] auto native_handle() const noexcept -> native_file_handle
+  {
+    return handle_;
+  }
+
+  static constexpr auto invalid_handle() noexcept -> native_file_handle
+  {
+#ifdef _WIN32
+    return nullptr;
+#else
+    return -1;
+#endif
+  }
+
+private:
+  native_file_handle handle_ = invalid_handle();
+};
+
+namespace detail
+{
+
+/**
+ * @brief One positional read or write in flight. Owned by the awaiter (and therefore by the suspended
+ * coroutine frame); the reactor only borrows it until `complete_` is called.
+ */
+struct io_request
+{
+  using completion = void (*)(io_request&) noexcept;
+
+  io_request*        next_     = nullptr;
+  completion         complete_ = nullptr;
+  std::byte*         data_     = nullptr;
+  std::size_t        size_     = 0;
+  std::uint64_t      offset_   = 0;
+  /** @brief Bytes transferred, or the negated system error code */
+  std::int64_t       result_   = 0;
+  native_file_handle file_     = async_file::invalid_handle();
+  io_operation       op_       = io_operation::read;
+};
+
+/**
+ * @brief Run `request` to completion on the calling thread. Does not call `complete_`.
+ */
+OULY_API void perform_blocking_io(io_request& request) noexcept;
+
+} // namespace detail
+
+template <TaskContext WC>
+class basic_io_awaiter;
+
+/**
+ * @brief Completes asynchronous file requests outside the scheduler's workers.
+ *
+ * On Linux the reactor drives an io_uring instance: workers only write a submission entry and a single
+ * completion thread reaps results. Where io_uring is unavailable (non-Linux builds, old kernels, or
+ * sandboxes that forbid the syscalls) requests are served by a few dedicated threads doing blocking
+ * positional I/O, so scheduler workers still never block on the disk.
+ *
+ * When a request completes, the awaiting coroutine is resubmitted to the workgroup it was running on
+ * when it suspended.
+ *
+ * @note All requests must have completed before the reactor is destroyed.
+ */
+class io_reactor
+{
+public:
+  static constexpr uint32_t default_queue_depth  = 256;
+  static constexpr uint32_t default_thread_count = 2;
+
+  OULY_API explicit io_reactor(io_backend backend = io_backend::automatic, uint32_t queue_depth = default_queue_depth,
+                               uint32_t thread_count = default_thread_count);
+  io_reactor(io_reactor const&) = delete;
+  io_reactor(io_reactor&&)      = delete;
+  OULY_API ~io_reactor() noexcept;
+
+  auto operator=(io_reactor const&) -> io_reactor& = delete;
+  auto operator=(io_reactor&&) -> io_reactor&      = delete;
+
+  /**
+   * @brief Process-wide reactor used by the free async_read/async_write functions, created on first use.
+   */
+  OULY_API static auto get_default() -> io_reactor&;
+
+  /**
+   * @brief The backend in use; never io_backend::automatic.
+   */
+  [[nodiscard]] auto get_backend() const noexcept -> io_backend
+  {
+    return backend_;
+  }
+
+  /**
+   * @brief Hand `request` to the backend. The request must stay alive until its `complete_` is called,
+   * which may happen on another thread before this function returns.
+   */
+  OULY_API void submit(detail::io_request& request) noexcept;
+
+  /**
+   * @brief `co_await reactor.async_read(file, offset, buffer)` reads up to buffer.size() bytes at `offset`
+   * and yields the number of bytes read (less than requested only at end of file).
+   */
+  [[nodiscard]] auto async_read(async_file const& file, std::uint64_t offset, std::span<std::byte> buffer) noexcept
+   -> basic_io_awaiter<task_context>;
+
+  /**
+   * @brief `co_await reactor.async_write(file, offset, buffer)` writes buffer at `offset` and yields the
+   * number of bytes written.
+   */
+  [[nodiscard]] auto async_write(async_file const& file, std::uint64_t offset,
+                                 std::span<std::byte const> buffer) noexcept -> basic_io_awaiter<task_context>;
+
+private:
+  struct backend_state;
+
+  std::unique_ptr<backend_state> state_;
+  io_backend                     backend_ = io_backend::thread_pool;
+};
+
+/**
+ * @brief Awaitable for a single file request issued through an io_reactor.
+ *
+ * The coroutine suspends while the request is in flight and is resubmitted to the workgroup it was
+ * running on when the completion arrives. `co_await` yields the number of bytes transferred and throws
+ * std::system_error if the request failed. Outside a scheduler worker the request is performed inline.
+ */
+template <TaskContext WC>
+class basic_io_awaiter : detail::io_request
+{
+public:
+  basic_io_awaiter(io_reactor& reactor, io_operation op, native_file_handle file, std::uint64_t offset,
+                   std::byte* data, std::size_t size) noexcept
+      : reactor_(&reactor)
+  {
+    op_     = op;
+    file_   = file;
+    offset_ = offset;
+    data_   = data;
+    size_   = size;
+  }
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool
+  {
+    return size_ == 0;
+  }
+
+  template <typename Promise>
+    requires(std::derived_from<Promise, ouly::detail::coro_state> &&
+             std::same_as<typename Promise::context_type, WC>)
+  auto await_suspend(std::coroutine_handle<Promise> awaiting_coro) noexcept -> bool
+  {
+    auto const* ctx = ouly::detail::coroutine_context_slot<WC>::current_;
+    if (ctx == nullptr)
+    {
+      ouly::detail::perform_blocking_io(*this);
+      return false;
+    }
+
+    origin_    = *ctx;
+    group_     = ctx->get_workgroup();
+    coroutine_ = awaiting_coro;
+    resume_    = &resume<Promise>;
+    complete_  = &on_complete;
+    // The completion may resume the coroutine, and destroy this awaiter, before submit() returns.
+    reactor_->submit(*this);
+    return true;
+  }
+
+  auto await_resume() const -> std::size_t
+  {
+    ouly::detail::throw_if_cancelled();
+    if (result_ < 0)
+    {
+      throw std::system_error(static_cast<int>(-result_), std::system_category());
+    }
+    return static_cast<std::size_t>(result_);
+  }
+
+private:
+  template <typename Promise>
+  static void resume(basic_io_awaiter& self) noexcept
+  {
+    auto origin    = self.origin_;
+    auto group     = self.group_;
+    auto coroutine = std::coroutine_handle<Promise>::from_address(self.coroutine_.address());
+    ouly::detail::submit_coroutine(origin, group, coroutine);
+  }
+
+  static void on_complete(io_request& request) noexcept
+  {
+    auto& self = static_cast<basic_io_awaiter&>(request);
+    self.resume_(self);
+  }
+
+  io_reactor*             reactor_ = nullptr;
+  void                    (*resume_)(basic_io_awaiter&) noexcept = nullptr;
+  std::coroutine_handle<> coroutine_;
+  WC                      origin_;
+  workgroup_id            group_;
+};
+
+using io_awaiter = basic_io_awaiter<task_context>;
+
+inline auto io_reactor::async_read(async_file const& file, std::uint64_t offset, std::span<std::byte> buffer) noexcept
+ -> basic_io_awaiter<task_context>
+{
+  return {*this, io_operation::read, file.native_handle(), offset, buffer.data(), buffer.size()};
+}
+
+inline auto io_reactor::async_write(async_file const& file, std::uint64_t offset,
+                                    std::span<std::byte const> buffer) noexcept -> basic_io_awaiter<task_context>
+{
+  // The buffer is only read from; io_request carries a single mutable pointer for both directions.
+  return {*this, io_operation::write, file.native_handle(), offset, const_cast<std::byte*>(buffer.data()),
+          buffer.size()};
+}
+
+/**
+ * @brief `co_await ouly::async_read(file, offset, buffer)` on the default reactor.
+ */
+template <typename T, std::size_t Extent>
+  requires(std::is_trivially_copyable_v<T> && !std::is_const_v<T>)
+auto async_read(async_file const& file, std::uint64_t offset, std::span<T, Extent> buffer) -> io_awaiter
+{
+  return io_reactor::get_default().async_read(file, offset, std::as_writable_bytes(std::span<T>(buffer)));
+}
+
+/**
+ * @brief `co_await ouly::async_write(file, offset, buffer)` on the default reactor.
+ */
+template <typename T, std::size_t Extent>
+  requires(std::is_trivially_copyable_v<T>)
+auto async_write(async_file const& file, std::uint64_t offset, std::span<T, Extent> buffer) -> io_awaiter
+{
+  return io_reactor::get_default().async_write(file, offset, std::as_bytes(std::span<T>(buffer)));
+}
+
+} // namespace ouly
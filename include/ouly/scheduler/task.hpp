@@ -4,6 +4,7 @@
 #include "ouly/scheduler/detail/allocation.hpp"
 #include "ouly/scheduler/config.hpp"
 #include "ouly/scheduler/awaiters.hpp"
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/user_config.hpp"
 
@@ -342,8 +343,10 @@ public:
   void run(WC const& ctx) noexcept
   {
     task_execution_guard guard(state_);
+    cancellation_guard   cancellation(cancellation_);
     try
     {
+      cancellation_.throw_if_cancellation_requested();
       if constexpr (std::is_void_v<R>)
       {
         invoke_task(function_, ctx);
@@ -364,7 +367,8 @@ public:
   }
 
 private:
-  task_state<R, WC>* state_ = nullptr;
+  task_state<R, WC>* state_        = nullptr;
+  cancellation_token cancellation_ = cancellation_slot::current_;
   F                  function_;
 };
 
@@ -392,12 +396,17 @@ private:
   void run(WC const& ctx) noexcept
   {
     task_execution_guard guard(result_);
+    cancellation_guard   cancellation(cancellation_);
     try
     {
       if (auto exception = predecessor_->get_exception())
       {
         result_->set_exception(ctx, std::move(exception));
       }
+      else if (cancellation_.is_cancellation_requested())
+      {
+        throw operation_cancelled();
+      }
       else if constexpr (std::is_void_v<R>)
       {
         invoke_continuation(function_, *predecessor_, ctx);
@@ -418,9 +427,10 @@ private:
     scheduler_allocator::destroy(this);
   }
 
-  task_state<T, WC>* predecessor_ = nullptr;
-  task_state<R, WC>* result_      = nullptr;
+  task_state<T, WC>* predecessor_  = nullptr;
+  task_state<R, WC>* result_       = nullptr;
   workgroup_id       group_;
+  cancellation_token cancellation_ = cancellation_slot::current_;
   F                  function_;
 };
 
@@ -561,8 +571,8 @@ public:
   using execute_fn = void (*)(scope_node_base*, WC const&) noexcept;
   using destroy_fn = void (*)(scope_node_base*) noexcept;
 
-  scope_node_base(workgroup_id group, execute_fn execute, destroy_fn destroy) noexcept
-      : group_(group), execute_(execute), destroy_(destroy)
+  scope_node_base(workgroup_id group, execute_fn execute_node, destroy_fn destroy_node) noexcept
+      : group_(group), execute_(execute_node), destroy_(destroy_node)
   {}
 
   void execute(WC const& ctx) noexcept
@@ -586,6 +596,11 @@ public:
     return group_ == ctx.get_workgroup();
   }
 
+  [[nodiscard]] auto is_claimed() const noexcept -> bool
+  {
+    return claimed_.load(std::memory_order_acquire);
+  }
+
   scope_node_base* next_ = nullptr;
 
 private:
@@ -614,11 +629,14 @@ private:
   {
     auto* self = static_cast<scope_node*>(base);
     task_execution_guard task_guard(self->state_);
+    cancellation_guard   cancellation(self->cancellation_);
     auto* previous = std::exchange(scope_execution_slot<WC>::current_,
                                    static_cast<basic_task_scope<WC>*>(self->scope_));
     std::exception_ptr exception;
     try
     {
+      // Children still queued when the token fires complete as cancelled without running.
+      self->cancellation_.throw_if_cancellation_requested();
       if constexpr (std::is_void_v<R>)
       {
         invoke_task(self->function_, ctx);
@@ -644,9 +662,10 @@ private:
     scheduler_allocator::destroy(static_cast<scope_node*>(base));
   }
 
-  task_state<R, WC>* state_    = nullptr;
-  void*              scope_    = nullptr;
-  complete_fn        complete_ = nullptr;
+  task_state<R, WC>* state_        = nullptr;
+  void*              scope_        = nullptr;
+  complete_fn        complete_     = nullptr;
+  cancellation_token cancellation_ = cancellation_slot::current_;
   F                   function_;
 };
 
@@ -849,13 +868,14 @@ public:
       group = ctx->get_workgroup();
     }
     auto allocator = state->get_allocator();
-    auto* node = allocator.make<coroutine_task_continuation_node<Promise, T, WC>>(state, coroutine, group);
+    auto* node = allocator.template make<coroutine_task_continuation_node<Promise, T, WC>>(state, coroutine, group);
     state->add_continuation(node, *ctx);
     return true;
   }
 
   auto await_resume() const -> decltype(auto)
   {
+    throw_if_cancelled();
     if (auto exception = task_access::state(task_)->get_exception())
     {
       std::rethrow_exception(exception);
@@ -1052,6 +1072,18 @@ class basic_task_scope
 public:
   explicit basic_task_scope(scheduler_allocator allocator = {}) noexcept : allocator_(allocator) {}
 
+  /**
+   * @brief Scope that keeps at most `max_in_flight` children outstanding (0 means unbounded).
+   *
+   * run() called from outside the scope's own children blocks once the limit is reached: the caller first
+   * executes unstarted children of this scope, then other scheduler work, and parks until a child completes
+   * only when neither is available. Children spawned from inside the scope are never throttled, since they
+   * would wait on the slot they occupy.
+   */
+  explicit basic_task_scope(uint32_t max_in_flight, scheduler_allocator allocator = {}) noexcept
+      : allocator_(allocator), max_in_flight_(max_in_flight)
+  {}
+
   basic_task_scope(basic_task_scope const&)                          = delete;
   auto operator=(basic_task_scope const&) -> basic_task_scope&       = delete;
 
@@ -1081,21 +1113,31 @@ public:
     using result_type   = detail::task_result_t<function_type, WC>;
     using node_type     = detail::scope_node<function_type, result_type, WC>;
 
-    std::scoped_lock lock(mutex_);
     auto const is_descendant = detail::scope_execution_slot<WC>::current_ == this;
+    auto const reserved      = max_in_flight_ != 0 && !is_descendant;
+    if (reserved)
+    {
+      reserve_slot(ctx);
+    }
+
+    std::unique_lock lock(mutex_);
     OULY_ASSERT((!closed_ || is_descendant) && "Cannot submit external work after joining a task_scope");
     if (closed_ && !is_descendant)
     {
       std::terminate();
     }
 
-    auto* state = allocator_.make<detail::task_state<result_type, WC>>(allocator_);
+    detail::task_state<result_type, WC>* state = nullptr;
     try
     {
-      auto* node = allocator_.make<node_type>(state, this, &complete_one, group, std::forward<F>(function));
+      state       = allocator_.make<detail::task_state<result_type, WC>>(allocator_);
+      auto* node  = allocator_.make<node_type>(state, this, &complete_one, group, std::forward<F>(function));
       node->next_ = nodes_;
       nodes_      = node;
-      outstanding_.fetch_add(1, std::memory_order_relaxed);
+      if (!reserved)
+      {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+      }
       outstanding_.notify_all();
       ctx.get_scheduler().submit(ctx, group,
                                  [node](WC const& run_ctx) noexcept
@@ -1106,12 +1148,25 @@ public:
     }
     catch (...)
     {
-      state->release();
+      if (state != nullptr)
+      {
+        state->release();
+      }
+      if (reserved)
+      {
+        lock.unlock();
+        complete_one(this, {});
+      }
       throw;
     }
     return detail::task_access::make(state);
   }
 
+  [[nodiscard]] auto get_max_in_flight() const noexcept -> uint32_t
+  {
+    return max_in_flight_;
+  }
+
   void join(WC const& ctx)
   {
     verify_not_current();
@@ -1119,29 +1174,8 @@ public:
       std::scoped_lock lock(mutex_);
       closed_ = true;
     }
-    while (true)
-    {
-      auto* nodes = take_nodes();
-      auto const had_nodes = nodes != nullptr;
-      for (auto* node = nodes; node != nullptr; node = node->next_)
-      {
-        if (node->can_execute(ctx))
-        {
-          node->execute(ctx);
-        }
-      }
-      release_nodes(nodes);
-
-      auto const count = outstanding_.load(std::memory_order_acquire);
-      if (count == 0)
-      {
-        break;
-      }
-      if (!had_nodes)
-      {
-        outstanding_.wait(count, std::memory_order_relaxed);
-      }
-    }
+    wait_below(ctx, 1);
+    release_nodes(take_nodes());
     rethrow_exception();
   }
 
@@ -1208,12 +1242,85 @@ private:
         self->exception_ = std::move(exception);
       }
     }
-    if (self->outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    // A bounded scope may have a spawner parked on a full scope, not only a joiner waiting for zero
+    auto const bounded = self->max_in_flight_ != 0;
+    if (self->outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1 || bounded)
     {
       self->outstanding_.notify_all();
     }
   }
 
+  void reserve_slot(WC const& ctx)
+  {
+    auto count = outstanding_.load(std::memory_order_acquire);
+    while (true)
+    {
+      if (count < max_in_flight_)
+      {
+        if (outstanding_.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel,
+                                               std::memory_order_acquire))
+        {
+          return;
+        }
+        continue;
+      }
+      wait_below(ctx, max_in_flight_);
+      count = outstanding_.load(std::memory_order_acquire);
+    }
+  }
+
+  // Wait until fewer than `limit` children are outstanding. Unstarted children of this scope run first, then
+  // other scheduler work, which a running child may be waiting on; the thread parks only when neither exists.
+  void wait_below(WC const& ctx, uint32_t limit)
+  {
+    auto count = outstanding_.load(std::memory_order_acquire);
+    while (count >= limit)
+    {
+      if (!help_one(ctx) && !ctx.get_scheduler().busy_work(ctx))
+      {
+        outstanding_.wait(count, std::memory_order_relaxed);
+      }
+      count = outstanding_.load(std::memory_order_acquire);
+    }
+  }
+
+  // Run one unstarted child on the calling thread. Children already claimed elsewhere are dropped from the
+  // list so that their captures are freed as soon as they finish.
+  auto help_one(WC const& ctx) -> bool
+  {
+    auto*                        nodes    = take_nodes();
+    detail::scope_node_base<WC>* kept     = nullptr;
+    detail::scope_node_base<WC>* tail     = nullptr;
+    bool                         executed = false;
+    while (nodes != nullptr)
+    {
+      auto* next = nodes->next_;
+      if (!executed && !nodes->is_claimed() && nodes->can_execute(ctx))
+      {
+        nodes->execute(ctx);
+        executed = true;
+      }
+      if (nodes->is_claimed())
+      {
+        nodes->release();
+      }
+      else
+      {
+        nodes->next_ = kept;
+        kept         = nodes;
+        tail         = tail == nullptr ? nodes : tail;
+      }
+      nodes = next;
+    }
+    if (kept != nullptr)
+    {
+      std::scoped_lock lock(mutex_);
+      tail->next_ = nodes_;
+      nodes_      = kept;
+    }
+    return executed;
+  }
+
   void rethrow_exception() const
   {
     std::exception_ptr exception;
@@ -1248,7 +1355,8 @@ private:
   mutable std::mutex          mutex_;
   detail::scope_node_base<WC>* nodes_ = nullptr;
   std::exception_ptr           exception_;
-  bool                         closed_ = false;
+  uint32_t                     max_in_flight_ = 0;
+  bool                         closed_        = false;
 };
 
 } // namespace ouly
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 #include "ouly/scheduler/co_task.hpp"
+#include "ouly/scheduler/cpu_topology.hpp"
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
 #include "ouly/scheduler/detail/v3/worker.hpp"
 #include "ouly/scheduler/detail/v3/workgroup.hpp"
@@ -43,13 +44,20 @@ namespace ouly::v3
  *   more sleeper, so bursts (parallel_for) fan out without broadcast storms.
  * - wait_for_tasks() helps execute work, then blocks on the same condition variable
  *   until all submitted tasks (queued and in-flight) complete.
+ * - Opt-in fair share (set_fair_share()): instead of always serving the highest-priority
+ *   group first, each worker runs a deficit round robin over its groups, so overlapping
+ *   groups get CPU time in proportion to their set_group_weight() weights.
+ * - Opt-in loans (allow_loan()): a worker whose own groups have nothing queued may take one
+ *   item at a time from groups its home group lends into, picked by weight. It checks its
+ *   own groups again before every borrowed item, and parks only when neither has work.
  *
  * The public API mirrors v1/v2: submit() overloads, task_context, workgroup creation,
  * busy_work(), wait_for_tasks(), begin/end_execution().
  *
  * @note The scheduler must be started with begin_execution() before submitting tasks.
  * @note Workgroup creation is frozen after begin_execution() is called.
- * @note Tasks of a workgroup only execute on workers that are members of that workgroup.
+ * @note Tasks of a workgroup only execute on workers that are members of that workgroup,
+ * or on workers lent to it through allow_loan().
  */
 class scheduler
 {
@@ -70,8 +78,10 @@ public:
   scheduler(scheduler&& other) noexcept
       : workers_(std::move(other.workers_)), workgroups_(std::move(other.workgroups_)),
         threads_(std::move(other.threads_)), workgroup_descs_(other.workgroup_descs_),
-        entry_fn_(std::move(other.entry_fn_)), worker_count_(other.worker_count_),
-        workgroup_count_(other.workgroup_count_), stop_(other.stop_.load(std::memory_order_relaxed))
+        entry_fn_(std::move(other.entry_fn_)), caller_cpus_(std::move(other.caller_cpus_)),
+        worker_count_(other.worker_count_),
+        workgroup_count_(other.workgroup_count_), fair_share_(other.fair_share_),
+        stop_(other.stop_.load(std::memory_order_relaxed))
   {
     OULY_ASSERT(other.threads_.empty());
     other.worker_count_    = 0;
@@ -89,8 +99,10 @@ public:
       threads_               = std::move(other.threads_);
       workgroup_descs_       = other.workgroup_descs_;
       entry_fn_              = std::move(other.entry_fn_);
+      caller_cpus_           = std::move(other.caller_cpus_);
       worker_count_          = other.worker_count_;
       workgroup_count_       = other.workgroup_count_;
+      fair_share_            = other.fair_share_;
       other.worker_count_    = 0;
       other.workgroup_count_ = 0;
     }
@@ -178,14 +190,60 @@ public:
 
   /**
    * @brief Ensure a work-group by id
+   * @param cores Kind of cores the group's workers are pinned to on hybrid CPUs (see cpu_topology). A
+   * worker shared by several groups is pinned to performance cores if any of them asks for it, else to
+   * efficiency cores if any asks for those. Workers stay within the CPUs the thread calling
+   * begin_execution() may use, when that leaves any. Worker 0 is that thread; it is pinned as well until
+   * end_execution() restores its previous affinity. Nothing is pinned on machines where all cores are alike.
    */
   OULY_API void create_group(workgroup_id group, uint32_t start_thread_idx, uint32_t thread_count,
-                             uint32_t priority = 0);
+                             uint32_t priority = 0, core_kind cores = core_kind::any);
 
   /**
    * @brief Create the next available group
    */
-  OULY_API auto create_group(uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority = 0) -> workgroup_id;
+  OULY_API auto create_group(uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority = 0,
+                             core_kind cores = core_kind::any) -> workgroup_id;
+
+  /**
+   * @brief Serve a worker's workgroups by weighted fair share instead of strict priority.
+   *
+   * Each worker runs a deficit round robin over the groups it belongs to: on its turn a group
+   * with queued work may run up to its weight in tasks before the worker moves to the next
+   * group, and a group that runs empty forfeits the rest of its turn. Groups sharing workers
+   * therefore get task counts in proportion to their weights, and a flood in one group cannot
+   * starve the others. Priority only decides the order of turns. Must be called before
+   * begin_execution().
+   */
+  void set_fair_share(bool enable) noexcept
+  {
+    fair_share_ = enable;
+  }
+
+  /**
+   * @brief Set a group's fair-share weight (tasks per turn, default 1). Must be called before
+   * begin_execution(), after the group is created.
+   */
+  OULY_API void set_group_weight(workgroup_id group, uint32_t weight);
+
+  /**
+   * @brief Number of tasks of `group` executed so far, summed over all workers.
+   *
+   * Compare the counts of groups sharing workers to check the share they actually got.
+   */
+  [[nodiscard]] OULY_API auto get_executed_count(workgroup_id group) const noexcept -> uint64_t;
+
+  /**
+   * @brief Let idle members of `lender` run queued work of `borrower`.
+   *
+   * A lent worker only takes work from `borrower` while none of its own groups has anything
+   * queued, and goes back to them after each borrowed task. When several groups can borrow a
+   * worker, the next one to serve is picked with probability proportional to `weight`
+   * among those with queued work; a weight of 0 removes the loan. Lent workers get their own
+   * group offsets past the member range, so get_worker_count(borrower) counts them too.
+   * Must be called before begin_execution().
+   */
+  OULY_API void allow_loan(workgroup_id lender, workgroup_id borrower, uint32_t weight = 1);
 
   /**
    * @brief Drop all queued (not yet executing) work of a group.
@@ -193,7 +251,7 @@ public:
   OULY_API void clear_group(workgroup_id group);
 
   /**
-   * @brief Get worker count in this group
+   * @brief Get worker count in this group, including workers that may be lent to it
    */
   [[nodiscard]] OULY_API auto get_worker_count(workgroup_id g) const noexcept -> uint32_t;
 
@@ -214,12 +272,13 @@ public:
 
   /**
    * @brief Try to execute a small amount of queued work on the calling worker.
+   * @return true if a work item was executed
    */
-  OULY_API void busy_work(worker_id thread) noexcept;
+  OULY_API auto busy_work(worker_id thread) noexcept -> bool;
 
-  void busy_work(task_context const& ctx) noexcept
+  auto busy_work(task_context const& ctx) noexcept -> bool
   {
-    busy_work(ctx.get_worker());
+    return busy_work(ctx.get_worker());
   }
 
   /**
@@ -242,11 +301,15 @@ private:
   void run_worker(worker_id wid);
 
   auto try_execute_one(worker_id wid) noexcept -> bool;
-  void execute_work(detail::v3::worker& wkr, uint32_t group_index, detail::v3::work_item& work) noexcept;
+  auto try_execute_fair(worker_id wid) noexcept -> bool;
+  auto try_borrow_one(worker_id wid) noexcept -> bool;
+  void execute_work(detail::v3::worker& wkr, uint32_t group_index, uint32_t offset,
+                    detail::v3::work_item& work) noexcept;
   void notify_workers(uint32_t count) noexcept;
   void finish_task() noexcept;
 
   [[nodiscard]] auto has_queued_work(detail::v3::worker const& wkr) const noexcept -> bool;
+  [[nodiscard]] auto has_loanable_work(detail::v3::worker const& wkr) const noexcept -> bool;
 
   // Tasks submitted but not yet finished executing (queued + in-flight).
   ouly::detail::cache_aligned_atomic<uint32_t> pending_{uint32_t{0}};
@@ -263,9 +326,12 @@ private:
   std::array<detail::v3::workgroup_desc, detail::v3::max_workgroup> workgroup_descs_{};
 
   scheduler_worker_entry entry_fn_;
+  // Affinity of the thread that called begin_execution(), which runs worker 0
+  std::vector<uint32_t> caller_cpus_;
 
   uint32_t worker_count_    = 0;
   uint32_t workgroup_count_ = 0;
+  bool     fair_share_      = false;
 
   std::atomic_bool stop_{false};
 };
@@ -3,6 +3,7 @@
 
 #include "ouly/scheduler/config.hpp"
 
+#include "ouly/scheduler/awaiters.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/delegate.hpp"
 #include "ouly/utility/user_config.hpp"
@@ -94,6 +95,22 @@ public:
    */
   OULY_API void cooperative_wait(std::binary_semaphore& event) const;
 
+  /**
+   * @brief Awaitable that moves the awaiting coroutine onto `group`: `co_await ctx.schedule_on(group);`
+   */
+  [[nodiscard]] static auto schedule_on(workgroup_id group) noexcept -> ouly::schedule_awaiter
+  {
+    return ouly::schedule_awaiter(group);
+  }
+
+  /**
+   * @brief Cancellation token of the work running on this thread; see cancellation_guard.
+   */
+  [[nodiscard]] static auto get_cancellation_token() noexcept -> ouly::cancellation_token
+  {
+    return ouly::detail::cancellation_slot::current_;
+  }
+
   auto operator<=>(task_context const&) const noexcept = default;
 
 private:
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Compare two nanobench JSON result files and flag regressions.
+
+Typical use with the scheduler kernel suite:
+
+    bench_scheduler_suite --json baseline.json      # on the reference build
+    bench_scheduler_suite --json candidate.json     # on the change under test
+    scripts/compare_benchmarks.py baseline.json candidate.json --threshold 5
+
+A benchmark regresses when its median time grows by more than the threshold (in percent). The
+combined median absolute percent error of both runs is added to the threshold unless
+--strict is given, so noisy benchmarks do not fail the gate on jitter alone. The exit code is 1
+when any benchmark regressed, which lets CI use the script as a gate.
+"""
+
+import argparse
+import json
+import sys
+
+ELAPSED = "median(elapsed)"
+ERROR = "medianAbsolutePercentError(elapsed)"
+
+
+def load_results(path):
+    with open(path, encoding="utf-8") as handle:
+        document = json.load(handle)
+    results = {}
+    for result in document.get("results", []):
+        name = result.get("name")
+        if name is None or ELAPSED not in result:
+            continue
+        results[name] = (float(result[ELAPSED]), float(result.get(ERROR, 0.0)) * 100.0)
+    return results
+
+
+def format_time(seconds):
+    for unit, scale in (("s", 1.0), ("ms", 1e-3), ("us", 1e-6)):
+        if seconds >= scale:
+            return f"{seconds / scale:.3f} {unit}"
+    return f"{seconds / 1e-9:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="nanobench JSON of the reference run")
+    parser.add_argument("candidate", help="nanobench JSON of the run under test")
+    parser.add_argument("--threshold", type=float, default=5.0, help="allowed slowdown in percent (default 5)")
+    parser.add_argument("--strict", action="store_true", help="do not widen the threshold by measurement error")
+    parser.add_argument("--filter", default="", help="only compare benchmarks whose name contains this text")
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    candidate = load_results(args.candidate)
+
+    names = sorted(name for name in baseline.keys() & candidate.keys() if args.filter in name)
+    if not names:
+        print("no benchmarks in common", file=sys.stderr)
+        return 2
+
+    regressions = []
+    width = max(len(name) for name in names)
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'candidate':>12}  {'change':>8}  {'allowed':>8}")
+    for name in names:
+        old_time, old_error = baseline[name]
+        new_time, new_error = candidate[name]
+        change = (new_time / old_time - 1.0) * 100.0 if old_time > 0 else 0.0
+        allowed = args.threshold if args.strict else args.threshold + old_error + new_error
+        marker = ""
+        if change > allowed:
+            marker = "  REGRESSION"
+            regressions.append(name)
+        elif change < -allowed:
+            marker = "  improved"
+        print(f"{name:<{width}}  {format_time(old_time):>12}  {format_time(new_time):>12}  {change:+7.1f}%"
+              f"  {allowed:7.1f}%{marker}")
+
+    for name in sorted(baseline.keys() - candidate.keys()):
+        print(f"{name}: missing from candidate", file=sys.stderr)
+    for name in sorted(candidate.keys() - baseline.keys()):
+        print(f"{name}: new in candidate")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) beyond {args.threshold:.1f}%:")
+        for name in regressions:
+            print(f"  {name}")
+        return 1
+    print(f"\nno regressions beyond {args.threshold:.1f}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
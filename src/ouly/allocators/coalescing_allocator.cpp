@@ -53,8 +53,30 @@ static inline auto mini2(auto const* it, auto const* data, size_t size, auto key
   return it;
 }
 
+coalescing_allocator::coalescing_allocator(fit_strategy strategy) : strategy_(strategy)
+{
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    offsets_.clear();
+    sizes_.clear();
+    index_.reset(0, std::numeric_limits<size_type>::max());
+  }
+}
+
 auto coalescing_allocator::allocate(size_type size) -> coalescing_allocator::size_type
 {
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    auto const node = index_.allocate(size);
+    if (node == 0)
+    {
+      return std::numeric_limits<size_type>::max();
+    }
+    auto const offset = index_.offset(node);
+    live_.emplace(offset, node);
+    return offset;
+  }
+
   // first fit
   for (uint32_t i = 0, end = static_cast<uint32_t>(sizes_.size()); i < end; ++i)
   {
@@ -77,6 +99,15 @@ auto coalescing_allocator::allocate(size_type size) -> coalescing_allocator::siz
 
 void coalescing_allocator::deallocate(size_type offset, size_type size)
 {
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    auto it = live_.find(offset);
+    OULY_ASSERT(it != live_.end() && index_.size(it->second) == size);
+    index_.release(it->second);
+    live_.erase(it);
+    return;
+  }
+
   if (offsets_.empty())
   {
     // free list can be empty when the entire range was allocated
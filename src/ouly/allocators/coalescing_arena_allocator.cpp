@@ -2,6 +2,7 @@
 
 #include "ouly/allocators/coalescing_arena_allocator.hpp"
 #include <cstddef>
+#include <utility>
 
 namespace ouly
 {
@@ -26,19 +27,30 @@ auto coalescing_arena_allocator::add_arena(size_type size, bool empty) -> std::p
   return std::make_pair(arena_id{arena_idx}, allocation_id{block_id});
 }
 
-auto coalescing_arena_allocator::commit(size_type size, size_type const* found) -> std::uint32_t
+auto coalescing_arena_allocator::commit(size_type size, size_type const* found, bool top_down) -> std::uint32_t
 {
   auto          free_idx  = static_cast<size_type>(std::distance(static_cast<size_type const*>(sizes_.data()), found));
   std::uint32_t free_node = ouly::detail::vector_access(free_ordering_, free_idx);
 
-  // Marker
-  ouly::detail::vector_access(block_entries_.free_marker_, free_node) = false;
-
   auto  arena_id  = ouly::detail::vector_access(block_entries_.arenas_, free_node);
   auto& arena     = ouly::detail::vector_access(arena_entries_.entries_, arena_id);
   auto  remaining = *found - size;
-  ouly::detail::vector_access(block_entries_.sizes_, free_node) = size;
   arena.free_size_ -= size;
+  if (top_down && remaining > 0)
+  {
+    // The free block keeps its start and shrinks; the allocation takes its tail
+    auto& list     = arena.blocks_;
+    auto  new_node = block_entries_.push(ouly::detail::vector_access(block_entries_.offsets_, free_node) + remaining,
+                                         size, arena_id, false);
+    list.insert_after(block_entries_, free_node, new_node);
+    ouly::detail::vector_access(block_entries_.sizes_, free_node) = remaining;
+    reinsert_left(free_idx, remaining, free_node);
+    return new_node;
+  }
+
+  // Marker
+  ouly::detail::vector_access(block_entries_.free_marker_, free_node) = false;
+  ouly::detail::vector_access(block_entries_.sizes_, free_node)       = size;
   if (remaining > 0)
   {
     auto& list     = arena.blocks_;
@@ -191,6 +203,128 @@ auto coalescing_arena_allocator::deallocate(allocation_id id) -> arena_id
   return {};
 }
 
+auto coalescing_arena_allocator::deallocate_batch(std::span<allocation_id const> ids) -> std::vector<arena_id>
+{
+  // Release every block without merging, remembering which arenas were touched
+  std::vector<uint8_t>  touched(arena_entries_.entries_.size(), 0);
+  std::vector<uint16_t> arenas;
+  for (auto id : ids)
+  {
+    auto const node = id.id_;
+    auto const size = ouly::detail::vector_access(block_entries_.sizes_, node);
+    // NOLINTNEXTLINE
+    [[maybe_unused]] auto measure = statistics::report_deallocate(size);
+    OULY_ASSERT(!ouly::detail::vector_access(block_entries_.free_marker_, node));
+
+    auto const arena_idx = ouly::detail::vector_access(block_entries_.arenas_, node);
+    auto&      arena     = ouly::detail::vector_access(arena_entries_.entries_, arena_idx);
+    arena.free_size_ += size;
+    OULY_ASSERT(arena.free_size_ <= arena.size_);
+    ouly::detail::vector_access(block_entries_.free_marker_, node) = true;
+    if (ouly::detail::vector_access(touched, arena_idx) == 0)
+    {
+      ouly::detail::vector_access(touched, arena_idx) = 1;
+      arenas.push_back(arena_idx);
+    }
+  }
+
+  // Free blocks of touched arenas leave the size list; their merged runs are added back below
+  size_t kept = 0;
+  for (size_t i = 0; i < free_ordering_.size(); ++i)
+  {
+    auto const node = ouly::detail::vector_access(free_ordering_, i);
+    if (ouly::detail::vector_access(touched, ouly::detail::vector_access(block_entries_.arenas_, node)) == 0)
+    {
+      ouly::detail::vector_access(free_ordering_, kept) = node;
+      ouly::detail::vector_access(sizes_, kept)         = ouly::detail::vector_access(sizes_, i);
+      ++kept;
+    }
+  }
+  free_ordering_.resize(kept);
+  sizes_.resize(kept);
+
+  std::vector<arena_id>                            dropped;
+  std::vector<std::pair<size_type, std::uint32_t>> runs;
+  for (auto arena_idx : arenas)
+  {
+    auto& arena = ouly::detail::vector_access(arena_entries_.entries_, arena_idx);
+    if (arena.free_size_ == arena.size_)
+    {
+      arena.size_ = 0;
+      arena.blocks_.clear(block_entries_);
+      arenas_.erase(arena_entries_, arena_idx);
+      dropped.push_back(arena_id{.id_ = arena_idx});
+      continue;
+    }
+
+    // One walk folds every run of free blocks into its first block
+    auto&         node_list = arena.blocks_;
+    std::uint32_t head      = 0;
+    for (std::uint32_t node = node_list.front(); node != 0;)
+    {
+      if (!ouly::detail::vector_access(block_entries_.free_marker_, node))
+      {
+        head = 0;
+        node = ouly::detail::vector_access(block_entries_.ordering_, node).next_;
+        continue;
+      }
+      if (head == 0)
+      {
+        head = node;
+        runs.emplace_back(0, head);
+        node = ouly::detail::vector_access(block_entries_.ordering_, node).next_;
+        continue;
+      }
+      ouly::detail::vector_access(block_entries_.sizes_, head) += ouly::detail::vector_access(block_entries_.sizes_, node);
+      node = node_list.erase(block_entries_, node);
+    }
+  }
+
+  for (auto& run : runs)
+  {
+    run.first = ouly::detail::vector_access(block_entries_.sizes_, run.second);
+  }
+  std::ranges::sort(runs);
+
+  std::vector<size_type>     sizes;
+  std::vector<std::uint32_t> ordering;
+  sizes.reserve(sizes_.size() + runs.size());
+  ordering.reserve(sizes_.size() + runs.size());
+  size_t existing = 0;
+  for (auto const& run : runs)
+  {
+    while (existing < sizes_.size() && ouly::detail::vector_access(sizes_, existing) < run.first)
+    {
+      sizes.push_back(ouly::detail::vector_access(sizes_, existing));
+      ordering.push_back(ouly::detail::vector_access(free_ordering_, existing));
+      ++existing;
+    }
+    sizes.push_back(run.first);
+    ordering.push_back(run.second);
+  }
+  sizes.insert(sizes.end(), sizes_.begin() + static_cast<std::ptrdiff_t>(existing), sizes_.end());
+  ordering.insert(ordering.end(), free_ordering_.begin() + static_cast<std::ptrdiff_t>(existing),
+                  free_ordering_.end());
+  sizes_         = std::move(sizes);
+  free_ordering_ = std::move(ordering);
+  return dropped;
+}
+
+auto coalescing_arena_allocator::batch_order(std::span<size_type const> sizes) -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> order(sizes.size());
+  for (uint32_t i = 0; i < order.size(); ++i)
+  {
+    ouly::detail::vector_access(order, i) = i;
+  }
+  std::ranges::stable_sort(order,
+                           [sizes](uint32_t lhs, uint32_t rhs) -> bool
+                           {
+                             return sizes[lhs] > sizes[rhs];
+                           });
+  return order;
+}
+
 void coalescing_arena_allocator::add_free(std::uint32_t node)
 {
   ouly::detail::vector_access(block_entries_.free_marker_, node) = true;
@@ -289,6 +423,67 @@ void coalescing_arena_allocator::reinsert_right(size_t of, size_type size, std::
   }
 }
 
+auto coalescing_arena_allocator::lifetime_usage(allocation_lifetime lifetime) const -> ca_lifetime_usage
+{
+  auto const        tag = static_cast<uint8_t>(lifetime);
+  ca_lifetime_usage usage;
+  for (auto arena_it = arenas_.begin(arena_entries_), arena_end_it = arenas_.end(arena_entries_);
+       arena_it != arena_end_it; ++arena_it)
+  {
+    const auto& arena = *arena_it;
+    size_type   run   = 0;
+    for (auto blk_it = arena.blocks_.begin(block_entries_), blk_end_it = arena.blocks_.end(block_entries_);
+         blk_it != blk_end_it; ++blk_it)
+    {
+      auto const blk = *blk_it;
+      auto const own = blk < lifetimes_.size() ? ouly::detail::vector_access(lifetimes_, blk) : uint8_t{0};
+      if (ouly::detail::vector_access(block_entries_.free_marker_, blk) || own != tag)
+      {
+        run = 0;
+        continue;
+      }
+
+      auto const size = ouly::detail::vector_access(block_entries_.sizes_, blk);
+      usage.runs_ += run == 0 ? 1 : 0;
+      run += size;
+      usage.bytes_ += size;
+      usage.largest_run_ = std::max(usage.largest_run_, run);
+      ++usage.allocation_count_;
+    }
+  }
+  return usage;
+}
+
+auto coalescing_arena_allocator::snapshot() const -> heap_snapshot
+{
+  heap_snapshot result;
+  for (auto arena_it = arenas_.begin(arena_entries_), arena_end_it = arenas_.end(arena_entries_);
+       arena_it != arena_end_it; ++arena_it)
+  {
+    const auto& arena = *arena_it;
+    auto const  first = arena.blocks_.front();
+    result.arenas_.push_back({.capacity_     = arena.size_,
+                              .memory_class_ = 0,
+                              .arena_        = ouly::detail::vector_access(block_entries_.arenas_, first),
+                              .dedicated_    = false,
+                              .blocks_       = {}});
+    auto& blocks = result.arenas_.back().blocks_;
+    for (auto blk_it = arena.blocks_.begin(block_entries_), blk_end_it = arena.blocks_.end(block_entries_);
+         blk_it != blk_end_it; ++blk_it)
+    {
+      auto const blk     = *blk_it;
+      bool const is_free = ouly::detail::vector_access(block_entries_.free_marker_, blk);
+      auto const own     = blk < lifetimes_.size() ? ouly::detail::vector_access(lifetimes_, blk) : uint8_t{0};
+      blocks.push_back({.offset_   = ouly::detail::vector_access(block_entries_.offsets_, blk),
+                        .size_     = ouly::detail::vector_access(block_entries_.sizes_, blk),
+                        .state_    = is_free ? heap_block_state::free : heap_block_state::used,
+                        .lifetime_ = is_free ? allocation_lifetime::persistent : static_cast<allocation_lifetime>(own),
+                        .movable_  = !is_free});
+    }
+  }
+  return result;
+}
+
 // NOLINTNEXTLINE
 void coalescing_arena_allocator::validate_integrity() const
 {
@@ -7,9 +7,30 @@
 namespace ouly
 {
 
+compacting_allocator::compacting_allocator(fit_strategy strategy) : strategy_(strategy)
+{
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    free_offsets_.clear();
+    free_sizes_.clear();
+    index_.reset(0, std::numeric_limits<size_type>::max());
+  }
+}
+
 auto compacting_allocator::allocate(size_type size) -> allocation_id
 {
   OULY_ASSERT(size != 0);
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    auto const node = index_.allocate(size);
+    if (node == 0)
+    {
+      return {};
+    }
+    auto const id                                 = push_entry(index_.offset(node), size);
+    ouly::detail::vector_access(entry_nodes_, id) = node;
+    return allocation_id{id};
+  }
   for (uint32_t i = 0, end = static_cast<uint32_t>(free_offsets_.size()); i < end; ++i)
   {
     if (free_sizes_[i] < size)
@@ -39,6 +60,12 @@ void compacting_allocator::deallocate(allocation_id id)
   auto const size   = ouly::detail::vector_access(entry_sizes_, id.get());
   free_entry(id.get());
 
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    index_.release(ouly::detail::vector_access(entry_nodes_, id.get()));
+    return;
+  }
+
   auto&      offsets = free_offsets_;
   auto&      sizes   = free_sizes_;
   auto const it      = std::ranges::lower_bound(offsets, offset);
@@ -99,9 +126,33 @@ void compacting_allocator::validate_integrity() const
 
   // free blocks and allocations must exactly tile [0, max)
   constexpr auto space_end = std::numeric_limits<size_type>::max();
-  size_type      pos       = 0;
-  size_t         fi        = 0;
-  size_t         ai        = 0;
+
+  if (strategy_ == fit_strategy::tlsf)
+  {
+    index_.validate_integrity();
+    size_type pos = 0;
+    size_t    ai  = 0;
+    index_.for_each_block(
+     [&](size_type offset, size_type size, bool is_free)
+     {
+       OULY_ASSERT(offset == pos);
+       if (!is_free)
+       {
+         OULY_ASSERT(ai < allocs.size());
+         OULY_ASSERT(ouly::detail::vector_access(entry_offsets_, allocs[ai]) == offset);
+         OULY_ASSERT(ouly::detail::vector_access(entry_sizes_, allocs[ai]) == size);
+         ++ai;
+       }
+       pos = offset + size;
+     });
+    OULY_ASSERT(pos == space_end);
+    OULY_ASSERT(ai == allocs.size());
+    return;
+  }
+
+  size_type pos = 0;
+  size_t    fi  = 0;
+  size_t    ai  = 0;
   while (pos < space_end)
   {
     if (fi < free_offsets_.size() && free_offsets_[fi] == pos)
@@ -142,6 +193,7 @@ auto compacting_allocator::push_entry(size_type offset, size_type size) -> uint3
     entry_offsets_.emplace_back();
     entry_sizes_.emplace_back();
     entry_live_.emplace_back();
+    entry_nodes_.emplace_back();
   }
   ouly::detail::vector_access(entry_offsets_, id) = offset;
   ouly::detail::vector_access(entry_sizes_, id)   = size;
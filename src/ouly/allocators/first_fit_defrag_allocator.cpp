@@ -100,6 +100,17 @@ auto first_fit_defrag_allocator::snapshot_allocations(scratch_allocator_ref scra
   return items;
 }
 
+auto first_fit_defrag_allocator::find_resume_position() const noexcept -> uint32_t
+{
+  if (resume_arena_ == 0)
+  {
+    return 0;
+  }
+  auto pos = std::ranges::find(arena_order_, resume_arena_);
+  OULY_ASSERT(pos != arena_order_.end());
+  return static_cast<uint32_t>(pos - arena_order_.begin());
+}
+
 auto first_fit_defrag_allocator::find_placement(defrag_item const&                     it,
                                                 ouly::scratch_vector<size_type> const& cursor) const
  -> std::pair<uint16_t, size_type>
@@ -330,6 +341,12 @@ void first_fit_defrag_allocator::drop_arena(uint16_t arena)
   auto pos = std::ranges::find(arena_order_, arena);
   OULY_ASSERT(pos != arena_order_.end());
   arena_order_.erase(pos);
+  if (arena == resume_arena_)
+  {
+    // the sweep lost its bookmark; the next defragment starts over
+    resume_arena_  = 0;
+    resume_offset_ = 0;
+  }
   ouly::detail::vector_access(arena_pool_, arena) = {};
   free_arenas_.push_back(arena);
 }
@@ -40,14 +40,17 @@ void validate_arena_layout(Ranges ranges, State const& state)
     cursor += range.size_;
   }
 
-  [[maybe_unused]] allocation_size_type free = 0;
+  [[maybe_unused]] allocation_size_type free    = 0;
+  [[maybe_unused]] allocation_size_type largest = 0;
   for (auto const& free_range : state.free_ranges_)
   {
     free += free_range.size_;
+    largest = std::max(largest, free_range.size_);
   }
 
   OULY_ASSERT(cursor == state.capacity_);
   OULY_ASSERT(free == state.free_);
+  OULY_ASSERT(largest == state.largest_free_);
 }
 
 } // namespace
@@ -122,6 +125,12 @@ auto gpu_allocator::is_relocating(allocation_id id) const noexcept -> bool
                              });
 }
 
+auto gpu_allocator::get_lifetime(allocation_id id) const noexcept -> allocation_lifetime
+{
+  OULY_ASSERT(ouly::detail::vector_access(entry_live_, id.get()));
+  return ouly::detail::vector_access(arena_pool_, ouly::detail::vector_access(entry_arenas_, id.get())).lifetime_;
+}
+
 void gpu_allocator::set_movable(allocation_id id, bool movable)
 {
   OULY_ASSERT(ouly::detail::vector_access(entry_live_, id.get()));
@@ -137,7 +146,7 @@ auto gpu_allocator::try_allocate(size_type size, gpu_allocation_options const& o
   {
     auto const& state = ouly::detail::vector_access(arena_pool_, arena);
     if (state.role_ != arena_role::normal || state.dedicated_ || state.memory_class_ != options.memory_class_ ||
-        state.free_ < size)
+        state.lifetime_ != options.lifetime_ || state.largest_free_ < size)
     {
       continue;
     }
@@ -173,9 +182,11 @@ auto gpu_allocator::try_allocate_in_arena(uint16_t arena, size_type size, gpu_al
   return {};
 }
 
-auto gpu_allocator::create_arena(size_type capacity, uint32_t memory_class, bool dedicated) -> arena_id
+auto gpu_allocator::create_arena(size_type capacity, gpu_allocation_options const& options, bool dedicated)
+ -> arena_id
 {
-  uint16_t arena = 0;
+  auto const memory_class = options.memory_class_;
+  uint16_t   arena        = 0;
   if (!free_arenas_.empty())
   {
     arena = free_arenas_.back();
@@ -191,16 +202,62 @@ auto gpu_allocator::create_arena(size_type capacity, uint32_t memory_class, bool
   auto& state         = ouly::detail::vector_access(arena_pool_, arena);
   state.capacity_     = capacity;
   state.free_         = capacity;
+  state.largest_free_ = capacity;
   state.memory_class_ = memory_class;
+  state.lifetime_     = options.lifetime_;
   state.active_       = true;
   state.dedicated_    = dedicated;
   state.free_ranges_  = {
    {.offset_ = 0, .size_ = capacity}
   };
   arena_order_.push_back(arena);
+
+  auto& budget = class_budget(memory_class);
+  ++budget.arena_count_;
+  budget.bytes_reserved_ += capacity;
+  budget.bytes_free_ += capacity;
+  budget.largest_free_block_ = std::max(budget.largest_free_block_, capacity);
   return arena_id{arena};
 }
 
+auto gpu_allocator::class_budget(uint32_t memory_class) -> gpu_memory_class_budget&
+{
+  if (memory_class >= budgets_.size())
+  {
+    budgets_.resize(size_t{memory_class} + 1);
+  }
+  return ouly::detail::vector_access(budgets_, memory_class);
+}
+
+void gpu_allocator::update_largest_free(uint16_t arena, size_type previous)
+{
+  auto const& state  = ouly::detail::vector_access(arena_pool_, arena);
+  auto&       budget = class_budget(state.memory_class_);
+  if (state.largest_free_ >= budget.largest_free_block_)
+  {
+    budget.largest_free_block_ = state.largest_free_;
+  }
+  else if (previous == budget.largest_free_block_)
+  {
+    // The arena that held the class maximum shrank; only then is a rescan needed
+    refresh_largest_free(state.memory_class_);
+  }
+}
+
+void gpu_allocator::refresh_largest_free(uint32_t memory_class)
+{
+  size_type largest = 0;
+  for (auto arena : arena_order_)
+  {
+    auto const& state = ouly::detail::vector_access(arena_pool_, arena);
+    if (state.memory_class_ == memory_class)
+    {
+      largest = std::max(largest, state.largest_free_);
+    }
+  }
+  class_budget(memory_class).largest_free_block_ = largest;
+}
+
 auto gpu_allocator::push_allocation(uint16_t arena, size_type offset, size_type size,
                                     gpu_allocation_options const& options) -> allocation_id
 {
@@ -232,6 +289,10 @@ auto gpu_allocator::push_allocation(uint16_t arena, size_type offset, size_type
   ouly::detail::vector_access(entry_resource_classes_, id) = options.resource_class_;
   ouly::detail::vector_access(entry_live_, id)             = true;
   ouly::detail::vector_access(entry_movable_, id)          = options.movable_;
+
+  auto& budget = class_budget(ouly::detail::vector_access(arena_pool_, arena).memory_class_);
+  budget.bytes_used_ += size;
+  ++budget.allocation_count_;
   return allocation_id{id};
 }
 
@@ -241,16 +302,136 @@ auto gpu_allocator::release_allocation(allocation_id id) -> uint16_t
   auto const arena  = ouly::detail::vector_access(entry_arenas_, id.get());
   auto const offset = ouly::detail::vector_access(entry_offsets_, id.get());
   auto const size   = ouly::detail::vector_access(entry_sizes_, id.get());
-  auto&      state  = ouly::detail::vector_access(arena_pool_, arena);
+
+  release_entry(id);
+  free_range_in_arena(arena, offset, size);
+  return arena;
+}
+
+void gpu_allocator::release_entry(allocation_id id)
+{
+  auto const arena = ouly::detail::vector_access(entry_arenas_, id.get());
+  auto&      state = ouly::detail::vector_access(arena_pool_, arena);
 
   OULY_ASSERT(state.allocations_ != 0);
   --state.allocations_;
-  free_range_in_arena(arena, offset, size);
+  auto& budget = class_budget(state.memory_class_);
+  budget.bytes_used_ -= ouly::detail::vector_access(entry_sizes_, id.get());
+  --budget.allocation_count_;
 
   ouly::detail::vector_access(entry_live_, id.get())    = false;
   ouly::detail::vector_access(entry_offsets_, id.get()) = free_entry_;
   free_entry_                                           = id.get();
-  return arena;
+}
+
+auto gpu_allocator::release_allocations(std::span<allocation_id const> ids) -> std::vector<uint16_t>
+{
+  struct released_range
+  {
+    uint16_t  arena_  = 0;
+    size_type offset_ = 0;
+    size_type size_   = 0;
+  };
+
+  std::vector<released_range> released;
+  released.reserve(ids.size());
+  for (auto id : ids)
+  {
+    if (!prepare_deallocate(id))
+    {
+      OULY_ASSERT(false && "cannot deallocate while a GPU relocation copy is pending");
+      continue;
+    }
+    released.push_back({.arena_  = ouly::detail::vector_access(entry_arenas_, id.get()),
+                        .offset_ = ouly::detail::vector_access(entry_offsets_, id.get()),
+                        .size_   = ouly::detail::vector_access(entry_sizes_, id.get())});
+    release_entry(id);
+  }
+
+  std::ranges::sort(released,
+                    [](released_range const& lhs, released_range const& rhs) -> bool
+                    {
+                      return lhs.arena_ != rhs.arena_ ? lhs.arena_ < rhs.arena_ : lhs.offset_ < rhs.offset_;
+                    });
+
+  // Merge the released ranges of each arena into its offset-sorted free list in one pass
+  std::vector<uint16_t>   arenas;
+  std::vector<free_range> merged;
+  for (auto first = released.begin(); first != released.end();)
+  {
+    auto const arena = first->arena_;
+    auto&      state = ouly::detail::vector_access(arena_pool_, arena);
+    merged.clear();
+    merged.reserve(state.free_ranges_.size() + static_cast<size_t>(released.end() - first));
+
+    auto append = [&merged](size_type offset, size_type size)
+    {
+      if (!merged.empty() && merged.back().offset_ + merged.back().size_ == offset)
+      {
+        merged.back().size_ += size;
+      }
+      else
+      {
+        merged.push_back({.offset_ = offset, .size_ = size});
+      }
+    };
+
+    size_type freed    = 0;
+    auto      existing = state.free_ranges_.begin();
+    for (; first != released.end() && first->arena_ == arena; ++first)
+    {
+      for (; existing != state.free_ranges_.end() && existing->offset_ < first->offset_; ++existing)
+      {
+        append(existing->offset_, existing->size_);
+      }
+      append(first->offset_, first->size_);
+      freed += first->size_;
+    }
+    for (; existing != state.free_ranges_.end(); ++existing)
+    {
+      append(existing->offset_, existing->size_);
+    }
+    std::swap(state.free_ranges_, merged);
+
+    state.free_ += freed;
+    class_budget(state.memory_class_).bytes_free_ += freed;
+    auto const previous = state.largest_free_;
+    for (auto const& range : state.free_ranges_)
+    {
+      state.largest_free_ = std::max(state.largest_free_, range.size_);
+    }
+    if (state.largest_free_ > previous)
+    {
+      update_largest_free(arena, previous);
+    }
+    arenas.push_back(arena);
+  }
+  return arenas;
+}
+
+auto gpu_allocator::batch_order(std::span<gpu_allocation_request const> requests) -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> order(requests.size());
+  for (uint32_t i = 0; i < order.size(); ++i)
+  {
+    ouly::detail::vector_access(order, i) = i;
+  }
+  std::ranges::stable_sort(order,
+                           [requests](uint32_t lhs, uint32_t rhs) -> bool
+                           {
+                             auto const& left  = requests[lhs];
+                             auto const& right = requests[rhs];
+                             if (left.options_.memory_class_ != right.options_.memory_class_)
+                             {
+                               return left.options_.memory_class_ < right.options_.memory_class_;
+                             }
+                             if (left.options_.alignment_ != right.options_.alignment_)
+                             {
+                               return left.options_.alignment_ > right.options_.alignment_;
+                             }
+                             return left.size_ > right.size_;
+                           });
+  return order;
 }
 
 auto gpu_allocator::prepare_deallocate(allocation_id id) -> bool
@@ -281,18 +462,84 @@ auto gpu_allocator::prepare_deallocate(allocation_id id) -> bool
   return true;
 }
 
-auto gpu_allocator::measure_arena(uint16_t arena) const -> arena_usage
+auto gpu_allocator::index_allocations(scratch_allocator_ref scratch) const -> arena_index
 {
-  arena_usage usage;
+  // Counting sort of the live ids by arena; ids stay ascending within an arena
+  arena_index index{.first_ = ouly::scratch_vector<uint32_t>{scratch, arena_pool_.size() + 1},
+                    .ids_   = ouly::scratch_vector<uint32_t>{scratch}};
+  for (size_t arena = 0; arena <= arena_pool_.size(); ++arena)
+  {
+    index.first_.push_back(0);
+  }
+  uint32_t live = 0;
   for (uint32_t id = 1; id < static_cast<uint32_t>(entry_live_.size()); ++id)
   {
-    if (ouly::detail::vector_access(entry_live_, id) && ouly::detail::vector_access(entry_arenas_, id) == arena)
+    if (ouly::detail::vector_access(entry_live_, id))
+    {
+      ++index.first_[ouly::detail::vector_access(entry_arenas_, id) + size_t{1}];
+      ++live;
+    }
+  }
+  for (size_t arena = 1; arena <= arena_pool_.size(); ++arena)
+  {
+    index.first_[arena] += index.first_[arena - 1];
+  }
+
+  index.ids_.reserve(live);
+  for (uint32_t i = 0; i < live; ++i)
+  {
+    index.ids_.push_back(0);
+  }
+  ouly::scratch_vector<uint32_t> cursor{scratch, arena_pool_.size()};
+  for (size_t arena = 0; arena < arena_pool_.size(); ++arena)
+  {
+    cursor.push_back(index.first_[arena]);
+  }
+  for (uint32_t id = 1; id < static_cast<uint32_t>(entry_live_.size()); ++id)
+  {
+    if (ouly::detail::vector_access(entry_live_, id))
     {
-      usage.live_ += ouly::detail::vector_access(entry_sizes_, id);
-      ++usage.count_;
-      usage.pinned_ = usage.pinned_ || !ouly::detail::vector_access(entry_movable_, id);
+      index.ids_[cursor[ouly::detail::vector_access(entry_arenas_, id)]++] = id;
     }
   }
+  return index;
+}
+
+auto gpu_allocator::rank_candidates(arena_index const& index, scratch_allocator_ref scratch) const
+ -> ouly::scratch_vector<evacuation_candidate>
+{
+  ouly::scratch_vector<evacuation_candidate> candidates{scratch, arena_order_.size()};
+  for (auto arena : arena_order_)
+  {
+    if (!can_evacuate(arena))
+    {
+      continue;
+    }
+
+    auto const usage = measure_arena(arena, index);
+    if (!usage.pinned_)
+    {
+      candidates.push_back({.arena_    = arena,
+                            .capacity_ = ouly::detail::vector_access(arena_pool_, arena).capacity_,
+                            .live_     = usage.live_,
+                            .count_    = usage.count_});
+    }
+  }
+
+  std::ranges::sort(candidates, &gpu_allocator::recovers_more);
+  return candidates;
+}
+
+auto gpu_allocator::measure_arena(uint16_t arena, arena_index const& index) const -> arena_usage
+{
+  arena_usage usage;
+  for (auto i = index.first_[arena], end = index.first_[arena + size_t{1}]; i < end; ++i)
+  {
+    auto const id = index.ids_[i];
+    usage.live_ += ouly::detail::vector_access(entry_sizes_, id);
+    ++usage.count_;
+    usage.pinned_ = usage.pinned_ || !ouly::detail::vector_access(entry_movable_, id);
+  }
   return usage;
 }
 
@@ -348,65 +595,21 @@ auto gpu_allocator::reserve_plan(evacuation_target& plan) -> bool
   return false;
 }
 
-void gpu_allocator::begin_evacuation(uint32_t max_blocks_scanned, scratch_allocator_ref scratch)
-{
-  ouly::scratch_vector<evacuation_candidate> candidates{scratch, arena_order_.size()};
-  for (auto arena : arena_order_)
-  {
-    if (!can_evacuate(arena))
-    {
-      continue;
-    }
-
-    auto const usage = measure_arena(arena);
-    if (!usage.pinned_)
-    {
-      candidates.push_back({.arena_    = arena,
-                            .capacity_ = ouly::detail::vector_access(arena_pool_, arena).capacity_,
-                            .live_     = usage.live_,
-                            .count_    = usage.count_});
-    }
-  }
-
-  std::ranges::sort(candidates, &gpu_allocator::recovers_more);
-
-  uint32_t scanned = 0;
-  for (auto const& candidate : candidates)
-  {
-    if (scanned >= max_blocks_scanned)
-    {
-      break;
-    }
-    ++scanned;
-
-    auto plan = simulate_evacuation(candidate.arena_, scratch);
-    if (!plan || !reserve_plan(*plan))
-    {
-      continue;
-    }
-
-    ouly::detail::vector_access(arena_pool_, candidate.arena_).role_ = arena_role::evacuation_source;
-    target_                                                          = std::move(*plan);
-    return;
-  }
-}
-
-auto gpu_allocator::simulate_evacuation(uint16_t source, scratch_allocator_ref scratch) const
- -> std::optional<evacuation_target>
+auto gpu_allocator::simulate_evacuation(uint16_t source, arena_index const& index,
+                                        scratch_allocator_ref scratch) const -> std::optional<evacuation_target>
 {
   evacuation_target plan{.source_arena_ = source, .moves_ = {}, .aborted_ = false};
-  for (uint32_t id = 1; id < static_cast<uint32_t>(entry_live_.size()); ++id)
+  plan.moves_.reserve(index.first_[source + size_t{1}] - index.first_[source]);
+  for (auto i = index.first_[source], end = index.first_[source + size_t{1}]; i < end; ++i)
   {
-    if (ouly::detail::vector_access(entry_live_, id) && ouly::detail::vector_access(entry_arenas_, id) == source)
-    {
-      plan.moves_.push_back({.move_               = gpu_move_id{},
-                             .allocation_         = allocation_id{id},
-                             .source_arena_       = source,
-                             .destination_arena_  = 0,
-                             .source_offset_      = ouly::detail::vector_access(entry_offsets_, id),
-                             .destination_offset_ = 0,
-                             .size_               = ouly::detail::vector_access(entry_sizes_, id)});
-    }
+    auto const id = index.ids_[i];
+    plan.moves_.push_back({.move_               = gpu_move_id{},
+                           .allocation_         = allocation_id{id},
+                           .source_arena_       = source,
+                           .destination_arena_  = 0,
+                           .source_offset_      = ouly::detail::vector_access(entry_offsets_, id),
+                           .destination_offset_ = 0,
+                           .size_               = ouly::detail::vector_access(entry_sizes_, id)});
   }
 
   std::ranges::sort(plan.moves_,
@@ -439,11 +642,13 @@ auto gpu_allocator::collect_destinations(uint16_t source, size_t move_count, scr
  -> ouly::scratch_vector<gpu_allocator::simulated_arena>
 {
   ouly::scratch_vector<simulated_arena> destinations{scratch, arena_order_.size()};
-  auto const                            memory_class = ouly::detail::vector_access(arena_pool_, source).memory_class_;
+  auto const&                           origin = ouly::detail::vector_access(arena_pool_, source);
   for (auto arena : arena_order_)
   {
+    // Moves stay among arenas of the source's lifetime, or evacuation would undo the segregation
     auto const& state = ouly::detail::vector_access(arena_pool_, arena);
-    if (arena == source || state.role_ != arena_role::normal || state.dedicated_ || state.memory_class_ != memory_class)
+    if (arena == source || state.role_ != arena_role::normal || state.dedicated_ ||
+        state.memory_class_ != origin.memory_class_ || state.lifetime_ != origin.lifetime_)
     {
       continue;
     }
@@ -539,6 +744,17 @@ auto gpu_allocator::reserve_range(uint16_t arena, size_type offset, size_type si
     }
     state.free_ -= size;
     ++state.reservations_;
+    class_budget(state.memory_class_).bytes_free_ -= size;
+    if (range.size_ == state.largest_free_)
+    {
+      auto const previous = state.largest_free_;
+      state.largest_free_ = 0;
+      for (auto const& remaining : state.free_ranges_)
+      {
+        state.largest_free_ = std::max(state.largest_free_, remaining.size_);
+      }
+      update_largest_free(arena, previous);
+    }
     return true;
   }
   return false;
@@ -562,19 +778,23 @@ void gpu_allocator::free_range_in_arena(uint16_t arena, size_type offset, size_t
    index != 0 && state.free_ranges_[index - 1].offset_ + state.free_ranges_[index - 1].size_ == offset;
   bool const merge_right = index != state.free_ranges_.size() && offset + size == state.free_ranges_[index].offset_;
 
+  size_type merged = size;
   if (merge_left && merge_right)
   {
     state.free_ranges_[index - 1].size_ += size + state.free_ranges_[index].size_;
+    merged = state.free_ranges_[index - 1].size_;
     state.free_ranges_.erase(state.free_ranges_.begin() + static_cast<std::ptrdiff_t>(index));
   }
   else if (merge_left)
   {
     state.free_ranges_[index - 1].size_ += size;
+    merged = state.free_ranges_[index - 1].size_;
   }
   else if (merge_right)
   {
     state.free_ranges_[index].offset_ = offset;
     state.free_ranges_[index].size_ += size;
+    merged = state.free_ranges_[index].size_;
   }
   else
   {
@@ -582,6 +802,13 @@ void gpu_allocator::free_range_in_arena(uint16_t arena, size_type offset, size_t
                               {.offset_ = offset, .size_ = size});
   }
   state.free_ += size;
+  class_budget(state.memory_class_).bytes_free_ += size;
+  if (merged > state.largest_free_)
+  {
+    auto const previous = state.largest_free_;
+    state.largest_free_ = merged;
+    update_largest_free(arena, previous);
+  }
 }
 
 void gpu_allocator::cancel_move(planned_move& move)
@@ -693,12 +920,23 @@ auto gpu_allocator::drop_arena(uint16_t arena) -> size_type
 {
   auto& state = ouly::detail::vector_access(arena_pool_, arena);
   OULY_ASSERT(can_release_arena(arena));
-  auto const capacity = state.capacity_;
-  auto       position = std::ranges::find(arena_order_, arena);
+  auto const capacity     = state.capacity_;
+  auto const memory_class = state.memory_class_;
+  auto const largest      = state.largest_free_;
+  auto       position     = std::ranges::find(arena_order_, arena);
   OULY_ASSERT(position != arena_order_.end());
   arena_order_.erase(position);
   state = {};
   free_arenas_.push_back(arena);
+
+  auto& budget = class_budget(memory_class);
+  --budget.arena_count_;
+  budget.bytes_reserved_ -= capacity;
+  budget.bytes_free_ -= capacity;
+  if (largest == budget.largest_free_block_)
+  {
+    refresh_largest_free(memory_class);
+  }
   return capacity;
 }
 
@@ -731,6 +969,109 @@ auto gpu_allocator::statistics() const noexcept -> gpu_defrag_statistics
   return result;
 }
 
+auto gpu_allocator::memory_class_budget(uint32_t memory_class) const noexcept -> gpu_memory_class_budget
+{
+  return memory_class < budgets_.size() ? ouly::detail::vector_access(budgets_, memory_class)
+                                        : gpu_memory_class_budget{};
+}
+
+void gpu_allocator::set_soft_limit(uint32_t memory_class, uint64_t bytes)
+{
+  class_budget(memory_class).soft_limit_ = bytes;
+}
+
+auto gpu_allocator::lifetime_usage(allocation_lifetime lifetime) const noexcept -> gpu_lifetime_usage
+{
+  gpu_lifetime_usage usage;
+  for (auto arena : arena_order_)
+  {
+    auto const& state = ouly::detail::vector_access(arena_pool_, arena);
+    if (state.lifetime_ != lifetime)
+    {
+      continue;
+    }
+    ++usage.arena_count_;
+    usage.allocation_count_ += state.allocations_;
+    usage.bytes_reserved_ += state.capacity_;
+    usage.bytes_free_ += state.free_;
+    usage.largest_free_block_ = std::max(usage.largest_free_block_, state.largest_free_);
+  }
+  return usage;
+}
+
+auto gpu_allocator::snapshot() const -> heap_snapshot
+{
+  heap_snapshot result;
+  result.arenas_.reserve(arena_order_.size());
+
+  std::vector<size_t> slots(arena_pool_.size(), 0);
+  for (auto arena : arena_order_)
+  {
+    auto const& state                         = ouly::detail::vector_access(arena_pool_, arena);
+    ouly::detail::vector_access(slots, arena) = result.arenas_.size();
+    result.arenas_.push_back({.capacity_     = state.capacity_,
+                              .memory_class_ = state.memory_class_,
+                              .arena_        = arena,
+                              .dedicated_    = state.dedicated_,
+                              .blocks_       = {}});
+    auto& blocks = result.arenas_.back().blocks_;
+    blocks.reserve(state.free_ranges_.size() + state.allocations_);
+    for (auto const& range : state.free_ranges_)
+    {
+      blocks.push_back({.offset_ = range.offset_, .size_ = range.size_, .lifetime_ = state.lifetime_});
+    }
+  }
+
+  for (uint32_t id = 1; id < entry_live_.size(); ++id)
+  {
+    if (!entry_live_[id])
+    {
+      continue;
+    }
+    auto const arena = ouly::detail::vector_access(entry_arenas_, id);
+    auto&      entry = ouly::detail::vector_access(result.arenas_, ouly::detail::vector_access(slots, arena));
+    entry.blocks_.push_back({.offset_         = ouly::detail::vector_access(entry_offsets_, id),
+                             .size_           = ouly::detail::vector_access(entry_sizes_, id),
+                             .resource_class_ = ouly::detail::vector_access(entry_resource_classes_, id),
+                             .state_          = heap_block_state::used,
+                             .lifetime_       = ouly::detail::vector_access(arena_pool_, arena).lifetime_,
+                             .movable_        = entry_movable_[id]});
+  }
+
+  // Whatever neither a free range nor a live allocation covers belongs to a relocation in progress
+  for (auto& arena : result.arenas_)
+  {
+    std::ranges::sort(arena.blocks_, {}, &heap_snapshot_block::offset_);
+    auto const lifetime = ouly::detail::vector_access(arena_pool_, arena.arena_).lifetime_;
+    size_type  cursor   = 0;
+    auto const count    = arena.blocks_.size();
+    for (size_t index = 0; index < count; ++index)
+    {
+      auto const block = ouly::detail::vector_access(arena.blocks_, index);
+      if (block.offset_ > cursor)
+      {
+        arena.blocks_.push_back({.offset_   = cursor,
+                                 .size_     = block.offset_ - cursor,
+                                 .state_    = heap_block_state::in_flight,
+                                 .lifetime_ = lifetime});
+      }
+      cursor = block.offset_ + block.size_;
+    }
+    if (cursor < arena.capacity_)
+    {
+      arena.blocks_.push_back({.offset_   = cursor,
+                               .size_     = arena.capacity_ - cursor,
+                               .state_    = heap_block_state::in_flight,
+                               .lifetime_ = lifetime});
+    }
+    if (arena.blocks_.size() != count)
+    {
+      std::ranges::sort(arena.blocks_, {}, &heap_snapshot_block::offset_);
+    }
+  }
+  return result;
+}
+
 // NOLINTNEXTLINE
 void gpu_allocator::validate_integrity() const
 {
@@ -745,6 +1086,8 @@ void gpu_allocator::validate_integrity() const
   std::vector<uint32_t>                    reservations(arena_pool_.size(), 0);
   std::vector<uint32_t>                    retiring(arena_pool_.size(), 0);
 
+  std::vector<gpu_memory_class_budget> budgets(budgets_.size());
+
   for (uint32_t id = 1; id < static_cast<uint32_t>(entry_live_.size()); ++id)
   {
     if (ouly::detail::vector_access(entry_live_, id))
@@ -753,6 +1096,10 @@ void gpu_allocator::validate_integrity() const
       occupied[arena].push_back({.offset_ = ouly::detail::vector_access(entry_offsets_, id),
                                  .size_   = ouly::detail::vector_access(entry_sizes_, id)});
       ++allocations[arena];
+
+      auto& budget = budgets[ouly::detail::vector_access(arena_pool_, arena).memory_class_];
+      budget.bytes_used_ += ouly::detail::vector_access(entry_sizes_, id);
+      ++budget.allocation_count_;
     }
   }
 
@@ -784,6 +1131,24 @@ void gpu_allocator::validate_integrity() const
     OULY_ASSERT(state.retiring_ == retiring[arena]);
 
     validate_arena_layout(occupied[arena], state);
+
+    auto& budget = budgets[state.memory_class_];
+    ++budget.arena_count_;
+    budget.bytes_reserved_ += state.capacity_;
+    budget.bytes_free_ += state.free_;
+    budget.largest_free_block_ = std::max(budget.largest_free_block_, state.largest_free_);
+  }
+
+  for (size_t memory_class = 0; memory_class < budgets.size(); ++memory_class)
+  {
+    [[maybe_unused]] auto const& expected = budgets[memory_class];
+    [[maybe_unused]] auto const& tracked  = ouly::detail::vector_access(budgets_, memory_class);
+    OULY_ASSERT(tracked.arena_count_ == expected.arena_count_);
+    OULY_ASSERT(tracked.allocation_count_ == expected.allocation_count_);
+    OULY_ASSERT(tracked.bytes_reserved_ == expected.bytes_reserved_);
+    OULY_ASSERT(tracked.bytes_used_ == expected.bytes_used_);
+    OULY_ASSERT(tracked.bytes_free_ == expected.bytes_free_);
+    OULY_ASSERT(tracked.largest_free_block_ == expected.largest_free_block_);
   }
 
   for (size_t arena = 1; arena < arena_pool_.size(); ++arena)
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/allocators/heap_snapshot.hpp"
+#include <algorithm>
+
+namespace ouly
+{
+
+void heap_arena_summary::merge(heap_arena_summary const& other) noexcept
+{
+  capacity_ += other.capacity_;
+  bytes_used_ += other.bytes_used_;
+  bytes_free_ += other.bytes_free_;
+  bytes_in_flight_ += other.bytes_in_flight_;
+  largest_free_block_ = std::max(largest_free_block_, other.largest_free_block_);
+  used_blocks_ += other.used_blocks_;
+  free_blocks_ += other.free_blocks_;
+}
+
+auto summarize(heap_snapshot_arena const& arena) noexcept -> heap_arena_summary
+{
+  heap_arena_summary summary;
+  summary.capacity_ = arena.capacity_;
+  for (auto const& block : arena.blocks_)
+  {
+    switch (block.state_)
+    {
+    case heap_block_state::free:
+      summary.bytes_free_ += block.size_;
+      summary.largest_free_block_ = std::max(summary.largest_free_block_, block.size_);
+      ++summary.free_blocks_;
+      break;
+    case heap_block_state::used:
+      summary.bytes_used_ += block.size_;
+      ++summary.used_blocks_;
+      break;
+    case heap_block_state::in_flight:
+      summary.bytes_in_flight_ += block.size_;
+      break;
+    default:
+      break;
+    }
+  }
+  return summary;
+}
+
+auto summarize(heap_snapshot const& snapshot) noexcept -> heap_arena_summary
+{
+  heap_arena_summary summary;
+  for (auto const& arena : snapshot.arenas_)
+  {
+    summary.merge(summarize(arena));
+  }
+  return summary;
+}
+
+} // namespace ouly
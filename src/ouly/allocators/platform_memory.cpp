@@ -2,6 +2,8 @@
 
 #include "ouly/allocators/detail/platform_memory.hpp"
 #include <algorithm>
+#include <array>
+#include <cstdio>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -113,10 +115,125 @@ inline static auto advice_to_posix(cfg::advice advice_type) noexcept -> int
     return MADV_WILLNEED;
   case cfg::advice::dont_need:
     return MADV_DONTNEED;
+  case cfg::advice::huge_page:
+#ifdef MADV_HUGEPAGE
+    return MADV_HUGEPAGE;
+#else
+    return MADV_NORMAL;
+#endif
   default:
     return MADV_NORMAL;
   }
 }
+
+// Default huge page size as reported by the kernel, e.g. "Hugepagesize:    2048 kB"
+inline static auto query_huge_page_size() noexcept -> std::size_t
+{
+#ifdef __linux__
+  constexpr std::size_t kib  = 1024;
+  std::FILE*            file = std::fopen("/proc/meminfo", "r"); // NOLINT(cppcoreguidelines-owning-memory)
+  if (file == nullptr)
+  {
+    return 0;
+  }
+  std::size_t result = 0;
+  std::array<char, 256> line{};
+  while (std::fgets(line.data(), static_cast<int>(line.size()), file) != nullptr)
+  {
+    std::size_t size_kib = 0;
+    // NOLINTNEXTLINE(cert-err34-c)
+    if (std::sscanf(line.data(), "Hugepagesize: %zu kB", &size_kib) == 1)
+    {
+      result = size_kib * kib;
+      break;
+    }
+  }
+  std::fclose(file); // NOLINT(cppcoreguidelines-owning-memory)
+  return result;
+#else
+  return 0;
+#endif
+}
+
+inline static auto huge_page_size() noexcept -> std::size_t
+{
+  static std::size_t const size = query_huge_page_size();
+  return size;
+}
+
+/**
+ * Map anonymous pages with the requested backing. Reserved huge pages are tried first for `huge`,
+ * then a mapping aligned to the huge page size is advised with MADV_HUGEPAGE so the kernel can
+ * promote it. The result covers exactly [result, result + size) in every case, so callers unmap it
+ * with the size they asked for.
+ */
+inline static auto map_pages(std::size_t size, int posix_prot, void* preferred_address,
+                             cfg::page_backing backing) noexcept -> void*
+{
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (preferred_address != nullptr)
+  {
+    flags |= MAP_FIXED;
+  }
+
+  std::size_t const huge_size = huge_page_size();
+  if (backing == cfg::page_backing::normal || huge_size == 0 || size < huge_size)
+  {
+    void* result = mmap(preferred_address, size, posix_prot, flags, -1, 0);
+    return (result == MAP_FAILED) ? nullptr : result;
+  }
+
+#ifdef MAP_HUGETLB
+  if (backing == cfg::page_backing::huge && (size % huge_size) == 0)
+  {
+    void* result = mmap(preferred_address, size, posix_prot, flags | MAP_HUGETLB, -1, 0);
+    if (result != MAP_FAILED)
+    {
+      return result;
+    }
+    // The huge page pool is empty or not configured: continue with transparent huge pages
+  }
+#endif
+
+  void* result = nullptr;
+  if (preferred_address != nullptr)
+  {
+    result = mmap(preferred_address, size, posix_prot, flags, -1, 0);
+    if (result == MAP_FAILED)
+    {
+      return nullptr;
+    }
+  }
+  else
+  {
+    // Over-map by one huge page and trim both ends so the region starts on a huge page boundary
+    std::size_t const padded = size + huge_size;
+    void*             raw    = mmap(nullptr, padded, posix_prot, flags, -1, 0);
+    if (raw == MAP_FAILED)
+    {
+      return nullptr;
+    }
+    auto const base    = reinterpret_cast<std::uintptr_t>(raw); // NOLINT(performance-no-int-to-ptr)
+    auto const aligned = (base + huge_size - 1) & ~(huge_size - 1);
+    auto const head    = aligned - base;
+    auto const tail    = padded - head - size;
+    if (head != 0)
+    {
+      munmap(raw, head);
+    }
+    result = reinterpret_cast<void*>(aligned); // NOLINT(performance-no-int-to-ptr)
+    if (tail != 0)
+    {
+      munmap(static_cast<std::byte*>(result) + size, tail);
+    }
+  }
+
+#ifdef MADV_HUGEPAGE
+  // Advisory only: the mapping stays valid on normal pages when THP is disabled
+  madvise(result, size, MADV_HUGEPAGE);
+#endif
+  return result;
+}
 #endif
 auto get_memory_info() noexcept -> memory_info
 {
@@ -127,30 +244,39 @@ auto get_memory_info() noexcept -> memory_info
   GetSystemInfo(&sys_info);
   info.page_size_              = sys_info.dwPageSize;
   info.allocation_granularity_ = sys_info.dwAllocationGranularity;
+  info.huge_page_size_         = GetLargePageMinimum();
 #else
   info.page_size_              = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
   info.allocation_granularity_ = info.page_size_; // On Unix, allocation granularity == page size
+  info.huge_page_size_         = huge_page_size();
 #endif
 
   return info;
 }
 
-auto virtual_alloc(std::size_t size, cfg::protection prot, void* preferred_address) noexcept -> void*
+auto virtual_alloc(std::size_t size, cfg::protection prot, void* preferred_address,
+                   cfg::page_backing backing) noexcept -> void*
 {
 #ifdef _WIN32
   DWORD allocation_type = MEM_COMMIT | MEM_RESERVE;
   DWORD protect         = protection_to_win32(prot);
-  return VirtualAlloc(preferred_address, size, allocation_type, protect);
-#else
-  int posix_prot = protection_to_posix(prot);
-  int flags      = MAP_PRIVATE | MAP_ANONYMOUS;
-  if (preferred_address != nullptr)
+  if (backing == cfg::page_backing::huge)
   {
-    flags |= MAP_FIXED;
+    // Large pages need SeLockMemoryPrivilege; without it VirtualAlloc fails and we use normal pages.
+    // Windows has no transparent huge pages, so transparent_huge maps normal pages.
+    SIZE_T large_page = GetLargePageMinimum();
+    if (large_page != 0 && (size % large_page) == 0)
+    {
+      void* result = VirtualAlloc(preferred_address, size, allocation_type | MEM_LARGE_PAGES, protect);
+      if (result != nullptr)
+      {
+        return result;
+      }
+    }
   }
-
-  void* result = mmap(preferred_address, size, posix_prot, flags, -1, 0);
-  return (result == MAP_FAILED) ? nullptr : result;
+  return VirtualAlloc(preferred_address, size, allocation_type, protect);
+#else
+  return map_pages(size, protection_to_posix(prot), preferred_address, backing);
 #endif
 }
 
@@ -169,6 +295,50 @@ auto virtual_free(void* ptr, std::size_t size) noexcept -> bool
 #endif
 }
 
+auto virtual_reserve(std::size_t size) noexcept -> void*
+{
+#ifdef _WIN32
+  return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+  // PROT_NONE with MAP_NORESERVE takes address space only; no swap or overcommit accounting
+  void* result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  return (result == MAP_FAILED) ? nullptr : result;
+#endif
+}
+
+auto virtual_commit(void* ptr, std::size_t size, cfg::protection prot) noexcept -> bool
+{
+  if (ptr == nullptr)
+  {
+    return false;
+  }
+
+#ifdef _WIN32
+  return VirtualAlloc(ptr, size, MEM_COMMIT, protection_to_win32(prot)) != nullptr;
+#else
+  // Map fresh pages over the reservation without MAP_NORESERVE: the kernel charges them against the commit
+  // limit here, so a strict overcommit policy refuses the commit instead of faulting on first touch
+  void* result = mmap(ptr, size, protection_to_posix(prot), MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  return result != MAP_FAILED;
+#endif
+}
+
+auto virtual_decommit(void* ptr, std::size_t size) noexcept -> bool
+{
+  if (ptr == nullptr)
+  {
+    return false;
+  }
+
+#ifdef _WIN32
+  return VirtualFree(ptr, size, MEM_DECOMMIT) != FALSE;
+#else
+  // Replacing the pages with a PROT_NONE, MAP_NORESERVE mapping drops them and their commit charge together
+  void* result = mmap(ptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+  return result != MAP_FAILED;
+#endif
+}
+
 auto virtual_protect(void* ptr, std::size_t size, cfg::protection new_prot) noexcept -> bool
 {
   if (ptr == nullptr)
@@ -294,21 +464,14 @@ auto map_file(std::filesystem::path const& filename, std::size_t size, cfg::prot
 #endif
 }
 
-auto map_anonymous(std::size_t size, cfg::protection prot, void* preferred_address) noexcept -> void*
+auto map_anonymous(std::size_t size, cfg::protection prot, void* preferred_address,
+                   cfg::page_backing backing) noexcept -> void*
 {
 #ifdef _WIN32
   (void)preferred_address; // Not directly supported
-  return virtual_alloc(size, prot, preferred_address);
+  return virtual_alloc(size, prot, preferred_address, backing);
 #else
-  int posix_prot = protection_to_posix(prot);
-  int flags      = MAP_PRIVATE | MAP_ANONYMOUS;
-  if (preferred_address != nullptr)
-  {
-    flags |= MAP_FIXED;
-  }
-
-  void* result = mmap(preferred_address, size, posix_prot, flags, -1, 0);
-  return (result == MAP_FAILED) ? nullptr : result;
+  return map_pages(size, protection_to_posix(prot), preferred_address, backing);
 #endif
 }
 
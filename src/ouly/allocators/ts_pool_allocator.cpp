@@ -0,0 +1,249 @@
+#include "ouly/allocators/ts_pool_allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace ouly
+{
+
+/**
+ * Magazine header, followed by `magazine_size_` slot pointers. `next_` links the magazine into a
+ * depot stack; it is atomic because a thread may read it through a stale head while the owner of
+ * the magazine pushes it somewhere else.
+ */
+struct ts_pool_allocator::magazine
+{
+  std::atomic<magazine*> next_{nullptr};
+  uint32_t               count_ = 0;
+
+  auto slots() noexcept -> void**
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<void**>(this + 1);
+  }
+};
+
+struct ts_pool_allocator::thread_cache
+{
+  magazine* loaded_   = nullptr; ///< Magazine allocate() pops from and deallocate() pushes onto
+  magazine* previous_ = nullptr; ///< Either empty or full, swapped in before visiting the depot
+};
+
+// NOLINTNEXTLINE
+thread_local detail::thread_cache_list<ts_pool_allocator, ts_pool_allocator::thread_cache> local_pool_caches;
+
+ts_pool_allocator::ts_pool_allocator(std::size_t slot_size, std::size_t slot_alignment, uint32_t magazine_size)
+    : alignment_(std::max(slot_alignment, alignof(void*))), magazine_size_(std::max(magazine_size, 1U))
+{
+  OULY_ASSERT(std::has_single_bit(slot_alignment));
+  stride_         = (std::max(slot_size, sizeof(void*)) + alignment_ - 1) & ~(alignment_ - 1);
+  slots_per_page_ = std::size_t{magazine_size_} * magazines_per_page;
+  id_             = detail::thread_cache_registry::get().add();
+}
+
+ts_pool_allocator::~ts_pool_allocator() noexcept
+{
+  detail::thread_cache_registry::get().remove(id_);
+
+  for (auto* page : pages_)
+  {
+    ::operator delete(page, std::align_val_t{alignment_});
+  }
+  for (auto* mag : magazines_)
+  {
+    mag->~magazine();
+    ::operator delete(static_cast<void*>(mag));
+  }
+  for (auto* cache : caches_)
+  {
+    delete cache;
+  }
+}
+
+auto ts_pool_allocator::lookup_cache(uint64_t id) noexcept -> thread_cache*
+{
+  return local_pool_caches.find(id);
+}
+
+auto ts_pool_allocator::local_cache() -> thread_cache*
+{
+  auto* cache = lookup_cache(id_);
+  return cache != nullptr ? cache : create_cache();
+}
+
+auto ts_pool_allocator::create_cache() -> thread_cache*
+{
+  thread_cache* cache = nullptr;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!idle_caches_.empty())
+    {
+      cache = idle_caches_.back();
+      idle_caches_.pop_back();
+    }
+    else
+    {
+      cache = new thread_cache();
+      caches_.push_back(cache);
+    }
+  }
+
+  auto take_empty = [this]() -> magazine*
+  {
+    auto* mag = pop(empty_);
+    return mag != nullptr ? mag : new_magazine();
+  };
+  cache->loaded_   = take_empty();
+  cache->previous_ = take_empty();
+
+  local_pool_caches.insert(id_, this, cache);
+  return cache;
+}
+
+auto ts_pool_allocator::allocate() -> void*
+{
+  auto* cache = local_cache();
+  auto* mag   = cache->loaded_;
+  if (mag->count_ > 0) [[likely]]
+  {
+    return mag->slots()[--mag->count_];
+  }
+  return refill(*cache);
+}
+
+void ts_pool_allocator::deallocate(void* ptr)
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+
+  auto* cache = local_cache();
+  auto* mag   = cache->loaded_;
+  if (mag->count_ < magazine_size_) [[likely]]
+  {
+    mag->slots()[mag->count_++] = ptr;
+    return;
+  }
+  spill(*cache, ptr);
+}
+
+auto ts_pool_allocator::refill(thread_cache& cache) -> void*
+{
+  if (cache.previous_->count_ == 0)
+  {
+    // Both magazines are empty: trade one for a full magazine from the depot
+    auto* full = pop(full_);
+    if (full == nullptr)
+    {
+      full = carve();
+    }
+    push(empty_, cache.previous_);
+    cache.previous_ = full;
+  }
+
+  std::swap(cache.loaded_, cache.previous_);
+  auto* mag = cache.loaded_;
+  return mag->slots()[--mag->count_];
+}
+
+void ts_pool_allocator::spill(thread_cache& cache, void* ptr)
+{
+  if (cache.previous_->count_ == magazine_size_)
+  {
+    // Both magazines are full: hand one to the depot and continue with an empty one
+    auto* empty = pop(empty_);
+    if (empty == nullptr)
+    {
+      empty = new_magazine();
+    }
+    push(full_, cache.previous_);
+    cache.previous_ = empty;
+  }
+
+  std::swap(cache.loaded_, cache.previous_);
+  auto* mag                   = cache.loaded_;
+  mag->slots()[mag->count_++] = ptr;
+}
+
+auto ts_pool_allocator::carve() -> magazine*
+{
+  auto* mag = pop(empty_);
+  if (mag == nullptr)
+  {
+    mag = new_magazine();
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto* const                 slots = mag->slots();
+  while (mag->count_ < magazine_size_)
+  {
+    if (cursor_ == end_)
+    {
+      auto const bytes = slots_per_page_ * stride_;
+      auto*      page  = static_cast<std::byte*>(::operator new(bytes, std::align_val_t{alignment_}));
+      pages_.push_back(page);
+      page_count_.fetch_add(1, std::memory_order_relaxed);
+      cursor_ = page;
+      end_    = page + bytes;
+    }
+    slots[mag->count_++] = cursor_;
+    cursor_ += stride_;
+  }
+  return mag;
+}
+
+auto ts_pool_allocator::new_magazine() -> magazine*
+{
+  void* raw = ::operator new(sizeof(magazine) + (std::size_t{magazine_size_} * sizeof(void*)));
+  auto* mag = ::new (raw) magazine();
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  magazines_.push_back(mag);
+  return mag;
+}
+
+void ts_pool_allocator::abandon(thread_cache* cache) noexcept
+{
+  for (auto* mag : {cache->loaded_, cache->previous_})
+  {
+    push(mag->count_ > 0 ? full_ : empty_, mag);
+  }
+  cache->loaded_   = nullptr;
+  cache->previous_ = nullptr;
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  idle_caches_.push_back(cache);
+}
+
+void ts_pool_allocator::push(magazine_stack& stack, magazine* mag) noexcept
+{
+  auto                       head = stack.load(std::memory_order_relaxed);
+  ouly::tagged_ptr<magazine> next;
+  do
+  {
+    mag->next_.store(head.get_ptr(), std::memory_order_relaxed);
+    next = ouly::tagged_ptr<magazine>(mag, head.get_next_tag());
+  }
+  while (!stack.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+auto ts_pool_allocator::pop(magazine_stack& stack) noexcept -> magazine*
+{
+  auto head = stack.load(std::memory_order_acquire);
+  while (head.get_ptr() != nullptr)
+  {
+    // The tag changes with every push and pop, so a head that was popped and pushed back
+    // between the load and the exchange fails the comparison
+    ouly::tagged_ptr<magazine> next(head.get_ptr()->next_.load(std::memory_order_relaxed), head.get_next_tag());
+    if (stack.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+    {
+      return head.get_ptr();
+    }
+  }
+  return nullptr;
+}
+
+} // namespace ouly
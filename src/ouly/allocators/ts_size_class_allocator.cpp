@@ -0,0 +1,524 @@
+#include "ouly/allocators/ts_size_class_allocator.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace ouly
+{
+
+static_assert(ts_size_class_allocator::size_of_class(ts_size_class_allocator::num_size_classes - 1) ==
+               ts_size_class_allocator::max_small_size,
+              "Size classes must end at max_small_size");
+static_assert(ts_size_class_allocator::size_class_of(ts_size_class_allocator::max_small_size) ==
+               ts_size_class_allocator::num_size_classes - 1,
+              "Size class lookup must map max_small_size to the last class");
+
+/**
+ * Slab header. The owner-only fields and the remote free list sit on different cache lines so
+ * remote frees do not bounce the owner's line.
+ */
+struct ts_size_class_allocator::slab_t
+{
+  static constexpr std::size_t line = 64;
+
+  std::atomic<thread_cache*> owner_{nullptr}; ///< Owning cache; nullptr while pooled or orphaned
+  void*                      free_       = nullptr;
+  slab_t*                    next_       = nullptr;
+  slab_t*                    prev_       = nullptr;
+  uint32_t                   size_class_ = 0;
+  uint32_t                   block_size_ = 0;
+  uint32_t                   capacity_   = 0; ///< Blocks that fit in the slab
+  uint32_t                   carved_     = 0; ///< Blocks handed out at least once; the rest are untouched
+  uint32_t                   used_       = 0; ///< Blocks allocated and not yet returned to free_
+
+  alignas(line) std::atomic<void*> remote_{nullptr}; ///< Blocks freed by other threads
+
+  [[nodiscard]] auto data() noexcept -> std::byte*
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<std::byte*>(this) + header_size();
+  }
+
+  static constexpr auto header_size() noexcept -> std::size_t
+  {
+    return (sizeof(slab_t) + alignment - 1) & ~(alignment - 1);
+  }
+
+  void format(uint32_t size_class) noexcept
+  {
+    size_class_ = size_class;
+    block_size_ = static_cast<uint32_t>(size_of_class(size_class));
+    capacity_   = static_cast<uint32_t>((slab_size - header_size()) / block_size_);
+    carved_     = 0;
+    used_       = 0;
+    free_       = nullptr;
+    next_       = nullptr;
+    prev_       = nullptr;
+  }
+
+  auto pop() noexcept -> void*
+  {
+    if (free_ != nullptr)
+    {
+      void* block = free_;
+      free_       = *static_cast<void**>(block);
+      ++used_;
+      return block;
+    }
+    if (carved_ < capacity_)
+    {
+      void* block = data() + (static_cast<std::size_t>(carved_++) * block_size_);
+      ++used_;
+      return block;
+    }
+    return nullptr;
+  }
+
+  void push(void* block) noexcept
+  {
+    *static_cast<void**>(block) = free_;
+    free_                       = block;
+    --used_;
+  }
+
+  // Move every remotely freed block to the local free list; true if any arrived
+  auto drain_remote() noexcept -> bool
+  {
+    if (remote_.load(std::memory_order_relaxed) == nullptr)
+    {
+      return false;
+    }
+    void* list = remote_.exchange(nullptr, std::memory_order_acquire);
+    while (list != nullptr)
+    {
+      void* next = *static_cast<void**>(list);
+      push(list);
+      list = next;
+    }
+    return true;
+  }
+
+  [[nodiscard]] auto has_space() const noexcept -> bool
+  {
+    return free_ != nullptr || carved_ < capacity_;
+  }
+};
+
+struct ts_size_class_allocator::thread_cache
+{
+  /** @brief Refills between sweeps that drain remote frees of every slab and return empty ones */
+  static constexpr uint32_t sweep_interval = 64;
+
+  struct bin
+  {
+    slab_t* current_ = nullptr; ///< Slab the fast path allocates from
+    slab_t* slabs_   = nullptr; ///< Every slab of this class owned by the cache, current_ included
+  };
+
+  std::array<bin, num_size_classes> bins_        = {};
+  slab_t*                           empty_       = nullptr;
+  uint32_t                          empty_count_ = 0;
+  uint32_t                          refills_     = 0;
+
+  void link(slab_t* slab) noexcept
+  {
+    auto& owned = bins_[slab->size_class_].slabs_;
+    slab->prev_ = nullptr;
+    slab->next_ = owned;
+    if (owned != nullptr)
+    {
+      owned->prev_ = slab;
+    }
+    owned = slab;
+  }
+
+  void unlink(slab_t* slab) noexcept
+  {
+    auto& target = bins_[slab->size_class_];
+    if (slab->prev_ != nullptr)
+    {
+      slab->prev_->next_ = slab->next_;
+    }
+    else
+    {
+      target.slabs_ = slab->next_;
+    }
+    if (slab->next_ != nullptr)
+    {
+      slab->next_->prev_ = slab->prev_;
+    }
+    if (target.current_ == slab)
+    {
+      target.current_ = nullptr;
+    }
+    slab->next_ = nullptr;
+    slab->prev_ = nullptr;
+  }
+};
+
+// NOLINTNEXTLINE
+thread_local detail::thread_cache_list<ts_size_class_allocator, ts_size_class_allocator::thread_cache> local_caches;
+
+ts_size_class_allocator::ts_size_class_allocator() : ts_size_class_allocator(default_retained_slabs) {}
+
+ts_size_class_allocator::ts_size_class_allocator(uint32_t retained_slabs)
+    : id_(detail::thread_cache_registry::get().add()), retained_slabs_(retained_slabs)
+{}
+
+ts_size_class_allocator::~ts_size_class_allocator() noexcept
+{
+  detail::thread_cache_registry::get().remove(id_);
+
+  auto free_list = [this](slab_t* slab)
+  {
+    while (slab != nullptr)
+    {
+      auto* next = slab->next_;
+      free_slab(slab);
+      slab = next;
+    }
+  };
+  for (auto* cache : caches_)
+  {
+    for (auto& target : cache->bins_)
+    {
+      free_list(target.slabs_);
+    }
+    free_list(cache->empty_);
+    delete cache;
+  }
+  for (auto* orphan : orphans_)
+  {
+    free_list(orphan);
+  }
+  free_list(empty_slabs_);
+}
+
+auto ts_size_class_allocator::lookup_cache(uint64_t id) noexcept -> thread_cache*
+{
+  return local_caches.find(id);
+}
+
+auto ts_size_class_allocator::local_cache() -> thread_cache*
+{
+  auto* cache = lookup_cache(id_);
+  return cache != nullptr ? cache : create_cache();
+}
+
+auto ts_size_class_allocator::create_cache() -> thread_cache*
+{
+  thread_cache* cache = nullptr;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!idle_caches_.empty())
+    {
+      cache = idle_caches_.back();
+      idle_caches_.pop_back();
+    }
+    else
+    {
+      cache = new thread_cache();
+      caches_.push_back(cache);
+    }
+  }
+  local_caches.insert(id_, this, cache);
+  return cache;
+}
+
+auto ts_size_class_allocator::allocate(std::size_t size) -> void*
+{
+  auto const size_class = size_class_of(size);
+  if (size_class == num_size_classes)
+  {
+    return ::operator new(size);
+  }
+
+  auto* cache = local_cache();
+  auto* slab  = cache->bins_[size_class].current_;
+  if (slab != nullptr)
+  {
+    if (void* block = slab->pop(); block != nullptr) [[likely]]
+    {
+      return block;
+    }
+  }
+  return refill(*cache, size_class);
+}
+
+void ts_size_class_allocator::deallocate(void* ptr, std::size_t size) noexcept
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+  if (size > max_small_size)
+  {
+    ::operator delete(ptr);
+    return;
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+  auto* slab  = reinterpret_cast<slab_t*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(slab_size - 1));
+  auto* cache = lookup_cache(id_);
+  // Only this thread can move ownership to or away from its own cache, so the check is stable
+  if (cache != nullptr && slab->owner_.load(std::memory_order_relaxed) == cache)
+  {
+    slab->push(ptr);
+    if (slab->used_ == 0 && cache->bins_[slab->size_class_].current_ != slab)
+    {
+      release_empty(*cache, slab);
+    }
+    return;
+  }
+
+  void* head = slab->remote_.load(std::memory_order_relaxed);
+  do
+  {
+    *static_cast<void**>(ptr) = head;
+  }
+  while (!slab->remote_.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+}
+
+auto ts_size_class_allocator::refill(thread_cache& cache, uint32_t size_class) -> void*
+{
+  if (++cache.refills_ % thread_cache::sweep_interval == 0)
+  {
+    collect(cache);
+  }
+
+  auto& target = cache.bins_[size_class];
+  if (target.current_ != nullptr && target.current_->drain_remote())
+  {
+    return target.current_->pop();
+  }
+
+  // Another owned slab may have space, either freed locally or by other threads
+  for (auto* slab = target.slabs_; slab != nullptr; slab = slab->next_)
+  {
+    if (slab != target.current_)
+    {
+      slab->drain_remote();
+      if (slab->has_space())
+      {
+        target.current_ = slab;
+        return slab->pop();
+      }
+    }
+  }
+
+  auto* slab = acquire_slab(cache, size_class);
+  cache.link(slab);
+  target.current_ = slab;
+  return slab->pop();
+}
+
+auto ts_size_class_allocator::acquire_slab(thread_cache& cache, uint32_t size_class) -> slab_t*
+{
+  slab_t* slab = nullptr;
+  if (cache.empty_ != nullptr)
+  {
+    slab         = cache.empty_;
+    cache.empty_ = slab->next_;
+    --cache.empty_count_;
+    slab->format(size_class);
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Adopt a slab left behind by an exited thread; its pending remote frees come along. Orphans that
+    // are still full stay where they are until enough of their blocks come back.
+    for (slab_t** link = &orphans_[size_class]; *link != nullptr; link = &(*link)->next_)
+    {
+      auto* orphan = *link;
+      orphan->drain_remote();
+      if (orphan->has_space())
+      {
+        *link         = orphan->next_;
+        orphan->next_ = nullptr;
+        orphan->owner_.store(&cache, std::memory_order_relaxed);
+        return orphan;
+      }
+    }
+    if (empty_slabs_ != nullptr)
+    {
+      slab         = empty_slabs_;
+      empty_slabs_ = slab->next_;
+      --empty_count_;
+      slab->format(size_class);
+    }
+  }
+
+  if (slab == nullptr)
+  {
+    slab = ::new (::operator new(slab_size, std::align_val_t{slab_size})) slab_t();
+    slab_count_.fetch_add(1, std::memory_order_relaxed);
+    slab->format(size_class);
+  }
+  slab->owner_.store(&cache, std::memory_order_relaxed);
+  return slab;
+}
+
+void ts_size_class_allocator::release_empty(thread_cache& cache, slab_t* slab) noexcept
+{
+  cache.unlink(slab);
+  slab->next_  = cache.empty_;
+  cache.empty_ = slab;
+  if (++cache.empty_count_ <= cached_empty_slabs)
+  {
+    return;
+  }
+
+  // Keep the most recently emptied slab warm and give the oldest back
+  slab_t* prev = nullptr;
+  slab_t* last = cache.empty_;
+  while (last->next_ != nullptr)
+  {
+    prev = last;
+    last = last->next_;
+  }
+  prev->next_ = nullptr;
+  --cache.empty_count_;
+  pool_slab(last);
+}
+
+void ts_size_class_allocator::collect(thread_cache& cache) noexcept
+{
+  for (auto& target : cache.bins_)
+  {
+    auto* slab = target.slabs_;
+    while (slab != nullptr)
+    {
+      auto* next = slab->next_;
+      slab->drain_remote();
+      if (slab->used_ == 0 && slab != target.current_)
+      {
+        release_empty(cache, slab);
+      }
+      slab = next;
+    }
+  }
+}
+
+void ts_size_class_allocator::pool_slab(slab_t* slab) noexcept
+{
+  slab->owner_.store(nullptr, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (empty_count_ < retained_slabs_)
+    {
+      slab->next_  = empty_slabs_;
+      empty_slabs_ = slab;
+      ++empty_count_;
+      return;
+    }
+  }
+  free_slab(slab);
+}
+
+void ts_size_class_allocator::free_slab(slab_t* slab) noexcept
+{
+  slab->~slab_t();
+  ::operator delete(static_cast<void*>(slab), std::align_val_t{slab_size});
+  slab_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ts_size_class_allocator::abandon(thread_cache* cache) noexcept
+{
+  std::vector<slab_t*> to_free;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto                        pool = [&](slab_t* slab)
+    {
+      slab->owner_.store(nullptr, std::memory_order_relaxed);
+      if (empty_count_ < retained_slabs_)
+      {
+        slab->next_  = empty_slabs_;
+        empty_slabs_ = slab;
+        ++empty_count_;
+      }
+      else
+      {
+        to_free.push_back(slab);
+      }
+    };
+
+    for (auto& target : cache->bins_)
+    {
+      auto* slab = target.slabs_;
+      while (slab != nullptr)
+      {
+        auto* next = slab->next_;
+        slab->drain_remote();
+        slab->prev_ = nullptr;
+        if (slab->used_ == 0)
+        {
+          pool(slab);
+        }
+        else
+        {
+          slab->owner_.store(nullptr, std::memory_order_relaxed);
+          slab->next_                 = orphans_[slab->size_class_];
+          orphans_[slab->size_class_] = slab;
+        }
+        slab = next;
+      }
+      target = {};
+    }
+    while (cache->empty_ != nullptr)
+    {
+      auto* slab    = cache->empty_;
+      cache->empty_ = slab->next_;
+      pool(slab);
+    }
+    cache->empty_count_ = 0;
+    cache->refills_     = 0;
+    idle_caches_.push_back(cache);
+  }
+  for (auto* slab : to_free)
+  {
+    free_slab(slab);
+  }
+}
+
+auto ts_size_class_allocator::trim() noexcept -> std::size_t
+{
+  slab_t* pooled = nullptr;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Orphans emptied by remote frees since their thread exited can go as well
+    for (auto& orphan_list : orphans_)
+    {
+      slab_t** link = &orphan_list;
+      while (*link != nullptr)
+      {
+        auto* slab = *link;
+        slab->drain_remote();
+        if (slab->used_ == 0)
+        {
+          *link        = slab->next_;
+          slab->next_  = empty_slabs_;
+          empty_slabs_ = slab;
+        }
+        else
+        {
+          link = &slab->next_;
+        }
+      }
+    }
+    pooled       = std::exchange(empty_slabs_, nullptr);
+    empty_count_ = 0;
+  }
+
+  std::size_t freed = 0;
+  while (pooled != nullptr)
+  {
+    auto* next = pooled->next_;
+    free_slab(pooled);
+    pooled = next;
+    ++freed;
+  }
+  return freed;
+}
+
+} // namespace ouly
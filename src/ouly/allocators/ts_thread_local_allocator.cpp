@@ -1,13 +1,19 @@
 
 #include "ouly/allocators/ts_thread_local_allocator.hpp"
 #include "ouly/allocators/config.hpp"
+#include "ouly/allocators/detail/platform_memory.hpp"
 #include "ouly/utility/common.hpp"
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <new>
 
 namespace ouly
 {
@@ -15,6 +21,7 @@ struct ts_thread_local_allocator::tls_t
 {
   uintptr_t generation_ = std::numeric_limits<uintptr_t>::max(); ///< Frame ID when the arena was created
   arena_t*  page_       = nullptr;                               ///< Pointer to the current arena_t for this thread
+  arena_t*  home_       = nullptr;                               ///< First arena installed this generation
 };
 /* Definition of the thread-local variable */
 // NOLINTNEXTLINE
@@ -77,20 +84,54 @@ auto ts_thread_local_allocator::allocate(std::size_t size) -> void*
 
 auto ts_thread_local_allocator::deallocate(void* ptr, std::size_t size) const -> bool
 {
-  size          = align_up(size);
-  arena_t* page = local_page.page_;
-  if ((page == nullptr) || local_page.generation_ != generation_)
+  if (ptr == nullptr || size == 0)
   {
     return false;
   }
 
-  auto* byte_ptr = static_cast<std::byte*>(ptr);
-  if (byte_ptr + size == &page->data_[0] + page->used_)
+  size              = align_up(size);
+  auto*    byte_ptr = static_cast<std::byte*>(ptr);
+  arena_t* page     = local_page.page_;
+  arena_t* home     = nullptr;
+  if (page != nullptr && local_page.generation_ == generation_)
   {
-    page->used_ -= size;
-    return true;
+    if (byte_ptr + size == &page->data_[0] + page->used_)
+    {
+      page->used_ -= size;
+      return true;
+    }
+    if (byte_ptr >= &page->data_[0] && byte_ptr < &page->data_[0] + page->used_)
+    {
+      return false; // our own block, but not the most recent one
+    }
+    home = local_page.home_;
+  }
+
+  arena_t* owner = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> lg{page_mutex_};
+    arena_t*                            arena = find_arena(ptr);
+    if (arena != nullptr)
+    {
+      owner = arena->home_;
+    }
   }
-  return false;
+
+  // Unowned arenas and our own older arenas keep the stack-only contract
+  if (owner == nullptr || owner == home)
+  {
+    return false;
+  }
+
+  // Push onto the owner's inbox; the owner takes the whole list with a single exchange
+  auto* block = ::new (ptr) free_block{.next_ = nullptr, .size_ = size};
+  auto* head  = owner->remote_free_.load(std::memory_order_relaxed);
+  do
+  {
+    block->next_ = head;
+  }
+  while (!owner->remote_free_.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+  return true;
 }
 
 auto ts_thread_local_allocator::realloc(void* ptr, std::size_t old_size, std::size_t new_size) -> void*
@@ -134,6 +175,10 @@ void ts_thread_local_allocator::reset() noexcept
 
   // 2. Reclaim every arena_t in the global free list.
   std::unique_lock<std::shared_mutex> lg{page_mutex_};
+  for (auto* page = page_list_head_; page != nullptr; page = page->next_)
+  {
+    page->home_ = nullptr;
+  }
   if (page_list_tail_ != nullptr)
   {
     page_list_tail_->next_ = available_pages_;
@@ -147,7 +192,12 @@ void ts_thread_local_allocator::reset() noexcept
   while (page != nullptr)
   {
     arena_t* next = page->next_;
-    ::operator delete(page, std::align_val_t{alignof(std::max_align_t)});
+    auto     it   = std::lower_bound(arenas_.begin(), arenas_.end(), page, std::less<>{});
+    if (it != arenas_.end() && *it == page)
+    {
+      arenas_.erase(it);
+    }
+    free_page(page);
     page = next;
   }
   pages_to_free_ = nullptr;
@@ -160,22 +210,50 @@ void ts_thread_local_allocator::release() noexcept
   while (page != nullptr)
   {
     arena_t* next = page->next_;
-    ::operator delete(page, std::align_val_t{alignof(std::max_align_t)});
+    free_page(page);
     page = next;
   }
   available_pages_ = nullptr;
+  arenas_.clear();
 }
-auto ts_thread_local_allocator::create_page(std::size_t payload_size) -> arena_t*
+auto ts_thread_local_allocator::create_page(std::size_t payload_size) const -> arena_t*
 {
   std::size_t total = sizeof(arena_t) + payload_size;
-  void*       raw   = ::operator new(total, std::align_val_t{alignof(std::max_align_t)});
+  if (backing_ == cfg::page_backing::normal)
+  {
+    void* raw = ::operator new(total, std::align_val_t{alignof(std::max_align_t)});
+
+    auto* page  = ::new (raw) arena_t{};
+    page->size_ = payload_size;
+    return page;
+  }
 
-  auto* page  = static_cast<arena_t*>(raw);
-  page->used_ = 0;
-  page->size_ = payload_size;
-  page->next_ = nullptr;
+  // Map whole pages and hand the rounding slack to the payload
+  auto const  info   = detail::get_memory_info();
+  std::size_t mapped = detail::round_up_to_pages(total, backing_, info.page_size_, info.huge_page_size_);
+  void*       raw    = detail::virtual_alloc(mapped, cfg::protection::read_write, nullptr, backing_);
+  if (raw == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+
+  auto* page         = ::new (raw) arena_t{};
+  page->size_        = mapped - offsetof(arena_t, data_);
+  page->mapped_size_ = mapped;
   return page;
 }
+
+void ts_thread_local_allocator::free_page(arena_t* page) noexcept
+{
+  if (page->mapped_size_ != 0)
+  {
+    detail::virtual_free(page, page->mapped_size_);
+  }
+  else
+  {
+    ::operator delete(page, std::align_val_t{alignof(std::max_align_t)});
+  }
+}
 auto ts_thread_local_allocator::pop_free_list(std::size_t min_payload) -> arena_t*
 {
   if (available_pages_ != nullptr && available_pages_->size_ >= min_payload)
@@ -188,19 +266,30 @@ auto ts_thread_local_allocator::pop_free_list(std::size_t min_payload) -> arena_
 }
 auto ts_thread_local_allocator::allocate_slow_path(std::size_t size) -> void*
 {
+  arena_t* home = local_page.generation_ == generation_ ? local_page.home_ : nullptr;
+  if (home != nullptr)
+  {
+    // Blocks other threads handed back are reused before a new arena is taken
+    drain_remote_frees(home);
+    if (void* reused = take_reused(home, size))
+    {
+      return reused;
+    }
+  }
+
   std::size_t payload = std::max(default_page_size_, size);
 
   if (payload > default_page_size_)
   {
     // If the requested size is larger than the default page size,
     // we allocate a single large page that is not reused.
-    auto* arena =
-     static_cast<arena_t*>(::operator new(sizeof(arena_t) + payload, std::align_val_t{alignof(std::max_align_t)}));
-    arena->size_ = payload;
+    auto* arena  = create_page(payload);
     arena->used_ = size; // Only mark the requested size as used, not the entire payload
+    arena->home_ = home;
 
     std::unique_lock<std::shared_mutex> lg{page_mutex_};
 
+    register_arena(arena);
     arena->next_   = pages_to_free_;
     pages_to_free_ = arena; // Add to the free list for reset
     return &arena->data_[0];
@@ -215,6 +304,7 @@ auto ts_thread_local_allocator::allocate_slow_path(std::size_t size) -> void*
   if (page == nullptr)
   {
     page = create_page(payload);
+    register_arena(page);
   }
 
   // 3) Install the page as the current thread’s arena_t
@@ -226,11 +316,17 @@ auto ts_thread_local_allocator::allocate_slow_path(std::size_t size) -> void*
   page->next_     = page_list_head_; // insert at the head of the list
   page_list_head_ = page;            // head of the list, for fast allocation
 
-  if (local_page.generation_ != generation_)
+  if (home == nullptr)
   {
+    // First arena of this thread in this generation becomes its home and inbox
+    home = page;
+    home->remote_free_.store(nullptr, std::memory_order_relaxed);
+    home->reuse_.fill(nullptr);
     local_page.generation_ = generation_;
+    local_page.home_       = home;
   }
 
+  page->home_      = home;
   local_page.page_ = page;
 
   std::size_t offset = page->used_;
@@ -238,6 +334,92 @@ auto ts_thread_local_allocator::allocate_slow_path(std::size_t size) -> void*
   return &page->data_[0] + offset;
 }
 
+auto ts_thread_local_allocator::find_arena(void const* ptr) const noexcept -> arena_t*
+{
+  // The candidate is the last arena starting at or before ptr
+  auto const* byte_ptr = static_cast<std::byte const*>(ptr);
+  auto        it       = std::upper_bound(arenas_.begin(), arenas_.end(), byte_ptr,
+                                          [](std::byte const* p, arena_t const* arena)
+                                          {
+                                            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                                            return std::less<>{}(p, reinterpret_cast<std::byte const*>(arena));
+                                          });
+  if (it == arenas_.begin())
+  {
+    return nullptr;
+  }
+  arena_t* arena = *std::prev(it);
+  if (byte_ptr >= &arena->data_[0] && byte_ptr < &arena->data_[0] + arena->size_)
+  {
+    return arena;
+  }
+  return nullptr;
+}
+
+void ts_thread_local_allocator::register_arena(arena_t* arena)
+{
+  arenas_.insert(std::upper_bound(arenas_.begin(), arenas_.end(), arena, std::less<>{}), arena);
+}
+
+void ts_thread_local_allocator::drain_remote_frees(arena_t* home) noexcept
+{
+  if (home->remote_free_.load(std::memory_order_relaxed) == nullptr)
+  {
+    return;
+  }
+
+  free_block* block = home->remote_free_.exchange(nullptr, std::memory_order_acquire);
+  while (block != nullptr)
+  {
+    free_block* next = block->next_;
+    add_reused(home, block, block->size_);
+    block = next;
+  }
+}
+
+namespace
+{
+template <std::size_t Alignment, std::size_t Bins>
+auto reuse_bin(std::size_t size) noexcept -> std::size_t
+{
+  return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(size / Alignment)) - 1, Bins - 1);
+}
+} // namespace
+
+void ts_thread_local_allocator::add_reused(arena_t* home, void* ptr, std::size_t size) noexcept
+{
+  auto& head  = home->reuse_[reuse_bin<alignment, reuse_bins>(size)];
+  auto* block = ::new (ptr) free_block{.next_ = head, .size_ = size};
+  head        = block;
+}
+
+auto ts_thread_local_allocator::take_reused(arena_t* home, std::size_t size) noexcept -> void*
+{
+  // Only the first class may hold blocks smaller than size, and the last one is open-ended, so the
+  // walk below stops at the first block everywhere else.
+  for (auto bin = reuse_bin<alignment, reuse_bins>(size); bin < reuse_bins; ++bin)
+  {
+    free_block** link = &home->reuse_[bin];
+    while (*link != nullptr)
+    {
+      free_block* block = *link;
+      if (block->size_ >= size)
+      {
+        *link                = block->next_;
+        auto const remaining = block->size_ - size;
+        auto*      result    = reinterpret_cast<std::byte*>(block); // NOLINT
+        if (remaining >= alignment)
+        {
+          add_reused(home, result + size, remaining);
+        }
+        return result;
+      }
+      link = &block->next_;
+    }
+  }
+  return nullptr;
+}
+
 auto ts_thread_local_allocator::remove_tls_slot(tls_t* slot) noexcept -> void
 {
   // Thread-safe removal from the linked list
@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/scheduler/cpu_topology.hpp"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ouly
+{
+
+namespace
+{
+
+// Below this fraction of the fastest CPU's capacity a CPU counts as an efficiency core
+constexpr uint32_t efficiency_percent = 85;
+constexpr uint32_t percent            = 100;
+
+auto read_first_line(std::filesystem::path const& file) -> std::string
+{
+  std::ifstream stream(file);
+  std::string   line;
+  if (stream)
+  {
+    std::getline(stream, line);
+  }
+  return line;
+}
+
+auto read_uint(std::filesystem::path const& file, uint32_t& value) -> bool
+{
+  auto line = read_first_line(file);
+  auto res  = std::from_chars(line.data(), line.data() + line.size(), value);
+  return res.ec == std::errc{} && res.ptr != line.data();
+}
+
+// Parse a kernel cpu list such as "0-7,16,18-19"
+auto parse_cpu_list(std::string const& list) -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> ids;
+  char const*           it  = list.data();
+  char const*           end = list.data() + list.size();
+  while (it < end)
+  {
+    uint32_t first = 0;
+    auto     res   = std::from_chars(it, end, first);
+    if (res.ec != std::errc{})
+    {
+      break;
+    }
+    uint32_t last = first;
+    it            = res.ptr;
+    if (it < end && *it == '-')
+    {
+      res = std::from_chars(it + 1, end, last);
+      if (res.ec != std::errc{})
+      {
+        break;
+      }
+      it = res.ptr;
+    }
+    for (uint32_t id = first; id <= last; ++id)
+    {
+      ids.push_back(id);
+    }
+    if (it < end && *it == ',')
+    {
+      ++it;
+    }
+    else
+    {
+      break;
+    }
+  }
+  return ids;
+}
+
+} // namespace
+
+cpu_topology::cpu_topology(std::vector<logical_cpu> cpus) : cpus_(std::move(cpus))
+{
+  classify_by_capacity();
+}
+
+void cpu_topology::classify_by_capacity()
+{
+  uint32_t fastest = 0;
+  for (auto const& cpu : cpus_)
+  {
+    fastest = std::max(fastest, cpu.capacity_);
+  }
+
+  hybrid_ = false;
+  for (auto& cpu : cpus_)
+  {
+    bool slow = cpu.capacity_ != 0 && static_cast<uint64_t>(cpu.capacity_) * percent <
+                                       static_cast<uint64_t>(fastest) * efficiency_percent;
+    cpu.kind_ = slow ? core_kind::efficiency : core_kind::performance;
+    hybrid_   = hybrid_ || slow;
+  }
+}
+
+auto cpu_topology::discover(std::filesystem::path const& sysfs_cpu_root) -> cpu_topology
+{
+  cpu_topology    topology;
+  std::error_code error;
+  for (auto const& entry : std::filesystem::directory_iterator(sysfs_cpu_root, error))
+  {
+    auto name = entry.path().filename().string();
+    if (name.size() <= 3 || name.compare(0, 3, "cpu") != 0)
+    {
+      continue;
+    }
+    uint32_t id  = 0;
+    auto     res = std::from_chars(name.data() + 3, name.data() + name.size(), id);
+    if (res.ec != std::errc{} || res.ptr != name.data() + name.size())
+    {
+      continue;
+    }
+    // cpu0 usually has no "online" file; it cannot be taken offline
+    uint32_t online = 1;
+    if (read_uint(entry.path() / "online", online) && online == 0)
+    {
+      continue;
+    }
+
+    logical_cpu cpu{.id_ = id};
+    if (!read_uint(entry.path() / "cpu_capacity", cpu.capacity_))
+    {
+      cpu.capacity_ = 0;
+      if (!read_uint(entry.path() / "cpufreq" / "cpuinfo_max_freq", cpu.capacity_))
+      {
+        cpu.capacity_ = 0;
+      }
+    }
+    topology.cpus_.push_back(cpu);
+  }
+  std::ranges::sort(topology.cpus_, {}, &logical_cpu::id_);
+  topology.classify_by_capacity();
+
+  // Intel hybrid parts name their core types directly through the PMU devices, which beats frequency guesses
+  auto devices = sysfs_cpu_root.parent_path().parent_path();
+  auto atoms   = parse_cpu_list(read_first_line(devices / "cpu_atom" / "cpus"));
+  if (!atoms.empty() && !parse_cpu_list(read_first_line(devices / "cpu_core" / "cpus")).empty())
+  {
+    topology.hybrid_ = false;
+    for (auto& cpu : topology.cpus_)
+    {
+      bool atom        = std::ranges::find(atoms, cpu.id_) != atoms.end();
+      cpu.kind_        = atom ? core_kind::efficiency : core_kind::performance;
+      topology.hybrid_ = topology.hybrid_ || atom;
+    }
+  }
+  return topology;
+}
+
+auto cpu_topology::get() -> cpu_topology const&
+{
+  static cpu_topology const topology = []() -> cpu_topology
+  {
+#ifdef __linux__
+    auto discovered = discover("/sys/devices/system/cpu");
+    if (!discovered.cpus_.empty())
+    {
+      return discovered;
+    }
+#endif
+    std::vector<logical_cpu> cpus(std::max(std::thread::hardware_concurrency(), 1U));
+    for (uint32_t i = 0; i < cpus.size(); ++i)
+    {
+      cpus[i].id_ = i;
+    }
+    return cpu_topology(std::move(cpus));
+  }();
+  return topology;
+}
+
+auto cpu_topology::get_cpu_ids(core_kind kind) const -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> ids;
+  for (auto const& cpu : cpus_)
+  {
+    if (kind == core_kind::any || cpu.kind_ == kind)
+    {
+      ids.push_back(cpu.id_);
+    }
+  }
+  return ids;
+}
+
+auto pin_current_thread(std::span<uint32_t const> cpu_ids) noexcept -> bool
+{
+  if (cpu_ids.empty())
+  {
+    return false;
+  }
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto id : cpu_ids)
+  {
+    if (id < CPU_SETSIZE)
+    {
+      CPU_SET(id, &set);
+    }
+  }
+  return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+auto current_thread_cpus() -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> ids;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+  {
+    for (uint32_t id = 0; id < CPU_SETSIZE; ++id)
+    {
+      if (CPU_ISSET(id, &set))
+      {
+        ids.push_back(id);
+      }
+    }
+  }
+#endif
+  return ids;
+}
+
+} // namespace ouly
@@ -0,0 +1,669 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/scheduler/io_reactor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define OULY_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define OULY_HAS_IO_URING 0
+#endif
+
+namespace ouly
+{
+
+namespace
+{
+
+#ifdef _WIN32
+auto last_error() noexcept -> int
+{
+  return static_cast<int>(GetLastError());
+}
+#else
+auto last_error() noexcept -> int
+{
+  return errno;
+}
+#endif
+
+// Largest single transfer handed to the OS; Linux caps read/write at this size as well.
+constexpr std::size_t max_transfer = 0x7ffff000;
+
+} // namespace
+
+async_file::async_file(std::filesystem::path const& path, access_mode mode)
+{
+  std::error_code error;
+  open(path, mode, error);
+  if (error)
+  {
+    throw std::system_error(error);
+  }
+}
+
+async_file::~async_file() noexcept
+{
+  close();
+}
+
+void async_file::open(std::filesystem::path const& path, access_mode mode, std::error_code& error) noexcept
+{
+  close();
+  error.clear();
+#ifdef _WIN32
+  DWORD access   = mode == access_mode::write ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+  DWORD creation = mode == access_mode::write ? OPEN_ALWAYS : OPEN_EXISTING;
+  HANDLE handle  = CreateFileW(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, creation,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    error.assign(last_error(), std::system_category());
+    return;
+  }
+  handle_ = handle;
+#else
+  constexpr mode_t default_file_mode = 0644;
+
+  int flags = mode == access_mode::write ? (O_RDWR | O_CREAT) : O_RDONLY;
+  // NOLINTNEXTLINE
+  int fd = ::open(path.c_str(), flags | O_CLOEXEC, default_file_mode);
+  if (fd == -1)
+  {
+    error.assign(last_error(), std::system_category());
+    return;
+  }
+  handle_ = fd;
+#endif
+}
+
+void async_file::close() noexcept
+{
+  if (!is_open())
+  {
+    return;
+  }
+#ifdef _WIN32
+  CloseHandle(handle_);
+#else
+  ::close(handle_);
+#endif
+  handle_ = invalid_handle();
+}
+
+auto async_file::size() const -> std::uint64_t
+{
+#ifdef _WIN32
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(handle_, &file_size))
+  {
+    throw std::system_error(last_error(), std::system_category());
+  }
+  return static_cast<std::uint64_t>(file_size.QuadPart);
+#else
+  struct stat st = {};
+  if (fstat(handle_, &st) == -1)
+  {
+    throw std::system_error(last_error(), std::system_category());
+  }
+  return static_cast<std::uint64_t>(st.st_size);
+#endif
+}
+
+namespace detail
+{
+
+void perform_blocking_io(io_request& request) noexcept
+{
+  std::size_t done = 0;
+  while (done < request.size_)
+  {
+    auto  chunk  = std::min(request.size_ - done, max_transfer);
+    auto* data   = request.data_ + done;
+    auto  offset = request.offset_ + done;
+#ifdef _WIN32
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD transferred     = 0;
+    BOOL  ok = request.op_ == io_operation::read
+                ? ReadFile(request.file_, data, static_cast<DWORD>(chunk), &transferred, &overlapped)
+                : WriteFile(request.file_, data, static_cast<DWORD>(chunk), &transferred, &overlapped);
+    if (!ok)
+    {
+      if (GetLastError() == ERROR_HANDLE_EOF)
+      {
+        break;
+      }
+      request.result_ = -static_cast<std::int64_t>(last_error());
+      return;
+    }
+    auto result = static_cast<std::int64_t>(transferred);
+#else
+    auto result = static_cast<std::int64_t>(
+     request.op_ == io_operation::read ? ::pread(request.file_, data, chunk, static_cast<off_t>(offset))
+                                       : ::pwrite(request.file_, data, chunk, static_cast<off_t>(offset)));
+    if (result < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      request.result_ = -static_cast<std::int64_t>(last_error());
+      return;
+    }
+#endif
+    if (result == 0)
+    {
+      break; // end of file
+    }
+    done += static_cast<std::size_t>(result);
+  }
+  request.result_ = static_cast<std::int64_t>(done);
+}
+
+/**
+ * @brief Blocking fallback: an intrusive FIFO of requests drained by dedicated threads.
+ */
+class thread_pool_backend
+{
+public:
+  explicit thread_pool_backend(uint32_t thread_count)
+  {
+    threads_.reserve(std::max(thread_count, 1U));
+    for (uint32_t i = 0; i < std::max(thread_count, 1U); ++i)
+    {
+      threads_.emplace_back(
+       [this]()
+       {
+         run();
+       });
+    }
+  }
+
+  thread_pool_backend(thread_pool_backend const&)                    = delete;
+  thread_pool_backend(thread_pool_backend&&)                         = delete;
+  auto operator=(thread_pool_backend const&) -> thread_pool_backend& = delete;
+  auto operator=(thread_pool_backend&&) -> thread_pool_backend&      = delete;
+
+  ~thread_pool_backend() noexcept
+  {
+    {
+      std::scoped_lock lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_)
+    {
+      thread.join();
+    }
+  }
+
+  void submit(io_request& request) noexcept
+  {
+    request.next_ = nullptr;
+    {
+      std::scoped_lock lock(mutex_);
+      if (tail_ != nullptr)
+      {
+        tail_->next_ = &request;
+      }
+      else
+      {
+        head_ = &request;
+      }
+      tail_ = &request;
+    }
+    wake_.notify_one();
+  }
+
+private:
+  void run() noexcept
+  {
+    while (true)
+    {
+      io_request* request = nullptr;
+      {
+        std::unique_lock lock(mutex_);
+        wake_.wait(lock,
+                   [this]()
+                   {
+                     return head_ != nullptr || stop_;
+                   });
+        if (head_ == nullptr)
+        {
+          return; // stopping and drained
+        }
+        request = std::exchange(head_, head_->next_);
+        if (head_ == nullptr)
+        {
+          tail_ = nullptr;
+        }
+      }
+      perform_blocking_io(*request);
+      request->complete_(*request);
+    }
+  }
+
+  std::mutex               mutex_;
+  std::condition_variable  wake_;
+  io_request*              head_ = nullptr;
+  io_request*              tail_ = nullptr;
+  bool                     stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+#if OULY_HAS_IO_URING
+
+/**
+ * @brief io_uring backend driven through the raw syscalls (no liburing dependency).
+ *
+ * Workers serialize on a mutex to fill submission entries and enter the kernel; a single completion thread
+ * reaps the completion ring and resubmits short transfers. In-flight requests are capped at the completion
+ * ring size so the kernel never has to drop or hold back completions.
+ */
+class io_uring_backend
+{
+public:
+  // Sentinel user_data of the no-op that stops the completion thread.
+  static constexpr std::uint64_t stop_token = 0;
+
+  io_uring_backend() noexcept = default;
+
+  io_uring_backend(io_uring_backend const&)                    = delete;
+  io_uring_backend(io_uring_backend&&)                         = delete;
+  auto operator=(io_uring_backend const&) -> io_uring_backend& = delete;
+  auto operator=(io_uring_backend&&) -> io_uring_backend&      = delete;
+
+  ~io_uring_backend() noexcept
+  {
+    if (completion_thread_.joinable())
+    {
+      // The stop no-op takes a completion slot like any request.
+      reserve_slot();
+      queue_and_submit(io_uring_op(IORING_OP_NOP), stop_token, nullptr, 0, 0, 0);
+      completion_thread_.join();
+    }
+    release();
+  }
+
+  /**
+   * @brief Set up the rings; false when io_uring or the read/write opcodes are unavailable.
+   */
+  auto init(uint32_t queue_depth) noexcept -> bool
+  {
+    io_uring_params params = {};
+    auto            fd     = syscall(__NR_io_uring_setup, std::max(queue_depth, 2U), &params);
+    if (fd < 0)
+    {
+      return false;
+    }
+    ring_fd_ = static_cast<int>(fd);
+
+    if (!supports_read_write())
+    {
+      release();
+      return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + (params.sq_entries * sizeof(std::uint32_t));
+    cq_ring_size_ = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ = map_ring(sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = (params.features & IORING_FEAT_SINGLE_MMAP) != 0 ? sq_ring_
+                                                                 : map_ring(cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    auto* sqes = map_ring(sqes_size_, IORING_OFF_SQES);
+    if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes == nullptr)
+    {
+      if (sqes != nullptr)
+      {
+        munmap(sqes, sqes_size_);
+      }
+      release();
+      return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sq_head_    = ring_field(sq_ring_, params.sq_off.head);
+    sq_tail_    = ring_field(sq_ring_, params.sq_off.tail);
+    sq_mask_    = *ring_field(sq_ring_, params.sq_off.ring_mask);
+    sq_array_   = ring_field(sq_ring_, params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    cq_head_    = ring_field(cq_ring_, params.cq_off.head);
+    cq_tail_    = ring_field(cq_ring_, params.cq_off.tail);
+    cq_mask_    = *ring_field(cq_ring_, params.cq_off.ring_mask);
+    cqes_       = reinterpret_cast<io_uring_cqe*>(static_cast<std::byte*>(cq_ring_) + params.cq_off.cqes);
+    cq_entries_ = params.cq_entries;
+
+    completion_thread_ = std::thread(
+     [this]()
+     {
+       reap();
+     });
+    return true;
+  }
+
+  void submit(io_request& request) noexcept
+  {
+    reserve_slot();
+    request.result_ = 0;
+    push_request(request);
+  }
+
+private:
+  /**
+   * @brief Count one more entry in flight, waiting while the completion ring is full.
+   *
+   * Bounding in-flight work by the completion ring means no completion is ever dropped and the kernel
+   * never answers an enter with EBUSY because of an overflowed ring.
+   */
+  void reserve_slot() noexcept
+  {
+    auto in_flight = in_flight_.load(std::memory_order_relaxed);
+    while (in_flight >= cq_entries_ || !in_flight_.compare_exchange_weak(in_flight, in_flight + 1,
+                                                                          std::memory_order_acq_rel,
+                                                                          std::memory_order_relaxed))
+    {
+      if (in_flight >= cq_entries_)
+      {
+        std::this_thread::yield();
+        in_flight = in_flight_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  static auto io_uring_op(unsigned op) noexcept -> std::uint8_t
+  {
+    return static_cast<std::uint8_t>(op);
+  }
+
+  static auto ring_field(void* ring, std::uint32_t offset) noexcept -> std::uint32_t*
+  {
+    return reinterpret_cast<std::uint32_t*>(static_cast<std::byte*>(ring) + offset);
+  }
+
+  auto map_ring(std::size_t size, off_t offset) const noexcept -> void*
+  {
+    void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    return ring == MAP_FAILED ? nullptr : ring;
+  }
+
+  auto supports_read_write() const noexcept -> bool
+  {
+    constexpr std::size_t probe_ops = 256;
+
+    // io_uring_probe ends in a flexible array member, so it is laid out by hand in raw storage.
+    std::vector<std::byte> storage(sizeof(io_uring_probe) + (probe_ops * sizeof(io_uring_probe_op)));
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, probe_ops) < 0)
+    {
+      return false;
+    }
+    auto supported = [probe](unsigned op)
+    {
+      return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+    };
+    return supported(IORING_OP_READ) && supported(IORING_OP_WRITE);
+  }
+
+  void release() noexcept
+  {
+    if (sqes_ != nullptr)
+    {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+    {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr)
+    {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0)
+    {
+      ::close(ring_fd_);
+    }
+    sqes_    = nullptr;
+    cq_ring_ = nullptr;
+    sq_ring_ = nullptr;
+    ring_fd_ = -1;
+  }
+
+  void push_request(io_request& request) noexcept
+  {
+    auto chunk = static_cast<std::uint32_t>(std::min(request.size_, max_transfer));
+    auto op    = io_uring_op(request.op_ == io_operation::read ? IORING_OP_READ : IORING_OP_WRITE);
+    queue_and_submit(op, reinterpret_cast<std::uint64_t>(&request), request.data_, chunk, request.offset_,
+                     request.file_);
+  }
+
+  void queue_and_submit(std::uint8_t op, std::uint64_t user_data, void* data, std::uint32_t size,
+                        std::uint64_t offset, int fd) noexcept
+  {
+    while (!queue(op, user_data, data, size, offset, fd))
+    {
+      std::this_thread::yield();
+    }
+    // Back off while the kernel is short of resources; the lock is released between attempts so the
+    // completion thread can make progress.
+    while (!submit_queued())
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  /**
+   * @brief Fill one submission entry; false when the submission ring is full.
+   */
+  auto queue(std::uint8_t op, std::uint64_t user_data, void* data, std::uint32_t size, std::uint64_t offset,
+             int fd) noexcept -> bool
+  {
+    std::scoped_lock lock(submit_lock_);
+    auto             tail = *sq_tail_;
+    auto             head = std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+    if (tail - head >= sq_entries_)
+    {
+      // Entries left queued by an earlier busy enter may be what keeps the ring full.
+      submit_locked();
+      return false;
+    }
+
+    auto  index = tail & sq_mask_;
+    auto& sqe   = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode    = op;
+    sqe.fd        = fd;
+    sqe.off       = offset;
+    sqe.addr      = reinterpret_cast<std::uint64_t>(data);
+    sqe.len       = size;
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Hand every queued entry to the kernel; false when it is temporarily busy and entries remain.
+   */
+  auto submit_queued() noexcept -> bool
+  {
+    std::scoped_lock lock(submit_lock_);
+    return submit_locked();
+  }
+
+  auto submit_locked() noexcept -> bool
+  {
+    auto const tail = *sq_tail_;
+    while (submitted_ != tail)
+    {
+      auto consumed = syscall(__NR_io_uring_enter, ring_fd_, tail - submitted_, 0U, 0U, nullptr, 0);
+      if (consumed > 0)
+      {
+        submitted_ += static_cast<std::uint32_t>(consumed);
+        continue;
+      }
+      if (consumed < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      // EAGAIN, EBUSY or nothing consumed: the caller retries later. Any other error means the ring
+      // itself is unusable, and retrying cannot fix that.
+      return consumed < 0 && errno != EAGAIN && errno != EBUSY;
+    }
+    return true;
+  }
+
+  void reap() noexcept
+  {
+    bool stopping = false;
+    while (!stopping || in_flight_.load(std::memory_order_acquire) != 0)
+    {
+      auto head = *cq_head_;
+      auto tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+      if (head == tail)
+      {
+        syscall(__NR_io_uring_enter, ring_fd_, 0U, 1U, IORING_ENTER_GETEVENTS, nullptr, 0);
+        continue;
+      }
+
+      auto const& cqe       = cqes_[head & cq_mask_];
+      auto        user_data = cqe.user_data;
+      auto        result    = cqe.res;
+      std::atomic_ref(*cq_head_).store(head + 1, std::memory_order_release);
+
+      if (user_data == stop_token)
+      {
+        in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+        stopping = true;
+        continue;
+      }
+      complete(*reinterpret_cast<io_request*>(user_data), result);
+    }
+  }
+
+  void complete(io_request& request, std::int32_t result) noexcept
+  {
+    if (result < 0)
+    {
+      request.result_ = result;
+    }
+    else
+    {
+      auto transferred = static_cast<std::size_t>(result);
+      request.result_ += result;
+      if (transferred != 0 && transferred < request.size_)
+      {
+        // Short transfer: continue with the remainder, the request stays in flight.
+        request.data_ += transferred;
+        request.offset_ += transferred;
+        request.size_ -= transferred;
+        push_request(request);
+        return;
+      }
+    }
+    in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+    request.complete_(request);
+  }
+
+  std::mutex            submit_lock_;
+  std::atomic<uint32_t> in_flight_{0};
+  std::uint32_t         submitted_    = 0; ///< Submission tail already handed to the kernel, under submit_lock_
+  int                   ring_fd_      = -1;
+  void*                 sq_ring_      = nullptr;
+  void*                 cq_ring_      = nullptr;
+  io_uring_sqe*         sqes_         = nullptr;
+  io_uring_cqe*         cqes_         = nullptr;
+  std::size_t           sq_ring_size_ = 0;
+  std::size_t           cq_ring_size_ = 0;
+  std::size_t           sqes_size_    = 0;
+  std::uint32_t*        sq_head_      = nullptr;
+  std::uint32_t*        sq_tail_      = nullptr;
+  std::uint32_t*        sq_array_     = nullptr;
+  std::uint32_t*        cq_head_      = nullptr;
+  std::uint32_t*        cq_tail_      = nullptr;
+  std::uint32_t         sq_mask_      = 0;
+  std::uint32_t         sq_entries_   = 0;
+  std::uint32_t         cq_mask_      = 0;
+  std::uint32_t         cq_entries_   = 0;
+  std::thread           completion_thread_;
+};
+
+#endif
+
+} // namespace detail
+
+struct io_reactor::backend_state
+{
+#if OULY_HAS_IO_URING
+  std::unique_ptr<detail::io_uring_backend> uring_;
+#endif
+  std::unique_ptr<detail::thread_pool_backend> pool_;
+};
+
+io_reactor::io_reactor(io_backend backend, [[maybe_unused]] uint32_t queue_depth, uint32_t thread_count)
+    : state_(std::make_unique<backend_state>())
+{
+#if OULY_HAS_IO_URING
+  if (backend != io_backend::thread_pool)
+  {
+    auto uring = std::make_unique<detail::io_uring_backend>();
+    if (uring->init(queue_depth))
+    {
+      state_->uring_ = std::move(uring);
+      backend_       = io_backend::io_uring;
+      return;
+    }
+  }
+#else
+  (void)backend;
+#endif
+  state_->pool_ = std::make_unique<detail::thread_pool_backend>(thread_count);
+  backend_      = io_backend::thread_pool;
+}
+
+io_reactor::~io_reactor() noexcept = default;
+
+auto io_reactor::get_default() -> io_reactor&
+{
+  static io_reactor reactor;
+  return reactor;
+}
+
+void io_reactor::submit(detail::io_request& request) noexcept
+{
+#if OULY_HAS_IO_URING
+  if (state_->uring_)
+  {
+    state_->uring_->submit(request);
+    return;
+  }
+#endif
+  state_->pool_->submit(request);
+}
+
+} // namespace ouly
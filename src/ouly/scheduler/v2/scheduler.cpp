@@ -107,10 +107,11 @@ void scheduler::submit_internal([[maybe_unused]] task_context const& current, wo
   }
 
   // Either we are not running on a worker that owns a slot in `dst`, or that worker's queue is full:
-  // route through the multi-producer mailbox, which is safe to push to from any thread.
+  // route through the multi-producer mailbox, which is safe to push to from any thread. A full ring
+  // spills into the mailbox's overflow list, so this only loops if that allocation fails.
   while (!target_workgroup.submit_to_mailbox(work))
   {
-    // Mailbox is full; recruit everyone, then help drain when we are a worker of this
+    // Out of memory for overflow; recruit everyone, then help drain when we are a worker of this
     // scheduler. A foreign thread must not call busy_work: it would pop from a deque it
     // does not own and break the single-consumer invariant.
     wake_up_workers(worker_count_);
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "ouly/scheduler/v3/scheduler.hpp"
+#include "ouly/scheduler/cpu_topology.hpp"
 #include "ouly/scheduler/detail/pause.hpp"
 #include "ouly/scheduler/detail/v3/worker.hpp"
 #include "ouly/scheduler/detail/v3/workgroup.hpp"
@@ -76,18 +77,21 @@ void scheduler::finish_task() noexcept
   }
 }
 
-void scheduler::execute_work(worker_type& wkr, uint32_t group_index, work_item_type& work) noexcept
+void scheduler::execute_work(worker_type& wkr, uint32_t group_index, uint32_t offset, work_item_type& work) noexcept
 {
   auto& ctx        = wkr.context_;
   auto  prev_group = ctx.group_id_;
   auto  prev_off   = ctx.offset_;
 
-  auto& group   = ouly::detail::vector_access(workgroups_, group_index);
   ctx.group_id_ = workgroup_id(group_index);
-  ctx.offset_   = group.get_offset(ctx.get_worker().get_index());
+  ctx.offset_   = offset;
 
   work(ctx);
 
+  // Owner-only counter: a plain load/store pair is enough and avoids a locked RMW per task
+  auto& executed = ouly::detail::vector_access(wkr.executed_, group_index);
+  executed.store(executed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
   // Restore so a context observed through this_context::get() stays valid after nested
   // helping (cooperative waits) regardless of which group's task we just ran.
   ctx.group_id_ = prev_group;
@@ -98,6 +102,11 @@ void scheduler::execute_work(worker_type& wkr, uint32_t group_index, work_item_t
 
 auto scheduler::try_execute_one(worker_id wid) noexcept -> bool
 {
+  if (fair_share_)
+  {
+    return try_execute_fair(wid);
+  }
+
   auto& wkr = ouly::detail::vector_access(workers_, wid.get_index());
 
   for (uint32_t i = 0; i < wkr.group_count_; ++i)
@@ -119,7 +128,105 @@ auto scheduler::try_execute_one(worker_id wid) noexcept -> bool
       {
         notify_workers(1);
       }
-      execute_work(wkr, group_index, work);
+      execute_work(wkr, group_index, group.get_offset(wid.get_index()), work);
+      return true;
+    }
+  }
+  return false;
+}
+
+auto scheduler::try_execute_fair(worker_id wid) noexcept -> bool
+{
+  auto& wkr = ouly::detail::vector_access(workers_, wid.get_index());
+  if (wkr.group_count_ == 0)
+  {
+    return false;
+  }
+
+  // Deficit round robin with a cost of one per task. The cursor group keeps its turn while it
+  // has credit and a task to take; otherwise the next group starts its turn with exactly its
+  // weight. Credit is never carried over, so a group that was idle, or whose take() lost a race,
+  // cannot bank turns for a later burst. Two passes reach every group with work even if the
+  // cursor started with no credit.
+  for (uint32_t visit = 0; visit < 2 * wkr.group_count_; ++visit)
+  {
+    uint32_t slot        = wkr.cursor_;
+    uint32_t group_index = ouly::detail::vector_access(wkr.group_order_, slot);
+    auto&    group       = ouly::detail::vector_access(workgroups_, group_index);
+    auto&    deficit     = ouly::detail::vector_access(wkr.deficit_, slot);
+
+    work_item_type work{work_item_type::noinit};
+    if (deficit > 0 && group.has_queued() && group.take(work, group.get_offset(wid.get_index()), update_seed()))
+    {
+      --deficit;
+      if (group.has_queued())
+      {
+        notify_workers(1);
+      }
+      execute_work(wkr, group_index, group.get_offset(wid.get_index()), work);
+      return true;
+    }
+
+    deficit       = 0;
+    wkr.cursor_   = (slot + 1) % wkr.group_count_;
+    uint32_t next = ouly::detail::vector_access(wkr.group_order_, wkr.cursor_);
+    ouly::detail::vector_access(wkr.deficit_, wkr.cursor_) =
+     ouly::detail::vector_access(workgroup_descs_, next).weight_;
+  }
+  return false;
+}
+
+auto scheduler::try_borrow_one(worker_id wid) noexcept -> bool
+{
+  auto& wkr = ouly::detail::vector_access(workers_, wid.get_index());
+
+  // Weighted pick among the groups this worker may be lent to that currently have work
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < wkr.loan_count_; ++i)
+  {
+    if (ouly::detail::vector_access(workgroups_, ouly::detail::vector_access(wkr.loan_order_, i)).has_queued())
+    {
+      total += ouly::detail::vector_access(wkr.loan_weight_, i);
+    }
+  }
+  if (total == 0)
+  {
+    return false;
+  }
+
+  // The low bits of the LCG are weak, use the high half
+  constexpr uint32_t seed_shift = 16;
+  uint32_t           pick       = (update_seed() >> seed_shift) % total;
+  uint32_t           first      = 0;
+  for (; first < wkr.loan_count_; ++first)
+  {
+    if (!ouly::detail::vector_access(workgroups_, ouly::detail::vector_access(wkr.loan_order_, first)).has_queued())
+    {
+      continue;
+    }
+    uint32_t weight = ouly::detail::vector_access(wkr.loan_weight_, first);
+    if (pick < weight)
+    {
+      break;
+    }
+    pick -= weight;
+  }
+
+  // Start at the picked group; if another worker drained it meanwhile, try the others
+  for (uint32_t i = 0; i < wkr.loan_count_; ++i)
+  {
+    uint32_t slot        = (first + i) % wkr.loan_count_;
+    uint32_t group_index = ouly::detail::vector_access(wkr.loan_order_, slot);
+    auto&    group       = ouly::detail::vector_access(workgroups_, group_index);
+
+    work_item_type work{work_item_type::noinit};
+    if (group.has_queued() && group.take_any(work))
+    {
+      if (group.has_queued())
+      {
+        notify_workers(1);
+      }
+      execute_work(wkr, group_index, ouly::detail::vector_access(wkr.loan_offset_, slot), work);
       return true;
     }
   }
@@ -138,6 +245,18 @@ auto scheduler::has_queued_work(worker_type const& wkr) const noexcept -> bool
   return false;
 }
 
+auto scheduler::has_loanable_work(worker_type const& wkr) const noexcept -> bool
+{
+  for (uint32_t i = 0; i < wkr.loan_count_; ++i)
+  {
+    if (ouly::detail::vector_access(workgroups_, ouly::detail::vector_access(wkr.loan_order_, i)).has_queued())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 void scheduler::run_worker(worker_id wid)
 {
   auto& wkr   = ouly::detail::vector_access(workers_, wid.get_index());
@@ -152,7 +271,8 @@ void scheduler::run_worker(worker_id wid)
 
   while (!stop_.load(std::memory_order_relaxed))
   {
-    if (try_execute_one(wid))
+    // Own groups first, so a lent worker returns home as soon as its groups have work again
+    if (try_execute_one(wid) || try_borrow_one(wid))
     {
       continue;
     }
@@ -161,7 +281,8 @@ void scheduler::run_worker(worker_id wid)
     work_available_.wait(lock,
                          [this, &wkr]() noexcept -> bool
                          {
-                           return stop_.load(std::memory_order_acquire) || has_queued_work(wkr);
+                           return stop_.load(std::memory_order_acquire) || has_queued_work(wkr) ||
+                                  has_loanable_work(wkr);
                          });
   }
 
@@ -195,7 +316,8 @@ void scheduler::submit_internal([[maybe_unused]] task_context const& current, wo
 
   while (!pushed && !group.push_mailbox(work))
   {
-    // Mailbox full: wake everyone, then help drain if we are a worker of this scheduler.
+    // Ring full and no memory for an overflow chunk: wake everyone, then help drain if we are a
+    // worker of this scheduler.
     notify_workers(worker_count_);
     if (self != nullptr)
     {
@@ -210,17 +332,18 @@ void scheduler::submit_internal([[maybe_unused]] task_context const& current, wo
   notify_workers(1);
 }
 
-void scheduler::busy_work(worker_id thread) noexcept
+auto scheduler::busy_work(worker_id thread) noexcept -> bool
 {
   constexpr uint32_t attempts = 2;
   for (uint32_t i = 0; i < attempts; ++i)
   {
     if (try_execute_one(thread))
     {
-      return;
+      return true;
     }
     ouly::detail::pause_exec();
   }
+  return false;
 }
 
 void scheduler::wait_for_tasks()
@@ -229,7 +352,7 @@ void scheduler::wait_for_tasks()
 
   while (pending_.get().load(std::memory_order_acquire) != 0)
   {
-    if (try_execute_one(main_thread))
+    if (try_execute_one(main_thread) || try_borrow_one(main_thread))
     {
       continue;
     }
@@ -245,7 +368,8 @@ void scheduler::wait_for_tasks()
     work_available_.wait(lock,
                          [this, &wkr]() noexcept -> bool
                          {
-                           return pending_.get().load(std::memory_order_acquire) == 0 || has_queued_work(wkr);
+                           return pending_.get().load(std::memory_order_acquire) == 0 || has_queued_work(wkr) ||
+                                  has_loanable_work(wkr);
                          });
   }
 }
@@ -307,15 +431,73 @@ void scheduler::begin_execution(scheduler_worker_entry&& entry, void* user_conte
       wkr.context_.group_id_ = workgroup_id(first_group);
       wkr.context_.offset_   = ouly::detail::vector_access(workgroups_, first_group).get_offset(w);
     }
+
+    // Placement: performance wins over efficiency, which wins over no preference
+    wkr.cores_ = core_kind::any;
+    for (uint32_t i = 0; i < wkr.group_count_; ++i)
+    {
+      auto cores = ouly::detail::vector_access(workgroup_descs_, ouly::detail::vector_access(wkr.group_order_, i)).cores_;
+      if (cores == core_kind::performance || (cores == core_kind::efficiency && wkr.cores_ == core_kind::any))
+      {
+        wkr.cores_ = cores;
+      }
+    }
+
+    wkr.cursor_ = 0;
+    wkr.deficit_.fill(0);
+    if (wkr.group_count_ > 0)
+    {
+      ouly::detail::vector_access(wkr.deficit_, 0) =
+       ouly::detail::vector_access(workgroup_descs_, ouly::detail::vector_access(wkr.group_order_, 0)).weight_;
+    }
+
+    // Loans: every non-member group one of this worker's groups lends into, at the highest weight
+    wkr.loan_count_ = 0;
+    for (uint32_t target = 0; target < workgroup_count_; ++target)
+    {
+      auto& group = ouly::detail::vector_access(workgroups_, target);
+      if (group.get_thread_count() == 0 || group.contains(w))
+      {
+        continue;
+      }
+      uint32_t weight = 0;
+      for (uint32_t i = 0; i < wkr.group_count_; ++i)
+      {
+        auto const& home = ouly::detail::vector_access(workgroup_descs_, ouly::detail::vector_access(wkr.group_order_, i));
+        weight           = std::max(weight, ouly::detail::vector_access(home.loan_weights_, target));
+      }
+      if (weight > 0)
+      {
+        ouly::detail::vector_access(wkr.loan_order_, wkr.loan_count_)  = static_cast<uint8_t>(target);
+        ouly::detail::vector_access(wkr.loan_weight_, wkr.loan_count_) = weight;
+        ouly::detail::vector_access(wkr.loan_offset_, wkr.loan_count_) = group.add_borrower();
+        ++wkr.loan_count_;
+      }
+    }
   }
 
   stop_.store(false, std::memory_order_relaxed);
   pending_.get().store(0, std::memory_order_relaxed);
 
   auto start_counter = std::latch(worker_count_);
+  caller_cpus_       = current_thread_cpus();
 
-  entry_fn_ = [cust_entry = std::move(entry), &start_counter](ouly::worker_id worker) -> void
+  entry_fn_ = [this, cust_entry = std::move(entry), &start_counter](ouly::worker_id worker) -> void
   {
+    auto const& topology = cpu_topology::get();
+    auto        cores    = ouly::detail::vector_access(workers_, worker.get_index()).cores_;
+    if (cores != core_kind::any && topology.is_hybrid())
+    {
+      // Keep to the CPUs the caller was allowed (taskset, cgroups) unless none of them is of this kind
+      auto cpus    = topology.get_cpu_ids(cores);
+      auto allowed = cpus;
+      std::erase_if(allowed,
+                    [this](uint32_t id) -> bool
+                    {
+                      return std::ranges::find(caller_cpus_, id) == caller_cpus_.end();
+                    });
+      pin_current_thread(allowed.empty() ? cpus : allowed);
+    }
     if (cust_entry)
     {
       cust_entry(worker);
@@ -352,9 +534,18 @@ void scheduler::end_execution()
     }
   }
   threads_.clear();
+
+  // Worker 0 ran on the caller's thread, which must not stay pinned to its groups' cores
+  if (workers_ && ouly::detail::vector_access(workers_, 0).cores_ != core_kind::any &&
+      cpu_topology::get().is_hybrid())
+  {
+    pin_current_thread(caller_cpus_);
+  }
+  caller_cpus_.clear();
 }
 
-void scheduler::create_group(workgroup_id group, uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority)
+void scheduler::create_group(workgroup_id group, uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority,
+                             core_kind cores)
 {
   if (group.get_index() >= detail::v3::max_workgroup || thread_count == 0)
   {
@@ -365,25 +556,57 @@ void scheduler::create_group(workgroup_id group, uint32_t start_thread_idx, uint
   desc.start_        = start_thread_idx;
   desc.thread_count_ = thread_count;
   desc.priority_     = priority;
+  desc.cores_        = cores;
 
   workgroup_count_ = std::max(workgroup_count_, group.get_index() + 1);
   worker_count_    = std::max(worker_count_, start_thread_idx + thread_count);
 }
 
-auto scheduler::create_group(uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority) -> workgroup_id
+auto scheduler::create_group(uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority, core_kind cores)
+ -> workgroup_id
 {
   for (uint32_t i = 0; i < detail::v3::max_workgroup; ++i)
   {
     if (ouly::detail::vector_access(workgroup_descs_, i).thread_count_ == 0)
     {
       workgroup_id new_group{i};
-      create_group(new_group, start_thread_idx, thread_count, priority);
+      create_group(new_group, start_thread_idx, thread_count, priority, cores);
       return new_group;
     }
   }
   return workgroup_id{0};
 }
 
+void scheduler::set_group_weight(workgroup_id group, uint32_t weight)
+{
+  if (group.get_index() < detail::v3::max_workgroup)
+  {
+    ouly::detail::vector_access(workgroup_descs_, group.get_index()).weight_ = std::max(weight, 1U);
+  }
+}
+
+auto scheduler::get_executed_count(workgroup_id group) const noexcept -> uint64_t
+{
+  uint64_t count = 0;
+  for (uint32_t w = 0; w < worker_count_ && workers_; ++w)
+  {
+    count += ouly::detail::vector_access(ouly::detail::vector_access(workers_, w).executed_, group.get_index())
+              .load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+void scheduler::allow_loan(workgroup_id lender, workgroup_id borrower, uint32_t weight)
+{
+  if (lender.get_index() >= detail::v3::max_workgroup || borrower.get_index() >= detail::v3::max_workgroup ||
+      lender == borrower)
+  {
+    return;
+  }
+  auto& desc = ouly::detail::vector_access(workgroup_descs_, lender.get_index());
+  ouly::detail::vector_access(desc.loan_weights_, borrower.get_index()) = weight;
+}
+
 void scheduler::clear_group(workgroup_id group)
 {
   if (workgroups_ && group.get_index() < workgroup_count_)
@@ -402,7 +625,8 @@ void scheduler::clear_group(workgroup_id group)
 
 auto scheduler::get_worker_count(workgroup_id g) const noexcept -> uint32_t
 {
-  return ouly::detail::vector_access(workgroups_, g.get_index()).get_thread_count();
+  auto const& group = ouly::detail::vector_access(workgroups_, g.get_index());
+  return group.get_thread_count() + group.get_borrower_count();
 }
 
 auto scheduler::get_worker_start_idx(workgroup_id g) const noexcept -> uint32_t
@@ -0,0 +1,165 @@
+#include "ouly/allocators/allocation_trace.hpp"
+#include "catch2/catch_all.hpp"
+#include "ouly/allocators/default_allocator.hpp"
+#include "ouly/allocators/mmap_file.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// NOLINTBEGIN
+TEST_CASE("allocation_trace: recording_allocator writes a replayable trace", "[allocation_trace]")
+{
+  std::ostringstream        out(std::ios::binary);
+  ouly::allocation_recorder recorder(out);
+
+  ouly::default_allocator<>                            backing;
+  ouly::recording_allocator<ouly::default_allocator<>> heap(backing, recorder);
+
+  auto* a = heap.allocate(128, ouly::alignment<64>{});
+  auto* b = heap.zero_allocate(32);
+  heap.deallocate(a, 128, ouly::alignment<64>{});
+  recorder.record_defragment();
+  auto* c = heap.allocate(256);
+  heap.deallocate(b, 32);
+  heap.deallocate(c, 256);
+
+  REQUIRE(recorder.events_written() == 7);
+  REQUIRE(recorder.live_allocations() == 0);
+
+  auto const                  bytes = out.str();
+  ouly::allocation_trace_view trace(bytes.data(), bytes.size());
+  REQUIRE(trace.size() == 7);
+
+  std::vector<ouly::trace_event> events(trace.begin(), trace.end());
+  REQUIRE(events[0].op_ == ouly::trace_op::allocate);
+  REQUIRE(events[0].size_ == 128);
+  REQUIRE(events[0].alignment() == 64);
+  REQUIRE(events[1].op_ == ouly::trace_op::allocate);
+  REQUIRE(events[1].alignment() == 1);
+  REQUIRE(events[1].handle_ != events[0].handle_);
+  REQUIRE(events[2].op_ == ouly::trace_op::deallocate);
+  REQUIRE(events[2].handle_ == events[0].handle_);
+  REQUIRE(events[2].size_ == 128);
+  REQUIRE(events[3].op_ == ouly::trace_op::defragment);
+  // the handle released by `a` is recycled, keeping replay tables dense
+  REQUIRE(events[4].handle_ == events[0].handle_);
+  REQUIRE(events[5].handle_ == events[1].handle_);
+  REQUIRE(events[6].handle_ == events[4].handle_);
+  REQUIRE(trace.handle_count() == 2);
+}
+
+TEST_CASE("allocation_trace: trace maps back from a file", "[allocation_trace]")
+{
+  auto const path = std::filesystem::temp_directory_path() / "ouly_allocation_trace_test.trace";
+  {
+    std::ofstream             out(path, std::ios::binary | std::ios::trunc);
+    ouly::allocation_recorder recorder(out);
+    for (uint64_t key = 1; key <= 100; ++key)
+    {
+      recorder.record_allocate(key, key * 256, 256);
+    }
+    recorder.rekey(50, 1000);
+    for (uint64_t key = 1; key <= 100; ++key)
+    {
+      recorder.record_deallocate(key == 50 ? 1000 : key);
+    }
+  }
+
+  {
+    auto                        file = ouly::make_mmap_source(path);
+    ouly::allocation_trace_view trace(file.data(), file.size());
+    REQUIRE(trace.size() == 200);
+    REQUIRE(trace.handle_count() == 100);
+
+    uint64_t live = 0;
+    for (auto event : trace)
+    {
+      if (event.op_ == ouly::trace_op::allocate)
+      {
+        REQUIRE(event.alignment() == 256);
+        live += event.size_;
+      }
+      else
+      {
+        live -= event.size_;
+      }
+    }
+    REQUIRE(live == 0);
+    REQUIRE(trace[149].handle_ == 49);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("allocation_trace: malformed data is rejected", "[allocation_trace]")
+{
+  std::string const garbage(64, 'x');
+  bool              thrown = false;
+  try
+  {
+    ouly::allocation_trace_view trace(garbage.data(), garbage.size());
+  }
+  catch (std::system_error const&)
+  {
+    thrown = true;
+  }
+  REQUIRE(thrown);
+
+  thrown = false;
+  try
+  {
+    ouly::allocation_trace_view trace(garbage.data(), 4);
+  }
+  catch (std::system_error const&)
+  {
+    thrown = true;
+  }
+  REQUIRE(thrown);
+}
+TEST_CASE("allocation_trace: traces from later versions are read by event_size", "[allocation_trace]")
+{
+  // A later version that appends 8 bytes to every event
+  constexpr uint32_t event_size = sizeof(ouly::trace_event) + 8;
+
+  ouly::trace_header header;
+  header.version_    = ouly::trace_header::version_v + 1;
+  header.event_size_ = event_size;
+
+  std::vector<char> bytes(sizeof(header) + (3 * event_size), '\x7f');
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    ouly::trace_event event;
+    event.size_   = 16 * (i + 1);
+    event.handle_ = i;
+    std::memcpy(bytes.data() + sizeof(header) + (i * event_size), &event, sizeof(event));
+  }
+
+  ouly::allocation_trace_view trace(bytes.data(), bytes.size());
+  REQUIRE(trace.size() == 3);
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(trace[i].handle_ == i);
+    REQUIRE(trace[i].size_ == 16 * (i + 1));
+    REQUIRE(trace[i].op_ == ouly::trace_op::allocate);
+  }
+  REQUIRE(trace.handle_count() == 3);
+
+  // Events smaller than the ones this version knows cannot be read
+  header.event_size_ = sizeof(ouly::trace_event) - 4;
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  bool thrown = false;
+  try
+  {
+    ouly::allocation_trace_view rejected(bytes.data(), bytes.size());
+  }
+  catch (std::system_error const&)
+  {
+    thrown = true;
+  }
+  REQUIRE(thrown);
+}
+// NOLINTEND
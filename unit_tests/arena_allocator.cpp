@@ -6,6 +6,7 @@
 #include "ouly/allocators/strat/best_fit_v2.hpp"
 #include "ouly/allocators/strat/greedy_v0.hpp"
 #include "ouly/allocators/strat/greedy_v1.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
 #include <iostream>
 #include <random>
 #include <unordered_set>
@@ -188,7 +189,8 @@ TEMPLATE_TEST_CASE("Validate arena_allocator", "[arena_allocator.strat]",
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min0>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min2>), (ouly::strat::greedy_v1<>),
-                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>)
+                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>),
+                   (ouly::strat::tlsf<>)
 
 )
 {
@@ -204,7 +206,8 @@ TEMPLATE_TEST_CASE("Validate arena_allocator : 1542249547 init bug", "[arena_all
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min0>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min2>), (ouly::strat::greedy_v1<>),
-                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>)
+                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>),
+                   (ouly::strat::tlsf<>)
 
 )
 {
@@ -0,0 +1,504 @@
+// SPDX-License-Identifier: MIT
+//
+// Replays a binary allocation trace against every offset allocator so strategies can be compared
+// on a real workload instead of a synthetic micro benchmark.
+//
+//   arena_allocator   with each strategy in ouly/allocators/strat
+//   coalescing_arena_allocator
+//   gpu_allocator     with an executor that completes copies immediately
+//
+// Per allocator it times a full replay per allocate/deallocate and reports the peak backing footprint
+// (bytes in arenas) and fragmentation (peak footprint over peak live bytes).
+//
+// Usage:
+//   bench_allocation_replay                   synthesize a GPU-frame trace, write it, map it, replay it
+//   bench_allocation_replay <trace>           replay a trace recorded with ouly::allocation_recorder
+//   bench_allocation_replay --record <trace>  only write the synthetic trace
+//   --json <file>                             where to write the nanobench results
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include "nanobench.h"
+#include "ouly/allocators/allocation_trace.hpp"
+#include "ouly/allocators/arena_allocator.hpp"
+#include "ouly/allocators/coalescing_arena_allocator.hpp"
+#include "ouly/allocators/gpu_allocator.hpp"
+#include "ouly/allocators/mmap_file.hpp"
+#include "ouly/allocators/strat/best_fit_tree.hpp"
+#include "ouly/allocators/strat/best_fit_v0.hpp"
+#include "ouly/allocators/strat/best_fit_v1.hpp"
+#include "ouly/allocators/strat/best_fit_v2.hpp"
+#include "ouly/allocators/strat/greedy_v0.hpp"
+#include "ouly/allocators/strat/greedy_v1.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// NOLINTBEGIN
+namespace
+{
+
+constexpr uint32_t arena_size = 16 * 1024 * 1024;
+
+// Backing bytes currently held in arenas, and the peak
+struct footprint
+{
+  uint64_t current_ = 0;
+  uint64_t peak_    = 0;
+
+  void add(uint64_t size)
+  {
+    current_ += size;
+    peak_ = std::max(peak_, current_);
+  }
+
+  void remove(uint64_t size)
+  {
+    current_ -= size;
+  }
+};
+
+template <std::size_t... I, typename Fn>
+void dispatch_alignment(uint8_t log2, Fn& fn, std::index_sequence<I...> /*unused*/)
+{
+  ((log2 == I ? (fn(ouly::alignment<(std::size_t{1} << I)>{}), true) : false) || ...);
+}
+
+// Calls fn(ouly::alignment<N>{}) for a runtime log2 alignment up to 64 KiB
+template <typename Fn>
+void with_alignment(uint8_t log2, Fn&& fn)
+{
+  dispatch_alignment(log2, fn, std::make_index_sequence<17>{});
+}
+
+// ---------------------------------------------------------------------------------------------
+// arena_allocator
+
+struct arena_manager
+{
+  footprint*             footprint_ = nullptr;
+  std::vector<uint32_t>* blocks_    = nullptr;
+  std::vector<uint64_t>  sizes_;
+
+  auto drop_arena(std::uint32_t id) -> bool
+  {
+    footprint_->remove(std::exchange(sizes_[id], 0));
+    return true;
+  }
+
+  auto add_arena([[maybe_unused]] std::uint32_t id, std::size_t size) -> std::uint32_t
+  {
+    sizes_.push_back(size);
+    footprint_->add(size);
+    return static_cast<std::uint32_t>(sizes_.size() - 1);
+  }
+
+  void remove_arena(std::uint32_t id)
+  {
+    footprint_->remove(std::exchange(sizes_[id], 0));
+  }
+
+  template <typename A>
+  void begin_defragment(A& /*unused*/)
+  {}
+
+  template <typename A>
+  void end_defragment(A& /*unused*/)
+  {}
+
+  void rebind_alloc(std::uint32_t handle, [[maybe_unused]] std::uint32_t arena, std::uint32_t block,
+                    [[maybe_unused]] std::size_t offset)
+  {
+    (*blocks_)[handle] = block;
+  }
+
+  void move_memory([[maybe_unused]] std::uint32_t src_arena, [[maybe_unused]] std::uint32_t dst_arena,
+                   [[maybe_unused]] std::size_t from, [[maybe_unused]] std::size_t to,
+                   [[maybe_unused]] std::size_t size)
+  {}
+};
+
+template <typename Strategy>
+struct arena_replay
+{
+  using allocator_t =
+   ouly::arena_allocator<ouly::config<ouly::cfg::strategy<Strategy>, ouly::cfg::manager<arena_manager>>>;
+
+  footprint             footprint_;
+  std::vector<uint32_t> blocks_;
+  arena_manager         manager_{.footprint_ = &footprint_, .blocks_ = &blocks_, .sizes_ = {}};
+  allocator_t           allocator_{arena_size, manager_};
+
+  explicit arena_replay(uint32_t handles) : blocks_(handles) {}
+
+  void allocate(ouly::trace_event const& event)
+  {
+    with_alignment(event.alignment_log2_,
+                   [&](auto alignment)
+                   {
+                     auto [arena, block, offset] =
+                      allocator_.allocate(static_cast<uint32_t>(event.size_), alignment, event.handle_);
+                     blocks_[event.handle_] = block;
+                   });
+  }
+
+  void deallocate(ouly::trace_event const& event)
+  {
+    allocator_.deallocate(blocks_[event.handle_]);
+  }
+
+  void defragment()
+  {
+    if constexpr (allocator_t::can_defragment)
+    {
+      allocator_.defragment();
+    }
+  }
+};
+
+// ---------------------------------------------------------------------------------------------
+// coalescing_arena_allocator
+
+struct coalescing_manager
+{
+  footprint*            footprint_ = nullptr;
+  std::vector<uint64_t> sizes_;
+
+  void add(ouly::arena_id arena, ouly::allocation_size_type size)
+  {
+    if (sizes_.size() <= arena.get())
+    {
+      sizes_.resize(arena.get() + 1);
+    }
+    sizes_[arena.get()] = size;
+    footprint_->add(size);
+  }
+
+  void remove(ouly::arena_id arena)
+  {
+    footprint_->remove(std::exchange(sizes_[arena.get()], 0));
+  }
+};
+
+struct coalescing_replay
+{
+  footprint                        footprint_;
+  coalescing_manager               manager_{.footprint_ = &footprint_, .sizes_ = {}};
+  ouly::coalescing_arena_allocator allocator_{arena_size};
+  std::vector<ouly::allocation_id> ids_;
+
+  explicit coalescing_replay(uint32_t handles) : ids_(handles) {}
+
+  void allocate(ouly::trace_event const& event)
+  {
+    with_alignment(event.alignment_log2_,
+                   [&](auto alignment)
+                   {
+                     ids_[event.handle_] =
+                      allocator_.allocate(static_cast<uint32_t>(event.size_), manager_, alignment).get_allocation_id();
+                   });
+  }
+
+  void deallocate(ouly::trace_event const& event)
+  {
+    allocator_.deallocate(ids_[event.handle_], manager_);
+  }
+
+  // no defragmentation pass; see best_fit_defrag_allocator
+  void defragment() {}
+};
+
+// ---------------------------------------------------------------------------------------------
+// gpu_allocator
+
+struct gpu_manager
+{
+  footprint*            footprint_ = nullptr;
+  std::vector<uint64_t> sizes_;
+
+  void add(ouly::arena_id arena, ouly::allocation_size_type size)
+  {
+    if (sizes_.size() <= arena.get())
+    {
+      sizes_.resize(arena.get() + 1);
+    }
+    sizes_[arena.get()] = size;
+    footprint_->add(size);
+  }
+
+  void remove(ouly::arena_id arena)
+  {
+    footprint_->remove(std::exchange(sizes_[arena.get()], 0));
+  }
+};
+
+// Copies and reference switches complete as soon as they are submitted
+struct immediate_executor
+{
+  ouly::gpu_timeline_value next_ = 1;
+
+  auto schedule_copy(ouly::gpu_relocation const& /*unused*/) -> std::optional<ouly::gpu_timeline_value>
+  {
+    return next_++;
+  }
+
+  auto switch_references(ouly::gpu_relocation const& /*unused*/) -> std::optional<ouly::gpu_timeline_value>
+  {
+    return next_++;
+  }
+
+  [[nodiscard]] auto is_complete(ouly::gpu_timeline_value /*unused*/) const -> bool
+  {
+    return true;
+  }
+};
+
+struct gpu_replay
+{
+  footprint                        footprint_;
+  gpu_manager                      manager_{.footprint_ = &footprint_, .sizes_ = {}};
+  immediate_executor               executor_;
+  ouly::gpu_allocator              allocator_{arena_size};
+  std::vector<ouly::allocation_id> ids_;
+
+  explicit gpu_replay(uint32_t handles) : ids_(handles) {}
+
+  void allocate(ouly::trace_event const& event)
+  {
+    ids_[event.handle_] =
+     allocator_
+      .allocate(static_cast<uint32_t>(event.size_), manager_,
+                ouly::gpu_allocation_options{.alignment_ = static_cast<ouly::allocation_size_type>(event.alignment())})
+      .get_allocation_id();
+  }
+
+  void deallocate(ouly::trace_event const& event)
+  {
+    if (!allocator_.try_deallocate(ids_[event.handle_], manager_))
+    {
+      allocator_.process_completions(manager_, executor_);
+      allocator_.deallocate(ids_[event.handle_], manager_);
+    }
+  }
+
+  void defragment()
+  {
+    for (int pass = 0; pass < 64; ++pass)
+    {
+      allocator_.defragment(manager_, executor_);
+      if (!allocator_.process_completions(manager_, executor_).evacuation_active_)
+      {
+        break;
+      }
+    }
+  }
+};
+
+// ---------------------------------------------------------------------------------------------
+// replay
+
+// Footprint of the last replay of one allocator
+struct replay_summary
+{
+  uint64_t peak_footprint_ = 0;
+  uint64_t peak_live_      = 0;
+};
+
+template <typename Replay>
+auto replay_once(ouly::allocation_trace_view const& trace, uint32_t handles) -> replay_summary
+{
+  auto     r         = std::make_unique<Replay>(handles);
+  uint64_t live      = 0;
+  uint64_t peak_live = 0;
+  for (auto event : trace)
+  {
+    if (event.op_ == ouly::trace_op::defragment)
+    {
+      r->defragment();
+    }
+    else if (event.op_ == ouly::trace_op::allocate)
+    {
+      r->allocate(event);
+      live += event.size_;
+      peak_live = std::max(peak_live, live);
+    }
+    else
+    {
+      r->deallocate(event);
+      live -= event.size_;
+    }
+  }
+  return {.peak_footprint_ = r->footprint_.peak_, .peak_live_ = peak_live};
+}
+
+// Each epoch replays the whole trace into a fresh allocator, including its defragmentation requests
+template <typename Replay>
+void replay(ankerl::nanobench::Bench& bench, std::string const& name, ouly::allocation_trace_view const& trace,
+            uint32_t handles)
+{
+  replay_summary summary;
+  bench.run(name,
+            [&]()
+            {
+              summary = replay_once<Replay>(trace, handles);
+            });
+
+  constexpr double mib      = 1024.0 * 1024.0;
+  auto const       peak     = static_cast<double>(summary.peak_footprint_);
+  auto const       live     = static_cast<double>(summary.peak_live_);
+  auto const       overhead = summary.peak_live_ != 0 ? 100.0 * (peak / live - 1.0) : 0.0;
+  std::cout << std::fixed << std::setprecision(1) << name << ": peak " << peak / mib << " MiB, live " << live / mib
+            << " MiB, waste " << overhead << " %\n";
+}
+
+// ---------------------------------------------------------------------------------------------
+// synthetic trace
+
+// A GPU frame loop: per-frame transient buffers freed at the end of the frame, streaming resources
+// with random lifetimes, and a defragmentation request every 60 frames
+void synthesize(std::filesystem::path const& path, uint32_t frames)
+{
+  std::ofstream             out(path, std::ios::binary | std::ios::trunc);
+  ouly::allocation_recorder recorder(out);
+
+  std::mt19937                           gen(0x7ace);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  auto log_uniform = [&](double lo, double hi) -> uint64_t
+  {
+    auto const v = std::exp2(std::log2(lo) + unit(gen) * (std::log2(hi) - std::log2(lo)));
+    return (static_cast<uint64_t>(v) + 255) & ~uint64_t{255};
+  };
+
+  uint64_t              next_key = 1;
+  std::vector<uint64_t> resources;
+  std::vector<uint64_t> transients;
+  for (uint32_t frame = 0; frame < frames; ++frame)
+  {
+    auto const transient_count = 20 + (gen() % 40);
+    for (uint32_t i = 0; i < transient_count; ++i)
+    {
+      transients.push_back(next_key);
+      recorder.record_allocate(next_key++, log_uniform(256, 256 * 1024), 256);
+    }
+
+    auto const resource_count = gen() % 8;
+    for (uint32_t i = 0; i < resource_count; ++i)
+    {
+      auto const size = log_uniform(4096, 4 * 1024 * 1024);
+      resources.push_back(next_key);
+      recorder.record_allocate(next_key++, size, size >= 1024 * 1024 ? 65536 : 4096);
+    }
+
+    // streaming: evict resources so the live set hovers around 1500
+    while (resources.size() > 1500 || (!resources.empty() && unit(gen) < 0.5))
+    {
+      auto const idx = gen() % resources.size();
+      recorder.record_deallocate(resources[idx]);
+      resources[idx] = resources.back();
+      resources.pop_back();
+    }
+
+    for (auto key : transients)
+    {
+      recorder.record_deallocate(key);
+    }
+    transients.clear();
+
+    if (frame % 60 == 59)
+    {
+      recorder.record_defragment();
+    }
+  }
+  for (auto key : resources)
+  {
+    recorder.record_deallocate(key);
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::filesystem::path path;
+  std::string           json_file = "allocation_replay.json";
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string_view arg = argv[i];
+    if (arg == "--record" && i + 1 < argc)
+    {
+      synthesize(argv[i + 1], 2000);
+      std::cout << "wrote " << argv[i + 1] << '\n';
+      return 0;
+    }
+    if (arg == "--json" && i + 1 < argc)
+    {
+      json_file = argv[++i];
+    }
+    else if (!arg.starts_with("-") && path.empty())
+    {
+      path = arg;
+    }
+    else
+    {
+      std::cout << "Usage: " << argv[0] << " [--json file] [trace | --record trace]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+  if (path.empty())
+  {
+    path = std::filesystem::temp_directory_path() / "ouly_allocation_replay.trace";
+    synthesize(path, 2000);
+  }
+
+  auto                              file = ouly::make_mmap_source(path);
+  ouly::allocation_trace_view const trace(file.data(), file.size());
+  auto const                        handles = trace.handle_count();
+  uint64_t                          ops     = 0;
+  for (auto event : trace)
+  {
+    ops += event.op_ != ouly::trace_op::defragment ? 1 : 0;
+  }
+  std::cout << path.string() << ": " << trace.size() << " events, " << handles << " handles\n";
+
+  ankerl::nanobench::Bench bench;
+  bench.title("Allocation trace replay")
+   .unit("op")
+   .batch(ops)
+   .warmup(1)
+   .epochs(5)
+   .epochIterations(1)
+   .relative(true);
+  replay<arena_replay<ouly::strat::greedy_v0<>>>(bench, "arena greedy-v0", trace, handles);
+  replay<arena_replay<ouly::strat::greedy_v1<>>>(bench, "arena greedy-v1", trace, handles);
+  replay<arena_replay<ouly::strat::best_fit_v0<>>>(bench, "arena bf-v0", trace, handles);
+  replay<arena_replay<ouly::strat::best_fit_v1<>>>(bench, "arena bf-v1", trace, handles);
+  replay<arena_replay<ouly::strat::best_fit_v2<>>>(bench, "arena bf-v2", trace, handles);
+  replay<arena_replay<ouly::strat::best_fit_tree<>>>(bench, "arena bf-tree", trace, handles);
+  replay<arena_replay<ouly::strat::tlsf<>>>(bench, "arena tlsf", trace, handles);
+  replay<coalescing_replay>(bench, "coalescing_arena", trace, handles);
+  replay<gpu_replay>(bench, "gpu_allocator", trace, handles);
+
+  std::ofstream out(json_file);
+  if (!out)
+  {
+    std::cerr << "cannot write " << json_file << "\n";
+    return 1;
+  }
+  bench.render(ankerl::nanobench::templates::json(), out);
+  std::cout << "results written to " << json_file << "\n";
+  return 0;
+}
+// NOLINTEND
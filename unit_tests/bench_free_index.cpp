@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: MIT
+//
+// Free-block index benchmark: first-fit scan against TLSF for coalescing_allocator and
+// compacting_allocator, replaying a GPU-heap-like trace.
+//
+//   sizes       log-uniform between 256 B and 1 MiB, rounded to 256 B
+//   lifetimes   mostly random (long-lived resources), some freed right after allocation (staging)
+//   live set    ~10k blocks held while the trace runs
+//
+// Times the steady phase per operation and reports fragmentation: the high-water offset compared to
+// the bytes live at that moment.
+//
+// Usage: bench_free_index [--json file] [--live blocks] [--ops pairs]
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include "nanobench.h"
+#include "ouly/allocators/compacting_allocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using size_type = ouly::coalescing_allocator_size_type;
+
+struct trace_op
+{
+  size_type size_ = 0; // 0 frees `slot_`
+  uint32_t  slot_ = 0;
+};
+
+struct trace
+{
+  std::vector<size_type> warmup_;
+  std::vector<trace_op>  steady_;
+};
+
+auto make_trace(uint32_t live_blocks, uint32_t operations) -> trace
+{
+  std::mt19937                           gen(0x5eed);
+  std::uniform_real_distribution<double> log_size(std::log2(256.0), std::log2(1024.0 * 1024.0));
+  std::uniform_int_distribution<int>     percent(0, 99);
+
+  auto next_size = [&]() -> size_type
+  {
+    auto const bytes = static_cast<size_type>(std::exp2(log_size(gen)));
+    return std::max<size_type>(256, (bytes + 255) & ~size_type{255});
+  };
+
+  trace result;
+  result.warmup_.reserve(live_blocks);
+  for (uint32_t i = 0; i < live_blocks; ++i)
+  {
+    result.warmup_.push_back(next_size());
+  }
+
+  // The steady phase keeps the live set size: every allocation lands in the slot just freed
+  result.steady_.reserve(std::size_t{operations} * 2);
+  uint32_t last = 0;
+  for (uint32_t i = 0; i < operations; ++i)
+  {
+    uint32_t slot = percent(gen) < 30 ? last : std::uniform_int_distribution<uint32_t>(0, live_blocks - 1)(gen);
+    result.steady_.push_back({.size_ = 0, .slot_ = slot});
+    result.steady_.push_back({.size_ = next_size(), .slot_ = slot});
+    last = slot;
+  }
+  return result;
+}
+
+struct coalescing_adapter
+{
+  struct handle
+  {
+    size_type offset_ = 0;
+    size_type size_   = 0;
+  };
+
+  explicit coalescing_adapter(ouly::fit_strategy strategy) : allocator_(strategy) {}
+
+  auto allocate(size_type size) -> handle
+  {
+    return {.offset_ = allocator_.allocate(size), .size_ = size};
+  }
+
+  void deallocate(handle h)
+  {
+    allocator_.deallocate(h.offset_, h.size_);
+  }
+
+  static auto end_of(handle h) -> uint64_t
+  {
+    return uint64_t{h.offset_} + h.size_;
+  }
+
+  ouly::coalescing_allocator allocator_;
+};
+
+struct compacting_adapter
+{
+  struct handle
+  {
+    ouly::allocation_id id_;
+    size_type           end_ = 0;
+  };
+
+  explicit compacting_adapter(ouly::fit_strategy strategy) : allocator_(strategy) {}
+
+  auto allocate(size_type size) -> handle
+  {
+    auto id = allocator_.allocate(size);
+    return {.id_ = id, .end_ = allocator_.get_offset(id) + size};
+  }
+
+  void deallocate(handle h)
+  {
+    allocator_.deallocate(h.id_);
+  }
+
+  static auto end_of(handle h) -> uint64_t
+  {
+    return h.end_;
+  }
+
+  ouly::compacting_allocator allocator_;
+};
+
+// Fragmentation of one allocator over every replay of the trace
+struct fragmentation
+{
+  uint64_t high_water_ = 0;
+  uint64_t live_bytes_ = 0; // bytes live when the high-water mark was reached
+};
+
+template <typename Adapter>
+void bench_replay(ankerl::nanobench::Bench& bench, std::string const& name, ouly::fit_strategy strategy,
+                  trace const& t)
+{
+  Adapter                               adapter(strategy);
+  std::vector<typename Adapter::handle> slots;
+  slots.reserve(t.warmup_.size());
+  uint64_t live = 0;
+  for (auto size : t.warmup_)
+  {
+    slots.push_back(adapter.allocate(size));
+    live += size;
+  }
+
+  // Every steady-phase allocation lands in the slot just freed, so the trace can be replayed back to back
+  std::vector<size_type> sizes(t.warmup_.begin(), t.warmup_.end());
+  fragmentation          result;
+  bench.run(name,
+            [&]()
+            {
+              for (auto const& op : t.steady_)
+              {
+                if (op.size_ == 0)
+                {
+                  adapter.deallocate(slots[op.slot_]);
+                  live -= sizes[op.slot_];
+                }
+                else
+                {
+                  slots[op.slot_] = adapter.allocate(op.size_);
+                  sizes[op.slot_] = op.size_;
+                  live += op.size_;
+                  auto const end = Adapter::end_of(slots[op.slot_]);
+                  if (end > result.high_water_)
+                  {
+                    result.high_water_ = end;
+                    result.live_bytes_ = live;
+                  }
+                }
+              }
+            });
+
+  constexpr double mib   = 1024.0 * 1024.0;
+  double           waste = 0;
+  if (result.live_bytes_ != 0)
+  {
+    waste = 100.0 * (static_cast<double>(result.high_water_) / static_cast<double>(result.live_bytes_) - 1.0);
+  }
+  std::cout << std::fixed << std::setprecision(1) << name << ": peak "
+            << static_cast<double>(result.high_water_) / mib << " MiB, live "
+            << static_cast<double>(result.live_bytes_) / mib << " MiB, waste " << waste << " %\n";
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+  std::string json_file   = "free_index.json";
+  uint32_t    live_blocks = 10000;
+  uint32_t    operations  = 100000;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json" && i + 1 < argc)
+    {
+      json_file = argv[++i];
+    }
+    else if (arg == "--live" && i + 1 < argc)
+    {
+      live_blocks = static_cast<uint32_t>(std::stoul(argv[++i]));
+    }
+    else if (arg == "--ops" && i + 1 < argc)
+    {
+      operations = static_cast<uint32_t>(std::stoul(argv[++i]));
+    }
+    else
+    {
+      std::cout << "Usage: " << argv[0] << " [--json file] [--live blocks] [--ops pairs]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  auto const t = make_trace(live_blocks, operations);
+
+  ankerl::nanobench::Bench bench;
+  bench.title("Free-block index, " + std::to_string(live_blocks) + " live blocks")
+   .unit("op")
+   .batch(t.steady_.size())
+   .warmup(1)
+   .epochs(5)
+   .epochIterations(1)
+   .relative(true);
+  bench_replay<coalescing_adapter>(bench, "coalescing first_fit", ouly::fit_strategy::first_fit, t);
+  bench_replay<coalescing_adapter>(bench, "coalescing tlsf", ouly::fit_strategy::tlsf, t);
+  bench_replay<compacting_adapter>(bench, "compacting first_fit", ouly::fit_strategy::first_fit, t);
+  bench_replay<compacting_adapter>(bench, "compacting tlsf", ouly::fit_strategy::tlsf, t);
+
+  std::ofstream out(json_file);
+  if (!out)
+  {
+    std::cerr << "cannot write " << json_file << "\n";
+    return 1;
+  }
+  bench.render(ankerl::nanobench::templates::json(), out);
+  std::cout << "results written to " << json_file << "\n";
+  return 0;
+}
@@ -7,6 +7,7 @@
 #include "ouly/allocators/strat/best_fit_v2.hpp"
 #include "ouly/allocators/strat/greedy_v0.hpp"
 #include "ouly/allocators/strat/greedy_v1.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
 #include <string_view>
 
 // NOLINTBEGIN
@@ -97,6 +98,7 @@ int main(int argc, char* argv[])
   bench_arena<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min0>>(size, "bf-v2-min0");
   bench_arena<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>>(size, "bf-v2-min1");
   bench_arena<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min2>>(size, "bf-v2-min2");
+  bench_arena<ouly::strat::tlsf<>>(size, "tlsf");
 
   return 0;
 }
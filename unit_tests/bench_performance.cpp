@@ -3,16 +3,22 @@
 #include "nanobench.h"
 #include "ouly/allocators/coalescing_arena_allocator.hpp"
 #include "ouly/allocators/ts_shared_linear_allocator.hpp"
+#include "ouly/allocators/ts_size_class_allocator.hpp"
 #include "ouly/allocators/ts_thread_local_allocator.hpp"
+#include "ouly/allocators/virtual_allocator.hpp"
+#include "ouly/containers/spsc_ring.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
 #include <atomic>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <random>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 // Include oneTBB headers for comparison benchmarks
@@ -269,6 +275,151 @@ void bench_ts_thread_local_allocator()
             });
 }
 
+// General-purpose allocation patterns, run against glibc malloc and ts_size_class_allocator
+struct malloc_backend
+{
+  static auto allocate(std::size_t size) -> void*
+  {
+    return std::malloc(size); // NOLINT(cppcoreguidelines-no-malloc)
+  }
+
+  static void deallocate(void* ptr, std::size_t /*size*/)
+  {
+    std::free(ptr); // NOLINT(cppcoreguidelines-no-malloc)
+  }
+};
+
+struct size_class_backend
+{
+  ouly::ts_size_class_allocator allocator_;
+
+  auto allocate(std::size_t size) -> void*
+  {
+    return allocator_.allocate(size);
+  }
+
+  void deallocate(void* ptr, std::size_t size)
+  {
+    allocator_.deallocate(ptr, size);
+  }
+};
+
+constexpr std::size_t mixed_block_count = 4096;
+
+auto mixed_sizes() -> std::vector<std::size_t> const&
+{
+  static std::vector<std::size_t> const sizes = []()
+  {
+    std::mt19937                          rng(42); // NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<size_t> small(8, 256);
+    std::uniform_int_distribution<size_t> medium(257, 4096);
+    std::vector<std::size_t>              result(mixed_block_count);
+    for (auto& size : result)
+    {
+      // Mostly small objects with a tail of medium buffers, like a typical heap profile
+      size = (rng() % 8 == 0) ? medium(rng) : small(rng);
+    }
+    return result;
+  }();
+  return sizes;
+}
+
+template <typename Backend>
+void bench_general_allocator(ankerl::nanobench::Bench& bench, std::string const& name, Backend& backend)
+{
+  auto const& sizes = mixed_sizes();
+
+  // Same-thread churn: allocate a working set, free every other block, refill, free all
+  bench.run(name + " mixed sizes same thread",
+            [&]
+            {
+              std::vector<void*> blocks(sizes.size());
+              for (std::size_t i = 0; i < sizes.size(); ++i)
+              {
+                blocks[i] = backend.allocate(sizes[i]);
+              }
+              for (std::size_t i = 0; i < sizes.size(); i += 2)
+              {
+                backend.deallocate(blocks[i], sizes[i]);
+                blocks[i] = backend.allocate(sizes[i]);
+              }
+              for (std::size_t i = 0; i < sizes.size(); ++i)
+              {
+                backend.deallocate(blocks[i], sizes[i]);
+              }
+              ankerl::nanobench::doNotOptimizeAway(blocks.data());
+            });
+
+  // Producer/consumer: one thread allocates, another frees, so every free is cross-thread
+  bench.run(name + " producer/consumer free",
+            [&]
+            {
+              auto        ring = std::make_unique<ouly::spsc_ring<std::pair<void*, std::size_t>, 1024>>();
+              std::thread consumer(
+               [&]()
+               {
+                 std::pair<void*, std::size_t> block;
+                 for (std::size_t i = 0; i < sizes.size(); ++i)
+                 {
+                   while (!ring->try_pop(block))
+                   {
+                     std::this_thread::yield();
+                   }
+                   backend.deallocate(block.first, block.second);
+                 }
+               });
+              for (auto size : sizes)
+              {
+                std::pair<void*, std::size_t> block{backend.allocate(size), size};
+                while (!ring->try_push(block))
+                {
+                  std::this_thread::yield();
+                }
+              }
+              consumer.join();
+            });
+
+  // Independent threads: per-thread caches against the shared heap
+  bench.run(name + " 4 threads mixed sizes",
+            [&]
+            {
+              std::vector<std::thread> threads;
+              for (int t = 0; t < 4; ++t)
+              {
+                threads.emplace_back(
+                 [&]()
+                 {
+                   std::vector<void*> blocks(sizes.size() / 4);
+                   for (std::size_t i = 0; i < blocks.size(); ++i)
+                   {
+                     blocks[i] = backend.allocate(sizes[i]);
+                   }
+                   for (std::size_t i = 0; i < blocks.size(); ++i)
+                   {
+                     backend.deallocate(blocks[i], sizes[i]);
+                   }
+                 });
+              }
+              for (auto& thread : threads)
+              {
+                thread.join();
+              }
+            });
+}
+
+void bench_ts_size_class_allocator()
+{
+  std::cout << "Benchmarking ts_size_class_allocator against malloc...\n";
+
+  ankerl::nanobench::Bench bench;
+  bench.title("General-purpose allocation").unit("block").batch(mixed_block_count).warmup(3).minEpochIterations(20);
+
+  malloc_backend system_heap;
+  bench_general_allocator(bench, "malloc", system_heap);
+  size_class_backend size_classes;
+  bench_general_allocator(bench, "ts_size_class", size_classes);
+}
+
 void bench_coalescing_arena_allocator()
 {
   std::cout << "Benchmarking coalescing_arena_allocator...\n";
@@ -373,6 +524,54 @@ void bench_coalescing_arena_allocator()
             });
 }
 
+// Random reads over a region far larger than the TLB reach of 4 KiB pages. Each index depends on the
+// previous read, so the loop measures load latency including the page walk on every TLB miss.
+void bench_huge_pages()
+{
+  std::cout << "Benchmarking huge page backing...\n";
+
+  constexpr std::size_t region_bytes = std::size_t{256} * 1024 * 1024;
+  constexpr std::size_t word_count   = region_bytes / sizeof(uint64_t);
+  constexpr uint32_t    reads        = 1U << 20U;
+
+  ankerl::nanobench::Bench bench;
+  bench.title("TLB-heavy random access").unit("read").batch(reads).warmup(1).minEpochIterations(5);
+
+  auto run = [&](char const* name, auto config)
+  {
+    using allocator_t = ouly::virtual_allocator<decltype(config)>;
+    allocator_t allocator;
+    auto*       words = static_cast<uint64_t*>(allocator.allocate(region_bytes));
+    if (words == nullptr)
+    {
+      std::cout << "  " << name << ": mapping failed, skipped\n";
+      return;
+    }
+    std::iota(words, words + word_count, uint64_t{0});
+
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    bench.run(name,
+              [&]
+              {
+                uint64_t sum = 0;
+                for (uint32_t i = 0; i < reads; ++i)
+                {
+                  state ^= state << 13U;
+                  state ^= state >> 7U;
+                  state ^= state << 17U;
+                  sum += words[(state ^ sum) & (word_count - 1)];
+                }
+                ankerl::nanobench::doNotOptimizeAway(sum);
+              });
+    allocator.deallocate(words, region_bytes);
+  };
+
+  using ouly::cfg::page_backing;
+  run("normal pages", ouly::config<>{});
+  run("transparent huge pages", ouly::config<ouly::cfg::backing_pages<page_backing::transparent_huge>>{});
+  run("reserved huge pages", ouly::config<ouly::cfg::backing_pages<page_backing::huge>>{});
+}
+
 int main(int argc, char* argv[])
 {
   std::cout << "Starting ouly performance benchmarks...\n";
@@ -381,7 +580,9 @@ int main(int argc, char* argv[])
   {
     bench_ts_shared_linear_allocator();
     bench_ts_thread_local_allocator();
+    bench_ts_size_class_allocator();
     bench_coalescing_arena_allocator();
+    bench_huge_pages();
 
     std::cout << "\nBenchmarks completed successfully!\n";
 
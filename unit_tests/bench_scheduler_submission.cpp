@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+//
+// Burst cross-group submission: producer tasks running on workers of their own workgroup push bursts of
+// tasks into a workgroup whose workers stay busy for the whole run, so the target's mailbox ring fills up
+// and the rest of every burst goes to its overflow. Measures the cost per submit for each producer count.
+// Every burst waits in the target until the run ends, so the queued tasks are only drained and counted
+// after it.
+//
+// Usage: bench_scheduler_submission [--json file]
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include "nanobench.h"
+#include "ouly/scheduler/scheduler.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+constexpr uint32_t burst_size    = 16384;
+constexpr uint32_t target_width  = 2;
+constexpr uint32_t burst_samples = 5;
+
+void bench_cross_group_burst(ankerl::nanobench::Bench& bench, uint32_t producers)
+{
+  // Group 0 is the main thread, group 1 the busy target, group 2 runs one producer task per worker
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.create_group(ouly::workgroup_id(1), 1, target_width);
+  scheduler.create_group(ouly::workgroup_id(2), 1 + target_width, producers);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  // Occupy the target group's workers so every burst has to queue
+  std::atomic_bool release{false};
+  for (uint32_t i = 0; i < target_width; ++i)
+  {
+    scheduler.submit(ctx, ouly::workgroup_id(1),
+                     [&release](ouly::task_context const&)
+                     {
+                       while (!release.load(std::memory_order_acquire))
+                       {
+                         std::this_thread::yield();
+                       }
+                     });
+  }
+
+  std::atomic<uint64_t> executed{0};
+  uint64_t              submitted = 0;
+  bench.batch(static_cast<uint64_t>(producers) * burst_size)
+   .run("producers " + std::to_string(producers),
+        [&]()
+        {
+          std::atomic<uint32_t> finished{0};
+          for (uint32_t p = 0; p < producers; ++p)
+          {
+            // Each producer submits with the context of the worker it runs on
+            scheduler.submit(ctx, ouly::workgroup_id(2),
+                             [&](ouly::task_context const& producer_ctx)
+                             {
+                               for (uint32_t i = 0; i < burst_size; ++i)
+                               {
+                                 scheduler.submit(producer_ctx, ouly::workgroup_id(1),
+                                                  [&executed](ouly::task_context const&)
+                                                  {
+                                                    executed.fetch_add(1, std::memory_order_relaxed);
+                                                  });
+                               }
+                               finished.fetch_add(1, std::memory_order_release);
+                             });
+          }
+          while (finished.load(std::memory_order_acquire) != producers)
+          {
+            std::this_thread::yield();
+          }
+          submitted += static_cast<uint64_t>(producers) * burst_size;
+        });
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  if (executed.load() != submitted)
+  {
+    std::cerr << "lost tasks: executed " << executed.load() << " of " << submitted << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+  std::string json_file = "scheduler_submission.json";
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json" && i + 1 < argc)
+    {
+      json_file = argv[++i];
+    }
+    else
+    {
+      std::cout << "Usage: " << argv[0] << " [--json file]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  // One burst per epoch: the queued tasks pile up until the run ends, so the sample count stays small
+  ankerl::nanobench::Bench bench;
+  bench.title("Burst cross-group submission").unit("submit").warmup(1).epochs(burst_samples).epochIterations(1);
+  for (uint32_t producers : {1U, 2U, 4U, 8U})
+  {
+    bench_cross_group_burst(bench, producers);
+  }
+
+  std::ofstream out(json_file);
+  if (!out)
+  {
+    std::cerr << "cannot write " << json_file << "\n";
+    return 1;
+  }
+  bench.render(ankerl::nanobench::templates::json(), out);
+  std::cout << "results written to " << json_file << "\n";
+  return 0;
+}
@@ -0,0 +1,886 @@
+// SPDX-License-Identifier: MIT
+//
+// Canonical task-parallel kernels run on the v1, v2 and v3 schedulers and on TBB, for a range of
+// thread counts. Results are written as nanobench JSON; compare two runs with
+// scripts/compare_benchmarks.py to catch regressions before switching scheduler versions.
+//
+// Kernels:
+//   fib            recursive fork/join, one spawn per call (Cilk classic)
+//   nqueens        backtracking search, one spawn per legal placement near the root
+//   uts            unbalanced tree search: geometric tree with a hash-defined, very uneven shape
+//   skynet         ten-way fan-out, one million leaves
+//   fanout         one parent spawning many tiny independent children, then joining
+//   nested_for     parallel_for whose body runs another parallel_for
+//   matmul         dense matrix multiply, parallel over rows
+//
+// Usage: bench_scheduler_suite [--json file] [--threads 1,2,4] [--kernel name] [--quick]
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include "nanobench.h"
+#include "ouly/scheduler/parallel_for.hpp"
+#include "ouly/scheduler/scheduler.hpp"
+#include "ouly/scheduler/task.hpp"
+#include "ouly/scheduler/v1/scheduler.hpp"
+#include "ouly/scheduler/v3/scheduler.hpp"
+#include "ouly/utility/subrange.hpp"
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct suite_config
+{
+  uint32_t fib_n          = 30;
+  uint32_t queens_n       = 11;
+  uint32_t uts_roots      = 2000;
+  uint32_t skynet_leaves  = 1000000;
+  uint32_t fanout_tasks   = 20000;
+  uint32_t nested_outer   = 64;
+  uint32_t nested_inner   = 4096;
+  uint32_t matmul_n       = 256;
+  uint32_t min_iterations = 5;
+};
+
+// Below these sizes kernels recurse serially; every backend uses the same cutoffs.
+constexpr uint32_t fib_cutoff    = 12;
+constexpr uint32_t queens_cutoff = 3;
+constexpr uint32_t uts_cutoff    = 4;
+constexpr uint32_t skynet_cutoff = 1000;
+
+// ---------------------------------------------------------------------------------------------
+// Serial building blocks
+
+auto fib_serial(uint32_t n) -> uint64_t
+{
+  return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+auto queens_safe(std::array<uint8_t, 32> const& board, uint32_t row, uint32_t col) -> bool
+{
+  for (uint32_t r = 0; r < row; ++r)
+  {
+    auto c = static_cast<uint32_t>(board[r]);
+    if (c == col || c + row == col + r || c + r == col + row)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto queens_serial(std::array<uint8_t, 32>& board, uint32_t row, uint32_t n) -> uint64_t
+{
+  if (row == n)
+  {
+    return 1;
+  }
+  uint64_t count = 0;
+  for (uint32_t col = 0; col < n; ++col)
+  {
+    if (queens_safe(board, row, col))
+    {
+      board[row] = static_cast<uint8_t>(col);
+      count += queens_serial(board, row + 1, n);
+    }
+  }
+  return count;
+}
+
+// Unbalanced tree: every node has `uts_branch` children with probability uts_q / 2^32 and none
+// otherwise, decided by a hash of the node id, so the shape is fixed but unpredictable.
+constexpr uint32_t uts_branch = 5;
+constexpr uint64_t uts_q      = 854698240ULL; // ~0.199 of 2^32, so each subtree has ~200 nodes on average
+
+auto uts_hash(uint64_t x) -> uint64_t
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27U)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31U);
+}
+
+auto uts_children(uint64_t node) -> uint32_t
+{
+  return (uts_hash(node) & 0xffffffffULL) < uts_q ? uts_branch : 0;
+}
+
+auto uts_child(uint64_t node, uint32_t index) -> uint64_t
+{
+  return uts_hash(node * uts_branch + index + 1);
+}
+
+auto uts_serial(uint64_t node) -> uint64_t
+{
+  uint64_t count = 1;
+  auto     n     = uts_children(node);
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    count += uts_serial(uts_child(node, i));
+  }
+  return count;
+}
+
+auto skynet_serial(uint64_t first, uint64_t size) -> uint64_t
+{
+  return (first + first + size - 1) * size / 2;
+}
+
+struct matrices
+{
+  explicit matrices(uint32_t n) : n_(n), a_(size_t{n} * n), b_(size_t{n} * n), c_(size_t{n} * n)
+  {
+    for (size_t i = 0; i < a_.size(); ++i)
+    {
+      a_[i] = static_cast<float>(i % 7) * 0.5F;
+      b_[i] = static_cast<float>(i % 5) * 0.25F;
+    }
+  }
+
+  void row(uint32_t i)
+  {
+    float* out = &c_[size_t{i} * n_];
+    std::fill(out, out + n_, 0.0F);
+    for (uint32_t k = 0; k < n_; ++k)
+    {
+      float        aik = a_[(size_t{i} * n_) + k];
+      float const* brow = &b_[size_t{k} * n_];
+      for (uint32_t j = 0; j < n_; ++j)
+      {
+        out[j] += aik * brow[j];
+      }
+    }
+  }
+
+  uint32_t           n_;
+  std::vector<float> a_;
+  std::vector<float> b_;
+  std::vector<float> c_;
+};
+
+auto nested_work(uint32_t value) -> uint32_t
+{
+  return (value * 2654435761U) ^ (value >> 7U);
+}
+
+// ---------------------------------------------------------------------------------------------
+// ouly kernels, generic over the task context so one implementation serves v1, v2 and v3
+
+template <typename WC>
+auto fib(WC const& ctx, uint32_t n) -> uint64_t
+{
+  if (n < fib_cutoff)
+  {
+    return fib_serial(n);
+  }
+  uint64_t                    left = 0;
+  ouly::basic_task_scope<WC> scope;
+  scope.run(ctx,
+            [&left, n](WC const& child)
+            {
+              left = fib(child, n - 1);
+            });
+  uint64_t right = fib(ctx, n - 2);
+  scope.join(ctx);
+  return left + right;
+}
+
+template <typename WC>
+auto queens(WC const& ctx, std::array<uint8_t, 32> board, uint32_t row, uint32_t n) -> uint64_t
+{
+  if (row >= queens_cutoff)
+  {
+    return queens_serial(board, row, n);
+  }
+  std::array<uint64_t, 32>   counts{};
+  ouly::basic_task_scope<WC> scope;
+  for (uint32_t col = 0; col < n; ++col)
+  {
+    if (queens_safe(board, row, col))
+    {
+      board[row] = static_cast<uint8_t>(col);
+      scope.run(ctx,
+                [&counts, board, row, n, col](WC const& child)
+                {
+                  counts[col] = queens(child, board, row + 1, n);
+                });
+    }
+  }
+  scope.join(ctx);
+  uint64_t total = 0;
+  for (auto c : counts)
+  {
+    total += c;
+  }
+  return total;
+}
+
+template <typename WC>
+auto uts(WC const& ctx, uint64_t node, uint32_t depth) -> uint64_t
+{
+  if (depth >= uts_cutoff)
+  {
+    return uts_serial(node);
+  }
+  auto                             n = uts_children(node);
+  std::array<uint64_t, uts_branch> counts{};
+  ouly::basic_task_scope<WC>       scope;
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    scope.run(ctx,
+              [&counts, node, depth, i](WC const& child)
+              {
+                counts[i] = uts(child, uts_child(node, i), depth + 1);
+              });
+  }
+  scope.join(ctx);
+  uint64_t total = 1;
+  for (auto c : counts)
+  {
+    total += c;
+  }
+  return total;
+}
+
+template <typename WC>
+auto uts_root(WC const& ctx, uint32_t roots) -> uint64_t
+{
+  std::vector<uint64_t>      counts(roots);
+  ouly::basic_task_scope<WC> scope;
+  for (uint32_t i = 0; i < roots; ++i)
+  {
+    scope.run(ctx,
+              [&counts, i](WC const& child)
+              {
+                // Root children always branch, so every root contributes a real subtree
+                uint64_t node  = uts_child(0, i);
+                uint64_t total = 1;
+                for (uint32_t c = 0; c < uts_branch; ++c)
+                {
+                  total += uts(child, uts_child(node, c), 1);
+                }
+                counts[i] = total;
+              });
+  }
+  scope.join(ctx);
+  uint64_t total = 1;
+  for (auto c : counts)
+  {
+    total += c;
+  }
+  return total;
+}
+
+template <typename WC>
+auto skynet(WC const& ctx, uint64_t first, uint64_t size) -> uint64_t
+{
+  if (size <= skynet_cutoff)
+  {
+    return skynet_serial(first, size);
+  }
+  constexpr uint32_t         fan = 10;
+  std::array<uint64_t, fan>  sums{};
+  ouly::basic_task_scope<WC> scope;
+  uint64_t                   part = size / fan;
+  for (uint32_t i = 0; i < fan; ++i)
+  {
+    scope.run(ctx,
+              [&sums, first, part, i](WC const& child)
+              {
+                sums[i] = skynet(child, first + (i * part), part);
+              });
+  }
+  scope.join(ctx);
+  uint64_t total = 0;
+  for (auto s : sums)
+  {
+    total += s;
+  }
+  return total;
+}
+
+template <typename WC>
+auto fanout(WC const& ctx, uint32_t tasks) -> uint64_t
+{
+  std::atomic<uint64_t>      sum{0};
+  ouly::basic_task_scope<WC> scope;
+  for (uint32_t i = 0; i < tasks; ++i)
+  {
+    scope.run(ctx,
+              [&sum, i]()
+              {
+                sum.fetch_add(i, std::memory_order_relaxed);
+              });
+  }
+  scope.join(ctx);
+  return sum.load(std::memory_order_relaxed);
+}
+
+template <typename WC>
+auto nested_for(WC const& ctx, uint32_t outer, uint32_t inner) -> uint64_t
+{
+  std::vector<uint64_t> rows(outer);
+  ouly::parallel_for(
+   [&rows, inner](uint32_t row, WC const& row_ctx)
+   {
+     std::atomic<uint64_t> sum{0};
+     ouly::parallel_for(
+      [&sum, row](uint32_t first, uint32_t last, WC const&)
+      {
+        uint64_t local = 0;
+        for (uint32_t i = first; i < last; ++i)
+        {
+          local += nested_work(i + row);
+        }
+        sum.fetch_add(local, std::memory_order_relaxed);
+      },
+      ouly::subrange<uint32_t>{0, inner}, row_ctx);
+     rows[row] = sum.load(std::memory_order_relaxed);
+   },
+   ouly::subrange<uint32_t>{0, outer}, ctx);
+  uint64_t total = 0;
+  for (auto r : rows)
+  {
+    total += r;
+  }
+  return total;
+}
+
+template <typename WC>
+void matmul(WC const& ctx, matrices& m)
+{
+  ouly::parallel_for(
+   [&m](uint32_t first, uint32_t last, WC const&)
+   {
+     for (uint32_t i = first; i < last; ++i)
+     {
+       m.row(i);
+     }
+   },
+   ouly::subrange<uint32_t>{0, m.n_}, ctx);
+}
+
+// ---------------------------------------------------------------------------------------------
+// TBB kernels
+
+auto tbb_fib(uint32_t n) -> uint64_t
+{
+  if (n < fib_cutoff)
+  {
+    return fib_serial(n);
+  }
+  uint64_t        left = 0;
+  tbb::task_group group;
+  group.run(
+   [&left, n]()
+   {
+     left = tbb_fib(n - 1);
+   });
+  uint64_t right = tbb_fib(n - 2);
+  group.wait();
+  return left + right;
+}
+
+auto tbb_queens(std::array<uint8_t, 32> board, uint32_t row, uint32_t n) -> uint64_t
+{
+  if (row >= queens_cutoff)
+  {
+    return queens_serial(board, row, n);
+  }
+  std::array<uint64_t, 32> counts{};
+  tbb::task_group          group;
+  for (uint32_t col = 0; col < n; ++col)
+  {
+    if (queens_safe(board, row, col))
+    {
+      board[row] = static_cast<uint8_t>(col);
+      group.run(
+       [&counts, board, row, n, col]()
+       {
+         counts[col] = tbb_queens(board, row + 1, n);
+       });
+    }
+  }
+  group.wait();
+  uint64_t total = 0;
+  for (auto c : counts)
+  {
+    total += c;
+  }
+  return total;
+}
+
+auto tbb_uts(uint64_t node, uint32_t depth) -> uint64_t
+{
+  if (depth >= uts_cutoff)
+  {
+    return uts_serial(node);
+  }
+  auto                             n = uts_children(node);
+  std::array<uint64_t, uts_branch> counts{};
+  tbb::task_group                  group;
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    group.run(
+     [&counts, node, depth, i]()
+     {
+       counts[i] = tbb_uts(uts_child(node, i), depth + 1);
+     });
+  }
+  group.wait();
+  uint64_t total = 1;
+  for (auto c : counts)
+  {
+    total += c;
+  }
+  return total;
+}
+
+auto tbb_uts_root(uint32_t roots) -> uint64_t
+{
+  std::vector<uint64_t> counts(roots);
+  tbb::task_group       group;
+  for (uint32_t i = 0; i < roots; ++i)
+  {
+    group.run(
+     [&counts, i]()
+     {
+       uint64_t node  = uts_child(0, i);
+       uint64_t total = 1;
+       for (uint32_t c = 0; c < uts_branch; ++c)
+       {
+         total += tbb_uts(uts_child(node, c), 1);
+       }
+       counts[i] = total;
+     });
+  }
+  group.wait();
+  uint64_t total = 1;
+  for (auto c : counts)
+  {
+    total += c;
+  }
+  return total;
+}
+
+auto tbb_skynet(uint64_t first, uint64_t size) -> uint64_t
+{
+  if (size <= skynet_cutoff)
+  {
+    return skynet_serial(first, size);
+  }
+  constexpr uint32_t        fan = 10;
+  std::array<uint64_t, fan> sums{};
+  tbb::task_group           group;
+  uint64_t                  part = size / fan;
+  for (uint32_t i = 0; i < fan; ++i)
+  {
+    group.run(
+     [&sums, first, part, i]()
+     {
+       sums[i] = tbb_skynet(first + (i * part), part);
+     });
+  }
+  group.wait();
+  uint64_t total = 0;
+  for (auto s : sums)
+  {
+    total += s;
+  }
+  return total;
+}
+
+auto tbb_fanout(uint32_t tasks) -> uint64_t
+{
+  std::atomic<uint64_t> sum{0};
+  tbb::task_group       group;
+  for (uint32_t i = 0; i < tasks; ++i)
+  {
+    group.run(
+     [&sum, i]()
+     {
+       sum.fetch_add(i, std::memory_order_relaxed);
+     });
+  }
+  group.wait();
+  return sum.load(std::memory_order_relaxed);
+}
+
+auto tbb_nested_for(uint32_t outer, uint32_t inner) -> uint64_t
+{
+  std::vector<uint64_t> rows(outer);
+  tbb::parallel_for(tbb::blocked_range<uint32_t>(0, outer),
+                    [&rows, inner](tbb::blocked_range<uint32_t> const& outer_range)
+                    {
+                      for (uint32_t row = outer_range.begin(); row != outer_range.end(); ++row)
+                      {
+                        std::atomic<uint64_t> sum{0};
+                        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, inner),
+                                          [&sum, row](tbb::blocked_range<uint32_t> const& range)
+                                          {
+                                            uint64_t local = 0;
+                                            for (uint32_t i = range.begin(); i != range.end(); ++i)
+                                            {
+                                              local += nested_work(i + row);
+                                            }
+                                            sum.fetch_add(local, std::memory_order_relaxed);
+                                          });
+                        rows[row] = sum.load(std::memory_order_relaxed);
+                      }
+                    });
+  uint64_t total = 0;
+  for (auto r : rows)
+  {
+    total += r;
+  }
+  return total;
+}
+
+void tbb_matmul(matrices& m)
+{
+  tbb::parallel_for(tbb::blocked_range<uint32_t>(0, m.n_),
+                    [&m](tbb::blocked_range<uint32_t> const& range)
+                    {
+                      for (uint32_t i = range.begin(); i != range.end(); ++i)
+                      {
+                        m.row(i);
+                      }
+                    });
+}
+
+// ---------------------------------------------------------------------------------------------
+// Drivers
+
+auto wants(std::string const& filter, char const* kernel) -> bool
+{
+  return filter.empty() || filter == kernel;
+}
+
+void check(bool ok, std::string const& name)
+{
+  if (!ok)
+  {
+    std::cerr << "wrong result in " << name << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+struct expected_results
+{
+  explicit expected_results(suite_config const& config)
+  {
+    fib_ = fib_serial(config.fib_n);
+    std::array<uint8_t, 32> board{};
+    queens_ = queens_serial(board, 0, config.queens_n);
+    uts_    = 1;
+    for (uint32_t i = 0; i < config.uts_roots; ++i)
+    {
+      uint64_t node = uts_child(0, i);
+      uts_ += 1;
+      for (uint32_t c = 0; c < uts_branch; ++c)
+      {
+        uts_ += uts_serial(uts_child(node, c));
+      }
+    }
+    skynet_ = skynet_serial(0, config.skynet_leaves);
+    fanout_ = uint64_t{config.fanout_tasks} * (config.fanout_tasks - 1) / 2;
+    nested_ = 0;
+    for (uint32_t row = 0; row < config.nested_outer; ++row)
+    {
+      for (uint32_t i = 0; i < config.nested_inner; ++i)
+      {
+        nested_ += nested_work(i + row);
+      }
+    }
+  }
+
+  uint64_t fib_;
+  uint64_t queens_;
+  uint64_t uts_;
+  uint64_t skynet_;
+  uint64_t fanout_;
+  uint64_t nested_;
+};
+
+template <typename Scheduler>
+void run_ouly(ankerl::nanobench::Bench& bench, std::string const& label, uint32_t threads, suite_config const& config,
+              expected_results const& expected, std::string const& filter)
+{
+  using context = typename Scheduler::context_type;
+
+  Scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, threads);
+  scheduler.begin_execution();
+  auto const& ctx    = context::this_context::get();
+  auto        suffix = "/" + label + "/" + std::to_string(threads);
+
+  if (wants(filter, "fib"))
+  {
+    bench.run("fib" + suffix,
+              [&]()
+              {
+                check(fib(ctx, config.fib_n) == expected.fib_, "fib" + suffix);
+              });
+  }
+  if (wants(filter, "nqueens"))
+  {
+    bench.run("nqueens" + suffix,
+              [&]()
+              {
+                check(queens(ctx, {}, 0, config.queens_n) == expected.queens_, "nqueens" + suffix);
+              });
+  }
+  if (wants(filter, "uts"))
+  {
+    bench.run("uts" + suffix,
+              [&]()
+              {
+                check(uts_root(ctx, config.uts_roots) == expected.uts_, "uts" + suffix);
+              });
+  }
+  if (wants(filter, "skynet"))
+  {
+    bench.run("skynet" + suffix,
+              [&]()
+              {
+                check(skynet(ctx, 0, config.skynet_leaves) == expected.skynet_, "skynet" + suffix);
+              });
+  }
+  if (wants(filter, "fanout"))
+  {
+    bench.run("fanout" + suffix,
+              [&]()
+              {
+                check(fanout(ctx, config.fanout_tasks) == expected.fanout_, "fanout" + suffix);
+              });
+  }
+  if (wants(filter, "nested_for"))
+  {
+    bench.run("nested_for" + suffix,
+              [&]()
+              {
+                check(nested_for(ctx, config.nested_outer, config.nested_inner) == expected.nested_,
+                      "nested_for" + suffix);
+              });
+  }
+  if (wants(filter, "matmul"))
+  {
+    matrices m(config.matmul_n);
+    bench.run("matmul" + suffix,
+              [&]()
+              {
+                matmul(ctx, m);
+                ankerl::nanobench::doNotOptimizeAway(m.c_.data());
+              });
+  }
+
+  scheduler.end_execution();
+}
+
+void run_tbb(ankerl::nanobench::Bench& bench, uint32_t threads, suite_config const& config,
+             expected_results const& expected, std::string const& filter)
+{
+  tbb::task_arena arena(static_cast<int>(threads));
+  auto            suffix = "/tbb/" + std::to_string(threads);
+  auto            in_arena = [&arena](auto&& body)
+  {
+    arena.execute(body);
+  };
+
+  if (wants(filter, "fib"))
+  {
+    bench.run("fib" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   check(tbb_fib(config.fib_n) == expected.fib_, "fib" + suffix);
+                 });
+              });
+  }
+  if (wants(filter, "nqueens"))
+  {
+    bench.run("nqueens" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   check(tbb_queens({}, 0, config.queens_n) == expected.queens_, "nqueens" + suffix);
+                 });
+              });
+  }
+  if (wants(filter, "uts"))
+  {
+    bench.run("uts" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   check(tbb_uts_root(config.uts_roots) == expected.uts_, "uts" + suffix);
+                 });
+              });
+  }
+  if (wants(filter, "skynet"))
+  {
+    bench.run("skynet" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   check(tbb_skynet(0, config.skynet_leaves) == expected.skynet_, "skynet" + suffix);
+                 });
+              });
+  }
+  if (wants(filter, "fanout"))
+  {
+    bench.run("fanout" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   check(tbb_fanout(config.fanout_tasks) == expected.fanout_, "fanout" + suffix);
+                 });
+              });
+  }
+  if (wants(filter, "nested_for"))
+  {
+    bench.run("nested_for" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   check(tbb_nested_for(config.nested_outer, config.nested_inner) == expected.nested_,
+                         "nested_for" + suffix);
+                 });
+              });
+  }
+  if (wants(filter, "matmul"))
+  {
+    matrices m(config.matmul_n);
+    bench.run("matmul" + suffix,
+              [&]()
+              {
+                in_arena(
+                 [&]()
+                 {
+                   tbb_matmul(m);
+                 });
+                ankerl::nanobench::doNotOptimizeAway(m.c_.data());
+              });
+  }
+}
+
+auto default_thread_counts() -> std::vector<uint32_t>
+{
+  uint32_t              hardware = std::max(std::thread::hardware_concurrency(), 1U);
+  std::vector<uint32_t> counts;
+  for (uint32_t t = 1; t < hardware; t *= 2)
+  {
+    counts.push_back(t);
+  }
+  counts.push_back(hardware);
+  return counts;
+}
+
+auto parse_thread_counts(std::string const& list) -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> counts;
+  size_t                pos = 0;
+  while (pos < list.size())
+  {
+    auto next = list.find(',', pos);
+    auto item = list.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+    if (!item.empty())
+    {
+      counts.push_back(std::max(static_cast<uint32_t>(std::stoul(item)), 1U));
+    }
+    pos = next == std::string::npos ? list.size() : next + 1;
+  }
+  return counts;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+  suite_config          config;
+  std::string           json_file = "scheduler_suite.json";
+  std::string           filter;
+  std::vector<uint32_t> threads = default_thread_counts();
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json" && i + 1 < argc)
+    {
+      json_file = argv[++i];
+    }
+    else if (arg == "--threads" && i + 1 < argc)
+    {
+      threads = parse_thread_counts(argv[++i]);
+    }
+    else if (arg == "--kernel" && i + 1 < argc)
+    {
+      filter = argv[++i];
+    }
+    else if (arg == "--quick")
+    {
+      config.fib_n         = 25;
+      config.queens_n      = 9;
+      config.uts_roots     = 200;
+      config.skynet_leaves = 100000;
+      config.fanout_tasks  = 2000;
+      config.nested_outer  = 16;
+      config.matmul_n      = 128;
+    }
+    else
+    {
+      std::cout << "Usage: " << argv[0] << " [--json file] [--threads 1,2,4] [--kernel name] [--quick]\n"
+                << "Kernels: fib nqueens uts skynet fanout nested_for matmul\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  expected_results expected(config);
+
+  ankerl::nanobench::Bench bench;
+  bench.title("Scheduler kernel suite").unit("run").warmup(1).minEpochIterations(config.min_iterations);
+
+  for (auto count : threads)
+  {
+    run_ouly<ouly::v1::scheduler>(bench, "v1", count, config, expected, filter);
+    run_ouly<ouly::v2::scheduler>(bench, "v2", count, config, expected, filter);
+    run_ouly<ouly::v3::scheduler>(bench, "v3", count, config, expected, filter);
+    run_tbb(bench, count, config, expected, filter);
+  }
+
+  std::ofstream out(json_file);
+  if (!out)
+  {
+    std::cerr << "cannot write " << json_file << "\n";
+    return 1;
+  }
+  bench.render(ankerl::nanobench::templates::json(), out);
+  std::cout << "results written to " << json_file << "\n";
+  return 0;
+}
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: MIT
+//
+// Two-thread queue benchmarks: spsc_ring against mpmc_ring and concurrent_queue.
+//
+//   ping-pong   one value travels to an echo thread and back; measures round-trip latency
+//   stream      a producer thread pushes a run of values, the main thread drains them; measures
+//               per-element throughput, and for spsc_ring also with batched push/pop
+//
+// Usage: bench_spsc_ring [--json file]
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include "nanobench.h"
+#include "ouly/containers/concurrent_queue.hpp"
+#include "ouly/containers/spsc_ring.hpp"
+#include "ouly/scheduler/detail/mpmc_ring.hpp"
+#include "ouly/scheduler/detail/pause.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+constexpr std::size_t ring_capacity = 1024;
+constexpr uint64_t    stream_length = 100000;
+constexpr std::size_t batch_size    = 32;
+
+using spsc_queue       = ouly::spsc_ring<uint64_t, ring_capacity>;
+using mpmc_queue       = ouly::detail::mpmc_ring<uint64_t, ring_capacity>;
+using concurrent_queue = ouly::concurrent_queue<uint64_t>;
+
+auto try_push(spsc_queue& queue, uint64_t value) -> bool
+{
+  return queue.try_push(value);
+}
+
+auto try_pop(spsc_queue& queue, uint64_t& value) -> bool
+{
+  return queue.try_pop(value);
+}
+
+auto try_push(mpmc_queue& queue, uint64_t value) -> bool
+{
+  return queue.push(std::move(value));
+}
+
+auto try_pop(mpmc_queue& queue, uint64_t& value) -> bool
+{
+  return queue.pop(value);
+}
+
+auto try_push(concurrent_queue& queue, uint64_t value) -> bool
+{
+  queue.enqueue(value);
+  return true;
+}
+
+auto try_pop(concurrent_queue& queue, uint64_t& value) -> bool
+{
+  return queue.try_dequeue(value);
+}
+
+template <typename Queue>
+void push_spin(Queue& queue, uint64_t value)
+{
+  while (!try_push(queue, value))
+  {
+    ouly::detail::pause_exec();
+  }
+}
+
+template <typename Queue>
+auto pop_spin(Queue& queue) -> uint64_t
+{
+  uint64_t value = 0;
+  while (!try_pop(queue, value))
+  {
+    ouly::detail::pause_exec();
+  }
+  return value;
+}
+
+// Echo thread for the ping-pong: returns every value it receives, incremented
+template <typename Queue>
+struct echo_pair
+{
+  Queue             forward_;
+  Queue             backward_;
+  std::atomic<bool> stop_{false};
+  std::thread       echo_;
+
+  echo_pair()
+      : echo_(
+         [this]()
+         {
+           uint64_t value = 0;
+           while (!stop_.load(std::memory_order_relaxed))
+           {
+             if (try_pop(forward_, value))
+             {
+               push_spin(backward_, value + 1);
+             }
+             else
+             {
+               ouly::detail::pause_exec();
+             }
+           }
+         })
+  {}
+
+  ~echo_pair()
+  {
+    stop_.store(true, std::memory_order_relaxed);
+    echo_.join();
+  }
+
+  echo_pair(echo_pair const&)                    = delete;
+  echo_pair(echo_pair&&)                         = delete;
+  auto operator=(echo_pair const&) -> echo_pair& = delete;
+  auto operator=(echo_pair&&) -> echo_pair&      = delete;
+};
+
+template <typename Queue>
+void bench_ping_pong(ankerl::nanobench::Bench& bench, std::string const& name)
+{
+  auto     pair  = std::make_unique<echo_pair<Queue>>();
+  uint64_t value = 0;
+  bench.run("ping-pong " + name,
+            [&]()
+            {
+              push_spin(pair->forward_, value);
+              value = pop_spin(pair->backward_);
+              ankerl::nanobench::doNotOptimizeAway(value);
+            });
+}
+
+template <typename Queue>
+void bench_stream(ankerl::nanobench::Bench& bench, std::string const& name)
+{
+  auto queue = std::make_unique<Queue>();
+  bench.run("stream " + name,
+            [&]()
+            {
+              std::thread producer(
+               [&]()
+               {
+                 for (uint64_t i = 0; i < stream_length; ++i)
+                 {
+                   push_spin(*queue, i);
+                 }
+               });
+              uint64_t sum = 0;
+              for (uint64_t i = 0; i < stream_length; ++i)
+              {
+                sum += pop_spin(*queue);
+              }
+              producer.join();
+              ankerl::nanobench::doNotOptimizeAway(sum);
+            });
+}
+
+void bench_stream_batched(ankerl::nanobench::Bench& bench)
+{
+  auto queue = std::make_unique<spsc_queue>();
+  bench.run("stream spsc_ring batched",
+            [&]()
+            {
+              std::thread producer(
+               [&]()
+               {
+                 std::array<uint64_t, batch_size> batch{};
+                 uint64_t                         next = 0;
+                 while (next < stream_length)
+                 {
+                   auto count = std::min<uint64_t>(batch_size, stream_length - next);
+                   for (uint64_t i = 0; i < count; ++i)
+                   {
+                     batch[i] = next + i;
+                   }
+                   auto pushed = queue->try_push_n(std::span<uint64_t const>(batch.data(), count));
+                   if (pushed == 0)
+                   {
+                     ouly::detail::pause_exec();
+                   }
+                   next += pushed;
+                 }
+               });
+              std::array<uint64_t, batch_size> out{};
+              uint64_t                         sum      = 0;
+              uint64_t                         received = 0;
+              while (received < stream_length)
+              {
+                auto count = queue->try_pop_n(out);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                  sum += out[i];
+                }
+                if (count == 0)
+                {
+                  ouly::detail::pause_exec();
+                }
+                received += count;
+              }
+              producer.join();
+              ankerl::nanobench::doNotOptimizeAway(sum);
+            });
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+  std::string json_file = "spsc_ring.json";
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json" && i + 1 < argc)
+    {
+      json_file = argv[++i];
+    }
+    else
+    {
+      std::cout << "Usage: " << argv[0] << " [--json file]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  // One Bench collects both groups so the JSON stays a single document for compare_benchmarks.py
+  ankerl::nanobench::Bench bench;
+  bench.title("Two-thread ping-pong").unit("round trip").warmup(1000).minEpochIterations(20000);
+  bench_ping_pong<spsc_queue>(bench, "spsc_ring");
+  bench_ping_pong<mpmc_queue>(bench, "mpmc_ring");
+  bench_ping_pong<concurrent_queue>(bench, "concurrent_queue");
+
+  bench.title("Two-thread stream").unit("element").batch(stream_length).warmup(1).minEpochIterations(5);
+  bench_stream<spsc_queue>(bench, "spsc_ring");
+  bench_stream_batched(bench);
+  bench_stream<mpmc_queue>(bench, "mpmc_ring");
+  bench_stream<concurrent_queue>(bench, "concurrent_queue");
+
+  std::ofstream out(json_file);
+  if (!out)
+  {
+    std::cerr << "cannot write " << json_file << "\n";
+    return 1;
+  }
+  bench.render(ankerl::nanobench::templates::json(), out);
+  std::cout << "results written to " << json_file << "\n";
+  return 0;
+}
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: MIT
+//
+// Shared node pool benchmark: ts_object_pool against an object_pool wrapped in a std::mutex, the
+// way task-graph and network-buffer pools are shared by scheduler workers today.
+//
+// Every thread repeatedly allocates a burst of nodes, touches them and frees them. In the
+// `handoff` pattern each thread frees the burst the previous thread produced instead of its own,
+// so most frees land on a thread other than the allocating one.
+//
+// Usage: bench_ts_pool [--json file] [--ops operations_per_thread] [--threads max_threads]
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include "nanobench.h"
+#include "ouly/allocators/object_pool.hpp"
+#include "ouly/allocators/ts_object_pool.hpp"
+
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct node
+{
+  uint64_t payload_[4] = {};
+  node*    next_       = nullptr;
+};
+
+constexpr std::size_t burst = 32;
+
+struct locked_pool
+{
+  auto allocate() -> node*
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return pool_.allocate();
+  }
+
+  void deallocate(node* n)
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    pool_.deallocate(n);
+  }
+
+  std::mutex              mutex_;
+  ouly::object_pool<node> pool_;
+};
+
+struct lock_free_pool
+{
+  auto allocate() -> node*
+  {
+    return pool_.allocate();
+  }
+
+  void deallocate(node* n)
+  {
+    pool_.deallocate(n);
+  }
+
+  ouly::ts_object_pool<node> pool_;
+};
+
+// Each thread owns one mailbox; in the handoff pattern thread i frees what thread i-1 published
+struct mailbox
+{
+  alignas(64) std::atomic<node*> head_{nullptr};
+};
+
+template <typename Pool>
+void run(uint32_t threads, uint32_t operations, bool handoff)
+{
+  Pool                     pool;
+  std::vector<mailbox>     boxes(threads);
+  std::barrier<>           start(threads + 1);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+
+  for (uint32_t t = 0; t < threads; ++t)
+  {
+    workers.emplace_back(
+     [&, t]()
+     {
+       start.arrive_and_wait();
+       for (uint32_t op = 0; op < operations; op += burst)
+       {
+         node* chain = nullptr;
+         for (std::size_t i = 0; i < burst; ++i)
+         {
+           auto* n        = ::new (pool.allocate()) node{};
+           n->payload_[0] = op + i;
+           n->next_       = chain;
+           chain          = n;
+         }
+
+         auto release = [&pool](node* list)
+         {
+           while (list != nullptr)
+           {
+             auto* next = list->next_;
+             pool.deallocate(list);
+             list = next;
+           }
+         };
+
+         if (handoff)
+         {
+           // Publish our burst, then free whatever the neighbour published. A burst of ours the
+           // neighbour has not taken yet is freed here.
+           release(boxes[t].head_.exchange(chain, std::memory_order_acq_rel));
+           release(boxes[(t + threads - 1) % threads].head_.exchange(nullptr, std::memory_order_acq_rel));
+         }
+         else
+         {
+           release(chain);
+         }
+       }
+     });
+  }
+
+  start.arrive_and_wait();
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  for (auto& box : boxes)
+  {
+    auto* chain = box.head_.exchange(nullptr);
+    while (chain != nullptr)
+    {
+      auto* next = chain->next_;
+      pool.deallocate(chain);
+      chain = next;
+    }
+  }
+}
+
+template <typename Pool>
+void bench_pool(ankerl::nanobench::Bench& bench, std::string const& name, uint32_t threads, uint32_t operations,
+                bool handoff)
+{
+  bench.run(name + (handoff ? " handoff " : " local ") + std::to_string(threads) + "t",
+            [&]()
+            {
+              run<Pool>(threads, operations, handoff);
+            });
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+  std::string json_file   = "ts_pool.json";
+  uint32_t    operations  = 1U << 20U;
+  uint32_t    max_threads = 64;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json" && i + 1 < argc)
+    {
+      json_file = argv[++i];
+    }
+    else if (arg == "--ops" && i + 1 < argc)
+    {
+      operations = static_cast<uint32_t>(std::stoul(argv[++i]));
+    }
+    else if (arg == "--threads" && i + 1 < argc)
+    {
+      max_threads = static_cast<uint32_t>(std::stoul(argv[++i]));
+    }
+    else
+    {
+      std::cout << "Usage: " << argv[0] << " [--json file] [--ops operations_per_thread] [--threads max_threads]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  // One Bench for every thread count so the JSON stays a single document; allocate + deallocate count as two
+  // operations
+  ankerl::nanobench::Bench bench;
+  bench.warmup(1).epochs(3).epochIterations(1);
+  for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+  {
+    bench.title("Shared node pool, " + std::to_string(threads) + " threads")
+     .unit("op")
+     .batch(2ULL * threads * operations)
+     .relative(true);
+    bench_pool<locked_pool>(bench, "mutex", threads, operations, false);
+    bench_pool<lock_free_pool>(bench, "ts", threads, operations, false);
+    bench_pool<locked_pool>(bench, "mutex", threads, operations, true);
+    bench_pool<lock_free_pool>(bench, "ts", threads, operations, true);
+  }
+
+  std::ofstream out(json_file);
+  if (!out)
+  {
+    std::cerr << "cannot write " << json_file << "\n";
+    return 1;
+  }
+  bench.render(ankerl::nanobench::templates::json(), out);
+  std::cout << "results written to " << json_file << "\n";
+  return 0;
+}
@@ -1,7 +1,9 @@
 #include "ouly/allocators/coalescing_allocator.hpp"
 #include "catch2/catch_all.hpp"
 #include "ouly/allocators/coalescing_arena_allocator.hpp"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <unordered_set>
 
@@ -132,6 +134,114 @@ TEST_CASE("coalescing_arena_allocator dedictated arena_ tests", "[coalescing_are
   REQUIRE(mgr.arena_count_ == 1);
 }
 
+TEST_CASE("coalescing_arena_allocator batch allocate and deallocate", "[coalescing_arena_allocator][default]")
+{
+  constexpr uint32_t               page_size = 1000;
+  alloc_mem_manager                mgr;
+  ouly::coalescing_arena_allocator allocator;
+  allocator.set_arena_size(page_size);
+
+  uint32_t                                 seed = 7919;
+  std::vector<ouly::allocation_size_type> sizes;
+  for (uint32_t i = 0; i < 64; ++i)
+  {
+    sizes.push_back(1 + xorshift(seed) % 300);
+  }
+  sizes.push_back(page_size * 2);
+
+  auto allocs = allocator.allocate_batch(std::span<ouly::allocation_size_type const>(sizes), mgr, ouly::alignment<16>{});
+  REQUIRE(allocs.size() == sizes.size());
+  for (size_t i = 0; i < allocs.size(); ++i)
+  {
+    REQUIRE(allocs[i].get_offset() % 16 == 0);
+    REQUIRE(allocs[i].get_offset() + sizes[i] <=
+            allocator.get_offset(allocs[i].get_allocation_id()) + allocator.get_size(allocs[i].get_allocation_id()));
+  }
+  allocator.validate_integrity();
+
+  std::vector<ouly::allocation_id> first;
+  std::vector<ouly::allocation_id> second;
+  for (size_t i = 0; i < allocs.size(); ++i)
+  {
+    (i % 3 == 0 ? first : second).push_back(allocs[i].get_allocation_id());
+  }
+
+  allocator.deallocate_batch(first, mgr);
+  allocator.validate_integrity();
+
+  // Freed space is reusable and single allocations still work alongside batches
+  auto single = allocator.allocate(100, mgr);
+  allocator.validate_integrity();
+  second.push_back(single.get_allocation_id());
+
+  allocator.deallocate_batch(second, mgr);
+  allocator.validate_integrity();
+  REQUIRE(mgr.arena_count_ == 0);
+}
+
+TEST_CASE("coalescing_arena_allocator lifetime hints fill arenas from opposite ends",
+          "[coalescing_arena_allocator][default]")
+{
+  constexpr uint32_t page_size = 1000;
+
+  auto interleave = [](ouly::coalescing_arena_allocator& allocator, alloc_mem_manager& mgr, bool hinted)
+  {
+    std::vector<ouly::ca_allocation> transient;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+      allocator.allocate(50, mgr, ouly::ca_allocation_options{});
+      transient.push_back(allocator.allocate(
+       50, mgr,
+       ouly::ca_allocation_options{.lifetime_ = hinted ? ouly::allocation_lifetime::transient
+                                                       : ouly::allocation_lifetime::persistent}));
+    }
+    return transient;
+  };
+
+  alloc_mem_manager                mixed_mgr;
+  ouly::coalescing_arena_allocator mixed(page_size);
+  for (auto const& al : interleave(mixed, mixed_mgr, false))
+  {
+    mixed.deallocate(al.get_allocation_id(), mixed_mgr);
+  }
+  // Without hints the short-lived blocks leave eight 50 byte holes between the ones that stay
+  auto const mixed_usage = mixed.lifetime_usage(ouly::allocation_lifetime::persistent);
+  REQUIRE(mixed_usage.allocation_count_ == 8);
+  REQUIRE(mixed_usage.runs_ == 8);
+  REQUIRE(mixed_usage.fragmentation() == Catch::Approx(0.875));
+  mixed.allocate(page_size - 8 * 50, mixed_mgr);
+  REQUIRE(mixed_mgr.arena_count_ == 2);
+
+  alloc_mem_manager                mgr;
+  ouly::coalescing_arena_allocator allocator(page_size);
+  auto const                       transient = interleave(allocator, mgr, true);
+  allocator.validate_integrity();
+  REQUIRE(mgr.arena_count_ == 1);
+  for (auto const& al : transient)
+  {
+    REQUIRE(al.get_offset() >= page_size - 8 * 50);
+    REQUIRE(allocator.get_lifetime(al.get_allocation_id()) == ouly::allocation_lifetime::transient);
+  }
+
+  auto const kept = allocator.lifetime_usage(ouly::allocation_lifetime::persistent);
+  REQUIRE(kept.allocation_count_ == 8);
+  REQUIRE(kept.runs_ == 1);
+  REQUIRE(kept.fragmentation() == 0.0);
+  auto const staged = allocator.lifetime_usage(ouly::allocation_lifetime::transient);
+  REQUIRE(staged.runs_ == 1);
+  REQUIRE(staged.bytes_ == 8 * 50);
+
+  // Freeing the transient blocks leaves a single hole, big enough for one large block
+  for (auto const& al : transient)
+  {
+    allocator.deallocate(al.get_allocation_id(), mgr);
+  }
+  allocator.validate_integrity();
+  auto big = allocator.allocate(page_size - 8 * 50, mgr);
+  REQUIRE(big.get_arena_id() == transient.front().get_arena_id());
+  REQUIRE(mgr.arena_count_ == 1);
+}
+
 TEST_CASE("coalescing_allocator without memory manager", "[coalescing_allocator][default]")
 {
   ouly::coalescing_allocator allocator;
@@ -154,4 +264,40 @@ TEST_CASE("coalescing_allocator without memory manager", "[coalescing_allocator]
   auto xoffset = allocator.allocate(256 + 16 + 60);
   REQUIRE(xoffset == soffset);
 }
+
+TEST_CASE("coalescing_allocator with tlsf", "[coalescing_allocator][tlsf]")
+{
+  ouly::coalescing_allocator allocator(ouly::fit_strategy::tlsf);
+  using size_type = ouly::coalescing_allocator::size_type;
+
+  std::minstd_rand                             gen(Catch::getSeed());
+  std::uniform_int_distribution<size_type>     sizes(1, 4096);
+  std::vector<std::pair<size_type, size_type>> live;
+  for (uint32_t iter = 0; iter < 4000; ++iter)
+  {
+    if (live.empty() || gen() % 100 < 60)
+    {
+      auto size   = sizes(gen);
+      auto offset = allocator.allocate(size);
+      REQUIRE(offset != std::numeric_limits<size_type>::max());
+      live.emplace_back(offset, size);
+    }
+    else
+    {
+      auto idx = gen() % live.size();
+      allocator.deallocate(live[idx].first, live[idx].second);
+      live[idx] = live.back();
+      live.pop_back();
+    }
+  }
+
+  std::sort(live.begin(), live.end());
+  for (std::size_t i = 1; i < live.size(); ++i)
+    REQUIRE(live[i - 1].first + live[i - 1].second <= live[i].first);
+
+  // once everything is returned the space is a single block again
+  for (auto const& [offset, size] : live)
+    allocator.deallocate(offset, size);
+  REQUIRE(allocator.allocate(1U << 20) == 0);
+}
 // NOLINTEND
\ No newline at end of file
@@ -67,14 +67,12 @@ struct compact_mem
   }
 };
 
-} // namespace
-
-TEST_CASE("compacting_allocator: randomized alloc/free/compact", "[compacting_allocator][default]")
+void randomized_alloc_free_compact(ouly::fit_strategy strategy)
 {
   uint32_t seed = Catch::getSeed();
   std::cout << " Seed : " << seed << std::endl;
 
-  ouly::compacting_allocator allocator;
+  ouly::compacting_allocator allocator(strategy);
   compact_mem                mem;
   std::vector<uint32_t>      live;
 
@@ -113,6 +111,46 @@ TEST_CASE("compacting_allocator: randomized alloc/free/compact", "[compacting_al
   mem.verify_all(allocator);
 }
 
+} // namespace
+
+TEST_CASE("compacting_allocator: randomized alloc/free/compact", "[compacting_allocator][default]")
+{
+  randomized_alloc_free_compact(ouly::fit_strategy::first_fit);
+}
+
+TEST_CASE("compacting_allocator: randomized alloc/free/compact with tlsf", "[compacting_allocator][tlsf]")
+{
+  randomized_alloc_free_compact(ouly::fit_strategy::tlsf);
+}
+
+TEST_CASE("compacting_allocator: tlsf reuses freed blocks and coalesces", "[compacting_allocator][tlsf]")
+{
+  ouly::compacting_allocator allocator(ouly::fit_strategy::tlsf);
+  REQUIRE(allocator.get_fit_strategy() == ouly::fit_strategy::tlsf);
+
+  auto a = allocator.allocate(256);
+  auto b = allocator.allocate(256);
+  auto c = allocator.allocate(256);
+  REQUIRE(allocator.get_offset(a) == 0);
+  REQUIRE(allocator.get_offset(b) == 256);
+  REQUIRE(allocator.get_offset(c) == 512);
+
+  // an exact fit is found even though its bin cannot guarantee the size
+  allocator.deallocate(b);
+  auto d = allocator.allocate(256);
+  REQUIRE(allocator.get_offset(d) == 256);
+  allocator.validate_integrity();
+
+  // freeing neighbours on both sides merges them into one block
+  allocator.deallocate(a);
+  allocator.deallocate(c);
+  allocator.deallocate(d);
+  allocator.validate_integrity();
+  auto e = allocator.allocate(768);
+  REQUIRE(allocator.get_offset(e) == 0);
+  allocator.validate_integrity();
+}
+
 TEST_CASE("compacting_allocator: compaction closes gaps and merges moves", "[compacting_allocator][default]")
 {
   ouly::compacting_allocator allocator;
@@ -257,6 +257,60 @@ TEMPLATE_TEST_CASE("defrag allocators: budget makes defragment incremental", "[d
   allocator.validate_integrity();
 }
 
+TEMPLATE_TEST_CASE("defrag allocators: budgeted steps resume the sweep", "[defrag_allocator][default]",
+                   ouly::first_fit_defrag_allocator, ouly::best_fit_defrag_allocator)
+{
+  constexpr uint32_t           page_size = 1024;
+  defrag_mem_manager<TestType> mgr;
+  TestType                     allocator{page_size};
+
+  std::vector<uint32_t> ids;
+  for (uint32_t i = 0; i < 24; ++i)
+  {
+    auto al = allocator.allocate(100, mgr);
+    mgr.track(al, 100);
+    ids.push_back(al.get_allocation_id().get());
+  }
+  for (uint32_t i = 0; i < ids.size(); i += 2)
+  {
+    allocator.deallocate(ouly::allocation_id{ids[i]}, mgr);
+    mgr.allocs_.erase(ids[i]);
+  }
+
+  // one relocation per step: every step makes progress and the sweep ends after at most one step
+  // per live allocation
+  ouly::coalescing_defrag_budget const budget{.max_allocations_moved_ = 1};
+  uint32_t                             steps = 0;
+  uint64_t                             bytes = 0;
+  uint64_t                             moved = 0;
+  bool                                 done  = false;
+  while (!done)
+  {
+    auto const step = allocator.defragment(mgr, budget);
+    REQUIRE(step.allocations_moved_ <= 1);
+    REQUIRE((step.completed_ || step.allocations_moved_ == 1));
+    bytes += step.bytes_moved_;
+    moved += step.allocations_moved_;
+    done = step.completed_;
+    allocator.validate_integrity();
+    REQUIRE(++steps <= mgr.allocs_.size() + 1);
+  }
+  REQUIRE(moved > 1);
+
+  auto const& stats = allocator.defrag_statistics();
+  REQUIRE(stats.calls_ == steps);
+  REQUIRE(stats.sweeps_completed_ == 1);
+  REQUIRE(stats.bytes_moved_ == bytes);
+  REQUIRE(stats.allocations_moved_ == moved);
+  REQUIRE(stats.max_bytes_per_call_ == 100);
+
+  // the finished sweep left nothing to do; a new one starts from the front
+  auto const final_pass = allocator.defragment(mgr);
+  REQUIRE(final_pass.completed_);
+  REQUIRE(final_pass.allocations_moved_ == 0);
+  REQUIRE(allocator.defrag_statistics().sweeps_completed_ == 2);
+}
+
 TEMPLATE_TEST_CASE("defrag allocators: dedicated allocations are pinned", "[defrag_allocator][default]",
                    ouly::first_fit_defrag_allocator, ouly::best_fit_defrag_allocator)
 {
@@ -285,6 +339,39 @@ TEMPLATE_TEST_CASE("defrag allocators: dedicated allocations are pinned", "[defr
   REQUIRE(mgr.arena_count_ == 0);
 }
 
+TEST_CASE("best_fit_defrag_allocator: runtime options record the alignment", "[defrag_allocator][default]")
+{
+  defrag_mem_manager<ouly::best_fit_defrag_allocator> mgr;
+  ouly::best_fit_defrag_allocator                     allocator{4096};
+
+  auto filler = allocator.allocate(40, mgr);
+  mgr.track(filler, 40);
+  auto const options =
+   ouly::ca_allocation_options{.alignment_ = 256, .lifetime_ = ouly::allocation_lifetime::transient};
+  auto transient = allocator.allocate(100, mgr, options);
+  REQUIRE(transient.get_allocation_id() != ouly::allocation_id());
+  REQUIRE(transient.get_offset() % 256 == 0);
+  REQUIRE(allocator.get_alignment(transient.get_allocation_id()) == 256);
+  REQUIRE(allocator.get_adjusted_offset(transient.get_allocation_id()) == transient.get_offset());
+  REQUIRE(allocator.get_adjusted_size(transient.get_allocation_id()) >= 100);
+  // Carved from the top of the arena
+  REQUIRE(transient.get_offset() > 2048);
+  mgr.track(transient, 100);
+
+  allocator.deallocate(filler.get_allocation_id(), mgr);
+  mgr.allocs_.erase(filler.get_allocation_id().get());
+
+  // Repacking bottom-up keeps the recorded alignment
+  auto const result = allocator.defragment(mgr);
+  REQUIRE(result.completed_);
+  REQUIRE(allocator.get_adjusted_offset(transient.get_allocation_id()) % 256 == 0);
+  REQUIRE(allocator.get_adjusted_offset(transient.get_allocation_id()) < 2048);
+  allocator.validate_integrity();
+
+  allocator.deallocate(transient.get_allocation_id(), mgr);
+  REQUIRE(mgr.arena_count_ == 0);
+}
+
 TEST_CASE("coalescing_arena_allocator: alignment is honored", "[coalescing_arena_allocator][default]")
 {
   defrag_mem_manager<ouly::coalescing_arena_allocator> mgr;
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <limits>
 #include <optional>
+#include <thread>
 #include <vector>
 
 // NOLINTBEGIN
@@ -116,6 +117,46 @@ static_assert(std::same_as<ouly::gpu_allocator::size_type, ouly::allocation_size
 static_assert(ouly::GpuMemoryManager<gpu_memory>);
 static_assert(ouly::GpuRelocationExecutor<gpu_executor>);
 
+struct budgeted_gpu_memory : gpu_memory
+{
+  std::vector<std::pair<uint32_t, ouly::gpu_memory_class_budget>> exceeded_;
+
+  void on_budget_exceeded(uint32_t memory_class, ouly::gpu_memory_class_budget const& budget)
+  {
+    exceeded_.emplace_back(memory_class, budget);
+  }
+};
+
+static_assert(ouly::GpuMemoryManagerWithBudget<budgeted_gpu_memory>);
+static_assert(!ouly::GpuMemoryManagerWithBudget<gpu_memory>);
+
+// Runs every planning item on its own thread, in reverse order
+struct thread_dispatcher
+{
+  uint32_t calls_ = 0;
+
+  template <typename Work>
+  void operator()(uint32_t count, Work& work)
+  {
+    ++calls_;
+    std::vector<std::thread> threads;
+    for (uint32_t item = count; item-- > 0;)
+    {
+      threads.emplace_back(
+       [&work, item]()
+       {
+         work(item, item + 1);
+       });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+  }
+};
+
+static_assert(ouly::GpuPlanningDispatcher<thread_dispatcher>);
+
 } // namespace
 
 TEST_CASE("gpu_allocator: allocation follows ouly id, alignment, and class conventions", "[gpu_allocator][default]")
@@ -411,4 +452,281 @@ TEST_CASE("gpu_allocator: defragmentation plans from a caller supplied scratch a
   REQUIRE(memory.active_ == 0);
 }
 
+TEST_CASE("gpu_allocator: dispatched planning matches serial planning", "[gpu_allocator][default]")
+{
+  constexpr uint32_t block_size = 4096;
+
+  gpu_memory          serial_memory;
+  gpu_memory          parallel_memory;
+  gpu_executor        serial_executor{.memory_ = &serial_memory};
+  gpu_executor        parallel_executor{.memory_ = &parallel_memory};
+  ouly::gpu_allocator serial{block_size};
+  ouly::gpu_allocator parallel{block_size};
+  thread_dispatcher   dispatch;
+
+  // Identical fragmented heaps over two memory classes, with some pinned allocations
+  uint32_t                          state = 0x2545f491;
+  std::vector<ouly::gpu_allocation> allocations;
+  for (uint32_t index = 0; index < 400; ++index)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    ouly::gpu_allocation_options const options{.alignment_    = 1U << (state % 5),
+                                               .memory_class_ = (state >> 8) % 2,
+                                               .movable_      = (state >> 12) % 16 != 0};
+    auto const                         size = 64 + ((state >> 16) % 16) * 48;
+    auto const                         lhs  = serial.allocate(size, serial_memory, options);
+    auto const                         rhs  = parallel.allocate(size, parallel_memory, options);
+    REQUIRE(lhs == rhs);
+    allocations.push_back(lhs);
+  }
+  for (size_t index = 0; index < allocations.size(); ++index)
+  {
+    if (index % 3 != 0)
+    {
+      serial.deallocate(allocations[index].get_allocation_id(), serial_memory);
+      parallel.deallocate(allocations[index].get_allocation_id(), parallel_memory);
+    }
+  }
+  REQUIRE(serial_memory.active_ > ouly::cfg::default_gpu_planning_batch);
+
+  ouly::gpu_defrag_budget const budget{.max_copy_bytes_ = 2048, .max_move_count_ = 8};
+  ouly::gpu_defrag_scratch      scratch{ouly::cfg::default_gpu_scratch_size};
+  for (uint32_t step = 0; step < 256; ++step)
+  {
+    auto const lhs = serial.defragment(serial_memory, serial_executor, budget);
+    auto const rhs = parallel.defragment(parallel_memory, parallel_executor, budget, scratch, dispatch);
+    REQUIRE(lhs.bytes_scheduled_ == rhs.bytes_scheduled_);
+    REQUIRE(lhs.moves_completed_ == rhs.moves_completed_);
+    REQUIRE(lhs.arenas_removed_ == rhs.arenas_removed_);
+    REQUIRE(lhs.completed_ == rhs.completed_);
+    serial_executor.completed_   = serial_executor.next_timeline_;
+    parallel_executor.completed_ = parallel_executor.next_timeline_;
+    if (lhs.completed_ && lhs.moves_scheduled_ == 0 && lhs.moves_completed_ == 0)
+    {
+      break;
+    }
+  }
+  serial.validate_integrity();
+  parallel.validate_integrity();
+
+  REQUIRE(dispatch.calls_ > 0);
+  REQUIRE(!serial_executor.copies_.empty());
+  REQUIRE(serial_executor.copies_.size() == parallel_executor.copies_.size());
+  for (size_t index = 0; index < serial_executor.copies_.size(); ++index)
+  {
+    auto const& lhs = serial_executor.copies_[index];
+    auto const& rhs = parallel_executor.copies_[index];
+    REQUIRE(lhs.move_ == rhs.move_);
+    REQUIRE(lhs.allocation_ == rhs.allocation_);
+    REQUIRE(lhs.source_arena_ == rhs.source_arena_);
+    REQUIRE(lhs.destination_arena_ == rhs.destination_arena_);
+    REQUIRE(lhs.source_offset_ == rhs.source_offset_);
+    REQUIRE(lhs.destination_offset_ == rhs.destination_offset_);
+  }
+  REQUIRE(serial_memory.active_ == parallel_memory.active_);
+}
+
+TEST_CASE("gpu_allocator: memory class budgets are tracked incrementally", "[gpu_allocator][default]")
+{
+  constexpr uint32_t block_size = 1024;
+
+  budgeted_gpu_memory memory;
+  gpu_executor        executor{.memory_ = &memory};
+  ouly::gpu_allocator allocator{block_size};
+
+  REQUIRE(allocator.memory_class_budget(0).arena_count_ == 0);
+  allocator.set_soft_limit(1, 2 * block_size);
+
+  std::vector<ouly::gpu_allocation> device;
+  for (uint32_t index = 0; index < 8; ++index)
+  {
+    device.push_back(allocator.allocate(256, memory, ouly::gpu_allocation_options{.memory_class_ = 1}));
+  }
+  auto const upload = allocator.allocate(100, memory, ouly::gpu_allocation_options{.memory_class_ = 0});
+
+  auto budget = allocator.memory_class_budget(1);
+  REQUIRE(budget.arena_count_ == 2);
+  REQUIRE(budget.allocation_count_ == 8);
+  REQUIRE(budget.bytes_reserved_ == 2 * block_size);
+  REQUIRE(budget.bytes_used_ == 8 * 256);
+  REQUIRE(budget.bytes_free_ == 0);
+  REQUIRE(budget.largest_free_block_ == 0);
+  REQUIRE(budget.fragmentation() == 0.0);
+  REQUIRE(memory.exceeded_.empty());
+
+  auto const other = allocator.memory_class_budget(0);
+  REQUIRE(other.bytes_used_ == 100);
+  REQUIRE(other.largest_free_block_ == block_size - 100);
+
+  // Freeing every other block leaves the free space in 256 byte holes
+  for (auto index : {0U, 2U, 4U, 6U})
+  {
+    allocator.deallocate(device[index].get_allocation_id(), memory);
+  }
+  budget = allocator.memory_class_budget(1);
+  REQUIRE(budget.bytes_used_ == 4 * 256);
+  REQUIRE(budget.bytes_free_ == 4 * 256);
+  REQUIRE(budget.largest_free_block_ == 256);
+  REQUIRE(budget.fragmentation() == Catch::Approx(0.75));
+  allocator.validate_integrity();
+
+  // A third arena pushes the class over its soft limit
+  device.push_back(allocator.allocate(512, memory, ouly::gpu_allocation_options{.memory_class_ = 1}));
+  REQUIRE(memory.exceeded_.size() == 1);
+  REQUIRE(memory.exceeded_.front().first == 1);
+  REQUIRE(memory.exceeded_.front().second.bytes_reserved_ == 3 * block_size);
+  REQUIRE(allocator.memory_class_budget(1).largest_free_block_ == block_size - 512);
+
+  // Compaction releases an arena and merges the holes
+  for (uint32_t step = 0; step < 16; ++step)
+  {
+    allocator.defragment(memory, executor);
+    executor.completed_ = executor.next_timeline_;
+    allocator.validate_integrity();
+  }
+  budget = allocator.memory_class_budget(1);
+  REQUIRE(budget.arena_count_ == 2);
+  REQUIRE(budget.bytes_used_ == 4 * 256 + 512);
+  REQUIRE(budget.bytes_free_ == budget.bytes_reserved_ - budget.bytes_used_);
+
+  for (auto index : {1U, 3U, 5U, 7U, 8U})
+  {
+    allocator.deallocate(device[index].get_allocation_id(), memory);
+  }
+  allocator.deallocate(upload.get_allocation_id(), memory);
+  budget = allocator.memory_class_budget(1);
+  REQUIRE(budget.arena_count_ == 0);
+  REQUIRE(budget.bytes_reserved_ == 0);
+  REQUIRE(budget.largest_free_block_ == 0);
+  REQUIRE(budget.soft_limit_ == 2 * block_size);
+  allocator.validate_integrity();
+}
+
+TEST_CASE("gpu_allocator: batches are packed and coalesced in one pass", "[gpu_allocator][default]")
+{
+  constexpr uint32_t block_size = 1024;
+
+  gpu_memory          memory;
+  ouly::gpu_allocator allocator{block_size};
+
+  std::vector<ouly::gpu_allocation_request> requests;
+  for (uint32_t index = 0; index < 48; ++index)
+  {
+    requests.push_back({.size_    = 16 + ((index * 29U) % 200),
+                        .options_ = {.alignment_ = 1U << (index % 5), .memory_class_ = index % 2}});
+  }
+  requests.push_back({.size_ = 2 * block_size, .options_ = {}});
+
+  auto const allocations = allocator.allocate_batch(requests, memory);
+  REQUIRE(allocations.size() == requests.size());
+  for (size_t index = 0; index < requests.size(); ++index)
+  {
+    auto const id = allocations[index].get_allocation_id();
+    REQUIRE(id != ouly::allocation_id());
+    REQUIRE(allocator.get_size(id) == requests[index].size_);
+    REQUIRE(allocations[index].get_offset() % requests[index].options_.alignment_ == 0);
+    REQUIRE(allocator.get_memory_class(id) == requests[index].options_.memory_class_);
+    fill(memory, allocations[index], requests[index].size_);
+  }
+  for (auto const& allocation : allocations)
+  {
+    verify(memory, allocator, allocation.get_allocation_id());
+  }
+  allocator.validate_integrity();
+
+  // Release every other allocation, then the rest: both batches must leave exact free lists
+  std::vector<ouly::allocation_id> even;
+  std::vector<ouly::allocation_id> odd;
+  for (size_t index = 0; index < allocations.size(); ++index)
+  {
+    (index % 2 == 0 ? even : odd).push_back(allocations[index].get_allocation_id());
+  }
+  allocator.deallocate_batch(even, memory);
+  allocator.validate_integrity();
+  for (auto id : odd)
+  {
+    verify(memory, allocator, id);
+  }
+  for (uint32_t memory_class : {0U, 1U})
+  {
+    auto const budget = allocator.memory_class_budget(memory_class);
+    REQUIRE(budget.bytes_free_ + budget.bytes_used_ == budget.bytes_reserved_);
+  }
+
+  allocator.deallocate_batch(odd, memory);
+  allocator.validate_integrity();
+  REQUIRE(memory.active_ == 0);
+  REQUIRE(allocator.memory_class_budget(0).bytes_reserved_ == 0);
+  REQUIRE(allocator.memory_class_budget(1).bytes_reserved_ == 0);
+}
+
+TEST_CASE("gpu_allocator: lifetime hints segregate arenas", "[gpu_allocator][default]")
+{
+  constexpr uint32_t block_size = 1024;
+
+  gpu_memory          memory;
+  gpu_executor        executor{.memory_ = &memory};
+  ouly::gpu_allocator allocator{block_size};
+
+  auto const persistent = ouly::gpu_allocation_options{.lifetime_ = ouly::allocation_lifetime::persistent};
+  auto const transient  = ouly::gpu_allocation_options{.lifetime_ = ouly::allocation_lifetime::transient};
+
+  std::vector<ouly::gpu_allocation> kept;
+  std::vector<ouly::gpu_allocation> staging;
+  for (uint32_t index = 0; index < 4; ++index)
+  {
+    kept.push_back(allocator.allocate(128, memory, persistent));
+    staging.push_back(allocator.allocate(128, memory, transient));
+  }
+  REQUIRE(memory.active_ == 2);
+  REQUIRE(kept.front().get_arena_id() != staging.front().get_arena_id());
+  REQUIRE(allocator.get_lifetime(staging.back().get_allocation_id()) == ouly::allocation_lifetime::transient);
+  REQUIRE(allocator.get_lifetime(kept.back().get_allocation_id()) == ouly::allocation_lifetime::persistent);
+
+  auto usage = allocator.lifetime_usage(ouly::allocation_lifetime::transient);
+  REQUIRE(usage.arena_count_ == 1);
+  REQUIRE(usage.allocation_count_ == 4);
+  REQUIRE(usage.bytes_free_ == block_size - 4 * 128);
+
+  // Dropping the transient buffers releases their arena and leaves the persistent one in one piece
+  for (auto const& allocation : staging)
+  {
+    allocator.deallocate(allocation.get_allocation_id(), memory);
+  }
+  REQUIRE(memory.active_ == 1);
+  usage = allocator.lifetime_usage(ouly::allocation_lifetime::persistent);
+  REQUIRE(usage.allocation_count_ == 4);
+  REQUIRE(usage.fragmentation() == 0.0);
+  REQUIRE(allocator.lifetime_usage(ouly::allocation_lifetime::transient).arena_count_ == 0);
+
+  // Evacuation only moves into arenas of the same lifetime
+  auto const frame = allocator.allocate(
+   128, memory, ouly::gpu_allocation_options{.lifetime_ = ouly::allocation_lifetime::frame});
+  std::vector<ouly::gpu_allocation> more;
+  for (uint32_t index = 0; index < 5; ++index)
+  {
+    more.push_back(allocator.allocate(128, memory, persistent));
+  }
+  REQUIRE(memory.active_ == 3);
+  for (auto index : {0U, 1U, 2U, 3U})
+  {
+    allocator.deallocate(more[index].get_allocation_id(), memory);
+  }
+  for (uint32_t step = 0; step < 8; ++step)
+  {
+    allocator.defragment(memory, executor);
+    executor.completed_ = executor.next_timeline_;
+    allocator.validate_integrity();
+  }
+  REQUIRE(!executor.copies_.empty());
+  for (auto const& copy : executor.copies_)
+  {
+    REQUIRE(copy.destination_arena_ != frame.get_arena_id());
+  }
+  REQUIRE(allocator.get_lifetime(more.back().get_allocation_id()) == ouly::allocation_lifetime::persistent);
+  REQUIRE(allocator.get_arena(frame.get_allocation_id()) == frame.get_arena_id());
+}
+
 // NOLINTEND
@@ -0,0 +1,180 @@
+#include "ouly/allocators/heap_snapshot.hpp"
+#include "catch2/catch_all.hpp"
+#include "ouly/allocators/coalescing_arena_allocator.hpp"
+#include "ouly/allocators/gpu_allocator.hpp"
+#include "ouly/serializers/binary_stream.hpp"
+#include "ouly/serializers/serializers.hpp"
+#include <optional>
+#include <vector>
+
+// NOLINTBEGIN
+namespace
+{
+
+struct null_memory
+{
+  uint32_t arenas_ = 0;
+
+  void add(ouly::arena_id, ouly::allocation_size_type)
+  {
+    ++arenas_;
+  }
+
+  void remove(ouly::arena_id)
+  {
+    --arenas_;
+  }
+};
+
+// Completes nothing, so scheduled copies stay in flight
+struct pending_executor
+{
+  ouly::gpu_timeline_value next_ = 1;
+
+  auto schedule_copy(ouly::gpu_relocation const&) -> std::optional<ouly::gpu_timeline_value>
+  {
+    return next_++;
+  }
+
+  auto switch_references(ouly::gpu_relocation const&) -> std::optional<ouly::gpu_timeline_value>
+  {
+    return next_++;
+  }
+
+  [[nodiscard]] auto is_complete(ouly::gpu_timeline_value) const -> bool
+  {
+    return false;
+  }
+};
+
+void require_tiled(ouly::heap_snapshot const& snapshot)
+{
+  REQUIRE(snapshot.version_ == ouly::heap_snapshot_version);
+  for (auto const& arena : snapshot.arenas_)
+  {
+    ouly::allocation_size_type cursor = 0;
+    for (auto const& block : arena.blocks_)
+    {
+      REQUIRE(block.offset_ == cursor);
+      REQUIRE(block.size_ != 0);
+      cursor += block.size_;
+    }
+    REQUIRE(cursor == arena.capacity_);
+  }
+}
+
+auto round_trip(ouly::heap_snapshot const& snapshot) -> ouly::heap_snapshot
+{
+  ouly::binary_output_stream out;
+  ouly::write(out, snapshot);
+
+  ouly::heap_snapshot       result;
+  ouly::binary_input_stream in(out.get_string());
+  ouly::read(in, result);
+  REQUIRE(in.size() == 0);
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("heap_snapshot: coalescing_arena_allocator block map", "[heap_snapshot]")
+{
+  null_memory                      memory;
+  ouly::coalescing_arena_allocator allocator(1000);
+
+  std::vector<ouly::ca_allocation> allocations;
+  for (uint32_t i = 0; i < 6; ++i)
+  {
+    allocations.push_back(allocator.allocate(
+     100, memory,
+     ouly::ca_allocation_options{.lifetime_ = i % 2 == 0 ? ouly::allocation_lifetime::persistent
+                                                         : ouly::allocation_lifetime::frame}));
+  }
+  allocator.deallocate(allocations[0].get_allocation_id(), memory);
+  allocator.allocate(2000, memory);
+
+  auto const snapshot = allocator.snapshot();
+  REQUIRE(snapshot.arenas_.size() == 2);
+  require_tiled(snapshot);
+
+  auto const first = ouly::summarize(snapshot.arenas_[0]);
+  REQUIRE(first.capacity_ == 1000);
+  REQUIRE(first.bytes_used_ == 500);
+  REQUIRE(first.used_blocks_ == 5);
+  REQUIRE(first.free_blocks_ == 2);
+  REQUIRE(first.largest_free_block_ == 400);
+  REQUIRE(first.fragmentation() == Catch::Approx(0.2));
+
+  auto const frame = std::ranges::count_if(snapshot.arenas_[0].blocks_,
+                                           [](ouly::heap_snapshot_block const& block)
+                                           {
+                                             return block.lifetime_ == ouly::allocation_lifetime::frame;
+                                           });
+  REQUIRE(frame == 3);
+
+  auto const total = ouly::summarize(snapshot);
+  REQUIRE(total.capacity_ == 3000);
+  REQUIRE(total.bytes_used_ == 2500);
+
+  auto const loaded = round_trip(snapshot);
+  REQUIRE(loaded.arenas_.size() == snapshot.arenas_.size());
+  REQUIRE(loaded.arenas_[0].blocks_.size() == snapshot.arenas_[0].blocks_.size());
+  REQUIRE(loaded.arenas_[0].blocks_.back().lifetime_ == ouly::allocation_lifetime::frame);
+  REQUIRE(ouly::summarize(loaded).bytes_free_ == total.bytes_free_);
+}
+
+TEST_CASE("heap_snapshot: gpu_allocator block map with relocations in flight", "[heap_snapshot]")
+{
+  constexpr uint32_t block_size = 1024;
+
+  null_memory         memory;
+  pending_executor    executor;
+  ouly::gpu_allocator allocator{block_size};
+
+  std::vector<ouly::gpu_allocation> allocations;
+  for (uint32_t i = 0; i < 8; ++i)
+  {
+    allocations.push_back(allocator.allocate(256, memory, ouly::gpu_allocation_options{.resource_class_ = i}));
+  }
+  auto const pinned = allocator.allocate(128, memory, ouly::gpu_allocation_options{.movable_ = false});
+  for (auto index : {0U, 2U, 5U, 7U})
+  {
+    allocator.deallocate(allocations[index].get_allocation_id(), memory);
+  }
+
+  auto snapshot = allocator.snapshot();
+  require_tiled(snapshot);
+  REQUIRE(snapshot.arenas_.size() == 3);
+  auto summary = ouly::summarize(snapshot);
+  REQUIRE(summary.bytes_used_ == 4 * 256 + 128);
+  REQUIRE(summary.bytes_in_flight_ == 0);
+
+  bool found_pinned = false;
+  for (auto const& arena : snapshot.arenas_)
+  {
+    for (auto const& block : arena.blocks_)
+    {
+      if (block.state_ == ouly::heap_block_state::used && block.offset_ == pinned.get_offset() &&
+          arena.arena_ == pinned.get_arena_id().get())
+      {
+        REQUIRE(!block.movable_);
+        found_pinned = true;
+      }
+    }
+  }
+  REQUIRE(found_pinned);
+
+  // Scheduled copies hold their destinations until the executor reports completion
+  auto const result = allocator.defragment(memory, executor);
+  REQUIRE(result.moves_scheduled_ != 0);
+  snapshot = allocator.snapshot();
+  require_tiled(snapshot);
+  summary = ouly::summarize(snapshot);
+  REQUIRE(summary.bytes_in_flight_ == result.bytes_scheduled_);
+  REQUIRE(summary.bytes_used_ == 4 * 256 + 128);
+
+  auto const loaded = round_trip(snapshot);
+  REQUIRE(ouly::summarize(loaded).bytes_in_flight_ == summary.bytes_in_flight_);
+  REQUIRE(loaded.arenas_.back().arena_ == snapshot.arenas_.back().arena_);
+}
+// NOLINTEND
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: MIT
+//
+// Renders a heap snapshot saved from gpu_allocator::snapshot() or
+// coalescing_arena_allocator::snapshot() as an occupancy map with per-arena metrics.
+//
+// Each arena is drawn as one row of cells; a cell is
+//   #  used      .  free      +  partly used      ~  holds a relocation in flight
+//
+// Usage:
+//   heap_snapshot_view <snapshot> [--columns N] [--html <out.html>]
+//   heap_snapshot_view --demo <snapshot>    write a snapshot of a fragmented gpu_allocator
+
+#include "ouly/allocators/gpu_allocator.hpp"
+#include "ouly/allocators/heap_snapshot.hpp"
+#include "ouly/serializers/binary_stream.hpp"
+#include "ouly/serializers/serializers.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// NOLINTBEGIN
+namespace
+{
+
+auto percent(uint64_t part, uint64_t whole) -> double
+{
+  return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+}
+
+auto state_name(ouly::heap_block_state state) -> char const*
+{
+  switch (state)
+  {
+  case ouly::heap_block_state::free:
+    return "free";
+  case ouly::heap_block_state::used:
+    return "used";
+  case ouly::heap_block_state::in_flight:
+    return "in-flight";
+  }
+  return "";
+}
+
+auto lifetime_name(ouly::allocation_lifetime lifetime) -> char const*
+{
+  switch (lifetime)
+  {
+  case ouly::allocation_lifetime::persistent:
+    return "persistent";
+  case ouly::allocation_lifetime::frame:
+    return "frame";
+  case ouly::allocation_lifetime::transient:
+    return "transient";
+  }
+  return "";
+}
+
+void print_summary(std::ostream& out, ouly::heap_arena_summary const& summary)
+{
+  out << std::fixed << std::setprecision(1) << summary.capacity_ << " B  used "
+      << percent(summary.bytes_used_, summary.capacity_) << "%  free "
+      << percent(summary.bytes_free_, summary.capacity_) << "%  in flight "
+      << percent(summary.bytes_in_flight_, summary.capacity_) << "%  blocks " << summary.used_blocks_ << '/'
+      << summary.free_blocks_ << " used/free  largest free " << summary.largest_free_block_ << " B  fragmentation "
+      << std::setprecision(3) << summary.fragmentation();
+}
+
+// Bytes of each state that fall inside [begin, end)
+struct cell
+{
+  uint64_t used_      = 0;
+  uint64_t free_      = 0;
+  uint64_t in_flight_ = 0;
+};
+
+void render_ascii(std::ostream& out, ouly::heap_snapshot const& snapshot, uint32_t columns)
+{
+  for (auto const& arena : snapshot.arenas_)
+  {
+    out << "arena " << arena.arena_ << "  class " << arena.memory_class_ << (arena.dedicated_ ? "  dedicated  " : "  ");
+    print_summary(out, ouly::summarize(arena));
+    if (arena.capacity_ == 0)
+    {
+      out << "\n  (no capacity, nothing to draw)\n";
+      continue;
+    }
+    out << "\n  |";
+
+    std::vector<cell> cells(columns);
+    for (auto const& block : arena.blocks_)
+    {
+      // Blocks past the capacity only come from a damaged snapshot; draw what lies inside it
+      uint64_t begin = block.offset_;
+      uint64_t end   = std::min<uint64_t>(uint64_t{block.offset_} + block.size_, arena.capacity_);
+      while (begin < end)
+      {
+        auto const index  = static_cast<uint32_t>(begin * columns / arena.capacity_);
+        auto const bound  = (static_cast<uint64_t>(index) + 1) * arena.capacity_ / columns;
+        auto const stop   = std::min(end, std::max(bound, begin + 1));
+        auto const amount = stop - begin;
+        auto&      target = cells[std::min(index, columns - 1)];
+        (block.state_ == ouly::heap_block_state::used   ? target.used_
+         : block.state_ == ouly::heap_block_state::free ? target.free_
+                                                        : target.in_flight_) += amount;
+        begin = stop;
+      }
+    }
+
+    for (auto const& c : cells)
+    {
+      out << (c.in_flight_ != 0 ? '~' : c.free_ == 0 ? '#' : c.used_ == 0 ? '.' : '+');
+    }
+    out << "|\n";
+  }
+
+  out << "total  ";
+  print_summary(out, ouly::summarize(snapshot));
+  out << '\n';
+}
+
+void render_html(std::ostream& out, ouly::heap_snapshot const& snapshot)
+{
+  out << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>heap snapshot</title><style>\n"
+         "body{font-family:monospace}.map{display:flex;height:24px;border:1px solid #444;margin-bottom:12px}\n"
+         ".used{background:#3b7dd8}.pinned{background:#b03030}.free{background:#eee}.in-flight{background:#e8a33d}\n"
+         ".used,.pinned,.free,.in-flight{border-right:1px solid #fff;box-sizing:border-box}\n"
+         "</style></head><body>\n<h1>heap snapshot</h1>\n<p>";
+  print_summary(out, ouly::summarize(snapshot));
+  out << "</p>\n";
+
+  for (auto const& arena : snapshot.arenas_)
+  {
+    out << "<h3>arena " << arena.arena_ << " &middot; class " << arena.memory_class_
+        << (arena.dedicated_ ? " &middot; dedicated" : "") << "</h3>\n<p>";
+    print_summary(out, ouly::summarize(arena));
+    if (arena.capacity_ == 0)
+    {
+      out << "</p>\n<p>no capacity, nothing to draw</p>\n";
+      continue;
+    }
+    out << "</p>\n<div class=\"map\">";
+    for (auto const& block : arena.blocks_)
+    {
+      bool const pinned = block.state_ == ouly::heap_block_state::used && !block.movable_;
+      out << "<div class=\"" << (pinned ? "pinned" : state_name(block.state_)) << "\" style=\"width:"
+          << std::setprecision(4) << percent(block.size_, arena.capacity_) << "%\" title=\"" << state_name(block.state_)
+          << " offset " << block.offset_ << " size " << block.size_;
+      if (block.state_ == ouly::heap_block_state::used)
+      {
+        out << " resource class " << block.resource_class_ << ' ' << lifetime_name(block.lifetime_)
+            << (block.movable_ ? " movable" : " pinned");
+      }
+      out << "\"></div>";
+    }
+    out << "</div>\n";
+  }
+  out << "</body></html>\n";
+}
+
+auto load(std::string const& path, ouly::heap_snapshot& snapshot) -> bool
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+  {
+    std::cerr << "cannot open " << path << '\n';
+    return false;
+  }
+  std::string const      bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  ouly::binary_input_stream in(reinterpret_cast<std::byte const*>(bytes.data()), bytes.size());
+  try
+  {
+    ouly::read(in, snapshot);
+  }
+  catch (std::exception const& error)
+  {
+    std::cerr << path << ": not a heap snapshot (" << error.what() << ")\n";
+    return false;
+  }
+  if (snapshot.version_ != ouly::heap_snapshot_version)
+  {
+    std::cerr << path << ": snapshot version " << snapshot.version_ << ", expected " << ouly::heap_snapshot_version
+              << '\n';
+    return false;
+  }
+  return true;
+}
+
+struct demo_memory
+{
+  void add(ouly::arena_id, ouly::allocation_size_type) {}
+  void remove(ouly::arena_id) {}
+};
+
+// A level's worth of buffers with every other one released leaves holes all over the heap
+auto make_demo() -> ouly::heap_snapshot
+{
+  demo_memory         memory;
+  ouly::gpu_allocator allocator{1024 * 1024};
+  std::minstd_rand    rng{42};
+
+  std::vector<ouly::gpu_allocation> allocations;
+  for (uint32_t i = 0; i < 600; ++i)
+  {
+    auto const size = 1024U << (rng() % 8);
+    allocations.push_back(allocator.allocate(
+     size, memory,
+     ouly::gpu_allocation_options{.alignment_ = 256, .resource_class_ = i % 4, .movable_ = (i % 17) != 0}));
+  }
+  for (size_t i = 0; i < allocations.size(); ++i)
+  {
+    if (rng() % 3 == 0)
+    {
+      allocator.deallocate(allocations[i].get_allocation_id(), memory);
+    }
+  }
+  return allocator.snapshot();
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+  std::vector<std::string_view> args(argv + 1, argv + argc);
+  if (args.size() == 2 && args[0] == "--demo")
+  {
+    ouly::binary_output_stream out;
+    ouly::write(out, make_demo());
+    std::ofstream file(std::string(args[1]), std::ios::binary);
+    file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return file ? 0 : 1;
+  }
+
+  if (args.empty())
+  {
+    std::cerr << "usage: heap_snapshot_view <snapshot> [--columns N] [--html <out.html>]\n"
+                 "       heap_snapshot_view --demo <snapshot>\n";
+    return 1;
+  }
+
+  uint32_t    columns = 64;
+  std::string html;
+  for (size_t i = 1; i + 1 < args.size(); i += 2)
+  {
+    if (args[i] == "--columns")
+    {
+      columns = std::max(1U, static_cast<uint32_t>(std::strtoul(std::string(args[i + 1]).c_str(), nullptr, 10)));
+    }
+    else if (args[i] == "--html")
+    {
+      html = args[i + 1];
+    }
+  }
+
+  ouly::heap_snapshot snapshot;
+  if (!load(std::string(args[0]), snapshot))
+  {
+    return 1;
+  }
+
+  render_ascii(std::cout, snapshot, columns);
+  if (!html.empty())
+  {
+    std::ofstream file(html);
+    if (!file)
+    {
+      std::cerr << "cannot write " << html << '\n';
+      return 1;
+    }
+    render_html(file, snapshot);
+    file.close();
+    if (!file)
+    {
+      std::cerr << "failed writing " << html << '\n';
+      return 1;
+    }
+    std::cout << "wrote " << html << '\n';
+  }
+  return 0;
+}
+// NOLINTEND
@@ -1,10 +1,17 @@
 #include "catch2/catch_all.hpp"
+#include "ouly/allocators/linear_arena_allocator.hpp"
 #include "ouly/allocators/mmap_file.hpp"
+#include "ouly/allocators/ts_thread_local_allocator.hpp"
 #include "ouly/allocators/virtual_allocator.hpp"
+#include "ouly/allocators/virtual_arena_allocator.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <new>
 #include <string>
 #include <system_error>
+#include <type_traits>
 
 // NOLINTBEGIN
 
@@ -262,4 +269,176 @@ TEST_CASE("Validate error handling", "[mmap_error_handling]")
     {}
   }
 }
+TEST_CASE("Validate huge page backing", "[virtual_allocator][huge_pages]")
+{
+  using ouly::cfg::page_backing;
+  auto const info      = ouly::detail::get_memory_info();
+  auto const huge_size = info.huge_page_size_ != 0 ? info.huge_page_size_ : std::size_t{2 * 1024 * 1024};
+
+  SECTION("Every backing maps usable memory, falling back when huge pages are unavailable")
+  {
+    for (auto backing : {page_backing::normal, page_backing::transparent_huge, page_backing::huge})
+    {
+      for (std::size_t size : {info.page_size_, huge_size, 3 * huge_size})
+      {
+        void* ptr = ouly::detail::virtual_alloc(size, ouly::cfg::protection::read_write, nullptr, backing);
+        REQUIRE(ptr != nullptr);
+        std::memset(ptr, 0x5a, size);
+        REQUIRE(static_cast<unsigned char*>(ptr)[size - 1] == 0x5a);
+        if (backing == page_backing::transparent_huge && info.huge_page_size_ != 0 && size >= huge_size)
+        {
+          // THP mappings are aligned so the kernel can promote them
+          REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % huge_size == 0);
+        }
+        REQUIRE(ouly::detail::virtual_free(ptr, size));
+
+        void* mapped = ouly::detail::map_anonymous(size, ouly::cfg::protection::read_write, nullptr, backing);
+        REQUIRE(mapped != nullptr);
+        static_cast<unsigned char*>(mapped)[0] = 1;
+        REQUIRE(ouly::detail::unmap(mapped, size));
+      }
+    }
+  }
+
+  SECTION("virtual_allocator rounds huge requests to whole huge pages")
+  {
+    using huge_config = ouly::config<ouly::cfg::backing_pages<page_backing::huge>>;
+    ouly::virtual_allocator<huge_config> allocator;
+    REQUIRE(allocator.huge_page_size() == info.huge_page_size_);
+
+    auto* ptr = static_cast<unsigned char*>(allocator.allocate(huge_size + 1));
+    REQUIRE(ptr != nullptr);
+    ptr[huge_size] = 7;
+    REQUIRE(ouly::detail::advise(ptr, huge_size, ouly::cfg::advice::huge_page));
+    allocator.deallocate(ptr, huge_size + 1);
+
+    // Small requests stay on normal pages
+    void* small = allocator.allocate(64);
+    REQUIRE(small != nullptr);
+    allocator.deallocate(small, 64);
+  }
+
+  SECTION("linear_arena_allocator places arenas on huge pages")
+  {
+    using huge_arenas = ouly::config<ouly::cfg::backing_pages<page_backing::transparent_huge>>;
+    using arena_t     = ouly::linear_arena_allocator<huge_arenas>;
+    static_assert(std::is_same_v<arena_t::underlying_allocator, ouly::page_allocator<huge_arenas>>);
+
+    arena_t arenas(huge_size);
+    auto*   first  = static_cast<unsigned char*>(arenas.allocate(huge_size / 2));
+    auto*   second = static_cast<unsigned char*>(arenas.allocate(huge_size));
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    std::memset(first, 1, huge_size / 2);
+    std::memset(second, 2, huge_size);
+    REQUIRE(arenas.get_arena_count() == 2);
+    arenas.rewind();
+  }
+
+  SECTION("ts_thread_local_allocator maps its pages")
+  {
+    ouly::ts_thread_local_allocator allocator(huge_size, page_backing::huge);
+    auto*                           small = static_cast<unsigned char*>(allocator.allocate(128));
+    auto*                           large = static_cast<unsigned char*>(allocator.allocate(3 * huge_size));
+    REQUIRE(small != nullptr);
+    REQUIRE(large != nullptr);
+    std::memset(small, 3, 128);
+    std::memset(large, 4, 3 * huge_size);
+    allocator.reset();
+    REQUIRE(allocator.allocate(huge_size / 2) != nullptr);
+    allocator.release();
+  }
+}
+
+TEST_CASE("Validate virtual_arena_allocator", "[virtual_arena_allocator]")
+{
+  using arena_t                     = ouly::virtual_arena_allocator<>;
+  constexpr std::size_t reserve     = std::size_t{64} * 1024 * 1024;
+  constexpr std::size_t granularity = arena_t::default_commit_granularity;
+
+  SECTION("Pages are committed on demand and blocks are contiguous")
+  {
+    arena_t arena(reserve);
+    REQUIRE(arena.get_reserved_size() >= reserve);
+    REQUIRE(arena.get_committed_size() == 0);
+
+    auto* first = static_cast<std::byte*>(arena.allocate(100));
+    REQUIRE(first == arena.data());
+    REQUIRE(arena.get_committed_size() == granularity);
+
+    auto* second = static_cast<std::byte*>(arena.allocate(64, ouly::alignment<64>{}));
+    REQUIRE(second == first + 128);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 64 == 0);
+
+    auto* big = static_cast<std::byte*>(arena.allocate(3 * granularity));
+    REQUIRE(big == second + 64);
+    std::memset(big, 0x11, 3 * granularity);
+    REQUIRE(arena.get_committed_size() == 4 * granularity);
+  }
+
+  SECTION("The last block grows in place without moving")
+  {
+    arena_t arena(reserve);
+    (void)arena.allocate(32);
+    auto* buffer = static_cast<unsigned char*>(arena.allocate(1024));
+    std::memset(buffer, 7, 1024);
+    std::size_t size = 1024;
+    while (size < 16 * 1024 * 1024)
+    {
+      auto* grown = static_cast<unsigned char*>(arena.realloc(buffer, size, size * 2));
+      REQUIRE(grown == buffer);
+      std::memset(grown + size, 7, size);
+      size *= 2;
+    }
+    REQUIRE(buffer[size - 1] == 7);
+    REQUIRE(arena.get_used_size() == 32 + size);
+    REQUIRE(arena.get_used_size() == 32 + size);
+
+    // A block that is not on top is copied
+    auto* first = static_cast<unsigned char*>(arena.data());
+    auto* moved = static_cast<unsigned char*>(arena.realloc(first, 32, 64));
+    REQUIRE(moved != first);
+
+    arena.deallocate(moved, 64);
+    REQUIRE(arena.get_used_size() == 32 + size);
+  }
+
+  SECTION("Markers and rewind reclaim space and decommit pages")
+  {
+    arena_t arena(reserve);
+    (void)arena.allocate(256);
+    auto marker = arena.get_marker();
+    auto* temp  = static_cast<unsigned char*>(arena.allocate(10 * granularity));
+    std::memset(temp, 0xff, 10 * granularity);
+    arena.rewind_to(marker);
+    REQUIRE(arena.get_used_size() == 256);
+    REQUIRE(arena.allocate(16) == temp);
+
+    arena.rewind(2 * granularity);
+    REQUIRE(arena.get_used_size() == 0);
+    REQUIRE(arena.get_committed_size() == 2 * granularity);
+
+    arena.rewind();
+    REQUIRE(arena.get_committed_size() == 0);
+
+    // Decommitted pages come back zeroed
+    auto* reused = static_cast<unsigned char*>(arena.allocate(10 * granularity));
+    REQUIRE(std::all_of(reused + 256, reused + 10 * granularity, [](unsigned char c) { return c == 0; }));
+  }
+
+  SECTION("Exhausting the reservation throws and moves transfer ownership")
+  {
+    arena_t arena(reserve);
+    REQUIRE_THROWS_AS((void)arena.allocate(arena.get_reserved_size() + 1), std::bad_alloc);
+    auto* block = arena.allocate(arena.get_reserved_size());
+    REQUIRE(block != nullptr);
+    REQUIRE_THROWS_AS((void)arena.allocate(1), std::bad_alloc);
+
+    arena_t moved(std::move(arena));
+    REQUIRE(moved.data() == block);
+    REQUIRE(moved.get_used_size() == moved.get_reserved_size());
+    REQUIRE(arena.data() == nullptr);
+  }
+}
+
 // NOLINTEND
@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: MIT
+
+#include "catch2/catch_all.hpp"
+#include "ouly/scheduler/async_sync.hpp"
+#include "ouly/scheduler/cancellation.hpp"
+#include "ouly/scheduler/co_task.hpp"
+#include "ouly/scheduler/scheduler.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <semaphore>
+#include <vector>
+
+namespace
+{
+
+auto coroutine_locked_increment(ouly::async_mutex& mutex, uint32_t& counter, uint32_t iterations,
+                                std::atomic<uint32_t>& finished, std::binary_semaphore& done) -> ouly::co_task<void>
+{
+  for (uint32_t index = 0; index < iterations; ++index)
+  {
+    if ((index & 1U) != 0)
+    {
+      auto guard = co_await mutex.scoped_lock();
+      auto value = counter;
+      co_await ouly::yield();
+      counter = value + 1;
+    }
+    else
+    {
+      co_await mutex.lock();
+      auto value = counter;
+      co_await ouly::yield();
+      counter = value + 1;
+      mutex.unlock();
+    }
+  }
+  if (finished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    done.release();
+  }
+}
+
+auto coroutine_limited(ouly::async_semaphore& semaphore, std::atomic<uint32_t>& running, std::atomic<uint32_t>& peak,
+                       std::atomic<uint32_t>& finished, std::binary_semaphore& done) -> ouly::co_task<void>
+{
+  co_await semaphore.acquire();
+  auto const now = running.fetch_add(1, std::memory_order_acq_rel) + 1;
+  auto       max = peak.load(std::memory_order_relaxed);
+  while (now > max && !peak.compare_exchange_weak(max, now, std::memory_order_relaxed))
+  {
+  }
+  co_await ouly::yield();
+  running.fetch_sub(1, std::memory_order_acq_rel);
+  semaphore.release();
+  if (finished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    done.release();
+  }
+}
+
+auto coroutine_wait_event(ouly::async_manual_reset_event& event, ouly::async_latch& latch,
+                          std::atomic<uint32_t>& woken) -> ouly::co_task<void>
+{
+  co_await event.wait();
+  woken.fetch_add(1, std::memory_order_relaxed);
+  latch.count_down();
+}
+
+auto coroutine_wait_latch(ouly::async_latch& latch, std::atomic<uint32_t>& woken, std::binary_semaphore& done)
+ -> ouly::co_task<void>
+{
+  co_await latch.wait();
+  if (woken.load(std::memory_order_relaxed) == 32)
+  {
+    done.release();
+  }
+}
+
+auto coroutine_cancelled_lock(ouly::async_mutex& mutex, std::atomic<uint32_t>& entered,
+                              std::atomic<uint32_t>& cancelled, std::binary_semaphore& done) -> ouly::co_task<void>
+{
+  try
+  {
+    auto guard = co_await mutex.scoped_lock();
+    entered.fetch_add(1, std::memory_order_relaxed);
+  }
+  catch (ouly::operation_cancelled const&)
+  {
+    cancelled.fetch_add(1, std::memory_order_relaxed);
+  }
+  done.release();
+}
+
+auto coroutine_cancelled_acquire(ouly::async_semaphore& semaphore, std::atomic<uint32_t>& entered,
+                                 std::atomic<uint32_t>& cancelled, std::binary_semaphore& done) -> ouly::co_task<void>
+{
+  try
+  {
+    co_await semaphore.acquire();
+    entered.fetch_add(1, std::memory_order_relaxed);
+  }
+  catch (ouly::operation_cancelled const&)
+  {
+    cancelled.fetch_add(1, std::memory_order_relaxed);
+  }
+  done.release();
+}
+
+} // namespace
+
+TEST_CASE("async_mutex serializes coroutines without blocking workers", "[scheduler][coroutine][async_sync]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  constexpr uint32_t    coroutine_count = 32;
+  constexpr uint32_t    iterations      = 50;
+  ouly::async_mutex     mutex;
+  uint32_t              counter = 0;
+  std::atomic<uint32_t> finished{coroutine_count};
+  std::binary_semaphore done{0};
+  for (uint32_t index = 0; index < coroutine_count; ++index)
+  {
+    scheduler.submit(ctx, coroutine_locked_increment(mutex, counter, iterations, finished, done));
+  }
+  ctx.cooperative_wait(done);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(counter == coroutine_count * iterations);
+  REQUIRE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST_CASE("async_semaphore bounds concurrent holders", "[scheduler][coroutine][async_sync]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.create_group(ouly::workgroup_id(1), 4, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  constexpr uint32_t    coroutine_count = 64;
+  ouly::async_semaphore semaphore(3);
+  std::atomic<uint32_t> running{0};
+  std::atomic<uint32_t> peak{0};
+  std::atomic<uint32_t> finished{coroutine_count};
+  std::binary_semaphore done{0};
+  for (uint32_t index = 0; index < coroutine_count; ++index)
+  {
+    scheduler.submit(ctx, ouly::workgroup_id(index % 2), coroutine_limited(semaphore, running, peak, finished, done));
+  }
+  ctx.cooperative_wait(done);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(peak.load() <= 3);
+  REQUIRE(semaphore.available() == 3);
+  REQUIRE(semaphore.try_acquire());
+}
+
+TEST_CASE("async_manual_reset_event and async_latch release waiters", "[scheduler][coroutine][async_sync]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  ouly::async_manual_reset_event event;
+  ouly::async_latch              latch(32);
+  std::atomic<uint32_t>          woken{0};
+  std::binary_semaphore          done{0};
+  scheduler.submit(ctx, coroutine_wait_latch(latch, woken, done));
+  for (uint32_t index = 0; index < 32; ++index)
+  {
+    scheduler.submit(ctx, coroutine_wait_event(event, latch, woken));
+  }
+  REQUIRE_FALSE(event.is_set());
+  REQUIRE_FALSE(latch.try_wait());
+  event.set();
+  ctx.cooperative_wait(done);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(woken.load() == 32);
+  REQUIRE(latch.try_wait());
+  REQUIRE(event.is_set());
+  event.reset();
+  REQUIRE_FALSE(event.is_set());
+}
+
+TEST_CASE("async primitives resume inline outside the scheduler", "[scheduler][coroutine][async_sync]")
+{
+  ouly::async_manual_reset_event event(true);
+  ouly::async_latch              latch(1);
+  std::atomic<uint32_t>          woken{0};
+  auto                           waiter = coroutine_wait_event(event, latch, woken);
+  waiter.wait();
+  REQUIRE(woken.load() == 1);
+  REQUIRE(latch.try_wait());
+}
+
+TEST_CASE("async_mutex and async_semaphore waits observe cancellation",
+          "[scheduler][coroutine][async_sync][cancellation]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  ouly::async_mutex         mutex;
+  ouly::async_semaphore     semaphore(0);
+  ouly::cancellation_source source;
+  std::atomic<uint32_t>     entered{0};
+  std::atomic<uint32_t>     cancelled{0};
+  std::binary_semaphore     locked{0};
+  std::binary_semaphore     acquired{0};
+  REQUIRE(mutex.try_lock());
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    scheduler.submit(ctx, coroutine_cancelled_lock(mutex, entered, cancelled, locked));
+    scheduler.submit(ctx, coroutine_cancelled_acquire(semaphore, entered, cancelled, acquired));
+  }
+
+  // Whether the waiters already queued or not, they throw instead of taking the lock or the permit
+  source.request_cancellation();
+  mutex.unlock();
+  semaphore.release();
+  ctx.cooperative_wait(locked);
+  ctx.cooperative_wait(acquired);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(entered.load() == 0);
+  REQUIRE(cancelled.load() == 2);
+  REQUIRE(mutex.try_lock());
+  mutex.unlock();
+  REQUIRE(semaphore.available() == 1);
+}
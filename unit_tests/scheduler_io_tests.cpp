@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+
+#include "catch2/catch_all.hpp"
+#include "ouly/scheduler/co_task.hpp"
+#include "ouly/scheduler/io_reactor.hpp"
+#include "ouly/scheduler/scheduler.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <semaphore>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+
+auto temp_file_path(char const* name) -> std::filesystem::path
+{
+  return std::filesystem::temp_directory_path() / name;
+}
+
+auto coroutine_round_trip(ouly::io_reactor& reactor, ouly::async_file& file, std::uint64_t offset,
+                          std::atomic<uint32_t>& mismatches, std::binary_semaphore& done) -> ouly::co_task<void>
+{
+  constexpr std::size_t block_size = 4096;
+
+  std::vector<std::byte> out(block_size);
+  for (std::size_t i = 0; i < block_size; ++i)
+  {
+    out[i] = static_cast<std::byte>((i + offset) & 0xFF);
+  }
+
+  auto group   = ouly::task_context::this_context::get().get_workgroup();
+  auto written = co_await reactor.async_write(file, offset, out);
+  if (written != block_size || ouly::task_context::this_context::get().get_workgroup() != group)
+  {
+    mismatches.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::vector<std::byte> in(block_size);
+  auto                   read = co_await reactor.async_read(file, offset, in);
+  if (read != block_size || in != out || ouly::task_context::this_context::get().get_workgroup() != group)
+  {
+    mismatches.fetch_add(1, std::memory_order_relaxed);
+  }
+  done.release();
+}
+
+auto coroutine_read_all(ouly::async_file& file, std::vector<std::byte>& buffer) -> ouly::co_task<std::size_t>
+{
+  co_return co_await ouly::async_read(file, 0, std::span(buffer));
+}
+
+auto coroutine_write_all(ouly::io_reactor& reactor, ouly::async_file& file, std::vector<std::byte> const& data)
+ -> ouly::co_task<std::size_t>
+{
+  co_return co_await reactor.async_write(file, 0, data);
+}
+
+void round_trip_on_scheduler(ouly::io_backend backend, uint32_t queue_depth = ouly::io_reactor::default_queue_depth)
+{
+  ouly::io_reactor reactor(backend, queue_depth);
+  REQUIRE(reactor.get_backend() != ouly::io_backend::automatic);
+  if (backend == ouly::io_backend::thread_pool)
+  {
+    REQUIRE(reactor.get_backend() == ouly::io_backend::thread_pool);
+  }
+
+  auto             path = temp_file_path("ouly_scheduler_io_tests.bin");
+  ouly::async_file file(path, ouly::access_mode::write);
+  REQUIRE(file.is_open());
+
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  constexpr uint32_t                                  coroutine_count = 16;
+  std::atomic<uint32_t>                               mismatches{0};
+  std::vector<std::unique_ptr<std::binary_semaphore>> done;
+  for (uint32_t i = 0; i < coroutine_count; ++i)
+  {
+    done.emplace_back(std::make_unique<std::binary_semaphore>(0));
+    scheduler.submit(ctx, ouly::workgroup_id(i % 2),
+                     coroutine_round_trip(reactor, file, std::uint64_t{i} * 4096, mismatches, *done.back()));
+  }
+  for (auto& event : done)
+  {
+    ctx.cooperative_wait(*event);
+  }
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(mismatches.load() == 0);
+  REQUIRE(file.size() == std::uint64_t{coroutine_count} * 4096);
+
+  file.close();
+  std::filesystem::remove(path);
+}
+
+} // namespace
+
+TEST_CASE("async file I/O resumes coroutines on their workgroup", "[scheduler][coroutine][io]")
+{
+  SECTION("automatic backend")
+  {
+    round_trip_on_scheduler(ouly::io_backend::automatic);
+  }
+  SECTION("automatic backend with a two-entry ring")
+  {
+    // More requests than ring entries: submissions queue up behind the ring and must all drain
+    round_trip_on_scheduler(ouly::io_backend::automatic, 2);
+  }
+  SECTION("thread pool backend")
+  {
+    round_trip_on_scheduler(ouly::io_backend::thread_pool);
+  }
+}
+
+TEST_CASE("async file I/O runs inline outside the scheduler", "[scheduler][coroutine][io]")
+{
+  auto path = temp_file_path("ouly_scheduler_io_inline.bin");
+  {
+    ouly::async_file       file(path, ouly::access_mode::write);
+    std::vector<std::byte> data(100);
+    std::iota(reinterpret_cast<unsigned char*>(data.data()), reinterpret_cast<unsigned char*>(data.data()) + 100,
+              static_cast<unsigned char>(0));
+    ouly::io_reactor reactor(ouly::io_backend::thread_pool);
+    auto             writer = coroutine_write_all(reactor, file, data);
+    REQUIRE(writer.wait() == 100);
+  }
+
+  ouly::async_file       file(path);
+  std::vector<std::byte> buffer(256);
+  auto                   reader = coroutine_read_all(file, buffer);
+  // Short read at end of file
+  REQUIRE(reader.wait() == 100);
+  REQUIRE(buffer[99] == std::byte{99});
+
+  ouly::async_file closed;
+  auto             failed = coroutine_read_all(closed, buffer);
+  REQUIRE_THROWS_AS(failed.wait(), std::system_error);
+
+  file.close();
+  std::filesystem::remove(path);
+  REQUIRE_THROWS_AS(ouly::async_file(path, ouly::access_mode::read), std::system_error);
+}
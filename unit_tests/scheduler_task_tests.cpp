@@ -2,15 +2,21 @@
 
 #include "catch2/catch_all.hpp"
 #include "ouly/scheduler/auto_parallel_for.hpp"
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/co_task.hpp"
+#include "ouly/scheduler/default_parallel_for.hpp"
+#include "ouly/scheduler/flow_graph.hpp"
 #include "ouly/scheduler/scheduler.hpp"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <new>
 #include <semaphore>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 namespace
@@ -80,6 +86,83 @@ auto coroutine_failure([[maybe_unused]] ouly::scheduler_allocator allocator) ->
   co_return 0;
 }
 
+auto coroutine_hop(ouly::workgroup_id target, std::atomic<uint32_t>& observed, std::binary_semaphore& done)
+  -> ouly::co_task<void>
+{
+  co_await ouly::task_context::this_context::get().schedule_on(target);
+  observed.store(ouly::task_context::this_context::get().get_workgroup().get_index(), std::memory_order_release);
+  for (uint32_t index = 0; index < 8; ++index)
+  {
+    co_await ouly::yield();
+  }
+  done.release();
+  co_return;
+}
+
+auto coroutine_cancelled_at_yield(ouly::cancellation_source& source, std::atomic<uint32_t>& steps)
+  -> ouly::co_task<int>
+{
+  steps.fetch_add(1, std::memory_order_relaxed);
+  source.request_cancellation();
+  co_await ouly::yield();
+  steps.fetch_add(1, std::memory_order_relaxed);
+  co_return 0;
+}
+
+auto coroutine_fan_out(std::atomic<int>& result, std::binary_semaphore& done) -> ouly::co_task<void>
+{
+  auto first  = coroutine_leaf({}, 20);
+  auto second = coroutine_leaf({}, 22);
+  co_await ouly::when_all(first, second);
+  int sum = first.result() + second.result();
+
+  std::vector<ouly::co_task<int>> children;
+  for (int index = 0; index < 64; ++index)
+  {
+    children.emplace_back(coroutine_leaf({}, 1));
+  }
+  co_await ouly::when_all(children);
+  for (auto& child : children)
+  {
+    sum += child.result();
+  }
+
+  co_await ouly::when_all();
+  result.store(sum, std::memory_order_release);
+  done.release();
+  co_return;
+}
+
+auto coroutine_fan_out_failure() -> ouly::co_task<int>
+{
+  auto good = coroutine_leaf({}, 1);
+  auto bad  = coroutine_failure({});
+  co_await ouly::when_all(good, bad);
+  co_return good.result();
+}
+
+auto coroutine_spawn_fib(uint32_t n) -> ouly::co_task<uint64_t>
+{
+  if (n < 2)
+  {
+    co_return n;
+  }
+  // The left half runs on this worker right away; the rest of this frame can be stolen meanwhile
+  auto left = coroutine_spawn_fib(n - 1);
+  co_await ouly::spawn(left);
+  auto right = co_await coroutine_spawn_fib(n - 2);
+  co_await left;
+  co_return left.result() + right;
+}
+
+auto coroutine_spawn_twice() -> ouly::co_task<uint64_t>
+{
+  auto child = coroutine_spawn_fib(10);
+  co_await ouly::spawn(child);
+  co_await ouly::spawn(child);
+  co_return co_await child;
+}
+
 } // namespace
 
 TEST_CASE("scheduler tasks chain queued continuations", "[scheduler][task][then]")
@@ -352,3 +435,324 @@ TEST_CASE("coroutines await scheduler tasks", "[scheduler][coroutine][task]")
   REQUIRE(direct.cooperative_wait(ctx) == 126);
   scheduler.end_execution();
 }
+
+TEST_CASE("coroutines hop workgroups and yield", "[scheduler][coroutine][schedule_on]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  std::atomic<uint32_t> observed{0};
+  std::binary_semaphore done{0};
+  scheduler.submit(ctx, coroutine_hop(ouly::workgroup_id(1), observed, done));
+  ctx.cooperative_wait(done);
+  scheduler.wait_for_tasks();
+
+  REQUIRE(observed.load(std::memory_order_acquire) == 1);
+  scheduler.end_execution();
+}
+
+TEST_CASE("coroutines await when_all of child coroutines", "[scheduler][coroutine][when_all]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  std::atomic<int>      result{0};
+  std::binary_semaphore done{0};
+  scheduler.submit(ctx, coroutine_fan_out(result, done));
+  ctx.cooperative_wait(done);
+  scheduler.wait_for_tasks();
+  REQUIRE(result.load(std::memory_order_acquire) == 42 + 64);
+
+  auto failed = coroutine_fan_out_failure();
+  REQUIRE_THROWS_AS(failed.cooperative_wait(ctx), std::runtime_error);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+}
+
+TEST_CASE("cancelled task_scope skips queued children", "[scheduler][task][scope][cancellation]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  ouly::cancellation_source source;
+  std::atomic<uint32_t>     count{0};
+  std::atomic<uint32_t>     without_token{0};
+  ouly::task_scope          scope;
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    for (uint32_t index = 0; index < 64; ++index)
+    {
+      scope.run(ctx,
+                [&source, &count, &without_token]()
+                {
+                  // Catch2 assertions are not thread-safe: record here, check after the join
+                  if (!ouly::task_context::get_cancellation_token().can_be_cancelled())
+                  {
+                    without_token.fetch_add(1, std::memory_order_relaxed);
+                  }
+                  count.fetch_add(1, std::memory_order_relaxed);
+                  source.request_cancellation();
+                });
+    }
+  }
+  REQUIRE_FALSE(ouly::task_context::get_cancellation_token().can_be_cancelled());
+  REQUIRE_THROWS_AS(scope.join(ctx), ouly::operation_cancelled);
+  REQUIRE(count.load(std::memory_order_relaxed) == 1);
+  REQUIRE(without_token.load(std::memory_order_relaxed) == 0);
+
+  // A reset source lets the same scope run again
+  source.reset();
+  scope.reset();
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    scope.run(ctx,
+              [&count]()
+              {
+                count.fetch_add(1, std::memory_order_relaxed);
+              });
+  }
+  scope.join(ctx);
+  REQUIRE(count.load(std::memory_order_relaxed) == 2);
+  scheduler.end_execution();
+}
+
+TEST_CASE("cancelled parallel_for stops early and throws", "[scheduler][task][parallel_for][cancellation]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  constexpr uint32_t        item_count = 100000;
+  ouly::cancellation_source source;
+  std::atomic<uint32_t>     visited{0};
+  auto                      cancel_early = [&](uint32_t& value, ouly::task_context const&)
+  {
+    value = 1;
+    if (visited.fetch_add(1, std::memory_order_relaxed) == 16)
+    {
+      source.request_cancellation();
+    }
+  };
+
+  std::vector<uint32_t> values(item_count, 0);
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    REQUIRE_THROWS_AS(ouly::default_parallel_for(cancel_early, values, ctx), ouly::operation_cancelled);
+  }
+  REQUIRE(visited.load() < item_count);
+
+  source.reset();
+  visited.store(0);
+  std::ranges::fill(values, 0);
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    REQUIRE_THROWS_AS(ouly::auto_parallel_for(cancel_early, values, ctx, test_auto_partitioner_traits{}),
+                      ouly::operation_cancelled);
+  }
+  REQUIRE(visited.load() < item_count);
+
+  // Without a pending request every element is visited
+  source.reset();
+  visited.store(0);
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    ouly::default_parallel_for([&visited](uint32_t&, ouly::task_context const&)
+                               { visited.fetch_add(1, std::memory_order_relaxed); },
+                               values, ctx);
+  }
+  REQUIRE(visited.load() == item_count);
+  scheduler.end_execution();
+}
+
+TEST_CASE("cancelled flow_graph skips pending nodes", "[scheduler][flow_graph][cancellation]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  ouly::flow_graph<ouly::scheduler> graph;
+  auto                              first  = graph.create_node();
+  auto                              second = graph.create_node();
+  auto                              third  = graph.create_node();
+  graph.connect(first, second);
+  graph.connect(second, third);
+
+  ouly::cancellation_source source;
+  std::atomic<uint32_t>     executed{0};
+  std::atomic_bool          inherited{false};
+  graph.add(first,
+            [&](ouly::task_context const&)
+            {
+              executed.fetch_add(1, std::memory_order_relaxed);
+              inherited.store(ouly::task_context::get_cancellation_token() == source.get_token());
+              source.request_cancellation();
+            });
+  graph.add(second,
+            [&](ouly::task_context const&)
+            {
+              executed.fetch_add(1, std::memory_order_relaxed);
+            });
+  graph.add(third,
+            [&](ouly::task_context const&)
+            {
+              executed.fetch_add(1, std::memory_order_relaxed);
+            });
+
+  graph.start(ctx, source.get_token());
+  graph.cooperative_wait(ctx);
+  REQUIRE(executed.load() == 1);
+  REQUIRE(inherited.load());
+
+  // Restarting with a fresh token runs every node again
+  source.reset();
+  graph.start(ctx);
+  graph.cooperative_wait(ctx);
+  REQUIRE(executed.load() == 4);
+  scheduler.end_execution();
+}
+
+TEST_CASE("cancelled coroutines throw at their next suspension point", "[scheduler][coroutine][cancellation]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  ouly::cancellation_source source;
+  std::atomic<uint32_t>     steps{0};
+  auto                      cancelled = [&]()
+  {
+    ouly::cancellation_guard guard(source.get_token());
+    return coroutine_cancelled_at_yield(source, steps);
+  }();
+  REQUIRE_THROWS_AS(cancelled.cooperative_wait(ctx), ouly::operation_cancelled);
+  REQUIRE(steps.load() == 1);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+}
+
+TEST_CASE("bounded task_scope limits children in flight", "[scheduler][task][scope][bounded]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.create_group(ouly::workgroup_id(1), 4, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  constexpr uint32_t    limit = 2;
+  std::atomic<uint32_t> running{0};
+  std::atomic<uint32_t> peak{0};
+  std::atomic<uint32_t> count{0};
+  auto                  child = [&]()
+  {
+    auto const now = running.fetch_add(1, std::memory_order_acq_rel) + 1;
+    auto       max = peak.load(std::memory_order_relaxed);
+    while (now > max && !peak.compare_exchange_weak(max, now, std::memory_order_relaxed))
+    {
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    count.fetch_add(1, std::memory_order_relaxed);
+    running.fetch_sub(1, std::memory_order_acq_rel);
+  };
+
+  ouly::task_scope scope(limit);
+  REQUIRE(scope.get_max_in_flight() == limit);
+  // Same workgroup: the spawner helps execute queued children
+  for (uint32_t index = 0; index < 200; ++index)
+  {
+    scope.run(ctx, child);
+  }
+  // Other workgroup: the spawner waits for a slot
+  for (uint32_t index = 0; index < 50; ++index)
+  {
+    scope.run(ctx, ouly::workgroup_id(1), child);
+  }
+  scope.join(ctx);
+  REQUIRE(count.load() == 250);
+  REQUIRE(peak.load() <= limit);
+
+  // Children spawned from inside the scope are not throttled
+  scope.reset();
+  scope.run(ctx,
+            [&](ouly::task_context const& child_ctx)
+            {
+              for (uint32_t index = 0; index < 8; ++index)
+              {
+                scope.run(child_ctx,
+                          [&count]()
+                          {
+                            count.fetch_add(1, std::memory_order_relaxed);
+                          });
+              }
+            });
+  scope.join(ctx);
+  REQUIRE(count.load() == 258);
+  scheduler.end_execution();
+}
+
+TEST_CASE("bounded task_scope spawner keeps running scheduler work while throttled",
+          "[scheduler][task][scope][bounded]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.create_group(ouly::workgroup_id(1), 1, 1);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  // Every child waits for a task on workgroup 0, whose only worker is the throttled spawner
+  constexpr uint32_t                        child_count = 16;
+  std::array<std::atomic_bool, child_count> helped{};
+  for (uint32_t index = 0; index < child_count; ++index)
+  {
+    scheduler.submit(ctx, ouly::workgroup_id(0),
+                     [&helped, index](ouly::task_context const&)
+                     {
+                       helped[index].store(true, std::memory_order_release);
+                       helped[index].notify_all();
+                     });
+  }
+
+  ouly::task_scope scope(1);
+  for (uint32_t index = 0; index < child_count; ++index)
+  {
+    scope.run(ctx, ouly::workgroup_id(1),
+              [&helped, index]()
+              {
+                helped[index].wait(false, std::memory_order_acquire);
+              });
+  }
+  scope.join(ctx);
+  REQUIRE(std::ranges::all_of(helped,
+                              [](std::atomic_bool const& flag)
+                              {
+                                return flag.load();
+                              }));
+  scheduler.end_execution();
+}
+
+TEST_CASE("spawned coroutines run work-first and parents can be stolen", "[scheduler][coroutine][spawn]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  auto root = coroutine_spawn_fib(20);
+  REQUIRE(root.cooperative_wait(ctx) == 6765);
+  scheduler.wait_for_tasks();
+
+  // Spawning an already started task does not run it again
+  auto twice = coroutine_spawn_twice();
+  REQUIRE(twice.cooperative_wait(ctx) == 55);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+}
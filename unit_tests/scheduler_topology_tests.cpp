@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+
+#include "catch2/catch_all.hpp"
+#include "ouly/scheduler/cpu_topology.hpp"
+#include "ouly/scheduler/v3/scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// NOLINTBEGIN
+namespace
+{
+
+struct fake_sysfs
+{
+  fake_sysfs()
+  {
+    root_ = std::filesystem::temp_directory_path() /
+            ("ouly_topology_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)));
+    std::filesystem::remove_all(root_);
+    std::filesystem::create_directories(cpu_root());
+  }
+
+  ~fake_sysfs()
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(root_, ec);
+  }
+
+  [[nodiscard]] auto cpu_root() const -> std::filesystem::path
+  {
+    return root_ / "devices" / "system" / "cpu";
+  }
+
+  void write(std::filesystem::path const& file, std::string const& value) const
+  {
+    std::filesystem::create_directories(file.parent_path());
+    std::ofstream(file) << value << "\n";
+  }
+
+  std::filesystem::path root_;
+};
+
+} // namespace
+
+TEST_CASE("cpu_topology classifies cores by cpu_capacity", "[scheduler][topology]")
+{
+  fake_sysfs sysfs;
+  for (uint32_t i = 0; i < 6; ++i)
+  {
+    auto cpu = sysfs.cpu_root() / ("cpu" + std::to_string(i));
+    sysfs.write(cpu / "cpu_capacity", i < 2 ? "1024" : "446");
+  }
+  // Offline CPUs and unrelated entries are ignored
+  sysfs.write(sysfs.cpu_root() / "cpu5" / "online", "0");
+  sysfs.write(sysfs.cpu_root() / "cpufreq" / "boost", "1");
+
+  auto topology = ouly::cpu_topology::discover(sysfs.cpu_root());
+  REQUIRE(topology.get_cpus().size() == 5);
+  REQUIRE(topology.is_hybrid());
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::performance) == std::vector<uint32_t>{0, 1});
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::efficiency) == std::vector<uint32_t>{2, 3, 4});
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::any).size() == 5);
+}
+
+TEST_CASE("cpu_topology falls back to maximum frequency and ignores boost spread", "[scheduler][topology]")
+{
+  fake_sysfs sysfs;
+  // Two favoured P-cores boost slightly higher than the others; they must all stay performance cores
+  std::vector<std::string> freqs = {"5400000", "5400000", "5000000", "5000000", "3800000", "3800000"};
+  for (uint32_t i = 0; i < freqs.size(); ++i)
+  {
+    sysfs.write(sysfs.cpu_root() / ("cpu" + std::to_string(i)) / "cpufreq" / "cpuinfo_max_freq", freqs[i]);
+  }
+
+  auto topology = ouly::cpu_topology::discover(sysfs.cpu_root());
+  REQUIRE(topology.is_hybrid());
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::performance) == std::vector<uint32_t>{0, 1, 2, 3});
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::efficiency) == std::vector<uint32_t>{4, 5});
+
+  SECTION("Intel hybrid PMU lists take precedence")
+  {
+    sysfs.write(sysfs.root_ / "devices" / "cpu_core" / "cpus", "0-1");
+    sysfs.write(sysfs.root_ / "devices" / "cpu_atom" / "cpus", "2-3,4-5");
+    auto listed = ouly::cpu_topology::discover(sysfs.cpu_root());
+    REQUIRE(listed.get_cpu_ids(ouly::core_kind::performance) == std::vector<uint32_t>{0, 1});
+    REQUIRE(listed.get_cpu_ids(ouly::core_kind::efficiency) == std::vector<uint32_t>{2, 3, 4, 5});
+  }
+}
+
+TEST_CASE("cpu_topology treats uniform cores as non-hybrid", "[scheduler][topology]")
+{
+  ouly::cpu_topology topology({{.id_ = 0, .capacity_ = 1024}, {.id_ = 1, .capacity_ = 1024}, {.id_ = 2}});
+  REQUIRE(!topology.is_hybrid());
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::efficiency).empty());
+  REQUIRE(topology.get_cpu_ids(ouly::core_kind::performance).size() == 3);
+
+  auto const& machine = ouly::cpu_topology::get();
+  REQUIRE(!machine.get_cpus().empty());
+  REQUIRE(!machine.get_cpu_ids(ouly::core_kind::performance).empty());
+}
+
+TEST_CASE("cpu_topology does not depend on the affinity of the thread that asks", "[scheduler][topology]")
+{
+  std::size_t seen = 0;
+  std::thread probe(
+   [&seen]()
+   {
+     auto cpus = ouly::current_thread_cpus();
+     if (!cpus.empty())
+     {
+       ouly::pin_current_thread(std::span(cpus).first(1));
+     }
+     seen = ouly::cpu_topology::get().get_cpus().size();
+   });
+  probe.join();
+
+#ifdef __linux__
+  auto const system = ouly::cpu_topology::discover("/sys/devices/system/cpu");
+  if (!system.get_cpus().empty())
+  {
+    REQUIRE(seen == system.get_cpus().size());
+  }
+#endif
+}
+
+TEST_CASE("v3 end_execution restores the affinity of the calling thread", "[scheduler][topology][v3]")
+{
+  auto const before = ouly::current_thread_cpus();
+
+  // Worker 0 is this thread and asks for efficiency cores, which pins it on hybrid machines
+  ouly::v3::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2, 0, ouly::core_kind::efficiency);
+  scheduler.begin_execution();
+  scheduler.end_execution();
+
+  REQUIRE(ouly::current_thread_cpus() == before);
+}
+
+TEST_CASE("v3 workgroups pinned to performance cores run there", "[scheduler][topology][v3]")
+{
+  auto const& machine     = ouly::cpu_topology::get();
+  auto        performance = machine.get_cpu_ids(ouly::core_kind::performance);
+
+  ouly::v3::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.create_group(ouly::workgroup_id(1), 1, 2, 0, ouly::core_kind::performance);
+  scheduler.begin_execution();
+
+  std::atomic<uint32_t> ran{0};
+  std::atomic<uint32_t> misplaced{0};
+  auto const&           ctx = ouly::v3::task_context::this_context::get();
+  for (uint32_t i = 0; i < 64; ++i)
+  {
+    scheduler.submit(ctx, ouly::workgroup_id(1),
+                     [&](ouly::v3::task_context const&)
+                     {
+#ifdef __linux__
+                       if (machine.is_hybrid() &&
+                           std::ranges::find(performance, static_cast<uint32_t>(sched_getcpu())) == performance.end())
+                       {
+                         misplaced.fetch_add(1, std::memory_order_relaxed);
+                       }
+#endif
+                       ran.fetch_add(1, std::memory_order_relaxed);
+                     });
+  }
+  scheduler.end_execution();
+
+  REQUIRE(ran.load() == 64);
+  REQUIRE(misplaced.load() == 0);
+}
+// NOLINTEND
@@ -5,6 +5,7 @@
 #define OULY_SCHEDULER_VERSION v2
 
 #include "catch2/catch_all.hpp"
+#include "ouly/scheduler/detail/work_mailbox.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
 #include <atomic>
@@ -86,4 +87,126 @@ TEST_CASE("v2: task continuations and scopes", "[scheduler][version][v2][task]")
   REQUIRE(count.load(std::memory_order_relaxed) == 1);
   scheduler.end_execution();
 }
+
+TEST_CASE("v2: external bursts overflow the mailbox without blocking", "[scheduler][version][v2][mailbox]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 1);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  // Keep the only worker of group 1 busy so nothing drains its mailbox during the burst
+  std::atomic_bool started{false};
+  std::atomic_bool release{false};
+  scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                   [&](ouly::task_context const&)
+                   {
+                     started.store(true, std::memory_order_release);
+                     while (!release.load(std::memory_order_acquire))
+                     {
+                       std::this_thread::yield();
+                     }
+                   });
+  while (!started.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+
+  // Several times the ring capacity, submitted by a worker that is not a member of group 1
+  constexpr uint32_t    burst = 8192;
+  std::atomic<uint32_t> count{0};
+  for (uint32_t i = 0; i < burst; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                     [&count](ouly::task_context const&)
+                     {
+                       count.fetch_add(1, std::memory_order_relaxed);
+                     });
+  }
+  REQUIRE(count.load() == 0);
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(count.load() == burst);
+}
+TEST_CASE("v2: mailbox overflow keeps order and never reports a spurious empty", "[scheduler][version][v2][mailbox]")
+{
+  // Ring of 64 plus several overflow chunks
+  constexpr uint32_t                       count = 2000;
+  ouly::detail::work_mailbox<uint32_t, 64> mailbox;
+
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    REQUIRE(mailbox.push(i));
+  }
+  REQUIRE(mailbox.size() == count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint32_t value = 0;
+    REQUIRE(mailbox.pop(value));
+    REQUIRE(value == i);
+  }
+  uint32_t value = 0;
+  REQUIRE(!mailbox.pop(value));
+
+  // Concurrent producers and consumers: once every producer is done, each consumer drains until it has seen
+  // an empty mailbox, so an empty reported while items remain shows up as a lost item.
+  constexpr uint32_t       producers = 4;
+  std::atomic<uint32_t>    popped{0};
+  std::atomic<uint64_t>    sum{0};
+  std::atomic_bool         produced{false};
+  std::vector<std::thread> consumers;
+  for (uint32_t c = 0; c < 2; ++c)
+  {
+    consumers.emplace_back(
+     [&]
+     {
+       uint32_t item = 0;
+       while (true)
+       {
+         bool const done = produced.load(std::memory_order_acquire);
+         if (mailbox.pop(item))
+         {
+           sum.fetch_add(item, std::memory_order_relaxed);
+           popped.fetch_add(1, std::memory_order_relaxed);
+         }
+         else if (done)
+         {
+           break;
+         }
+       }
+     });
+  }
+  std::vector<std::thread> threads;
+  for (uint32_t p = 0; p < producers; ++p)
+  {
+    threads.emplace_back(
+     [&mailbox]
+     {
+       for (uint32_t i = 0; i < count; ++i)
+       {
+         while (!mailbox.push(i))
+         {
+           std::this_thread::yield();
+         }
+       }
+     });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  produced.store(true, std::memory_order_release);
+  for (auto& thread : consumers)
+  {
+    thread.join();
+  }
+  REQUIRE(popped.load() == producers * count);
+  REQUIRE(sum.load() == uint64_t{producers} * count * (count - 1) / 2);
+  REQUIRE(mailbox.size() == 0);
+}
 // NOLINTEND
@@ -7,6 +7,7 @@
 #include "catch2/catch_all.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <numeric>
@@ -138,4 +139,280 @@ TEST_CASE("v3: task continuations and scopes", "[scheduler][version][v3][task]")
   REQUIRE(count.load(std::memory_order_relaxed) == 1);
   scheduler.end_execution();
 }
+
+TEST_CASE("v3: external bursts overflow the mailbox without blocking", "[scheduler][version][v3][mailbox]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 1);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  // Keep the only worker of group 1 busy so nothing drains its mailbox during the burst
+  std::atomic_bool started{false};
+  std::atomic_bool release{false};
+  scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                   [&](ouly::task_context const&)
+                   {
+                     started.store(true, std::memory_order_release);
+                     while (!release.load(std::memory_order_acquire))
+                     {
+                       std::this_thread::yield();
+                     }
+                   });
+  while (!started.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+
+  // Several times the ring capacity, submitted by a worker that is not a member of group 1
+  constexpr uint32_t    burst = 8192;
+  std::atomic<uint32_t> count{0};
+  for (uint32_t i = 0; i < burst; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                     [&count](ouly::task_context const&)
+                     {
+                       count.fetch_add(1, std::memory_order_relaxed);
+                     });
+  }
+  REQUIRE(count.load() == 0);
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(count.load() == burst);
+}
+
+TEST_CASE("v3: idle workers are lent to groups they may borrow into", "[scheduler][version][v3][loan]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 1);
+  scheduler.create_group(ouly::workgroup_id(2), 3, 1);
+  scheduler.allow_loan(ouly::workgroup_id(0), ouly::workgroup_id(1), 3);
+  scheduler.allow_loan(ouly::workgroup_id(0), ouly::workgroup_id(2), 0);
+  scheduler.begin_execution();
+
+  // Workers 0 and 1 may be lent to group 1 and get offsets past its single member
+  REQUIRE(scheduler.get_worker_count(ouly::workgroup_id(1)) == 3);
+  REQUIRE(scheduler.get_worker_count(ouly::workgroup_id(2)) == 1);
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  // Occupy two workers with blockers of groups 1 and 2; group 1's queued work then needs a lent worker unless
+  // the group 1 blocker itself went to one
+  std::atomic<uint32_t> started{0};
+  std::atomic_bool      release{false};
+  for (uint32_t group = 1; group <= 2; ++group)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(group),
+                     [&](ouly::task_context const&)
+                     {
+                       started.fetch_add(1, std::memory_order_release);
+                       while (!release.load(std::memory_order_acquire))
+                       {
+                         std::this_thread::yield();
+                       }
+                     });
+  }
+  while (started.load(std::memory_order_acquire) != 2)
+  {
+    std::this_thread::yield();
+  }
+
+  constexpr uint32_t    tasks = 256;
+  std::atomic<uint32_t> borrowed{0};
+  std::atomic<uint32_t> bad_offsets{0};
+  std::atomic<uint32_t> not_lent{0};
+  for (uint32_t i = 0; i < tasks; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                     [&](ouly::task_context const& ctx)
+                     {
+                       // Either blocker may have been lent out, so the member can be free too; a lent
+                       // worker w runs at offset 1 + w
+                       auto worker   = ctx.get_worker().get_index();
+                       auto expected = worker == 2 ? 0U : 1U + worker;
+                       if (ctx.get_workgroup() != ouly::workgroup_id(1) || ctx.get_group_offset() != expected)
+                       {
+                         bad_offsets.fetch_add(1, std::memory_order_relaxed);
+                       }
+                       borrowed.fetch_add(1, std::memory_order_relaxed);
+                     });
+  }
+  scheduler.submit(main_ctx, ouly::workgroup_id(2),
+                   [&](ouly::task_context const&)
+                   {
+                     not_lent.fetch_add(1, std::memory_order_relaxed);
+                   });
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (borrowed.load(std::memory_order_acquire) != tasks && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::yield();
+  }
+  auto borrowed_before_release = borrowed.load();
+  // Weight 0 means group 2 never borrows
+  auto not_lent_before_release = not_lent.load();
+
+  // Lent workers still serve their own group
+  std::atomic<uint32_t> home{0};
+  for (uint32_t i = 0; i < tasks; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                     [&home](ouly::task_context const& ctx)
+                     {
+                       if (ctx.get_workgroup() == ouly::workgroup_id(0))
+                       {
+                         home.fetch_add(1, std::memory_order_relaxed);
+                       }
+                     });
+  }
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  REQUIRE(borrowed_before_release == tasks);
+  REQUIRE(bad_offsets.load() == 0);
+  REQUIRE(not_lent_before_release == 0);
+  REQUIRE(home.load() == tasks);
+  REQUIRE(not_lent.load() == 1);
+}
+
+TEST_CASE("v3: fair share splits a shared worker by group weight", "[scheduler][version][v3][fair_share]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  // Groups 1 and 2 share worker 1 only; group 1 has the higher priority and would starve group 2
+  scheduler.create_group(ouly::workgroup_id(1), 1, 1, 1);
+  scheduler.create_group(ouly::workgroup_id(2), 1, 1, 0);
+  scheduler.set_fair_share(true);
+  scheduler.set_group_weight(ouly::workgroup_id(1), 3);
+  scheduler.set_group_weight(ouly::workgroup_id(2), 1);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  std::atomic_bool started{false};
+  std::atomic_bool release{false};
+  scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                   [&](ouly::task_context const&)
+                   {
+                     started.store(true, std::memory_order_release);
+                     while (!release.load(std::memory_order_acquire))
+                     {
+                       std::this_thread::yield();
+                     }
+                   });
+  while (!started.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+
+  // Both groups are flooded before the worker is released; only worker 1 runs them, so the order is
+  // decided by its round robin alone
+  constexpr uint32_t    tasks  = 1000;
+  constexpr uint32_t    window = 400;
+  std::atomic<uint32_t> sequence{0};
+  std::atomic<uint32_t> first_group1{0};
+  for (uint32_t i = 0; i < tasks; ++i)
+  {
+    for (uint32_t group = 1; group <= 2; ++group)
+    {
+      scheduler.submit(main_ctx, ouly::workgroup_id(group),
+                       [&, group](ouly::task_context const&)
+                       {
+                         if (sequence.fetch_add(1, std::memory_order_relaxed) < window && group == 1)
+                         {
+                           first_group1.fetch_add(1, std::memory_order_relaxed);
+                         }
+                       });
+    }
+  }
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+
+  REQUIRE(scheduler.get_executed_count(ouly::workgroup_id(1)) == tasks + 1);
+  REQUIRE(scheduler.get_executed_count(ouly::workgroup_id(2)) == tasks);
+  scheduler.end_execution();
+
+  // 3:1 while both groups have work
+  REQUIRE(first_group1.load() >= 290);
+  REQUIRE(first_group1.load() <= 310);
+}
+
+TEST_CASE("v3: fair share does not bank credit while a group idles", "[scheduler][version][v3][fair_share]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.create_group(ouly::workgroup_id(1), 1, 1, 1);
+  scheduler.create_group(ouly::workgroup_id(2), 1, 1, 0);
+  scheduler.set_fair_share(true);
+  scheduler.set_group_weight(ouly::workgroup_id(1), 3);
+  scheduler.set_group_weight(ouly::workgroup_id(2), 1);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  // Group 2 idles while group 1 keeps the shared worker busy, then the worker idles as well
+  for (uint32_t i = 0; i < 2000; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(1), [](ouly::task_context const&) {});
+  }
+  scheduler.wait_for_tasks();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  std::atomic_bool started{false};
+  std::atomic_bool release{false};
+  scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                   [&](ouly::task_context const&)
+                   {
+                     started.store(true, std::memory_order_release);
+                     while (!release.load(std::memory_order_acquire))
+                     {
+                       std::this_thread::yield();
+                     }
+                   });
+  while (!started.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+
+  // The idle group floods first; only worker 1 runs these, so `order` is written by one thread
+  constexpr uint32_t    tasks = 1000;
+  std::vector<uint32_t> order(2 * tasks, 0);
+  std::atomic<uint32_t> sequence{0};
+  for (uint32_t i = 0; i < tasks; ++i)
+  {
+    for (uint32_t group : {2U, 1U})
+    {
+      scheduler.submit(main_ctx, ouly::workgroup_id(group),
+                       [&, group](ouly::task_context const&)
+                       {
+                         order[sequence.fetch_add(1, std::memory_order_relaxed)] = group;
+                       });
+    }
+  }
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+
+  // While both groups have work no turn runs longer than the group's weight
+  constexpr uint32_t window     = 800;
+  uint32_t           run        = 0;
+  uint32_t           max_run[3] = {};
+  for (uint32_t i = 0; i < window; ++i)
+  {
+    run               = i > 0 && order[i] == order[i - 1] ? run + 1 : 1;
+    max_run[order[i]] = std::max(max_run[order[i]], run);
+  }
+  REQUIRE(max_run[1] <= 3);
+  REQUIRE(max_run[2] == 1);
+}
 // NOLINTEND
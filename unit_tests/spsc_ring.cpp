@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/containers/spsc_ring.hpp"
+#include "catch2/catch_all.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN
+
+TEST_CASE("spsc_ring single threaded push and pop", "[spsc_ring]")
+{
+  ouly::spsc_ring<int, 4> ring;
+  REQUIRE(ring.empty());
+  REQUIRE(ring.capacity() == 4);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    REQUIRE(ring.try_push(i));
+  }
+  REQUIRE(!ring.try_push(4));
+  REQUIRE(ring.size() == 4);
+
+  int value = -1;
+  REQUIRE(ring.try_pop(value));
+  REQUIRE(value == 0);
+  REQUIRE(ring.try_push(4));
+
+  for (int i = 1; i <= 4; ++i)
+  {
+    REQUIRE(ring.try_pop(value));
+    REQUIRE(value == i);
+  }
+  REQUIRE(!ring.try_pop(value));
+  REQUIRE(ring.empty());
+}
+
+TEST_CASE("spsc_ring batches wrap around the buffer", "[spsc_ring][batch]")
+{
+  ouly::spsc_ring<uint32_t, 8> ring;
+  std::array<uint32_t, 5>      in{};
+  std::array<uint32_t, 5>      out{};
+  uint32_t                     next     = 0;
+  uint32_t                     expected = 0;
+
+  for (uint32_t round = 0; round < 10; ++round)
+  {
+    for (auto& v : in)
+    {
+      v = next++;
+    }
+    REQUIRE(ring.try_push_n(in) == in.size());
+    REQUIRE(ring.try_pop_n(out) == out.size());
+    for (auto v : out)
+    {
+      REQUIRE(v == expected++);
+    }
+  }
+
+  // A batch larger than the free space is truncated
+  std::vector<uint32_t> big(12, 7);
+  REQUIRE(ring.try_push_n(big) == 8);
+  REQUIRE(ring.try_push_n(big) == 0);
+  std::vector<uint32_t> drained(12, 0);
+  REQUIRE(ring.try_pop_n(drained) == 8);
+  REQUIRE(ring.try_pop_n(drained) == 0);
+}
+
+TEST_CASE("spsc_ring owns non-trivial elements", "[spsc_ring]")
+{
+  auto shared = std::make_shared<int>(5);
+  {
+    ouly::spsc_ring<std::shared_ptr<int>, 4> ring;
+    REQUIRE(ring.try_push(shared));
+    REQUIRE(ring.try_emplace(shared));
+    REQUIRE(shared.use_count() == 3);
+
+    std::shared_ptr<int> out;
+    REQUIRE(ring.try_pop(out));
+    REQUIRE(*out == 5);
+    out.reset();
+    REQUIRE(shared.use_count() == 2);
+  }
+  // The element left in the ring was destroyed with it
+  REQUIRE(shared.use_count() == 1);
+
+  ouly::spsc_ring<std::string, 2> strings;
+  REQUIRE(strings.try_push(std::string(64, 'x')));
+  std::string out;
+  REQUIRE(strings.try_pop(out));
+  REQUIRE(out == std::string(64, 'x'));
+}
+
+TEST_CASE("spsc_ring transfers a stream between two threads in order", "[spsc_ring][threads]")
+{
+  constexpr uint32_t            count = 200000;
+  ouly::spsc_ring<uint32_t, 64> ring;
+
+  std::thread producer(
+   [&]()
+   {
+     std::array<uint32_t, 16> batch{};
+     uint32_t                 next = 0;
+     while (next < count)
+     {
+       if ((next & 1) == 0)
+       {
+         if (ring.try_push(next))
+         {
+           ++next;
+         }
+         continue;
+       }
+       auto n = std::min<uint32_t>(static_cast<uint32_t>(batch.size()), count - next);
+       for (uint32_t i = 0; i < n; ++i)
+       {
+         batch[i] = next + i;
+       }
+       next += static_cast<uint32_t>(ring.try_push_n(std::span<uint32_t const>(batch.data(), n)));
+     }
+   });
+
+  uint32_t                 expected = 0;
+  bool                     ordered  = true;
+  std::array<uint32_t, 32> out{};
+  while (expected < count)
+  {
+    auto n = ring.try_pop_n(out);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      ordered = ordered && out[i] == expected;
+      ++expected;
+    }
+  }
+  producer.join();
+  REQUIRE(ordered);
+  REQUIRE(ring.empty());
+}
+
+TEST_CASE("spsc_ring blocking waits park both sides", "[spsc_ring][blocking]")
+{
+  using blocking_ring = ouly::spsc_ring<uint64_t, 8, ouly::config<ouly::cfg::blocking_wait>>;
+  constexpr uint32_t count = 50000;
+  blocking_ring      forward;
+  blocking_ring      backward;
+
+  // Ping-pong parks the consumer of each ring on every round trip; the bulk phase fills the ring and
+  // parks the producer
+  std::thread echo(
+   [&]()
+   {
+     uint64_t value = 0;
+     for (uint32_t i = 0; i < count; ++i)
+     {
+       forward.pop_wait(value);
+       backward.push_wait(value + 1);
+     }
+     for (uint32_t i = 0; i < count; ++i)
+     {
+       forward.pop_wait(value);
+       std::this_thread::yield();
+     }
+     backward.push_wait(value);
+   });
+
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint64_t reply = 0;
+    forward.push_wait(i);
+    backward.pop_wait(reply);
+    sum += reply - i;
+  }
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    forward.push_wait(i);
+  }
+  uint64_t last = 0;
+  backward.pop_wait(last);
+  echo.join();
+
+  REQUIRE(sum == count);
+  REQUIRE(last == count - 1);
+}
+
+// NOLINTEND
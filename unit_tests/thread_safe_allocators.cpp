@@ -1,9 +1,15 @@
 #include "catch2/catch_all.hpp"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstring>
+#include <mutex>
+#include <ouly/allocators/ts_object_pool.hpp>
+#include <ouly/allocators/ts_pool_allocator.hpp>
 #include <ouly/allocators/ts_shared_linear_allocator.hpp>
+#include <ouly/allocators/ts_size_class_allocator.hpp>
 #include <ouly/allocators/ts_thread_local_allocator.hpp>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -436,4 +442,434 @@ TEST_CASE("Thread-safe allocators realloc test", "[allocator]")
     allocator.release();
   }
 }
-// NOLINTEND
\ No newline at end of file
+
+TEST_CASE("ts_thread_local_allocator reuses blocks freed on other threads", "[allocator][threads]")
+{
+  constexpr std::size_t           block_size = 256;
+  constexpr std::size_t           page_size  = 16 * block_size;
+  ouly::ts_thread_local_allocator allocator(page_size);
+
+  // Fill the owner's first arena exactly
+  std::vector<void*> blocks;
+  for (std::size_t i = 0; i < page_size / block_size; ++i)
+  {
+    blocks.push_back(allocator.allocate(block_size));
+  }
+
+  // The owner's own non-recent blocks keep the stack-only contract
+  REQUIRE(allocator.deallocate(blocks[0], block_size) == false);
+
+  std::atomic<std::size_t> queued{0};
+  std::thread              remote(
+   [&]()
+   {
+     for (auto* ptr : blocks)
+     {
+       if (allocator.deallocate(ptr, block_size))
+       {
+         queued.fetch_add(1, std::memory_order_relaxed);
+       }
+     }
+   });
+  remote.join();
+  REQUIRE(queued.load() == blocks.size());
+
+  // The arena is exhausted, so the owner drains its inbox before taking a new arena. Requests
+  // smaller than the freed blocks split them.
+  auto within_freed = [&](void* ptr)
+  {
+    return std::any_of(blocks.begin(), blocks.end(),
+                       [ptr](void* block)
+                       {
+                         auto* p = static_cast<std::byte*>(ptr);
+                         auto* b = static_cast<std::byte*>(block);
+                         return p >= b && p < b + block_size;
+                       });
+  };
+  std::set<void*> reused;
+  for (std::size_t i = 0; i < 2 * blocks.size(); ++i)
+  {
+    void* ptr = allocator.allocate(block_size / 2);
+    REQUIRE(within_freed(ptr));
+    reused.insert(ptr);
+  }
+  REQUIRE(reused.size() == 2 * blocks.size());
+  REQUIRE(within_freed(allocator.allocate(block_size / 2)) == false);
+
+  allocator.release();
+}
+
+TEST_CASE("ts_thread_local_allocator passes blocks between threads", "[allocator][threads]")
+{
+  ouly::ts_thread_local_allocator allocator(4096);
+  constexpr int                   num_threads = 4;
+  constexpr int                   rounds      = 200;
+  constexpr std::size_t           batch       = 16;
+
+  std::mutex                                  exchange_lock;
+  std::vector<std::pair<void*, std::size_t>> exchange;
+  std::atomic<int>                            corrupted{0};
+
+  auto worker = [&](int id)
+  {
+    for (int round = 0; round < rounds; ++round)
+    {
+      std::vector<std::pair<void*, std::size_t>> mine;
+      for (std::size_t i = 0; i < batch; ++i)
+      {
+        std::size_t size = 16 + ((i * 37 + static_cast<std::size_t>(round)) % 200);
+        void*       ptr  = allocator.allocate(size);
+        std::memset(ptr, id + 1, size);
+        mine.emplace_back(ptr, size);
+      }
+
+      std::vector<std::pair<void*, std::size_t>> theirs;
+      {
+        std::lock_guard<std::mutex> lg{exchange_lock};
+        exchange.insert(exchange.end(), mine.begin(), mine.end());
+        auto take = std::min(exchange.size(), batch);
+        theirs.assign(exchange.begin(), exchange.begin() + static_cast<std::ptrdiff_t>(take));
+        exchange.erase(exchange.begin(), exchange.begin() + static_cast<std::ptrdiff_t>(take));
+      }
+
+      for (auto [ptr, size] : theirs)
+      {
+        // A block handed out twice would have been overwritten by its second owner
+        auto const* bytes = static_cast<unsigned char const*>(ptr);
+        if (std::any_of(bytes, bytes + size, [&](unsigned char b) { return b != bytes[0]; }))
+        {
+          corrupted.fetch_add(1, std::memory_order_relaxed);
+        }
+        allocator.deallocate(ptr, size);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  REQUIRE(corrupted.load() == 0);
+
+  allocator.release();
+}
+
+TEST_CASE("ts_size_class_allocator size classes", "[allocator][size_class]")
+{
+  using alloc = ouly::ts_size_class_allocator;
+  REQUIRE(alloc::size_class_of(0) == 0);
+  REQUIRE(alloc::size_class_of(1) == 0);
+  REQUIRE(alloc::size_class_of(16) == 0);
+  REQUIRE(alloc::size_class_of(17) == 1);
+  REQUIRE(alloc::size_class_of(128) == 7);
+  REQUIRE(alloc::size_of_class(alloc::size_class_of(129)) == 160);
+  REQUIRE(alloc::size_class_of(alloc::max_small_size + 1) == alloc::num_size_classes);
+  for (std::size_t size = 1; size <= alloc::max_small_size; ++size)
+  {
+    auto size_class = alloc::size_class_of(size);
+    REQUIRE(alloc::size_of_class(size_class) >= size);
+    REQUIRE((size_class == 0 || alloc::size_of_class(size_class - 1) < size));
+  }
+}
+
+TEST_CASE("ts_size_class_allocator reuses freed blocks", "[allocator][size_class]")
+{
+  ouly::ts_size_class_allocator allocator;
+
+  std::vector<std::pair<void*, std::size_t>> blocks;
+  std::set<void*>                            unique;
+  for (std::size_t i = 0; i < 4000; ++i)
+  {
+    auto  size = 1 + ((i * 37) % 2000);
+    void* ptr  = allocator.allocate(size);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t) == 0);
+    std::memset(ptr, static_cast<int>(i & 0xff), size);
+    blocks.emplace_back(ptr, size);
+    unique.insert(ptr);
+  }
+  REQUIRE(unique.size() == blocks.size());
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+  {
+    auto [ptr, size] = blocks[i];
+    REQUIRE(static_cast<unsigned char*>(ptr)[size - 1] == static_cast<unsigned char>(i & 0xff));
+  }
+
+  auto slabs = allocator.get_slab_count();
+  for (auto [ptr, size] : blocks)
+  {
+    allocator.deallocate(ptr, size);
+  }
+  // A second round of the same sizes fits in the slabs already owned
+  for (auto& [ptr, size] : blocks)
+  {
+    ptr = allocator.allocate(size);
+  }
+  REQUIRE(allocator.get_slab_count() == slabs);
+  for (auto [ptr, size] : blocks)
+  {
+    allocator.deallocate(ptr, size);
+  }
+
+  // Large blocks bypass the slabs
+  void* large = allocator.allocate(1 << 20);
+  std::memset(large, 1, 1 << 20);
+  allocator.deallocate(large, 1 << 20);
+  allocator.deallocate(nullptr, 64);
+}
+
+TEST_CASE("ts_size_class_allocator frees across threads", "[allocator][size_class][threads]")
+{
+  ouly::ts_size_class_allocator allocator(4);
+
+  constexpr std::size_t    count = 20000;
+  std::vector<void*>       blocks(count);
+  std::atomic<std::size_t> produced{0};
+  std::atomic<std::size_t> bad{0};
+
+  // Producer allocates and consumer frees: every free is remote
+  std::thread producer(
+   [&]()
+   {
+     for (std::size_t i = 0; i < count; ++i)
+     {
+       auto* ptr = static_cast<std::size_t*>(allocator.allocate(24 + (i % 5) * 40));
+       *ptr      = i;
+       blocks[i] = ptr;
+       produced.store(i + 1, std::memory_order_release);
+     }
+   });
+  std::thread consumer(
+   [&]()
+   {
+     for (std::size_t i = 0; i < count; ++i)
+     {
+       while (produced.load(std::memory_order_acquire) <= i)
+       {
+         std::this_thread::yield();
+       }
+       if (*static_cast<std::size_t*>(blocks[i]) != i)
+       {
+         bad.fetch_add(1, std::memory_order_relaxed);
+       }
+       allocator.deallocate(blocks[i], 24 + (i % 5) * 40);
+     }
+   });
+  producer.join();
+  consumer.join();
+  REQUIRE(bad.load() == 0);
+
+  // Both threads exited and every block was freed: trim returns all slabs to the system
+  allocator.trim();
+  REQUIRE(allocator.get_slab_count() == 0);
+
+  // A thread exits with blocks still allocated; they are freed later from this thread
+  std::vector<void*> survivors(500);
+  std::thread        owner(
+   [&]()
+   {
+     for (auto& ptr : survivors)
+     {
+       ptr = allocator.allocate(48);
+     }
+   });
+  owner.join();
+  REQUIRE(allocator.get_slab_count() > 0);
+  for (auto* ptr : survivors)
+  {
+    allocator.deallocate(ptr, 48);
+  }
+  allocator.trim();
+  REQUIRE(allocator.get_slab_count() == 0);
+
+  // A later thread adopts the orphaned slab instead of allocating a new one
+  void*       kept = nullptr;
+  std::thread first(
+   [&]()
+   {
+     kept = allocator.allocate(48);
+   });
+  first.join();
+  REQUIRE(allocator.get_slab_count() == 1);
+  std::thread second(
+   [&]()
+   {
+     void* reused = allocator.allocate(48);
+     allocator.deallocate(reused, 48);
+   });
+  second.join();
+  REQUIRE(allocator.get_slab_count() == 1);
+  allocator.deallocate(kept, 48);
+  allocator.trim();
+  REQUIRE(allocator.get_slab_count() == 0);
+}
+
+TEST_CASE("ts_size_class_allocator skips orphaned slabs that are full", "[allocator][size_class][threads]")
+{
+  ouly::ts_size_class_allocator allocator(4);
+
+  // A thread fills one slab completely and exits holding every block of it
+  std::vector<void*> full;
+  std::thread        owner(
+   [&]()
+   {
+     full.push_back(allocator.allocate(48));
+     while (true)
+     {
+       void* ptr = allocator.allocate(48);
+       if (allocator.get_slab_count() > 1)
+       {
+         allocator.deallocate(ptr, 48);
+         break;
+       }
+       full.push_back(ptr);
+     }
+   });
+  owner.join();
+  REQUIRE(full.size() > 1);
+
+  // The full orphan cannot serve this thread; it gets another slab instead
+  std::vector<void*> fresh(full.size() + 1);
+  std::thread        next(
+   [&]()
+   {
+     for (auto& ptr : fresh)
+     {
+       ptr = allocator.allocate(48);
+       std::memset(ptr, 0x5a, 48);
+     }
+   });
+  next.join();
+  std::set<void*> unique(full.begin(), full.end());
+  unique.insert(fresh.begin(), fresh.end());
+  REQUIRE(unique.size() == full.size() + fresh.size());
+  REQUIRE(unique.count(nullptr) == 0);
+
+  for (auto* ptr : full)
+  {
+    allocator.deallocate(ptr, 48);
+  }
+  for (auto* ptr : fresh)
+  {
+    allocator.deallocate(ptr, 48);
+  }
+  allocator.trim();
+  REQUIRE(allocator.get_slab_count() == 0);
+}
+
+TEST_CASE("ts_pool_allocator reuses slots", "[allocator][pool]")
+{
+  ouly::ts_pool_allocator pool(24, 32, 8);
+  REQUIRE(pool.get_slot_size() == 32);
+
+  std::set<void*> slots;
+  for (int i = 0; i < 100; ++i)
+  {
+    void* ptr = pool.allocate();
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % 32 == 0);
+    slots.insert(ptr);
+  }
+  REQUIRE(slots.size() == 100);
+  auto const pages = pool.get_page_count();
+
+  // Freed slots are served again without new pages, whichever magazine they went through
+  for (int round = 0; round < 10; ++round)
+  {
+    for (auto* ptr : slots)
+    {
+      pool.deallocate(ptr);
+    }
+    std::set<void*> again;
+    for (std::size_t i = 0; i < slots.size(); ++i)
+    {
+      again.insert(pool.allocate());
+    }
+    REQUIRE(again == slots);
+  }
+  REQUIRE(pool.get_page_count() == pages);
+  pool.deallocate(nullptr);
+}
+
+TEST_CASE("ts_object_pool shares objects between threads", "[allocator][pool][threads]")
+{
+  struct node
+  {
+    std::size_t value_ = 0;
+    node*       next_  = nullptr;
+  };
+
+  ouly::ts_object_pool<node> pool(16);
+  constexpr int              num_threads = 4;
+  constexpr std::size_t      rounds      = 2000;
+  constexpr std::size_t      batch       = 24;
+
+  std::mutex         exchange_lock;
+  std::vector<node*> exchange;
+  std::set<node*>    live;
+  std::atomic<int>   corrupted{0};
+
+  auto worker = [&](std::size_t id)
+  {
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+      std::vector<node*> mine;
+      for (std::size_t i = 0; i < batch; ++i)
+      {
+        mine.push_back(::new (pool.allocate()) node{.value_ = (id << 32) | round});
+      }
+
+      std::vector<node*> theirs;
+      {
+        std::lock_guard<std::mutex> lg{exchange_lock};
+        for (auto* n : mine)
+        {
+          // A slot handed out twice would still be live
+          if (!live.insert(n).second)
+          {
+            corrupted.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        exchange.insert(exchange.end(), mine.begin(), mine.end());
+        auto take = std::min(exchange.size(), batch);
+        theirs.assign(exchange.end() - static_cast<std::ptrdiff_t>(take), exchange.end());
+        exchange.resize(exchange.size() - take);
+        for (auto* n : theirs)
+        {
+          live.erase(n);
+        }
+      }
+
+      for (auto* n : theirs)
+      {
+        if ((n->value_ & 0xffffffff) > round && (n->value_ >> 32) == id)
+        {
+          corrupted.fetch_add(1, std::memory_order_relaxed);
+        }
+        pool.deallocate(n);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  REQUIRE(corrupted.load() == 0);
+
+  for (auto* n : exchange)
+  {
+    pool.deallocate(n);
+  }
+  // The working set is a few batches per thread, far below what unbounded growth would need
+  REQUIRE(pool.get_page_count() < 16);
+}
+// NOLINTEND